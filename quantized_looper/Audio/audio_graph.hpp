@@ -0,0 +1,252 @@
+/**
+ * @file audio_graph.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Block-based processing graph with compile-time block geometry.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Quantized looper includes
+#include <quantized_looper/Audio/loop_engine.hpp>
+#include <quantized_looper/Audio/mix_kernels.hpp>
+
+/**
+ * @brief One block of planar audio.
+ *
+ * Frames and channels are template parameters, so every loop over a channel
+ * has a constant trip count the compiler can unroll and vectorize. Channels
+ * are stored one after the other rather than interleaved, so each channel is
+ * a contiguous run.
+ *
+ * @tparam Sample Sample type.
+ * @tparam Frames Frames per block.
+ * @tparam Channels Number of channels.
+ */
+template<typename Sample, std::size_t Frames, std::size_t Channels>
+struct audio_block
+{
+    using sample_type = Sample;
+    static constexpr std::size_t frames = Frames;
+    static constexpr std::size_t channels = Channels;
+
+    Sample* channel(std::size_t c) { return data[c].data(); }
+
+    const Sample* channel(std::size_t c) const { return data[c].data(); }
+
+    /**
+     * @brief Load interleaved samples, e.g. one audio_io half buffer.
+     */
+    void deinterleave(const Sample* interleaved)
+    {
+        for (std::size_t i = 0; i < Frames; ++i) {
+            for (std::size_t c = 0; c < Channels; ++c) {
+                data[c][i] = interleaved[i * Channels + c];
+            }
+        }
+    }
+
+    /**
+     * @brief Store as interleaved samples.
+     */
+    void interleave(Sample* interleaved) const
+    {
+        for (std::size_t i = 0; i < Frames; ++i) {
+            for (std::size_t c = 0; c < Channels; ++c) {
+                interleaved[i * Channels + c] = data[c][i];
+            }
+        }
+    }
+
+    alignas(32) std::array<std::array<Sample, Frames>, Channels> data{};
+};
+
+/**
+ * @brief Chain of nodes that each process a whole block in place.
+ *
+ * A node is any type with `void process(Block&)`. The chain is a tuple, so
+ * dispatch is a fold over direct calls the compiler can inline; there is no
+ * virtual call per node or per sample.
+ *
+ * @tparam Block audio_block instantiation flowing through the graph.
+ * @tparam Nodes Node types, run in order.
+ */
+template<typename Block, typename... Nodes>
+class audio_graph
+{
+public:
+    using block_type = Block;
+
+    explicit audio_graph(Nodes... chain)
+      : nodes(std::move(chain)...)
+    {
+    }
+
+    void process(Block& block)
+    {
+        std::apply([&block](auto&... node) { (node.process(block), ...); },
+                   nodes);
+    }
+
+    /**
+     * @brief Process one interleaved buffer, e.g. an audio_io half.
+     */
+    void process_interleaved(const typename Block::sample_type* in,
+                             typename Block::sample_type* out)
+    {
+        scratch.deinterleave(in);
+        process(scratch);
+        scratch.interleave(out);
+    }
+
+    template<std::size_t I>
+    auto& node()
+    {
+        return std::get<I>(nodes);
+    }
+
+private:
+    std::tuple<Nodes...> nodes;
+    Block scratch{};
+};
+
+/**
+ * @brief Scales every channel by a fixed-point or floating point gain.
+ *
+ * Integer samples use a Q15 gain in an int32_t, so 32768 is unity and larger
+ * gains boost; the product is taken in 64 bits and saturates to the sample
+ * type. Floating point samples use the gain as is.
+ */
+template<typename Sample>
+class gain_node
+{
+public:
+    using gain_type =
+      std::conditional_t<std::is_floating_point_v<Sample>, Sample, int32_t>;
+
+    //! Gain that passes samples through unchanged
+    static constexpr gain_type unity =
+      std::is_floating_point_v<Sample> ? gain_type{ 1 } : gain_type{ 32768 };
+
+    explicit gain_node(gain_type gain)
+      : gain(gain)
+    {
+    }
+
+    void set_gain(gain_type value) { gain = value; }
+
+    template<typename Block>
+    void process(Block& block)
+    {
+        for (std::size_t c = 0; c < Block::channels; ++c) {
+            Sample* x = block.channel(c);
+            for (std::size_t i = 0; i < Block::frames; ++i) {
+                if constexpr (std::is_floating_point_v<Sample>) {
+                    x[i] = x[i] * gain;
+                } else {
+                    const int64_t y = (static_cast<int64_t>(x[i]) * gain) >> 15;
+                    x[i] = static_cast<Sample>(
+                      std::clamp<int64_t>(y,
+                                          std::numeric_limits<Sample>::min(),
+                                          std::numeric_limits<Sample>::max()));
+                }
+            }
+        }
+    }
+
+private:
+    gain_type gain;
+};
+
+/**
+ * @brief Runs a mono loop_engine or track_bank on one input channel and adds
+ * its playback to every channel, so the input is monitored on top of the loop.
+ *
+ * The node only refers to the engine; the loop buffer is usually far too big
+ * to pass around by value and lives in static storage.
+ *
+ * @tparam Engine Any type with process(in, out, n), e.g. loop_engine.
+ */
+template<typename Engine>
+class loop_node
+{
+public:
+    explicit loop_node(Engine& engine, std::size_t input_channel = 0)
+      : looper(&engine)
+      , input_channel(input_channel)
+    {
+    }
+
+    template<typename Block>
+    void process(Block& block)
+    {
+        std::array<typename Block::sample_type, Block::frames> playback;
+        looper->process(
+          block.channel(input_channel), playback.data(), Block::frames);
+        for (std::size_t c = 0; c < Block::channels; ++c) {
+            auto* x = block.channel(c);
+            if constexpr (std::is_same_v<typename Block::sample_type, int16_t>) {
+                mix_q15(x, playback.data(), Block::frames);
+            } else {
+                for (std::size_t i = 0; i < Block::frames; ++i) {
+                    x[i] = mix_saturate(x[i], playback[i]);
+                }
+            }
+        }
+    }
+
+    Engine& engine() { return *looper; }
+
+private:
+    Engine* looper;
+    std::size_t input_channel;
+};
+
+/**
+ * @brief Lets an onset_tempo listen to one channel while asked to, and
+ * passes the block through untouched.
+ *
+ * @tparam Detector Any type with feed(samples, n), e.g. onset_tempo.
+ */
+template<typename Detector>
+class onset_node
+{
+public:
+    explicit onset_node(Detector& detector, std::size_t input_channel = 0)
+      : detector(&detector)
+      , input_channel(input_channel)
+    {
+    }
+
+    /**
+     * @brief Start or stop feeding the detector, from the main loop.
+     */
+    void listen(bool on) { listening = on; }
+
+    bool listens() const { return listening; }
+
+    template<typename Block>
+    void process(Block& block)
+    {
+        if (listening) {
+            detector->feed(block.channel(input_channel), Block::frames);
+        }
+    }
+
+    Detector& tempo() { return *detector; }
+
+private:
+    Detector* detector;
+    std::size_t input_channel;
+    bool listening = false;
+};
@@ -0,0 +1,180 @@
+/**
+ * @file audio_io.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Double-buffered audio I/O shared by the DMA driver and host backends.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Quantized looper includes
+#include <quantized_looper/Software/spsc_ring.hpp>
+
+/**
+ * @brief Circular capture and playback buffers split into two halves.
+ *
+ * A backend streams both buffers continuously. When it has finished with the
+ * first half it calls on_half_complete(), when it has finished with the second
+ * half it calls on_complete(). Either way the callback gets the half that was
+ * just captured and the half of the playback buffer that has just been played,
+ * which it must refill before the backend wraps around to it again.
+ *
+ * Samples are interleaved, `Channels` per frame.
+ *
+ * @tparam Sample Sample type as transferred by the backend.
+ * @tparam BlockFrames Frames per half buffer.
+ * @tparam Channels Interleaved channels per frame.
+ */
+template<typename Sample, std::size_t BlockFrames, std::size_t Channels>
+class audio_io
+{
+public:
+    using sample_type = Sample;
+    static constexpr std::size_t block_frames = BlockFrames;
+    static constexpr std::size_t channels = Channels;
+    static constexpr std::size_t block_samples = BlockFrames * Channels;
+
+    /**
+     * @brief Block callback, run in the context that completed the half.
+     *
+     * On the board this is the DMA interrupt.
+     */
+    using callback_t = void (*)(const Sample* in, Sample* out, void* context);
+
+    audio_io() = default;
+
+    audio_io(audio_io const&) = delete;
+    void operator=(audio_io const&) = delete;
+
+    void set_callback(callback_t callback, void* context = nullptr)
+    {
+        block_callback = callback;
+        callback_context = context;
+    }
+
+    void on_half_complete() { dispatch(0); }
+
+    void on_complete() { dispatch(block_samples); }
+
+    /**
+     * @brief Number of blocks handed to the callback so far.
+     */
+    uint32_t blocks() const { return block_count; }
+
+    Sample* rx_buffer() { return rx.data(); }
+
+    Sample* tx_buffer() { return tx.data(); }
+
+    static constexpr std::size_t buffer_samples() { return 2 * block_samples; }
+
+protected:
+    // 32-byte alignment keeps each half on whole Cortex-M7 cache lines
+    alignas(32) std::array<Sample, 2 * block_samples> rx{};
+    alignas(32) std::array<Sample, 2 * block_samples> tx{};
+
+private:
+    void dispatch(std::size_t offset)
+    {
+        if (block_callback != nullptr) {
+            block_callback(&rx[offset], &tx[offset], callback_context);
+        } else {
+            std::fill_n(&tx[offset], block_samples, Sample{});
+        }
+        ++block_count;
+    }
+
+    callback_t block_callback = nullptr;
+    void* callback_context = nullptr;
+    uint32_t block_count = 0;
+};
+
+/**
+ * @brief Hands blocks between the audio interrupt and the processing task.
+ *
+ * exchange() is the audio_io callback: it queues the captured block and plays
+ * the oldest processed one. process() runs in the task and drains every queued
+ * block through the engine. The processed path is primed with silence so the
+ * task has one whole block period of slack; underruns play silence and
+ * overruns drop the captured block, and both are counted.
+ *
+ * @tparam Io audio_io instantiation the queue serves.
+ * @tparam Depth Blocks that can be queued in each direction.
+ */
+template<typename Io, std::size_t Depth = 4>
+class audio_block_queue
+{
+public:
+    using sample_type = typename Io::sample_type;
+    using block_type = std::array<sample_type, Io::block_samples>;
+
+    audio_block_queue() { processed.try_push(block_type{}); }
+
+    /**
+     * @brief audio_io callback; pass the queue as the context.
+     */
+    static void exchange(const sample_type* in, sample_type* out, void* context)
+    {
+        auto* self = static_cast<audio_block_queue*>(context);
+
+        block_type* slot = self->captured.write_slot();
+        if (slot != nullptr) {
+            std::copy_n(in, Io::block_samples, slot->data());
+            self->captured.commit_write();
+        } else {
+            self->overrun_count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        const block_type* ready = self->processed.read_slot();
+        if (ready != nullptr) {
+            std::copy_n(ready->data(), Io::block_samples, out);
+            self->processed.commit_read();
+        } else {
+            std::fill_n(out, Io::block_samples, sample_type{});
+            self->underrun_count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Run every queued block through a processing function.
+     *
+     * @param fn Callable as fn(const sample_type* in, sample_type* out)
+     * @return Number of blocks processed
+     */
+    template<typename Fn>
+    std::size_t process(Fn&& fn)
+    {
+        std::size_t n = 0;
+        for (;;) {
+            const block_type* in = captured.read_slot();
+            if (in == nullptr) {
+                break;
+            }
+            block_type* out = processed.write_slot();
+            if (out == nullptr) {
+                break;
+            }
+            fn(in->data(), out->data());
+            processed.commit_write();
+            captured.commit_read();
+            ++n;
+        }
+        return n;
+    }
+
+    uint32_t overruns() const { return overrun_count.load(); }
+
+    uint32_t underruns() const { return underrun_count.load(); }
+
+private:
+    spsc_ring<block_type, Depth> captured;
+    spsc_ring<block_type, Depth> processed;
+    std::atomic<uint32_t> overrun_count{ 0 };
+    std::atomic<uint32_t> underrun_count{ 0 };
+};
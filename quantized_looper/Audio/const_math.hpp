@@ -0,0 +1,65 @@
+/**
+ * @file const_math.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Math functions usable in constant expressions, for building tables.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+/**
+ * @brief Enough trigonometry to build filter and fade tables at compile time.
+ *
+ * The <cmath> functions are not constexpr in C++20. These are only meant for
+ * table generation; they are accurate to about 1e-12, far below one Q15 or
+ * float step.
+ */
+namespace const_math {
+
+constexpr double pi = 3.14159265358979323846;
+
+/**
+ * @brief sin(x) for any x, by range reduction to [-pi, pi] and a Taylor
+ * series.
+ */
+constexpr double sin(double x)
+{
+    // Reduce to [-pi, pi]
+    double turns = x / (2 * pi);
+    long long whole = static_cast<long long>(turns < 0 ? turns - 0.5
+                                                       : turns + 0.5);
+    x -= static_cast<double>(whole) * 2 * pi;
+
+    // Fold to [-pi/2, pi/2], where the series converges quickly
+    if (x > pi / 2) {
+        x = pi - x;
+    } else if (x < -pi / 2) {
+        x = -pi - x;
+    }
+
+    double term = x;
+    double sum = x;
+    for (int k = 1; k < 12; ++k) {
+        term *= -x * x / ((2.0 * k) * (2.0 * k + 1.0));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double cos(double x)
+{
+    return sin(x + pi / 2);
+}
+
+/**
+ * @brief Normalized sinc, sin(pi x) / (pi x).
+ */
+constexpr double sinc(double x)
+{
+    if (x > -1e-12 && x < 1e-12) {
+        return 1.0;
+    }
+    return sin(pi * x) / (pi * x);
+}
+
+} // namespace const_math
@@ -0,0 +1,193 @@
+/**
+ * @file dsp_intrinsics.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Cortex-M7 DSP instructions with bit-exact portable fallbacks.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <cstdint>
+#include <cstring>
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define QL_HAS_DSP_INSTRUCTIONS 1
+#include <cmsis_compiler.h>
+#else
+#define QL_HAS_DSP_INSTRUCTIONS 0
+#endif
+
+/**
+ * @brief Packed-SIMD and saturating arithmetic used by the audio kernels.
+ *
+ * On a core with the DSP extension each function is the CMSIS intrinsic from
+ * cmsis_gcc.h. Everywhere else it is a plain C++ model of the instruction that
+ * produces the same bits, so kernels written on top of these run unchanged on
+ * the host and can be checked against a scalar reference there.
+ *
+ * Packed words hold two int16_t lanes, lane 0 in the low halfword.
+ */
+namespace dsp {
+
+constexpr int32_t saturate16(int32_t x)
+{
+    return x > INT16_MAX ? INT16_MAX : (x < INT16_MIN ? INT16_MIN : x);
+}
+
+constexpr int32_t saturate32(int64_t x)
+{
+    return x > INT32_MAX ? INT32_MAX
+                         : (x < INT32_MIN ? INT32_MIN : static_cast<int32_t>(x));
+}
+
+constexpr int16_t lane0(uint32_t x)
+{
+    return static_cast<int16_t>(x & 0xFFFF);
+}
+
+constexpr int16_t lane1(uint32_t x)
+{
+    return static_cast<int16_t>(x >> 16);
+}
+
+constexpr uint32_t pack(int32_t lo, int32_t hi)
+{
+    return (static_cast<uint32_t>(lo) & 0xFFFF) |
+           (static_cast<uint32_t>(hi) << 16);
+}
+
+/**
+ * @brief Two int16_t samples from memory as one packed word.
+ */
+inline uint32_t load2(const int16_t* p)
+{
+    uint32_t x;
+    std::memcpy(&x, p, sizeof(x));
+    return x;
+}
+
+inline void store2(int16_t* p, uint32_t x)
+{
+    std::memcpy(p, &x, sizeof(x));
+}
+
+/**
+ * @brief Lane-wise saturating add (QADD16).
+ */
+inline uint32_t qadd16(uint32_t x, uint32_t y)
+{
+#if QL_HAS_DSP_INSTRUCTIONS
+    return __QADD16(x, y);
+#else
+    return pack(saturate16(lane0(x) + lane0(y)),
+                saturate16(lane1(x) + lane1(y)));
+#endif
+}
+
+/**
+ * @brief Saturating 32-bit add (QADD).
+ */
+inline int32_t qadd(int32_t x, int32_t y)
+{
+#if QL_HAS_DSP_INSTRUCTIONS
+    return __QADD(x, y);
+#else
+    return saturate32(static_cast<int64_t>(x) + y);
+#endif
+}
+
+/**
+ * @brief Dual multiply, add both products (SMUAD): x0*y0 + x1*y1.
+ */
+inline int32_t smuad(uint32_t x, uint32_t y)
+{
+#if QL_HAS_DSP_INSTRUCTIONS
+    return static_cast<int32_t>(__SMUAD(x, y));
+#else
+    return static_cast<int32_t>(static_cast<uint32_t>(lane0(x) * lane0(y)) +
+                                static_cast<uint32_t>(lane1(x) * lane1(y)));
+#endif
+}
+
+/**
+ * @brief Dual multiply with exchanged lanes, add (SMUADX): x0*y1 + x1*y0.
+ */
+inline int32_t smuadx(uint32_t x, uint32_t y)
+{
+#if QL_HAS_DSP_INSTRUCTIONS
+    return static_cast<int32_t>(__SMUADX(x, y));
+#else
+    return static_cast<int32_t>(static_cast<uint32_t>(lane0(x) * lane1(y)) +
+                                static_cast<uint32_t>(lane1(x) * lane0(y)));
+#endif
+}
+
+/**
+ * @brief Dual multiply-accumulate (SMLAD): acc + x0*y0 + x1*y1.
+ *
+ * Like the instruction, the sum wraps on overflow.
+ */
+inline int32_t smlad(uint32_t x, uint32_t y, int32_t acc)
+{
+#if QL_HAS_DSP_INSTRUCTIONS
+    return static_cast<int32_t>(__SMLAD(x, y, static_cast<uint32_t>(acc)));
+#else
+    return static_cast<int32_t>(static_cast<uint32_t>(acc) +
+                                static_cast<uint32_t>(lane0(x) * lane0(y)) +
+                                static_cast<uint32_t>(lane1(x) * lane1(y)));
+#endif
+}
+
+/**
+ * @brief Most significant word multiply-accumulate (SMMLA):
+ * acc + ((x * y) >> 32), truncated.
+ */
+inline int32_t smmla(int32_t x, int32_t y, int32_t acc)
+{
+#if QL_HAS_DSP_INSTRUCTIONS
+    return __SMMLA(x, y, acc);
+#else
+    return static_cast<int32_t>(
+      static_cast<uint32_t>(acc) +
+      static_cast<uint32_t>((static_cast<int64_t>(x) * y) >> 32));
+#endif
+}
+
+/**
+ * @brief Saturate a 32-bit value to int16_t (SSAT #16).
+ */
+inline int32_t ssat16(int32_t x)
+{
+#if QL_HAS_DSP_INSTRUCTIONS
+    return __SSAT(x, 16);
+#else
+    return saturate16(x);
+#endif
+}
+
+/**
+ * @brief Low halfword of `lo` and low halfword of `hi` (PKHBT lsl #16).
+ */
+inline uint32_t pkhbt(uint32_t lo, uint32_t hi)
+{
+#if QL_HAS_DSP_INSTRUCTIONS
+    return __PKHBT(lo, hi, 16);
+#else
+    return pack(static_cast<int32_t>(lo), static_cast<int32_t>(hi));
+#endif
+}
+
+/**
+ * @brief High halfword of `hi` and high halfword of `lo` (PKHTB asr #16).
+ */
+inline uint32_t pkhtb(uint32_t hi, uint32_t lo)
+{
+#if QL_HAS_DSP_INSTRUCTIONS
+    return __PKHTB(hi, lo, 16);
+#else
+    return (hi & 0xFFFF0000u) | (lo >> 16);
+#endif
+}
+
+} // namespace dsp
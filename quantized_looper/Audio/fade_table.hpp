@@ -0,0 +1,182 @@
+/**
+ * @file fade_table.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Fade curves generated at compile time, and the fades built on them.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Quantized looper includes
+#include <quantized_looper/Audio/const_math.hpp>
+#include <quantized_looper/Audio/dsp_intrinsics.hpp>
+
+/**
+ * @brief Shape of a fade.
+ */
+enum class fade_curve : uint8_t
+{
+    linear,     //!< Gains of the two sides sum to one
+    equal_power //!< Squared gains sum to one; no dip for uncorrelated audio
+};
+
+namespace detail {
+
+/**
+ * @brief Fade-in gain for step i of a fade of the given length.
+ *
+ * Steps sit at (i + 1) / (length + 1), so neither end reaches 0 or 1 and the
+ * fade-out, read backwards from the same table, is the exact complement.
+ */
+constexpr double fade_gain(fade_curve curve,
+                           std::size_t i,
+                           std::size_t length)
+{
+    double t = static_cast<double>(i + 1) / static_cast<double>(length + 1);
+    if (curve == fade_curve::linear) {
+        return t;
+    }
+    return const_math::sin(t * const_math::pi / 2);
+}
+
+} // namespace detail
+
+/**
+ * @brief Table entry type: Q15 for integer samples, the sample type otherwise.
+ */
+template<typename Sample>
+using fade_gain_type =
+  std::conditional_t<std::is_floating_point_v<Sample>, Sample, int16_t>;
+
+template<typename Sample, fade_curve Curve, std::size_t Length>
+constexpr std::array<fade_gain_type<Sample>, Length> make_fade_table()
+{
+    std::array<fade_gain_type<Sample>, Length> table{};
+    for (std::size_t i = 0; i < Length; ++i) {
+        double gain = detail::fade_gain(Curve, i, Length);
+        if constexpr (std::is_floating_point_v<Sample>) {
+            table[i] = static_cast<Sample>(gain);
+        } else {
+            table[i] = static_cast<int16_t>(gain * 32767.0 + 0.5);
+        }
+    }
+    return table;
+}
+
+/**
+ * @brief Fade-in gains, built by the compiler and placed in flash.
+ *
+ * The matching fade-out is the same table read from the end.
+ */
+template<typename Sample, fade_curve Curve, std::size_t Length>
+inline constexpr auto fade_table = make_fade_table<Sample, Curve, Length>();
+
+/**
+ * @brief Applies fades of a fixed length from one of the compile-time tables.
+ *
+ * A fade is addressed by its step, so a caller can spread one fade over any
+ * number of blocks by passing the step it has reached. The curve can be
+ * switched at run time; both tables are always in flash.
+ *
+ * @tparam Sample Sample type, int16_t or floating point.
+ * @tparam Length Fade length in samples.
+ */
+template<typename Sample, std::size_t Length>
+class fade_ramp
+{
+    static_assert(std::is_floating_point_v<Sample> ||
+                    std::is_same_v<Sample, int16_t>,
+                  "fade_ramp works on int16_t or floating point samples");
+
+public:
+    static constexpr std::size_t length = Length;
+
+    /**
+     * @brief Feedback level, in the same units as loop_engine's: Q15 in an
+     * int32_t for integer samples so unity is 32768.
+     */
+    using level_type =
+      std::conditional_t<std::is_floating_point_v<Sample>, Sample, int32_t>;
+
+    explicit constexpr fade_ramp(fade_curve curve = fade_curve::equal_power)
+    {
+        set_curve(curve);
+    }
+
+    constexpr void set_curve(fade_curve curve)
+    {
+        gains = curve == fade_curve::linear
+                  ? fade_table<Sample, fade_curve::linear, Length>.data()
+                  : fade_table<Sample, fade_curve::equal_power, Length>.data();
+    }
+
+    fade_gain_type<Sample> in(std::size_t step) const { return gains[step]; }
+
+    fade_gain_type<Sample> out(std::size_t step) const
+    {
+        return gains[Length - 1 - step];
+    }
+
+    /**
+     * @brief Crossfade in place from `from` into `dst`:
+     * dst[i] = from[i] * out(step + i) + dst[i] * in(step + i)
+     */
+    void crossfade(Sample* dst,
+                   const Sample* from,
+                   std::size_t step,
+                   std::size_t n) const
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            if constexpr (std::is_floating_point_v<Sample>) {
+                dst[i] = from[i] * out(step + i) + dst[i] * in(step + i);
+            } else {
+                int32_t sum = from[i] * out(step + i) + dst[i] * in(step + i);
+                dst[i] = static_cast<Sample>(dsp::saturate16(sum >> 15));
+            }
+        }
+    }
+
+    /**
+     * @brief Overdub with the input faded in or out, one table lookup and
+     * multiply per sample:
+     * loop[i] = loop[i] * g + in[i] * w, w = in(step + i) or out(step + i)
+     *
+     * With unity feedback g is one. Otherwise the loop gain g follows the
+     * input, from one down to `feedback` while fading in and back up while
+     * fading out, so the old loop does not step in level either.
+     *
+     * @param rising true to fade the input in, false to fade it out
+     */
+    void overdub(Sample* loop,
+                 const Sample* in,
+                 level_type feedback,
+                 std::size_t step,
+                 std::size_t n,
+                 bool rising) const
+    {
+        const level_type unity = std::is_floating_point_v<Sample> ? 1 : 32768;
+        const level_type loss = unity - feedback;
+        for (std::size_t i = 0; i < n; ++i) {
+            auto w = rising ? this->in(step + i) : out(step + i);
+            if constexpr (std::is_floating_point_v<Sample>) {
+                loop[i] = loop[i] * (1 - loss * w) + in[i] * w;
+            } else if (loss == 0) {
+                int32_t faded = (in[i] * w) >> 15;
+                loop[i] = static_cast<Sample>(dsp::saturate16(loop[i] + faded));
+            } else {
+                int32_t gain = 32768 - ((loss * w) >> 15);
+                int32_t sum = ((loop[i] * gain) >> 15) + ((in[i] * w) >> 15);
+                loop[i] = static_cast<Sample>(dsp::saturate16(sum));
+            }
+        }
+    }
+
+private:
+    const fade_gain_type<Sample>* gains = nullptr;
+};
@@ -0,0 +1,470 @@
+/**
+ * @file loop_engine.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Loop buffer with record/overdub/play commands quantized to the beat.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <variant>
+
+// Quantized looper includes
+#include <quantized_looper/Audio/fade_table.hpp>
+#include <quantized_looper/Audio/mix_kernels.hpp>
+#include <quantized_looper/Audio/transport.hpp>
+
+/**
+ * @brief What the loop is doing with incoming audio.
+ */
+enum class loop_state : uint8_t
+{
+    idle,       //!< Nothing recorded or playback stopped; output is silent
+    recording,  //!< Writing the first pass; the loop length grows
+    playing,    //!< Looping the recorded material
+    overdubbing //!< Looping and summing the input into the loop
+};
+
+/**
+ * @brief Commands that can be armed to run on the next boundary.
+ */
+enum class loop_command : uint8_t
+{
+    none,
+    record,  //!< Start a fresh recording, discarding the old loop
+    overdub, //!< Start summing input into the loop, closing a recording
+    play,    //!< Close a recording or end an overdub and keep looping
+    stop,    //!< Stop playback; the loop is kept and restarts on play
+    undo,    //!< Take back the last overdub (track_bank with undo pages)
+    redo     //!< Put back the last undone overdub (as undo)
+};
+
+/**
+ * @brief Saturating sum used for overdubbing.
+ *
+ * Integer samples clip at the limits of the type, floating point samples are
+ * summed as is.
+ */
+template<typename Sample>
+constexpr Sample mix_saturate(Sample a, Sample b)
+{
+    if constexpr (std::is_floating_point_v<Sample>) {
+        return a + b;
+    } else {
+        static_assert(sizeof(Sample) < sizeof(int32_t),
+                      "mix_saturate only widens up to 16-bit samples");
+        int32_t sum = static_cast<int32_t>(a) + static_cast<int32_t>(b);
+        sum = std::clamp<int32_t>(sum,
+                                  std::numeric_limits<Sample>::min(),
+                                  std::numeric_limits<Sample>::max());
+        return static_cast<Sample>(sum);
+    }
+}
+
+/**
+ * @brief Gain or feedback level for a sample type.
+ *
+ * Integer samples use Q15 in an int32_t, so unity (32768) is representable;
+ * floating point samples use the level as is.
+ */
+template<typename Sample>
+using level_type =
+  std::conditional_t<std::is_floating_point_v<Sample>, Sample, int32_t>;
+
+template<typename Sample>
+constexpr level_type<Sample> unity_level =
+  std::is_floating_point_v<Sample> ? 1 : 32768;
+
+/**
+ * @brief Convert a fraction in [0, 1] to a level, clamping out of range input.
+ */
+template<typename Sample>
+constexpr level_type<Sample> level_from_fraction(float fraction)
+{
+    fraction = std::clamp(fraction, 0.0f, 1.0f);
+    if constexpr (std::is_floating_point_v<Sample>) {
+        return fraction;
+    } else {
+        return static_cast<int32_t>(fraction * 32768.0f);
+    }
+}
+
+/**
+ * @brief loop = loop * feedback + in, saturating for integer samples.
+ */
+template<typename Sample>
+void overdub_feedback(Sample* loop,
+                      const Sample* in,
+                      level_type<Sample> feedback,
+                      std::size_t n)
+{
+    if constexpr (std::is_same_v<Sample, int16_t>) {
+        // Unity feedback is a plain sum; Q15 cannot hold 1.0 itself
+        if (feedback >= 32768) {
+            mix_q15(loop, in, n);
+        } else {
+            overdub_q15(loop, in, static_cast<int16_t>(feedback), n);
+        }
+    } else if constexpr (std::is_floating_point_v<Sample>) {
+        for (std::size_t i = 0; i < n; ++i) {
+            loop[i] = loop[i] * feedback + in[i];
+        }
+    } else {
+        for (std::size_t i = 0; i < n; ++i) {
+            loop[i] = mix_saturate(loop[i], in[i]);
+        }
+    }
+}
+
+/**
+ * @brief Single mono loop whose commands fire on the exact sample of the next
+ * beat or bar.
+ *
+ * The engine counts every sample it processes. Beats fall on multiples of
+ * samples_per_beat() from the start of that count. process() splits each block
+ * at the next event (an armed command's boundary, the loop wrap, or the end of
+ * the buffer) and runs a branch-free copy loop for each piece, so the only
+ * per-sample cost beyond the copy is the segment length bound.
+ *
+ * With a non-zero FadeFrames the engine hides its own discontinuities:
+ *  - Closing a recording crossfades the input that follows the loop into the
+ *    loop's first FadeFrames samples, so the wrap continues the performance
+ *    instead of jumping back to the start.
+ *  - Punching in fades the input in, and punching out (overdub to play) keeps
+ *    writing for FadeFrames samples while the input fades out.
+ * Fades are spread over as many blocks as they need and count as events, so
+ * the rest of the loop still runs the plain kernels.
+ *
+ * @tparam Sample Sample type, e.g. int16_t or float.
+ * @tparam MaxFrames Capacity of the loop buffer in samples.
+ * @tparam FadeFrames Length of loop and punch fades in samples; 0 disables
+ * them. Needs int16_t or floating point samples when non-zero.
+ */
+template<typename Sample, std::size_t MaxFrames, std::size_t FadeFrames = 0>
+class loop_engine
+{
+public:
+    /**
+     * @brief Construct a new loop engine
+     *
+     * @param sample_rate Audio sample rate in Hz
+     * @param beats_per_bar Beats per bar for bar quantization
+     */
+    explicit loop_engine(uint32_t sample_rate, uint32_t beats_per_bar = 4)
+      : sample_rate(sample_rate)
+      , beats_per_bar(beats_per_bar)
+    {
+        set_tempo_ms(1000);
+    }
+
+    /**
+     * @brief Set the beat length from a tap tempo period.
+     *
+     * @param cycle_time_ms Time between beats in milliseconds
+     */
+    void set_tempo_ms(uint32_t cycle_time_ms)
+    {
+        set_samples_per_beat(static_cast<uint32_t>(
+          static_cast<uint64_t>(cycle_time_ms) * sample_rate / 1000));
+    }
+
+    /**
+     * @brief Set the beat length directly.
+     *
+     * @param samples Samples per beat; clamped to at least one
+     */
+    void set_samples_per_beat(uint32_t samples)
+    {
+        beat_samples = std::max<uint32_t>(samples, 1);
+    }
+
+    /**
+     * @brief Set how much of the old loop survives each overdub pass.
+     *
+     * @param fraction 1.0 keeps the loop intact, 0.0 replaces it
+     */
+    void set_feedback(float fraction)
+    {
+        feedback = level_from_fraction<Sample>(fraction);
+    }
+
+    void set_beats_per_bar(uint32_t beats)
+    {
+        beats_per_bar = std::max<uint32_t>(beats, 1);
+    }
+
+    /**
+     * @brief Choose the curve for loop and punch fades.
+     */
+    void set_fade_curve(fade_curve curve)
+    {
+        if constexpr (FadeFrames > 0) {
+            fades.set_curve(curve);
+        }
+    }
+
+    /**
+     * @brief Arm a command to run on the next boundary of the given grid.
+     *
+     * A boundary that falls on the very next sample counts, so a command armed
+     * exactly on a beat runs on that beat. Arming again replaces the pending
+     * command.
+     *
+     * @param command Command to run
+     * @param grid Grid to snap to
+     */
+    void arm(loop_command command, quantize grid)
+    {
+        pending = command;
+        pending_at = next_boundary(grid);
+    }
+
+    /**
+     * @brief Process one block of audio.
+     *
+     * @param in Input samples
+     * @param out Output samples; receives the loop playback
+     * @param n Number of samples in both buffers
+     */
+    void process(const Sample* in, Sample* out, std::size_t n)
+    {
+        for (;;) {
+            // Checked once more after the last piece, so a command due on the
+            // sample after this block is already reflected in state()
+            if (pending != loop_command::none && clock == pending_at) {
+                execute(pending);
+                pending = loop_command::none;
+            }
+            if (n == 0) {
+                break;
+            }
+
+            std::size_t run = std::min<std::size_t>(n, samples_to_event());
+            switch (current) {
+                case loop_state::idle:
+                    std::fill_n(out, run, Sample{});
+                    break;
+                case loop_state::recording:
+                    std::copy_n(in, run, &buffer[play_index]);
+                    std::fill_n(out, run, Sample{});
+                    loop_length = play_index + run;
+                    break;
+                case loop_state::playing:
+                    std::copy_n(&buffer[play_index], run, out);
+                    write_fades(in, run);
+                    break;
+                case loop_state::overdubbing:
+                    std::copy_n(&buffer[play_index], run, out);
+                    if (write_fades(in, run) == false) {
+                        overdub_feedback(
+                          &buffer[play_index], in, feedback, run);
+                    }
+                    break;
+            }
+
+            advance(run);
+            in += run;
+            out += run;
+            n -= run;
+        }
+    }
+
+    loop_state state() const { return current; }
+
+    loop_command armed() const { return pending; }
+
+    /**
+     * @brief Sample index at which the armed command will run.
+     */
+    uint64_t armed_at() const { return pending_at; }
+
+    std::size_t length() const { return loop_length; }
+
+    std::size_t position() const { return play_index; }
+
+    uint64_t sample_clock() const { return clock; }
+
+    uint32_t samples_per_beat() const { return beat_samples; }
+
+    const Sample* data() const { return buffer.data(); }
+
+    static constexpr std::size_t capacity() { return MaxFrames; }
+
+private:
+    uint64_t next_boundary(quantize grid) const
+    {
+        uint64_t step = 1;
+        if (grid == quantize::beat) {
+            step = beat_samples;
+        } else if (grid == quantize::bar) {
+            step = static_cast<uint64_t>(beat_samples) * beats_per_bar;
+        }
+        return (clock + step - 1) / step * step;
+    }
+
+    /**
+     * @brief Write the fades that are in progress into the loop.
+     *
+     * @return true if the input was written as part of a punch fade
+     */
+    bool write_fades(const Sample* in, std::size_t n)
+    {
+        if constexpr (FadeFrames > 0) {
+            Sample* loop = &buffer[play_index];
+            if (seam_step < FadeFrames) {
+                fades.crossfade(loop, in, seam_step, n);
+            }
+            if (punch_step < FadeFrames) {
+                fades.overdub(loop, in, feedback, punch_step, n, punch_rising);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Samples until the state has to be re-evaluated.
+     */
+    std::size_t samples_to_event() const
+    {
+        std::size_t limit = std::numeric_limits<std::size_t>::max();
+        if (pending != loop_command::none) {
+            limit = static_cast<std::size_t>(pending_at - clock);
+        }
+        if (current == loop_state::recording) {
+            limit = std::min(limit, MaxFrames - play_index);
+        } else if (current != loop_state::idle) {
+            limit = std::min(limit, loop_length - play_index);
+            if (seam_step < FadeFrames) {
+                limit = std::min(limit, FadeFrames - seam_step);
+            }
+            if (punch_step < FadeFrames) {
+                limit = std::min(limit, FadeFrames - punch_step);
+            }
+        }
+        return limit;
+    }
+
+    void advance(std::size_t run)
+    {
+        clock += run;
+        if (current == loop_state::idle) {
+            return;
+        }
+        play_index += run;
+        if (current == loop_state::recording) {
+            // A full buffer closes the loop rather than dropping audio
+            if (play_index == MaxFrames) {
+                close_recording();
+                current = loop_state::playing;
+            }
+            return;
+        }
+        if (play_index == loop_length) {
+            play_index = 0;
+        }
+        if (seam_step < FadeFrames) {
+            seam_step += run;
+        }
+        if (punch_step < FadeFrames) {
+            punch_step += run;
+        }
+    }
+
+    void execute(loop_command command)
+    {
+        switch (command) {
+            case loop_command::none:
+                break;
+            case loop_command::record:
+                current = loop_state::recording;
+                play_index = 0;
+                loop_length = 0;
+                seam_step = FadeFrames;
+                punch_step = FadeFrames;
+                break;
+            case loop_command::overdub:
+                // Overdubbing straight out of a recording closes the loop.
+                // One closed before its first sample has nothing to
+                // overdub onto, and stops like play would leave it
+                if (current == loop_state::recording) {
+                    close_recording();
+                    if (loop_length == 0) {
+                        current = loop_state::idle;
+                        break;
+                    }
+                }
+                if (loop_length > 0 && current != loop_state::overdubbing) {
+                    current = loop_state::overdubbing;
+                    start_punch(true);
+                }
+                break;
+            case loop_command::play:
+                if (current == loop_state::recording) {
+                    close_recording();
+                } else if (current == loop_state::overdubbing) {
+                    start_punch(false);
+                }
+                current =
+                  loop_length > 0 ? loop_state::playing : loop_state::idle;
+                break;
+            case loop_command::stop:
+                current = loop_state::idle;
+                play_index = 0;
+                seam_step = FadeFrames;
+                punch_step = FadeFrames;
+                break;
+            case loop_command::undo:
+            case loop_command::redo:
+                // A single engine keeps no overdub history
+                break;
+        }
+    }
+
+    void close_recording()
+    {
+        play_index = 0;
+        // A loop shorter than the fade would wrap in the middle of it
+        if (loop_length >= FadeFrames) {
+            seam_step = 0;
+        }
+    }
+
+    void start_punch(bool rising)
+    {
+        if (loop_length >= FadeFrames) {
+            punch_step = 0;
+            punch_rising = rising;
+        }
+    }
+
+    uint32_t sample_rate;
+    uint32_t beats_per_bar;
+    uint32_t beat_samples = 1;
+    level_type<Sample> feedback = unity_level<Sample>;
+
+    loop_state current = loop_state::idle;
+    loop_command pending = loop_command::none;
+    uint64_t pending_at = 0;
+
+    uint64_t clock = 0;
+    std::size_t play_index = 0;
+    std::size_t loop_length = 0;
+
+    // Steps into the loop wrap and punch fades; FadeFrames when not fading
+    std::size_t seam_step = FadeFrames;
+    std::size_t punch_step = FadeFrames;
+    bool punch_rising = false;
+    [[no_unique_address]] std::conditional_t<(FadeFrames > 0),
+                                             fade_ramp<Sample, FadeFrames>,
+                                             std::monostate> fades;
+
+    std::array<Sample, MaxFrames> buffer{};
+};
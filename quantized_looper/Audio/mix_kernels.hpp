@@ -0,0 +1,184 @@
+/**
+ * @file mix_kernels.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Saturating mix and overdub kernels for q15 and q31 audio.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <cstddef>
+#include <cstdint>
+
+// Quantized looper includes
+#include <quantized_looper/Audio/dsp_intrinsics.hpp>
+
+/*
+ * Each kernel comes in two versions with identical results:
+ *
+ *  - The plain name is the fast path. q15 kernels work on two samples per
+ *    32-bit word with the packed-SIMD instructions; q31 kernels use the
+ *    saturating and most-significant-word multiply instructions.
+ *  - The `_scalar` name is the reference: one sample at a time in portable
+ *    C++, written straight from the definition of the operation.
+ *
+ * Gains and feedback are Q15 (q15 kernels) or Q31 (q31 kernels). Feedback must
+ * not be negative, and q15 mixing gains must stay within +/-32767, which keeps
+ * every intermediate product and sum inside 32 bits.
+ */
+
+/**
+ * @brief dst[i] = sat(dst[i] + src[i])
+ */
+inline void mix_q15_scalar(int16_t* dst, const int16_t* src, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        dst[i] = static_cast<int16_t>(dsp::saturate16(dst[i] + src[i]));
+    }
+}
+
+inline void mix_q15(int16_t* dst, const int16_t* src, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        dsp::store2(dst + i, dsp::qadd16(dsp::load2(dst + i), dsp::load2(src + i)));
+        dsp::store2(dst + i + 2,
+                    dsp::qadd16(dsp::load2(dst + i + 2), dsp::load2(src + i + 2)));
+    }
+    mix_q15_scalar(dst + i, src + i, n - i);
+}
+
+/**
+ * @brief loop[i] = sat(((loop[i] * feedback) >> 15) + in[i])
+ *
+ * @param loop Loop buffer, updated in place
+ * @param in Incoming audio
+ * @param feedback Q15 feedback in [0, 32767]
+ * @param n Number of samples
+ */
+inline void overdub_q15_scalar(int16_t* loop,
+                               const int16_t* in,
+                               int16_t feedback,
+                               std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        int32_t faded = (loop[i] * feedback) >> 15;
+        loop[i] = static_cast<int16_t>(dsp::saturate16(faded + in[i]));
+    }
+}
+
+inline void overdub_q15(int16_t* loop,
+                        const int16_t* in,
+                        int16_t feedback,
+                        std::size_t n)
+{
+    // Feedback in lane 0 only: SMUAD picks out loop lane 0, SMUADX lane 1
+    const uint32_t gain = dsp::pack(feedback, 0);
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        uint32_t x = dsp::load2(loop + i);
+        int32_t faded0 = dsp::smuad(x, gain) >> 15;
+        int32_t faded1 = dsp::smuadx(x, gain) >> 15;
+        uint32_t faded = dsp::pkhbt(faded0, faded1);
+        dsp::store2(loop + i, dsp::qadd16(faded, dsp::load2(in + i)));
+    }
+    overdub_q15_scalar(loop + i, in + i, feedback, n - i);
+}
+
+/**
+ * @brief dst[i] = sat((a[i] * gain_a + b[i] * gain_b) >> 15)
+ *
+ * Used for crossfades and for mixing two sources at independent levels.
+ *
+ * @param gain_a Q15 gain for `a` in [-32767, 32767]
+ * @param gain_b Q15 gain for `b` in [-32767, 32767]
+ */
+inline void mix2_q15_scalar(int16_t* dst,
+                            const int16_t* a,
+                            int16_t gain_a,
+                            const int16_t* b,
+                            int16_t gain_b,
+                            std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        int32_t sum = a[i] * gain_a + b[i] * gain_b;
+        dst[i] = static_cast<int16_t>(dsp::saturate16(sum >> 15));
+    }
+}
+
+inline void mix2_q15(int16_t* dst,
+                     const int16_t* a,
+                     int16_t gain_a,
+                     const int16_t* b,
+                     int16_t gain_b,
+                     std::size_t n)
+{
+    const uint32_t gains = dsp::pack(gain_a, gain_b);
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        uint32_t xa = dsp::load2(a + i);
+        uint32_t xb = dsp::load2(b + i);
+        // Regroup as (a0, b0) and (a1, b1) so one SMLAD does each sample
+        int32_t y0 = dsp::smlad(dsp::pkhbt(xa, xb), gains, 0) >> 15;
+        int32_t y1 = dsp::smlad(dsp::pkhtb(xb, xa), gains, 0) >> 15;
+        dsp::store2(dst + i, dsp::pkhbt(dsp::ssat16(y0), dsp::ssat16(y1)));
+    }
+    mix2_q15_scalar(dst + i, a + i, gain_a, b + i, gain_b, n - i);
+}
+
+/**
+ * @brief dst[i] = sat(dst[i] + src[i])
+ */
+inline void mix_q31_scalar(int32_t* dst, const int32_t* src, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        dst[i] = dsp::saturate32(static_cast<int64_t>(dst[i]) + src[i]);
+    }
+}
+
+inline void mix_q31(int32_t* dst, const int32_t* src, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        dst[i] = dsp::qadd(dst[i], src[i]);
+        dst[i + 1] = dsp::qadd(dst[i + 1], src[i + 1]);
+        dst[i + 2] = dsp::qadd(dst[i + 2], src[i + 2]);
+        dst[i + 3] = dsp::qadd(dst[i + 3], src[i + 3]);
+    }
+    mix_q31_scalar(dst + i, src + i, n - i);
+}
+
+/**
+ * @brief loop[i] = sat((((loop[i] * feedback) >> 32) << 1) + in[i])
+ *
+ * The product keeps the top word only, which is what SMMLA gives, so the
+ * lowest bit of the faded loop is always zero.
+ *
+ * @param feedback Q31 feedback in [0, INT32_MAX]
+ */
+inline void overdub_q31_scalar(int32_t* loop,
+                               const int32_t* in,
+                               int32_t feedback,
+                               std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        int64_t faded = ((static_cast<int64_t>(loop[i]) * feedback) >> 32) * 2;
+        loop[i] = dsp::saturate32(faded + in[i]);
+    }
+}
+
+inline void overdub_q31(int32_t* loop,
+                        const int32_t* in,
+                        int32_t feedback,
+                        std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        int32_t faded0 = dsp::smmla(loop[i], feedback, 0);
+        int32_t faded1 = dsp::smmla(loop[i + 1], feedback, 0);
+        loop[i] = dsp::qadd(faded0 * 2, in[i]);
+        loop[i + 1] = dsp::qadd(faded1 * 2, in[i + 1]);
+    }
+    overdub_q31_scalar(loop + i, in + i, feedback, n - i);
+}
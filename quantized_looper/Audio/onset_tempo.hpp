@@ -0,0 +1,350 @@
+/**
+ * @file onset_tempo.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Tempo of recorded audio from spectral-flux onsets and their
+ * autocorrelation, computed as the audio comes in.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Quantized looper includes
+#include <quantized_looper/Audio/real_fft.hpp>
+#include <quantized_looper/Audio/time_stretch.hpp>
+
+/**
+ * @brief Cross-correlation with arm_correlate_f32's output layout: for
+ * `a` at least as long as `b`, dst[na - 1 + l] is the sum over j of
+ * a[j] * b[j - l], for l from -(nb - 1) to na - 1. The first na - nb
+ * entries are not written.
+ *
+ * On the target this is arm_correlate_f32 from CMSIS-DSP; elsewhere a
+ * direct model of it. The layout is that of arm_correlate_f32.c for
+ * srcALen >= srcBLen: it skips the first srcALen - srcBLen outputs
+ * (`pOut += j`), writes a[0] * b[srcBLen - 1] next and goes on in
+ * increasing lag to a[srcALen - 1] * b[0] in the last of its
+ * 2 * srcALen - 1 outputs.
+ */
+inline void correlate_f32(const float* a,
+                          std::size_t na,
+                          const float* b,
+                          std::size_t nb,
+                          float* dst)
+{
+#if QL_HAS_CMSIS_DSP
+    arm_correlate_f32(const_cast<float*>(a),
+                      static_cast<uint32_t>(na),
+                      const_cast<float*>(b),
+                      static_cast<uint32_t>(nb),
+                      dst);
+#else
+    const auto m = static_cast<std::ptrdiff_t>(na);
+    const auto n = static_cast<std::ptrdiff_t>(nb);
+    for (std::ptrdiff_t l = -(n - 1); l < m; ++l) {
+        float sum = 0.0f;
+        for (std::ptrdiff_t j = std::max<std::ptrdiff_t>(l, 0);
+             j < std::min(m, n + l);
+             ++j) {
+            sum += a[j] * b[j - l];
+        }
+        dst[m - 1 + l] = sum;
+    }
+#endif
+}
+
+/**
+ * @brief Estimates the tempo of audio as it is recorded, for a first loop
+ * recorded without tapping.
+ *
+ * Every hop of Frame / 2 samples it takes a Hann-windowed frame through
+ * real_fft and sums how much each bin's compressed magnitude rose since the
+ * last frame. That spectral flux peaks on drum hits and note onsets. Less
+ * its recent average, rectified, it makes an onset envelope at one value
+ * per hop, whose autocorrelation peaks at the beat period and its
+ * multiples.
+ *
+ * The autocorrelation is kept up to date as the envelope grows, so nothing
+ * is left to compute when the loop closes: every Chunk values, the new
+ * chunk is correlated with itself and the MaxLag values before it by
+ * correlate_f32 (arm_correlate_f32 on the target), and the lags of
+ * interest are added to running sums. That costs O(Chunk + MaxLag) per
+ * value whatever the loop length, where correlating the whole envelope at
+ * the close would cost O(length * MaxLag) at once.
+ *
+ * samples_per_beat() picks the lag with the best autocorrelation,
+ * weighted towards 120 BPM to settle between a tempo and its double or
+ * half. Given the loop length, it only considers periods that fit a whole
+ * number of beats into the loop, which a loop recorded in time does.
+ *
+ * @tparam Frame Analysis frame, a power of two supported by real_fft
+ * @tparam MaxLag Longest beat period in hops, plus two: the lag above
+ * the longest is read to find its peak
+ * @tparam Chunk Envelope values correlated at a time
+ */
+template<std::size_t Frame = 512,
+         std::size_t MaxLag = 192,
+         std::size_t Chunk = 32>
+class onset_tempo
+{
+public:
+    static constexpr std::size_t frame = Frame;
+    static constexpr std::size_t hop = Frame / 2;
+
+    /**
+     * @brief Construct a new detector
+     *
+     * @param sample_rate Audio sample rate in Hz
+     * @param min_bpm Slowest tempo to report
+     * @param max_bpm Fastest tempo to report
+     */
+    explicit onset_tempo(uint32_t sample_rate,
+                         uint32_t min_bpm = 60,
+                         uint32_t max_bpm = 200)
+      : rate(sample_rate)
+      , min_lag(std::max<std::size_t>(
+          static_cast<std::size_t>(60.0 * sample_rate / (max_bpm * hop)), 2))
+      , max_lag(std::min<std::size_t>(
+          static_cast<std::size_t>(
+            std::ceil(60.0 * sample_rate / (min_bpm * hop))),
+          MaxLag - 2))
+    {
+        reset();
+    }
+
+    /**
+     * @brief Forget everything heard, to listen to a new recording.
+     */
+    void reset()
+    {
+        input.fill(0.0f);
+        previous.fill(0.0f);
+        envelope.fill(0.0f);
+        acf.fill(0.0f);
+        filled = 0;
+        held = 0;
+        values = 0;
+        mean = 0.0f;
+        first = true;
+    }
+
+    /**
+     * @brief Take the next samples of the recording.
+     *
+     * At most one frame is analysed and one chunk correlated per hop, so
+     * the work per call is bounded by the number of hops it completes.
+     */
+    template<typename Sample>
+    void feed(const Sample* x, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            float v = static_cast<float>(x[i]);
+            if constexpr (std::is_same_v<Sample, int16_t>) {
+                v *= 1.0f / 32768.0f;
+            }
+            input[filled++] = v;
+            if (filled == Frame) {
+                analyse();
+                std::copy(input.begin() + hop, input.end(), input.begin());
+                filled = Frame - hop;
+            }
+        }
+    }
+
+    /**
+     * @brief Best beat period heard so far.
+     *
+     * @return Samples per beat, 0 before a beat's worth of onsets
+     */
+    uint32_t samples_per_beat()
+    {
+        flush();
+        float best_score = 0.0f;
+        float best = 0.0f;
+        for (std::size_t lag = min_lag; lag <= max_lag; ++lag) {
+            if (acf[lag] < acf[lag - 1] || acf[lag] < acf[lag + 1]) {
+                continue;
+            }
+            float peak = interpolate_peak(lag);
+            float score = weighted(peak * hop);
+            if (score > best_score) {
+                best_score = score;
+                best = peak;
+            }
+        }
+        return static_cast<uint32_t>(std::lround(best * hop));
+    }
+
+    /**
+     * @brief Best beat period that divides a loop into whole beats.
+     *
+     * @param loop_length Loop length in samples
+     * @return Samples per beat, 0 before a beat's worth of onsets or if no
+     * whole number of beats fits the tempo range
+     */
+    uint32_t samples_per_beat(std::size_t loop_length)
+    {
+        flush();
+        float best_score = 0.0f;
+        uint32_t best = 0;
+        const double shortest = static_cast<double>(min_lag * hop);
+        const double longest = static_cast<double>(max_lag * hop);
+        for (std::size_t beats = 1;; ++beats) {
+            double period = static_cast<double>(loop_length) / beats;
+            if (period < shortest) {
+                break;
+            }
+            if (period > longest) {
+                continue;
+            }
+            float score = weighted(static_cast<float>(period));
+            if (score > best_score) {
+                best_score = score;
+                best = static_cast<uint32_t>(std::lround(period));
+            }
+        }
+        return best;
+    }
+
+    /**
+     * @brief Onset envelope values taken so far, one per hop.
+     */
+    std::size_t onsets() const { return values; }
+
+private:
+    static constexpr std::size_t bins = Frame / 2;
+    static constexpr std::size_t span = MaxLag + Chunk;
+
+    static constexpr std::array<float, Frame> window =
+      make_hann_window<Frame>();
+
+    /**
+     * @brief One hop: spectral flux of the newest frame into the envelope.
+     */
+    void analyse()
+    {
+        for (std::size_t i = 0; i < Frame; ++i) {
+            buffer[i] = input[i] * window[i];
+        }
+        fft.forward(buffer.data(), spectrum.data());
+
+        // Square root of magnitude: a cheap stand-in for log compression,
+        // so quiet hits count next to loud ones
+        float flux = 0.0f;
+        for (std::size_t k = 1; k < bins; ++k) {
+            float re = spectrum[2 * k];
+            float im = spectrum[2 * k + 1];
+            float level = std::sqrt(std::sqrt(re * re + im * im));
+            flux += std::max(level - previous[k], 0.0f);
+            previous[k] = level;
+        }
+        if (first) {
+            // No previous frame to rise from
+            first = false;
+            flux = 0.0f;
+        }
+        mean += (flux - mean) * (1.0f / 16.0f);
+        envelope[MaxLag + held++] = std::max(flux - mean, 0.0f);
+        ++values;
+        if (held == Chunk) {
+            correlate(held);
+        }
+    }
+
+    /**
+     * @brief Add the products of the held values with every value up to
+     * MaxLag before them to the running autocorrelation, then slide them
+     * into history.
+     */
+    void correlate(std::size_t n)
+    {
+        correlate_f32(envelope.data(),
+                      MaxLag + n,
+                      envelope.data() + MaxLag,
+                      n,
+                      products.data());
+        // products[n + 2 * MaxLag - 1 - k] holds the lag k sum
+        for (std::size_t k = 1; k < MaxLag; ++k) {
+            acf[k] += products[n + 2 * MaxLag - 1 - k];
+        }
+        std::copy(envelope.begin() + n,
+                  envelope.begin() + MaxLag + n,
+                  envelope.begin());
+        held = 0;
+    }
+
+    /**
+     * @brief Bring the autocorrelation up to the latest value.
+     */
+    void flush()
+    {
+        if (held > 0) {
+            correlate(held);
+        }
+    }
+
+    /**
+     * @brief Autocorrelation at a fractional lag, linearly interpolated.
+     */
+    float acf_at(float lag) const
+    {
+        auto k = static_cast<std::size_t>(lag);
+        if (k + 1 >= MaxLag) {
+            return 0.0f;
+        }
+        float f = lag - static_cast<float>(k);
+        return acf[k] + f * (acf[k + 1] - acf[k]);
+    }
+
+    /**
+     * @brief Lag of the top of the parabola through a local maximum.
+     */
+    float interpolate_peak(std::size_t lag) const
+    {
+        float a = acf[lag - 1];
+        float b = acf[lag];
+        float c = acf[lag + 1];
+        float curve = a - 2.0f * b + c;
+        float offset = curve < 0.0f ? 0.5f * (a - c) / curve : 0.0f;
+        return static_cast<float>(lag) + offset;
+    }
+
+    /**
+     * @brief Autocorrelation at a beat period, weighted by a log-normal
+     * prior around 120 BPM an octave wide.
+     */
+    float weighted(float period_samples) const
+    {
+        float bpm = 60.0f * static_cast<float>(rate) / period_samples;
+        float octaves = std::log2(bpm / 120.0f);
+        float prior = std::exp(-0.5f * octaves * octaves);
+        return std::max(acf_at(period_samples / hop), 0.0f) * prior;
+    }
+
+    uint32_t rate;
+    std::size_t min_lag;
+    std::size_t max_lag;
+
+    real_fft<Frame> fft;
+    std::array<float, Frame> input{};
+    std::array<float, Frame> buffer{};
+    std::array<float, Frame> spectrum{};
+    std::array<float, bins> previous{};
+    std::size_t filled = 0;
+    bool first = true;
+    float mean = 0.0f;
+
+    // MaxLag values of history, then the chunk being filled
+    std::array<float, span> envelope{};
+    std::array<float, 2 * span - 1> products{};
+    std::array<float, MaxLag> acf{};
+    std::size_t held = 0;
+    std::size_t values = 0;
+};
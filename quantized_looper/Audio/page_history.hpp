@@ -0,0 +1,361 @@
+/**
+ * @file page_history.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Undo and redo of overdub layers from copy-on-write loop pages.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Multi-level undo and redo for a set of loop buffers, keeping only
+ * the pages each layer changed.
+ *
+ * Every track buffer is divided into pages of PageFrames samples. While a
+ * layer is open on a track, the first write to each page copies the page
+ * into a shared pool before it changes, so the layer holds exactly the
+ * pages it touched. Undo swaps those pages back into the buffer, which
+ * leaves the layer's own version in the pool for redo, so either costs one
+ * swap per touched page and no extra memory.
+ *
+ * Layers are kept oldest first across all tracks. When the pool or the
+ * layer list is full the oldest layer is dropped to make room; a redo
+ * layer goes together with the redo layers after it on its track. A layer
+ * that could outgrow the whole pool is refused when it begins, and one that
+ * runs out of pages anyway is dropped on its own. Either way the track's
+ * earlier layers stay, and the writes that went unrecorded are only taken
+ * back where undoing an earlier layer swaps in pages from before them.
+ *
+ * All storage is fixed and nothing runs in a time proportional to the loop
+ * length except the page copies and swaps themselves.
+ *
+ * @tparam Sample Sample type.
+ * @tparam Tracks Number of track buffers.
+ * @tparam TrackFrames Capacity of each track buffer in samples.
+ * @tparam Pages Pages in the shared pool.
+ * @tparam PageFrames Samples per page.
+ * @tparam Layers Most layers kept across all tracks.
+ */
+template<typename Sample,
+         std::size_t Tracks,
+         std::size_t TrackFrames,
+         std::size_t Pages,
+         std::size_t PageFrames = 512,
+         std::size_t Layers = 16>
+class page_history
+{
+    static_assert(Pages > 0 && Pages < 0xFFFF, "Pages must fit a uint16_t");
+    static_assert(PageFrames > 0, "PageFrames must be positive");
+    static_assert(Layers > 0, "page_history needs at least one layer");
+    static_assert(Tracks <= 256, "Track numbers are stored as uint8_t");
+
+public:
+    static constexpr std::size_t page_frames = PageFrames;
+    static constexpr std::size_t track_pages =
+      (TrackFrames + PageFrames - 1) / PageFrames;
+
+    page_history()
+    {
+        for (std::size_t p = 0; p < Pages; ++p) {
+            next[p] = static_cast<page_index>(p + 1 < Pages ? p + 1 : none);
+        }
+        free_head = 0;
+        free_count = Pages;
+    }
+
+    /**
+     * @brief Open a new layer on a track, closing its previous one and
+     * dropping its redo layers.
+     *
+     * @param track Track index
+     * @param frames How far into the track the layer may write
+     * @return false if that many pages would not fit in the pool; no layer
+     * is opened and the track's history is left as it is
+     */
+    bool begin(std::size_t track, std::size_t frames = TrackFrames)
+    {
+        open[track] = false;
+        if ((frames + PageFrames - 1) / PageFrames > Pages) {
+            return false;
+        }
+        drop_redo(track);
+        if (count == Layers) {
+            drop(0);
+        }
+        layer_track[count] = static_cast<uint8_t>(track);
+        layer_head[count] = none;
+        layer_pages[count] = 0;
+        layer_undone[count] = false;
+        ++count;
+        saved[track].reset();
+        open[track] = true;
+        return true;
+    }
+
+    /**
+     * @brief Copy aside the pages of [first, first + n) not yet saved in the
+     * track's open layer. Call before writing to them.
+     *
+     * @param track Track index
+     * @param loop The track's buffer
+     * @param first First sample about to be written
+     * @param n Number of samples about to be written
+     */
+    void save(std::size_t track,
+              const Sample* loop,
+              std::size_t first,
+              std::size_t n)
+    {
+        if (!open[track] || n == 0) {
+            return;
+        }
+        std::size_t last = (first + n - 1) / PageFrames;
+        for (std::size_t page = first / PageFrames; page <= last; ++page) {
+            if (saved[track][page]) {
+                continue;
+            }
+            page_index p = allocate(track);
+            std::size_t layer = newest(track, false);
+            if (p == none) {
+                // Only the open layer is left and it is still short of
+                // pages, so it is given up, half recorded as it is
+                remove(layer);
+                open[track] = false;
+                return;
+            }
+            std::copy_n(
+              loop + page * PageFrames, frames_in(page), pool[p].data());
+            home[p] = static_cast<page_index>(page);
+            next[p] = layer_head[layer];
+            layer_head[layer] = p;
+            ++layer_pages[layer];
+            saved[track].set(page);
+        }
+    }
+
+    /**
+     * @brief The open layer's saved copy of a sample, or nullptr if its page
+     * has not been saved. Writes that belong under the layer rather than in
+     * it go to both.
+     */
+    Sample* saved_copy(std::size_t track, std::size_t index)
+    {
+        std::size_t page = index / PageFrames;
+        if (!open[track] || !saved[track][page]) {
+            return nullptr;
+        }
+        std::size_t layer = newest(track, false);
+        for (page_index p = layer_head[layer]; p != none; p = next[p]) {
+            if (home[p] == page) {
+                return &pool[p][index - page * PageFrames];
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Take back the track's newest layer.
+     *
+     * @return false if the track has nothing to undo
+     */
+    bool undo(std::size_t track, Sample* loop)
+    {
+        open[track] = false;
+        std::size_t layer = newest(track, false);
+        if (layer == count) {
+            return false;
+        }
+        swap_pages(layer, loop);
+        layer_undone[layer] = true;
+        return true;
+    }
+
+    /**
+     * @brief Put back the track's most recently undone layer.
+     *
+     * @return false if the track has nothing to redo
+     */
+    bool redo(std::size_t track, Sample* loop)
+    {
+        open[track] = false;
+        std::size_t layer = oldest_undone(track);
+        if (layer == count) {
+            return false;
+        }
+        swap_pages(layer, loop);
+        layer_undone[layer] = false;
+        return true;
+    }
+
+    /**
+     * @brief Forget every layer of a track, e.g. when it records anew.
+     */
+    void discard(std::size_t track)
+    {
+        open[track] = false;
+        for (std::size_t i = count; i-- > 0;) {
+            if (layer_track[i] == track) {
+                remove(i);
+            }
+        }
+    }
+
+    std::size_t undo_levels(std::size_t track) const
+    {
+        return levels(track, false);
+    }
+
+    std::size_t redo_levels(std::size_t track) const
+    {
+        return levels(track, true);
+    }
+
+    std::size_t free_pages() const { return free_count; }
+
+private:
+    using page_index = uint16_t;
+
+    static constexpr page_index none = 0xFFFF;
+
+    static constexpr std::size_t frames_in(std::size_t page)
+    {
+        return std::min(PageFrames, TrackFrames - page * PageFrames);
+    }
+
+    std::size_t levels(std::size_t track, bool undone) const
+    {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            n += layer_track[i] == track && layer_undone[i] == undone;
+        }
+        return n;
+    }
+
+    /**
+     * @brief Index of the track's newest layer in the given state, or count
+     */
+    std::size_t newest(std::size_t track, bool undone) const
+    {
+        for (std::size_t i = count; i-- > 0;) {
+            if (layer_track[i] == track && layer_undone[i] == undone) {
+                return i;
+            }
+        }
+        return count;
+    }
+
+    std::size_t oldest_undone(std::size_t track) const
+    {
+        for (std::size_t i = 0; i < count; ++i) {
+            if (layer_track[i] == track && layer_undone[i]) {
+                return i;
+            }
+        }
+        return count;
+    }
+
+    void swap_pages(std::size_t layer, Sample* loop)
+    {
+        for (page_index p = layer_head[layer]; p != none; p = next[p]) {
+            std::swap_ranges(pool[p].data(),
+                             pool[p].data() + frames_in(home[p]),
+                             loop + home[p] * PageFrames);
+        }
+    }
+
+    /**
+     * @brief Take a free page, dropping old layers other than the track's
+     * open one until there is one. None if the open layer already holds
+     * the whole pool, rather than dropping layers in vain.
+     */
+    page_index allocate(std::size_t track)
+    {
+        std::size_t keep = newest(track, false);
+        if (free_head == none && layer_pages[keep] == Pages) {
+            return none;
+        }
+        while (free_head == none) {
+            keep = newest(track, false);
+            std::size_t victim = keep == 0 ? 1 : 0;
+            if (victim >= count) {
+                return none;
+            }
+            drop(victim);
+        }
+        page_index p = free_head;
+        free_head = next[p];
+        --free_count;
+        return p;
+    }
+
+    /**
+     * @brief Drop a layer to make room, along with anything that depends on
+     * it.
+     */
+    void drop(std::size_t layer)
+    {
+        std::size_t track = layer_track[layer];
+        if (layer_undone[layer]) {
+            // Later redo layers only make sense on top of this one
+            drop_redo(track);
+        } else if (open[track] && newest(track, false) == layer) {
+            discard(track);
+        } else {
+            remove(layer);
+        }
+    }
+
+    void drop_redo(std::size_t track)
+    {
+        for (std::size_t i = count; i-- > 0;) {
+            if (layer_track[i] == track && layer_undone[i]) {
+                remove(i);
+            }
+        }
+    }
+
+    void remove(std::size_t layer)
+    {
+        for (page_index p = layer_head[layer]; p != none;) {
+            page_index following = next[p];
+            next[p] = free_head;
+            free_head = p;
+            ++free_count;
+            p = following;
+        }
+        for (std::size_t i = layer + 1; i < count; ++i) {
+            layer_track[i - 1] = layer_track[i];
+            layer_head[i - 1] = layer_head[i];
+            layer_pages[i - 1] = layer_pages[i];
+            layer_undone[i - 1] = layer_undone[i];
+        }
+        --count;
+    }
+
+    // Pool pages: the saved samples, the track page each one belongs to and
+    // the next page of the same layer, or of the free list
+    alignas(32) std::array<std::array<Sample, PageFrames>, Pages> pool{};
+    std::array<page_index, Pages> home{};
+    std::array<page_index, Pages> next{};
+    page_index free_head;
+    std::size_t free_count;
+
+    // Layers, oldest first
+    std::array<uint8_t, Layers> layer_track{};
+    std::array<page_index, Layers> layer_head{};
+    std::array<page_index, Layers> layer_pages{};
+    std::array<bool, Layers> layer_undone{};
+    std::size_t count = 0;
+
+    // Whether each track's newest layer is still taking pages, and which
+    // pages it has
+    std::array<bool, Tracks> open{};
+    std::array<std::bitset<track_pages>, Tracks> saved{};
+};
@@ -0,0 +1,241 @@
+/**
+ * @file polyphase_resampler.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Arbitrary-ratio polyphase resampler reading straight from a loop.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Quantized looper includes
+#include <quantized_looper/Audio/const_math.hpp>
+#include <quantized_looper/Audio/dsp_intrinsics.hpp>
+
+/**
+ * @brief Read position or step in input samples, 32.32 fixed point.
+ */
+using resample_pos = uint64_t;
+
+constexpr resample_pos resample_one = resample_pos{ 1 } << 32;
+
+/**
+ * @brief Step that plays material recorded at `from` samples per beat at
+ * `to` samples per beat.
+ */
+constexpr resample_pos resample_step(uint32_t from, uint32_t to)
+{
+    return (static_cast<resample_pos>(from) << 32) / to;
+}
+
+namespace detail {
+
+/**
+ * @brief Windowed-sinc prototype tap k of phase p.
+ *
+ * The prototype runs at Phases times the input rate with its cutoff at
+ * `cutoff` times the input Nyquist frequency, under a Blackman window.
+ */
+constexpr double polyphase_tap(std::size_t phases,
+                               std::size_t taps,
+                               double cutoff,
+                               std::size_t p,
+                               std::size_t k)
+{
+    // Distance from the output point in input samples. Tap k sits at input
+    // sample (k - taps / 2 + 1) relative to the integer part of the position
+    double x = static_cast<double>(k) - static_cast<double>(taps / 2 - 1) -
+               static_cast<double>(p) / static_cast<double>(phases);
+    double half = static_cast<double>(taps) / 2;
+    if (x <= -half || x >= half) {
+        return 0.0;
+    }
+    double w = 0.42 + 0.5 * const_math::cos(const_math::pi * x / half) +
+               0.08 * const_math::cos(2 * const_math::pi * x / half);
+    return cutoff * const_math::sinc(cutoff * x) * w;
+}
+
+} // namespace detail
+
+/**
+ * @brief Coefficients for every phase, each phase normalized to unity DC gain.
+ */
+template<typename Coeff, std::size_t Phases, std::size_t Taps>
+constexpr std::array<std::array<Coeff, Taps>, Phases> make_polyphase_table(
+  double cutoff)
+{
+    std::array<std::array<Coeff, Taps>, Phases> table{};
+    for (std::size_t p = 0; p < Phases; ++p) {
+        double sum = 0;
+        for (std::size_t k = 0; k < Taps; ++k) {
+            sum += detail::polyphase_tap(Phases, Taps, cutoff, p, k);
+        }
+        for (std::size_t k = 0; k < Taps; ++k) {
+            double h = detail::polyphase_tap(Phases, Taps, cutoff, p, k) / sum;
+            if constexpr (std::is_floating_point_v<Coeff>) {
+                table[p][k] = static_cast<Coeff>(h);
+            } else {
+                double q = h * 32768.0;
+                q = q < 0 ? q - 0.5 : q + 0.5;
+                table[p][k] = static_cast<Coeff>(
+                  q > 32767.0 ? 32767.0 : (q < -32768.0 ? -32768.0 : q));
+            }
+        }
+    }
+    return table;
+}
+
+/**
+ * @brief Resamples a loop at any ratio while it plays.
+ *
+ * Each output sample picks the phase nearest its fractional read position
+ * and runs one short FIR over the loop around that position, so the cost
+ * per output sample is Taps multiply-accumulates (Taps / 2 SMLADs for
+ * int16_t) whatever the ratio. The filter reads the loop buffer directly,
+ * wrapping at its end, so there is no per-track filter state.
+ *
+ * The coefficients are built at compile time and live in flash. There is a
+ * table per cutoff band: reading faster than the loop was recorded lowers
+ * the cutoff to keep the content that would fold over out of the output.
+ *
+ * CMSIS-DSP is linked, but its arm_fir_interpolate_q15 and
+ * arm_fir_decimate_q15 only resample by integer factors, each with its own
+ * filter and state buffer. A tap-tempo ratio such as 24/25 would need a 24x
+ * interpolator feeding a 25x decimator per track, so they are not used here.
+ *
+ * @tparam Sample Sample type, int16_t or floating point.
+ * @tparam Phases Phases per input sample, a power of two.
+ * @tparam Taps Taps per phase, even.
+ */
+template<typename Sample, std::size_t Phases = 64, std::size_t Taps = 16>
+class polyphase_resampler
+{
+    static_assert(std::is_floating_point_v<Sample> ||
+                    std::is_same_v<Sample, int16_t>,
+                  "polyphase_resampler works on int16_t or floating point");
+    static_assert((Phases & (Phases - 1)) == 0, "Phases must be a power of 2");
+    static_assert(Taps % 2 == 0 && Taps >= 2, "Taps must be even");
+
+public:
+    using coeff_type =
+      std::conditional_t<std::is_floating_point_v<Sample>, Sample, int16_t>;
+    using table_type = std::array<std::array<coeff_type, Taps>, Phases>;
+
+    static constexpr std::size_t phases = Phases;
+    static constexpr std::size_t taps = Taps;
+
+    /**
+     * @brief Generate n output samples.
+     *
+     * @param loop Loop buffer
+     * @param length Loop length in samples; reads wrap at this point. An
+     * empty loop plays silence
+     * @param pos Read position of the first output, below length
+     * @param step Read position increment per output sample
+     * @param out Output samples
+     * @param n Number of output samples
+     * @return Read position after the last output, wrapped into the loop
+     */
+    static resample_pos process(const Sample* loop,
+                                std::size_t length,
+                                resample_pos pos,
+                                resample_pos step,
+                                Sample* out,
+                                std::size_t n)
+    {
+        if (length == 0) {
+            std::fill_n(out, n, Sample{});
+            return 0;
+        }
+        const table_type& table = table_for(step);
+        const resample_pos end = static_cast<resample_pos>(length) << 32;
+        for (std::size_t i = 0; i < n; ++i) {
+            // Round to the nearest phase; rounding up past the last phase
+            // lands on phase 0 of the next sample
+            const resample_pos at = pos + phase_round;
+            std::size_t index = static_cast<std::size_t>(at >> 32);
+            if (index >= length) {
+                index -= length;
+            }
+            std::size_t phase = static_cast<uint32_t>(at) >> phase_shift;
+            const coeff_type* h = table[phase].data();
+
+            // Taps that stay inside the loop read it in place; the few outputs
+            // next to the wrap gather their taps first
+            if (index >= Taps / 2 - 1 && index + Taps / 2 < length) {
+                out[i] = dot(&loop[index - (Taps / 2 - 1)], h);
+            } else {
+                std::size_t first = index + length - (Taps / 2 - 1);
+                std::array<Sample, Taps> x;
+                for (std::size_t k = 0; k < Taps; ++k) {
+                    x[k] = loop[(first + k) % length];
+                }
+                out[i] = dot(x.data(), h);
+            }
+
+            pos += step;
+            while (pos >= end) {
+                pos -= end;
+            }
+        }
+        return pos;
+    }
+
+    /**
+     * @brief Table used for a step: the cutoff drops in bands as the step
+     * rises above one.
+     */
+    static const table_type& table_for(resample_pos step)
+    {
+        if (step <= resample_one) {
+            return band_1;
+        }
+        if (step <= resample_one + resample_one / 4) {
+            return band_1_25;
+        }
+        if (step <= resample_one + resample_one / 2) {
+            return band_1_5;
+        }
+        return band_2;
+    }
+
+private:
+    static constexpr unsigned phase_shift = 32 - std::bit_width(Phases - 1);
+    static constexpr resample_pos phase_round = resample_pos{ 1 }
+                                                << (phase_shift - 1);
+
+    // Cutoffs as a fraction of the input Nyquist frequency; 0.9 leaves room
+    // for the transition band of a short filter
+    static constexpr table_type band_1 =
+      make_polyphase_table<coeff_type, Phases, Taps>(0.9);
+    static constexpr table_type band_1_25 =
+      make_polyphase_table<coeff_type, Phases, Taps>(0.9 / 1.25);
+    static constexpr table_type band_1_5 =
+      make_polyphase_table<coeff_type, Phases, Taps>(0.9 / 1.5);
+    static constexpr table_type band_2 =
+      make_polyphase_table<coeff_type, Phases, Taps>(0.9 / 2);
+
+    static Sample dot(const Sample* x, const coeff_type* h)
+    {
+        if constexpr (std::is_floating_point_v<Sample>) {
+            Sample sum = 0;
+            for (std::size_t k = 0; k < Taps; ++k) {
+                sum += x[k] * h[k];
+            }
+            return sum;
+        } else {
+            int32_t sum = 0;
+            for (std::size_t k = 0; k < Taps; k += 2) {
+                sum = dsp::smlad(dsp::load2(x + k), dsp::load2(h + k), sum);
+            }
+            return static_cast<Sample>(dsp::saturate16(sum >> 15));
+        }
+    }
+};
@@ -0,0 +1,166 @@
+/**
+ * @file real_fft.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Real FFT on CMSIS-DSP's arm_rfft_fast_f32, with a host model.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(ARM_MATH_CM7)
+#define QL_HAS_CMSIS_DSP 1
+#include <arm_math.h>
+#else
+#define QL_HAS_CMSIS_DSP 0
+#endif
+
+/**
+ * @brief Forward and inverse FFT of N real samples.
+ *
+ * The spectrum uses the arm_rfft_fast_f32 packing: N floats holding
+ * { X[0].re, X[N/2].re, X[1].re, X[1].im, ..., X[N/2-1].re, X[N/2-1].im },
+ * since the DC and Nyquist bins of a real signal have no imaginary part.
+ * The forward transform is unscaled and the inverse scales by 1/N, so
+ * inverse(forward(x)) == x.
+ *
+ * On the target this is arm_rfft_fast_f32 from CMSIS-DSP. Elsewhere it is a
+ * plain C++ model with the same packing and scaling, so code built on it can
+ * be tested on the host. Like the CMSIS function, both directions use their
+ * input as scratch: the input buffer is overwritten.
+ *
+ * @tparam N Transform length, a power of two from 32 to 4096.
+ */
+template<std::size_t N>
+class real_fft
+{
+    static_assert(N >= 32 && N <= 4096 && (N & (N - 1)) == 0,
+                  "arm_rfft_fast_f32 supports power of two lengths 32..4096");
+
+public:
+    static constexpr std::size_t size = N;
+
+    real_fft()
+    {
+#if QL_HAS_CMSIS_DSP
+        arm_rfft_fast_init_f32(&instance, N);
+#else
+        for (std::size_t k = 0; k < N / 2; ++k) {
+            double angle = -2.0 * M_PI * static_cast<double>(k) / N;
+            twiddle[k] = { static_cast<float>(std::cos(angle)),
+                           static_cast<float>(std::sin(angle)) };
+        }
+#endif
+    }
+
+    /**
+     * @brief Time domain to packed spectrum.
+     *
+     * @param time N samples; overwritten
+     * @param spectrum N floats of packed spectrum
+     */
+    void forward(float* time, float* spectrum)
+    {
+#if QL_HAS_CMSIS_DSP
+        arm_rfft_fast_f32(&instance, time, spectrum, 0);
+#else
+        // Pack even and odd samples as one half-length complex signal
+        auto* z = reinterpret_cast<std::complex<float>*>(time);
+        cfft(z, false);
+
+        spectrum[0] = z[0].real() + z[0].imag();
+        spectrum[1] = z[0].real() - z[0].imag();
+        for (std::size_t k = 1; k < half; ++k) {
+            std::complex<float> a = z[k];
+            std::complex<float> b = std::conj(z[half - k]);
+            std::complex<float> even = 0.5f * (a + b);
+            std::complex<float> odd =
+              std::complex<float>(0, -0.5f) * (a - b);
+            std::complex<float> x = even + twiddle[k] * odd;
+            spectrum[2 * k] = x.real();
+            spectrum[2 * k + 1] = x.imag();
+        }
+#endif
+    }
+
+    /**
+     * @brief Packed spectrum to time domain.
+     *
+     * @param spectrum N floats of packed spectrum; overwritten
+     * @param time N samples
+     */
+    void inverse(float* spectrum, float* time)
+    {
+#if QL_HAS_CMSIS_DSP
+        arm_rfft_fast_f32(&instance, spectrum, time, 1);
+#else
+        auto* z = reinterpret_cast<std::complex<float>*>(time);
+        float dc = spectrum[0];
+        float nyquist = spectrum[1];
+        z[0] = { 0.5f * (dc + nyquist), 0.5f * (dc - nyquist) };
+        for (std::size_t k = 1; k < half; ++k) {
+            std::complex<float> a(spectrum[2 * k], spectrum[2 * k + 1]);
+            std::complex<float> b(spectrum[2 * (half - k)],
+                                  -spectrum[2 * (half - k) + 1]);
+            std::complex<float> even = 0.5f * (a + b);
+            std::complex<float> odd = 0.5f * (a - b) / twiddle[k];
+            z[k] = even + std::complex<float>(0, 1) * odd;
+        }
+        cfft(z, true);
+#endif
+    }
+
+private:
+#if QL_HAS_CMSIS_DSP
+    arm_rfft_fast_instance_f32 instance;
+#else
+    static constexpr std::size_t half = N / 2;
+
+    /**
+     * @brief In-place radix-2 complex FFT of N/2 points; the inverse scales
+     * by 2/N so the real inverse as a whole scales by 1/N.
+     */
+    void cfft(std::complex<float>* z, bool inverse_direction) const
+    {
+        for (std::size_t i = 1, j = 0; i < half; ++i) {
+            std::size_t bit = half >> 1;
+            for (; j & bit; bit >>= 1) {
+                j ^= bit;
+            }
+            j ^= bit;
+            if (i < j) {
+                std::swap(z[i], z[j]);
+            }
+        }
+        for (std::size_t len = 2; len <= half; len <<= 1) {
+            // twiddle[] is for N points; this stage needs N/len spacing
+            std::size_t stride = N / len;
+            for (std::size_t i = 0; i < half; i += len) {
+                for (std::size_t k = 0; k < len / 2; ++k) {
+                    std::complex<float> w = twiddle[k * stride];
+                    if (inverse_direction) {
+                        w = std::conj(w);
+                    }
+                    std::complex<float> u = z[i + k];
+                    std::complex<float> v = z[i + k + len / 2] * w;
+                    z[i + k] = u + v;
+                    z[i + k + len / 2] = u - v;
+                }
+            }
+        }
+        if (inverse_direction) {
+            for (std::size_t i = 0; i < half; ++i) {
+                z[i] /= static_cast<float>(half);
+            }
+        }
+    }
+
+    std::array<std::complex<float>, N / 2> twiddle;
+#endif
+};
@@ -0,0 +1,269 @@
+/**
+ * @file time_stretch.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Pitch-preserving time-stretch of a loop with a phase vocoder.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Quantized looper includes
+#include <quantized_looper/Audio/const_math.hpp>
+#include <quantized_looper/Audio/dsp_intrinsics.hpp>
+#include <quantized_looper/Audio/polyphase_resampler.hpp>
+#include <quantized_looper/Audio/real_fft.hpp>
+
+/**
+ * @brief Periodic Hann window, built at compile time.
+ */
+template<std::size_t N>
+constexpr std::array<float, N> make_hann_window()
+{
+    std::array<float, N> w{};
+    for (std::size_t i = 0; i < N; ++i) {
+        w[i] = static_cast<float>(
+          0.5 - 0.5 * const_math::cos(2 * const_math::pi * i / N));
+    }
+    return w;
+}
+
+/**
+ * @brief Plays a loop at another speed without changing its pitch.
+ *
+ * A phase vocoder: every hop it takes one Hann-windowed frame of the loop at
+ * the read position, transforms it with real_fft (arm_rfft_fast_f32 on the
+ * target), advances each bin's phase by the bin's measured frequency over
+ * one output hop, transforms back and overlap-adds. Analysis frames are
+ * Hop * step apart in the loop and synthesis frames Hop apart in the
+ * output, so the loop plays `step` times faster at the original pitch.
+ *
+ * It is a drop-in for polyphase_resampler in track_bank: same arguments,
+ * and it reads the loop buffer directly, wrapping at the loop end. The
+ * frame, spectrum, phases and overlap-add buffers are fixed members and the
+ * transforms run in place between them, so nothing is allocated while
+ * playing. Frames are centred half a frame ahead of the read position, so
+ * the output lines up with the loop with no added latency.
+ *
+ * When the read position jumps, e.g. on a tempo change or a restart, the
+ * vocoder re-primes by computing the overlapping frames behind the new
+ * position in one go.
+ *
+ * @tparam Sample Sample type, int16_t or floating point.
+ * @tparam Frame Frame length, a power of two supported by real_fft.
+ * @tparam Overlap Frames overlapping each output sample; the hop is
+ * Frame / Overlap.
+ */
+template<typename Sample, std::size_t Frame = 512, std::size_t Overlap = 4>
+class time_stretch
+{
+    static_assert(std::is_floating_point_v<Sample> ||
+                    std::is_same_v<Sample, int16_t>,
+                  "time_stretch works on int16_t or floating point samples");
+    static_assert(Overlap >= 4 && Frame % Overlap == 0,
+                  "Hann overlap-add needs at least four overlapping frames");
+
+public:
+    static constexpr std::size_t frame = Frame;
+    static constexpr std::size_t hop = Frame / Overlap;
+
+    /**
+     * @brief Generate n output samples.
+     *
+     * @param loop Loop buffer
+     * @param length Loop length in samples; an empty loop plays silence
+     * @param pos Read position of the first output, below length
+     * @param step Loop samples per output sample
+     * @param out Output samples
+     * @param n Number of output samples
+     * @return Read position after the last output, wrapped into the loop
+     */
+    resample_pos process(const Sample* loop,
+                         std::size_t length,
+                         resample_pos pos,
+                         resample_pos step,
+                         Sample* out,
+                         std::size_t n)
+    {
+        if (length == 0) {
+            std::fill_n(out, n, Sample{});
+            last_length = 0;
+            return 0;
+        }
+        const resample_pos end = static_cast<resample_pos>(length) << 32;
+        if (step != last_step || length != last_length ||
+            !continues(pos, step, end)) {
+            prime(loop, length, pos, step);
+        }
+
+        for (std::size_t i = 0; i < n; ++i) {
+            if (ready == hop) {
+                next_hop(loop, length, pos, step);
+            }
+            float y = overlap[ready++];
+            if constexpr (std::is_floating_point_v<Sample>) {
+                out[i] = static_cast<Sample>(y);
+            } else {
+                out[i] = static_cast<Sample>(
+                  dsp::saturate16(static_cast<int32_t>(std::lround(y))));
+            }
+            pos += step;
+            while (pos >= end) {
+                pos -= end;
+            }
+        }
+        expected = pos;
+        return pos;
+    }
+
+private:
+    static constexpr std::size_t bins = Frame / 2;
+
+    // Hann analysis and synthesis windows overlap-add to 3/8 * Overlap
+    static constexpr float ola_gain = 8.0f / (3.0f * Overlap);
+
+    static constexpr float two_pi = 6.283185307179586f;
+
+    static constexpr std::array<float, Frame> window =
+      make_hann_window<Frame>();
+
+    /**
+     * @brief Whether `pos` carries on from the last call. The caller's loop
+     * wrap lands within a step of where this one would be, which is not a
+     * jump.
+     */
+    bool continues(resample_pos pos, resample_pos step, resample_pos end) const
+    {
+        if (expected >= end) {
+            return false;
+        }
+        resample_pos distance = (pos + end - expected) % end;
+        return std::min(distance, end - distance) <= step;
+    }
+
+    /**
+     * @brief Fill the overlap-add buffer as if the vocoder had been running,
+     * so the next output sample is complete.
+     */
+    void prime(const Sample* loop,
+               std::size_t length,
+               resample_pos pos,
+               resample_pos step)
+    {
+        last_step = step;
+        last_length = length;
+        overlap.fill(0);
+        first_frame = true;
+
+        // The frames before the one next_hop() would compute for `pos`
+        const resample_pos end = static_cast<resample_pos>(length) << 32;
+        resample_pos back = (step * hop) % end;
+        resample_pos start = pos;
+        for (std::size_t k = 1; k < Overlap; ++k) {
+            start = (start + end - back) % end;
+        }
+        for (std::size_t k = 1; k < Overlap; ++k) {
+            next_hop(loop, length, start, step);
+            start = (start + back) % end;
+        }
+        ready = hop;
+    }
+
+    /**
+     * @brief Retire one hop of finished output and add the next frame, whose
+     * output starts at read position `pos`.
+     */
+    void next_hop(const Sample* loop,
+                  std::size_t length,
+                  resample_pos pos,
+                  resample_pos step)
+    {
+        std::copy(overlap.begin() + hop, overlap.end(), overlap.begin());
+        std::fill(overlap.end() - hop, overlap.end(), 0.0f);
+
+        // The new frame covers output from `pos` on and is centred half a
+        // frame later, which in the loop is half a frame of output times step
+        const resample_pos end = static_cast<resample_pos>(length) << 32;
+        resample_pos centre = (pos + step * (Frame / 2)) % end;
+        std::size_t start =
+          static_cast<std::size_t>((centre >> 32) + length -
+                                   (Frame / 2) % length) %
+          length;
+
+        for (std::size_t i = 0, j = start; i < Frame; ++i) {
+            buffer[i] = static_cast<float>(loop[j]) * window[i];
+            if (++j == length) {
+                j = 0;
+            }
+        }
+        fft.forward(buffer.data(), spectrum.data());
+
+        // Loop samples since the last analysis frame, wrapped
+        float analysis_hop = static_cast<float>(
+          (start + length - last_start) % length);
+        last_start = start;
+        advance_phases(analysis_hop);
+
+        fft.inverse(spectrum.data(), buffer.data());
+        for (std::size_t i = 0; i < Frame; ++i) {
+            overlap[i] += buffer[i] * window[i] * ola_gain;
+        }
+        ready = 0;
+    }
+
+    /**
+     * @brief Replace each bin's phase with the synthesis phase, advanced by
+     * the bin's measured frequency over one output hop.
+     */
+    void advance_phases(float analysis_hop)
+    {
+        // DC and Nyquist are real and pass through
+        for (std::size_t k = 1; k < bins; ++k) {
+            float re = spectrum[2 * k];
+            float im = spectrum[2 * k + 1];
+            float magnitude = std::sqrt(re * re + im * im);
+            float phase = std::atan2(im, re);
+
+            if (first_frame || analysis_hop == 0.0f) {
+                synthesis_phase[k] = phase;
+            } else {
+                // Deviation from the bin centre's expected advance, wrapped
+                // to +/-pi, gives the frequency within the bin
+                float bin_freq = two_pi * static_cast<float>(k) / Frame;
+                float deviation =
+                  phase - analysis_phase[k] - bin_freq * analysis_hop;
+                deviation -= two_pi * std::nearbyint(deviation / two_pi);
+                float freq = bin_freq + deviation / analysis_hop;
+                synthesis_phase[k] += freq * static_cast<float>(hop);
+                synthesis_phase[k] -=
+                  two_pi * std::nearbyint(synthesis_phase[k] / two_pi);
+            }
+            analysis_phase[k] = phase;
+
+            spectrum[2 * k] = magnitude * std::cos(synthesis_phase[k]);
+            spectrum[2 * k + 1] = magnitude * std::sin(synthesis_phase[k]);
+        }
+        first_frame = false;
+    }
+
+    real_fft<Frame> fft;
+    std::array<float, Frame> buffer{};
+    std::array<float, Frame> spectrum{};
+    std::array<float, Frame> overlap{};
+    std::array<float, bins> analysis_phase{};
+    std::array<float, bins> synthesis_phase{};
+
+    std::size_t ready = hop;
+    std::size_t last_start = 0;
+    bool first_frame = true;
+    resample_pos expected = ~resample_pos{ 0 };
+    resample_pos last_step = 0;
+    std::size_t last_length = 0;
+};
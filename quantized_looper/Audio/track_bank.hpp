@@ -0,0 +1,772 @@
+/**
+ * @file track_bank.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Parallel loop tracks stored as structure-of-arrays.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <variant>
+
+// Quantized looper includes
+#include <quantized_looper/Audio/fade_table.hpp>
+#include <quantized_looper/Audio/loop_engine.hpp>
+#include <quantized_looper/Audio/page_history.hpp>
+#include <quantized_looper/Audio/polyphase_resampler.hpp>
+#include <quantized_looper/Audio/transport.hpp>
+
+/**
+ * @brief A loop command armed on one track, as queued on the transport.
+ */
+struct track_command
+{
+    std::size_t track;
+    loop_command command;
+};
+
+/**
+ * @brief A fixed number of mono loop tracks sharing one clock and beat grid.
+ *
+ * The bank owns the transport: it advances it by every sample it processes,
+ * and its armed commands are the transport's queued actions, so LEDs and
+ * clock outputs that read transport() see the grid the loops run on.
+ *
+ * Every per-track property lives in its own array indexed by track, and the
+ * loop buffers are one contiguous array of arrays, so the mixer walks each
+ * property and each buffer in order instead of hopping between track objects.
+ *
+ * The first track recorded while every other track is empty sets the base
+ * length. Later recordings close on their own after base length times the
+ * track's length multiplier, so all tracks stay phase locked to the first one.
+ *
+ * Commands and quantization work as in loop_engine, one armed command per
+ * track. The output is the sum of all playing, unmuted tracks, each scaled by
+ * its gain. A track being recorded is silent, as in loop_engine. Loop wrap
+ * and punch fades also work as in loop_engine, tracked per track.
+ *
+ * Each loop remembers the tempo it was recorded at. When the tempo changes,
+ * loops keep their length in beats: a loop recorded at another tempo plays
+ * through the Retimer. With the default polyphase resampler its pitch
+ * follows the tempo; with time_stretch it keeps its pitch. Such a loop can
+ * be played but not overdubbed; overdubbing stops when the tempo moves and
+ * re-recording takes the new tempo.
+ *
+ * With UndoPages > 0 every overdub, from punch-in to the end of its punch-out
+ * fade, is an undo layer kept in a page_history: only the pages it wrote are
+ * copied, into a pool of UndoPages pages shared by all tracks. The undo and
+ * redo commands are armed and quantized like any other. Undoing during an
+ * overdub ends the overdub first. An overdub on a loop longer than
+ * undo_frames, what the pool holds, gets no layer, and the track's earlier
+ * layers are kept; a pool of undo_layer_pages pages covers a whole track.
+ *
+ * @tparam Sample Sample type, int16_t or floating point.
+ * @tparam Tracks Number of tracks.
+ * @tparam TrackFrames Capacity of each track in samples.
+ * @tparam FadeFrames Length of loop and punch fades in samples; 0 disables
+ * them.
+ * @tparam Retimer Plays a loop at another rate, with polyphase_resampler's
+ * process() signature. One instance is kept per track.
+ * @tparam UndoPages Pages of overdub history shared by all tracks; 0
+ * disables undo.
+ */
+template<typename Sample,
+         std::size_t Tracks,
+         std::size_t TrackFrames,
+         std::size_t FadeFrames = 0,
+         typename Retimer = polyphase_resampler<Sample>,
+         std::size_t UndoPages = 0>
+class track_bank
+{
+    static_assert(std::is_floating_point_v<Sample> ||
+                    std::is_same_v<Sample, int16_t>,
+                  "track_bank mixes int16_t or floating point samples");
+    static_assert(Tracks > 0, "track_bank needs at least one track");
+
+    // Samples per undo page: a short overdub copies little, and a second at
+    // 48 kHz is under a hundred pages to swap
+    static constexpr std::size_t undo_page_frames = 512;
+
+    static_assert(UndoPages == 0 || FadeFrames <= undo_page_frames,
+                  "The loop wrap fade must fit in the first undo page");
+
+public:
+    using sample_type = Sample;
+    using transport_type = ::transport<track_command, Tracks>;
+
+    /**
+     * @brief Undo pages an overdub over a whole track can take.
+     */
+    static constexpr std::size_t undo_layer_pages =
+      (TrackFrames + undo_page_frames - 1) / undo_page_frames;
+
+    /**
+     * @brief Longest loop whose overdubs get an undo layer.
+     */
+    static constexpr std::size_t undo_frames =
+      std::min(UndoPages * undo_page_frames, TrackFrames);
+
+    /**
+     * @brief Construct a new track bank
+     *
+     * @param sample_rate Audio sample rate in Hz
+     * @param beats_per_bar Beats per bar for bar quantization
+     */
+    explicit track_bank(uint32_t sample_rate, uint32_t beats_per_bar = 4)
+      : timeline(sample_rate, beats_per_bar)
+    {
+        states.fill(loop_state::idle);
+        multipliers.fill(1);
+        steps.fill(resample_one);
+        seam_step.fill(FadeFrames);
+        punch_step.fill(FadeFrames);
+        gains.fill(unity_level<Sample>);
+        feedbacks.fill(unity_level<Sample>);
+    }
+
+    /**
+     * @brief Set the beat length from a tap tempo period.
+     *
+     * @param cycle_time_ms Time between beats in milliseconds
+     */
+    void set_tempo_ms(uint32_t cycle_time_ms)
+    {
+        set_samples_per_beat(static_cast<uint32_t>(
+          static_cast<uint64_t>(cycle_time_ms) * timeline.sample_rate() /
+          1000));
+    }
+
+    /**
+     * @brief Set the beat length from a tempo period in microseconds, for
+     * tap tempo finer than a millisecond.
+     */
+    void set_tempo_us(uint32_t cycle_time_us)
+    {
+        set_samples_per_beat(static_cast<uint32_t>(
+          (static_cast<uint64_t>(cycle_time_us) * timeline.sample_rate() +
+           500000) /
+          1000000));
+    }
+
+    /**
+     * @brief Set the beat length directly, retiming every loop to it.
+     *
+     * @param samples Samples per beat; clamped to at least one
+     */
+    void set_samples_per_beat(uint32_t samples)
+    {
+        samples = std::max<uint32_t>(samples, 1);
+        if (samples == timeline.samples_per_beat()) {
+            return;
+        }
+        timeline.set_samples_per_beat(samples);
+        for (std::size_t t = 0; t < Tracks; ++t) {
+            if (states[t] != loop_state::recording && lengths[t] > 0) {
+                retime(t);
+            }
+        }
+    }
+
+    /**
+     * @brief Set the beat length found in loops already recorded, e.g. by
+     * onset_tempo from the first loop. Closed loops are taken to have been
+     * recorded at this tempo, so they keep playing untouched rather than
+     * being resampled; the grid and armed commands follow it.
+     *
+     * @param samples Samples per beat; clamped to at least one
+     */
+    void adopt_tempo(uint32_t samples)
+    {
+        samples = std::max<uint32_t>(samples, 1);
+        for (std::size_t t = 0; t < Tracks; ++t) {
+            if (states[t] != loop_state::recording && lengths[t] > 0) {
+                record_beat[t] = samples;
+                play_index[t] = static_cast<std::size_t>(
+                  static_cast<uint64_t>(play_index[t]) * lengths[t] /
+                  durations[t]);
+                durations[t] = lengths[t];
+                steps[t] = resample_one;
+            }
+        }
+        base_beat = samples;
+        timeline.set_samples_per_beat(samples);
+    }
+
+    void set_beats_per_bar(uint32_t beats)
+    {
+        timeline.set_beats_per_bar(beats);
+    }
+
+    /**
+     * @brief Move the beat grid to a position, e.g. to line up with another
+     * looper. Loops keep playing from where they are; armed commands move
+     * to the next boundary from the new position.
+     */
+    void locate(uint64_t beats, uint32_t sample)
+    {
+        timeline.locate(beats, sample);
+    }
+
+    /**
+     * @brief Choose the curve for loop and punch fades on every track.
+     */
+    void set_fade_curve(fade_curve curve)
+    {
+        if constexpr (FadeFrames > 0) {
+            fades.set_curve(curve);
+        }
+    }
+
+    /**
+     * @brief Set a track's playback level.
+     *
+     * @param fraction 1.0 is unity, 0.0 silent
+     */
+    void set_gain(std::size_t track, float fraction)
+    {
+        gains[track] = level_from_fraction<Sample>(fraction);
+    }
+
+    /**
+     * @brief Set how much of a track survives each overdub pass.
+     *
+     * @param fraction 1.0 keeps the loop intact, 0.0 replaces it
+     */
+    void set_feedback(std::size_t track, float fraction)
+    {
+        feedbacks[track] = level_from_fraction<Sample>(fraction);
+    }
+
+    /**
+     * @brief Mute a track's output. A muted track keeps its position and can
+     * still be overdubbed.
+     */
+    void set_mute(std::size_t track, bool mute) { muted[track] = mute; }
+
+    /**
+     * @brief Set how many base lengths the track's next recording lasts.
+     *
+     * @param multiple Base lengths; clamped to at least one
+     */
+    void set_length_multiplier(std::size_t track, uint32_t multiple)
+    {
+        multipliers[track] = std::max<uint32_t>(multiple, 1);
+    }
+
+    /**
+     * @brief Arm a command on one track for the next boundary of the grid,
+     * replacing any command already armed on it.
+     *
+     * @param track Track index
+     * @param command Command to run
+     * @param grid Grid to snap to
+     */
+    void arm(std::size_t track, loop_command command, quantize grid)
+    {
+        disarm(track);
+        timeline.schedule({ track, command }, grid);
+    }
+
+    /**
+     * @brief Stop a track and discard its loop right away. Clearing the last
+     * loop lets the next recording set a new base length.
+     */
+    void clear(std::size_t track)
+    {
+        states[track] = loop_state::idle;
+        disarm(track);
+        play_index[track] = 0;
+        lengths[track] = 0;
+        durations[track] = 0;
+        steps[track] = resample_one;
+        seam_step[track] = FadeFrames;
+        punch_step[track] = FadeFrames;
+        if constexpr (UndoPages > 0) {
+            history.discard(track);
+        }
+        if (others_empty(track)) {
+            base = 0;
+        }
+    }
+
+    /**
+     * @brief Process one block of audio.
+     *
+     * @param in Input samples, recorded or overdubbed into armed tracks
+     * @param out Output samples; receives the mix of all tracks
+     * @param n Number of samples in both buffers
+     */
+    void process(const Sample* in, Sample* out, std::size_t n)
+    {
+        for (;;) {
+            timeline.fire_due([this](const track_command& c) {
+                execute(c.track, c.command);
+            });
+            if (n == 0) {
+                break;
+            }
+
+            std::size_t run =
+              std::min({ n, samples_to_event(), mix_chunk_frames });
+            mix(in, out, run);
+            advance(run);
+            in += run;
+            out += run;
+            n -= run;
+        }
+    }
+
+    loop_state state(std::size_t track) const { return states[track]; }
+
+    loop_command armed(std::size_t track) const
+    {
+        const track_command* c = timeline.find_if(
+          [track](const track_command& c) { return c.track == track; });
+        return c != nullptr ? c->command : loop_command::none;
+    }
+
+    /**
+     * @brief Recorded length in samples.
+     */
+    std::size_t length(std::size_t track) const { return lengths[track]; }
+
+    /**
+     * @brief Samples one pass takes at the current tempo.
+     */
+    std::size_t duration(std::size_t track) const { return durations[track]; }
+
+    std::size_t position(std::size_t track) const { return play_index[track]; }
+
+    /**
+     * @brief Overdubs on the track that can be undone.
+     */
+    std::size_t undo_levels(std::size_t track) const
+    {
+        if constexpr (UndoPages > 0) {
+            return history.undo_levels(track);
+        }
+        return 0;
+    }
+
+    std::size_t redo_levels(std::size_t track) const
+    {
+        if constexpr (UndoPages > 0) {
+            return history.redo_levels(track);
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Length that multipliers refer to at the current tempo; zero
+     * until the first track closes.
+     */
+    std::size_t base_length() const { return at_tempo(base, base_beat); }
+
+    uint64_t sample_clock() const { return timeline.sample_clock(); }
+
+    uint32_t samples_per_beat() const { return timeline.samples_per_beat(); }
+
+    /**
+     * @brief The musical position every consumer reads.
+     */
+    const transport_type& transport() const { return timeline; }
+
+    const Sample* data(std::size_t track) const
+    {
+        return buffers[track].data();
+    }
+
+    static constexpr std::size_t tracks() { return Tracks; }
+
+    static constexpr std::size_t capacity() { return TrackFrames; }
+
+private:
+    using accumulator_type =
+      std::conditional_t<std::is_floating_point_v<Sample>, Sample, int32_t>;
+
+    // Pieces are mixed through a stack accumulator of this many frames
+    static constexpr std::size_t mix_chunk_frames = 32;
+
+    /**
+     * @brief A length recorded at `beat` samples per beat, at the current
+     * tempo.
+     */
+    std::size_t at_tempo(std::size_t length, uint32_t beat) const
+    {
+        uint32_t now = timeline.samples_per_beat();
+        if (beat == now) {
+            return length;
+        }
+        uint64_t scaled = static_cast<uint64_t>(length) * now;
+        return static_cast<std::size_t>((scaled + beat / 2) / beat);
+    }
+
+    /**
+     * @brief Follow a tempo change, keeping the track's phase within its loop.
+     */
+    void retime(std::size_t track)
+    {
+        std::size_t duration = std::max<std::size_t>(
+          at_tempo(lengths[track], record_beat[track]), 1);
+        play_index[track] = static_cast<std::size_t>(
+          static_cast<uint64_t>(play_index[track]) * duration /
+          durations[track]);
+        durations[track] = duration;
+        steps[track] =
+          resample_step(record_beat[track], timeline.samples_per_beat());
+
+        if (steps[track] != resample_one) {
+            // Fades and overdubs write at the recorded rate
+            seam_step[track] = FadeFrames;
+            punch_step[track] = FadeFrames;
+            if (states[track] == loop_state::overdubbing) {
+                states[track] = loop_state::playing;
+            }
+        }
+    }
+
+    void disarm(std::size_t track)
+    {
+        timeline.cancel_if(
+          [track](const track_command& c) { return c.track == track; });
+    }
+
+    void mix(const Sample* in, Sample* out, std::size_t n)
+    {
+        std::array<accumulator_type, mix_chunk_frames> sum{};
+        for (std::size_t t = 0; t < Tracks; ++t) {
+            loop_state s = states[t];
+            if (s == loop_state::idle || s == loop_state::recording ||
+                muted[t]) {
+                continue;
+            }
+
+            // A retimed track's index counts in duration units and may lie
+            // past the buffer, so it is only an address at the recorded rate
+            const Sample* x = nullptr;
+            std::array<Sample, mix_chunk_frames> resampled;
+            if (steps[t] == resample_one) {
+                x = buffers[t].data() + play_index[t];
+            } else {
+                resample_pos pos = play_index[t] * steps[t];
+                pos %= static_cast<resample_pos>(lengths[t]) << 32;
+                retimers[t].process(buffers[t].data(),
+                                    lengths[t],
+                                    pos,
+                                    steps[t],
+                                    resampled.data(),
+                                    n);
+                x = resampled.data();
+            }
+
+            const accumulator_type gain = gains[t];
+            for (std::size_t i = 0; i < n; ++i) {
+                if constexpr (std::is_floating_point_v<Sample>) {
+                    sum[i] += x[i] * gain;
+                } else {
+                    // Scaled per track so eight full-scale tracks at unity
+                    // still fit the accumulator
+                    sum[i] += (x[i] * gain) >> 15;
+                }
+            }
+        }
+
+        for (std::size_t i = 0; i < n; ++i) {
+            if constexpr (std::is_floating_point_v<Sample>) {
+                out[i] = sum[i];
+            } else {
+                out[i] = static_cast<Sample>(dsp::saturate16(sum[i]));
+            }
+        }
+
+        // Writes come after the mix, so playback is the loop before this
+        // pass. A retimed track only plays, as retime() ends its fades and
+        // overdub
+        for (std::size_t t = 0; t < Tracks; ++t) {
+            if (states[t] == loop_state::idle || steps[t] != resample_one) {
+                continue;
+            }
+            Sample* x = buffers[t].data() + play_index[t];
+            if (states[t] == loop_state::recording) {
+                std::copy_n(in, n, x);
+            } else {
+                bool punching = punch_step[t] < FadeFrames;
+                bool layering =
+                  punching || states[t] == loop_state::overdubbing;
+                if constexpr (UndoPages > 0) {
+                    if (layering) {
+                        history.save(t, buffers[t].data(), play_index[t], n);
+                    }
+                }
+                write_seam(t, x, in, n);
+                if (layering) {
+                    if (punching) {
+                        write_punch(t, x, in, n);
+                    } else {
+                        overdub_feedback(x, in, feedbacks[t], n);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Write the loop wrap crossfade, if one is in progress.
+     *
+     * The crossfade finishes the recording, so when an overdub follows
+     * straight on, it also goes into that layer's saved copy.
+     */
+    void write_seam(std::size_t track,
+                    Sample* loop,
+                    const Sample* in,
+                    std::size_t n)
+    {
+        if constexpr (FadeFrames > 0) {
+            if (seam_step[track] < FadeFrames) {
+                fades.crossfade(loop, in, seam_step[track], n);
+                if constexpr (UndoPages > 0) {
+                    Sample* copy = history.saved_copy(track, play_index[track]);
+                    if (copy != nullptr) {
+                        fades.crossfade(copy, in, seam_step[track], n);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Overdub through the punch fade in progress.
+     */
+    void write_punch(std::size_t track,
+                     Sample* loop,
+                     const Sample* in,
+                     std::size_t n)
+    {
+        if constexpr (FadeFrames > 0) {
+            fades.overdub(loop,
+                          in,
+                          feedbacks[track],
+                          punch_step[track],
+                          n,
+                          punch_rising[track]);
+        }
+    }
+
+    /**
+     * @brief Length a recording on this track closes at, or the buffer size
+     * when it is the base recording.
+     */
+    std::size_t record_limit(std::size_t track) const
+    {
+        if (base == 0) {
+            return TrackFrames;
+        }
+        return std::min<std::size_t>(base_length() * multipliers[track],
+                                     TrackFrames);
+    }
+
+    /**
+     * @brief Samples until any track has to be re-evaluated.
+     */
+    std::size_t samples_to_event() const
+    {
+        std::size_t limit = timeline.samples_to_next_action();
+        for (std::size_t t = 0; t < Tracks; ++t) {
+            if (states[t] == loop_state::recording) {
+                limit = std::min(limit, record_limit(t) - play_index[t]);
+            } else if (states[t] != loop_state::idle) {
+                limit = std::min(limit, durations[t] - play_index[t]);
+                if (seam_step[t] < FadeFrames) {
+                    limit = std::min(limit, FadeFrames - seam_step[t]);
+                }
+                if (punch_step[t] < FadeFrames) {
+                    limit = std::min(limit, FadeFrames - punch_step[t]);
+                }
+            }
+        }
+        return limit;
+    }
+
+    void advance(std::size_t run)
+    {
+        timeline.advance(run);
+        for (std::size_t t = 0; t < Tracks; ++t) {
+            if (states[t] == loop_state::idle) {
+                continue;
+            }
+            play_index[t] += run;
+            if (states[t] == loop_state::recording) {
+                lengths[t] = play_index[t];
+                durations[t] = play_index[t];
+                if (play_index[t] == record_limit(t)) {
+                    close_recording(t, loop_state::playing);
+                }
+                continue;
+            }
+            if (play_index[t] == durations[t]) {
+                play_index[t] = 0;
+            }
+            if (seam_step[t] < FadeFrames) {
+                seam_step[t] += run;
+            }
+            if (punch_step[t] < FadeFrames) {
+                punch_step[t] += run;
+            }
+        }
+    }
+
+    void close_recording(std::size_t track, loop_state next)
+    {
+        if (base == 0) {
+            base = lengths[track];
+            base_beat = timeline.samples_per_beat();
+        }
+        record_beat[track] = timeline.samples_per_beat();
+        steps[track] = resample_one;
+        play_index[track] = 0;
+        states[track] = lengths[track] > 0 ? next : loop_state::idle;
+        // A loop shorter than the fade would wrap in the middle of it
+        if (lengths[track] >= FadeFrames) {
+            seam_step[track] = 0;
+        }
+    }
+
+    void start_punch(std::size_t track, bool rising)
+    {
+        if (lengths[track] >= FadeFrames) {
+            punch_step[track] = 0;
+            punch_rising[track] = rising;
+        }
+    }
+
+    bool others_empty(std::size_t track) const
+    {
+        for (std::size_t t = 0; t < Tracks; ++t) {
+            if (t != track && lengths[t] > 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void execute(std::size_t track, loop_command command)
+    {
+        switch (command) {
+            case loop_command::none:
+                break;
+            case loop_command::record:
+                // Re-recording the only loop starts a new base length
+                if (others_empty(track)) {
+                    base = 0;
+                }
+                if constexpr (UndoPages > 0) {
+                    history.discard(track);
+                }
+                states[track] = loop_state::recording;
+                play_index[track] = 0;
+                lengths[track] = 0;
+                durations[track] = 0;
+                steps[track] = resample_one;
+                seam_step[track] = FadeFrames;
+                punch_step[track] = FadeFrames;
+                break;
+            case loop_command::overdub:
+                if (states[track] == loop_state::recording) {
+                    close_recording(track, loop_state::overdubbing);
+                    if (states[track] == loop_state::overdubbing) {
+                        start_punch(track, true);
+                        begin_layer(track);
+                    }
+                } else if (lengths[track] > 0 &&
+                           steps[track] == resample_one &&
+                           states[track] != loop_state::overdubbing) {
+                    states[track] = loop_state::overdubbing;
+                    start_punch(track, true);
+                    begin_layer(track);
+                }
+                break;
+            case loop_command::play:
+                if (states[track] == loop_state::recording) {
+                    close_recording(track, loop_state::playing);
+                } else if (lengths[track] > 0) {
+                    if (states[track] == loop_state::overdubbing) {
+                        start_punch(track, false);
+                    }
+                    states[track] = loop_state::playing;
+                }
+                break;
+            case loop_command::stop:
+                states[track] = loop_state::idle;
+                play_index[track] = 0;
+                seam_step[track] = FadeFrames;
+                punch_step[track] = FadeFrames;
+                break;
+            case loop_command::undo:
+            case loop_command::redo:
+                if constexpr (UndoPages > 0) {
+                    if (states[track] == loop_state::recording) {
+                        break;
+                    }
+                    // The layer being written is the one to take back, so
+                    // the overdub ends without a punch-out fade
+                    if (states[track] == loop_state::overdubbing) {
+                        states[track] = loop_state::playing;
+                    }
+                    punch_step[track] = FadeFrames;
+                    if (command == loop_command::undo) {
+                        history.undo(track, buffers[track].data());
+                    } else {
+                        history.redo(track, buffers[track].data());
+                    }
+                }
+                break;
+        }
+    }
+
+    void begin_layer(std::size_t track)
+    {
+        if constexpr (UndoPages > 0) {
+            history.begin(track, lengths[track]);
+        }
+    }
+
+    transport_type timeline;
+    std::size_t base = 0;
+    uint32_t base_beat = 1;
+
+    std::array<loop_state, Tracks> states;
+    std::array<std::size_t, Tracks> play_index{};
+    std::array<std::size_t, Tracks> lengths{};
+    std::array<std::size_t, Tracks> durations{};
+    std::array<uint32_t, Tracks> record_beat{};
+    std::array<resample_pos, Tracks> steps;
+    std::array<uint32_t, Tracks> multipliers;
+    std::array<level_type<Sample>, Tracks> gains;
+    std::array<level_type<Sample>, Tracks> feedbacks;
+    std::array<bool, Tracks> muted{};
+
+    // Steps into each track's wrap and punch fades; FadeFrames when not fading
+    std::array<std::size_t, Tracks> seam_step;
+    std::array<std::size_t, Tracks> punch_step;
+    std::array<bool, Tracks> punch_rising{};
+    [[no_unique_address]] std::conditional_t<(FadeFrames > 0),
+                                             fade_ramp<Sample, FadeFrames>,
+                                             std::monostate> fades;
+
+    // Stateless for the resampler; frame and phase state for time_stretch
+    std::array<Retimer, Tracks> retimers{};
+
+    [[no_unique_address]] std::conditional_t<
+      (UndoPages > 0),
+      page_history<Sample, Tracks, TrackFrames, UndoPages, undo_page_frames>,
+      std::monostate> history;
+
+    alignas(32) std::array<std::array<Sample, TrackFrames>, Tracks> buffers{};
+};
@@ -0,0 +1,356 @@
+/**
+ * @file transport.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Musical position from the audio sample count, and actions queued
+ * on its beat grid.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief Grid that an armed command snaps to.
+ */
+enum class quantize : uint8_t
+{
+    immediate,
+    beat,
+    bar
+};
+
+/**
+ * @brief The one clock everything musical reads: bar, beat and tick, all
+ * derived from the number of audio samples processed.
+ *
+ * Whoever processes audio calls advance() with each block's length, and
+ * nothing else keeps time. Position is computed on demand from the sample
+ * count and a tempo anchor, so readers never accumulate their own elapsed
+ * time and cannot drift from the audio.
+ *
+ * A tempo change re-anchors the grid at the current sample, keeping the
+ * position within the beat, so the beat count carries on without a jump.
+ *
+ * Actions are queued for a grid boundary and fire on its exact sample.
+ * Actions on a beat or bar stay on that beat or bar if the tempo changes
+ * while they wait. The audio engine asks samples_to_next_action() where to
+ * split its block and calls fire_due() at each split.
+ *
+ * @tparam Action What a queued action carries, copied in and out.
+ * @tparam Capacity Actions that can wait at once.
+ */
+template<typename Action, std::size_t Capacity = 16>
+class transport
+{
+public:
+    /**
+     * @brief Ticks per beat; a multiple of MIDI clock's 24.
+     */
+    static constexpr uint32_t ppqn = 96;
+
+    struct position
+    {
+        uint64_t beats;  //!< Whole beats since the start
+        uint64_t bar;    //!< Bar number from zero
+        uint32_t beat;   //!< Beat within the bar
+        uint32_t tick;   //!< Tick within the beat, below ppqn
+        uint32_t sample; //!< Sample within the beat
+    };
+
+    /**
+     * @brief Construct a new transport at 60 BPM
+     *
+     * @param sample_rate Audio sample rate in Hz
+     * @param beats_per_bar Beats per bar for bar positions and quantization
+     */
+    explicit transport(uint32_t sample_rate, uint32_t beats_per_bar = 4)
+      : rate(sample_rate)
+      , bar_beats(std::max<uint32_t>(beats_per_bar, 1))
+      , beat_samples(std::max<uint32_t>(sample_rate, 1))
+    {
+    }
+
+    /**
+     * @brief Set the beat length, keeping the position within the beat.
+     *
+     * @param samples Samples per beat; clamped to at least one
+     */
+    void set_samples_per_beat(uint32_t samples)
+    {
+        samples = std::max<uint32_t>(samples, 1);
+        if (samples == beat_samples) {
+            return;
+        }
+        position p = now();
+        anchor_beat = p.beats;
+        anchor_sample =
+          static_cast<int64_t>(clock) -
+          static_cast<int64_t>((static_cast<uint64_t>(p.sample) * samples +
+                                beat_samples / 2) /
+                               beat_samples);
+        beat_samples = samples;
+        reschedule(false);
+    }
+
+    /**
+     * @brief Jump to a position, e.g. to line up with another clock. Actions
+     * waiting for a beat or bar move to the next one from the new position.
+     *
+     * @param beats Whole beats since the start
+     * @param sample Sample within the beat
+     */
+    void locate(uint64_t beats, uint32_t sample)
+    {
+        sample = std::min(sample, beat_samples - 1);
+        anchor_beat = beats;
+        anchor_sample =
+          static_cast<int64_t>(clock) - static_cast<int64_t>(sample);
+        reschedule(true);
+    }
+
+    /**
+     * @brief Set the beat length from a tempo period in microseconds.
+     */
+    void set_tempo_us(uint32_t cycle_time_us)
+    {
+        set_samples_per_beat(static_cast<uint32_t>(
+          (static_cast<uint64_t>(cycle_time_us) * rate + 500000) / 1000000));
+    }
+
+    void set_beats_per_bar(uint32_t beats)
+    {
+        bar_beats = std::max<uint32_t>(beats, 1);
+    }
+
+    /**
+     * @brief Move time on by n samples. Called once per processed piece of
+     * audio, by the audio engine only.
+     */
+    void advance(std::size_t n) { clock += n; }
+
+    /**
+     * @brief Position at the current sample.
+     */
+    position now() const { return at(clock); }
+
+    /**
+     * @brief Position at any sample since the last tempo change.
+     */
+    position at(uint64_t sample) const
+    {
+        uint64_t elapsed =
+          static_cast<uint64_t>(static_cast<int64_t>(sample) - anchor_sample);
+        position p{};
+        p.beats = anchor_beat + elapsed / beat_samples;
+        p.sample = static_cast<uint32_t>(elapsed % beat_samples);
+        p.tick = static_cast<uint32_t>(static_cast<uint64_t>(p.sample) * ppqn /
+                                       beat_samples);
+        p.bar = p.beats / bar_beats;
+        p.beat = static_cast<uint32_t>(p.beats % bar_beats);
+        return p;
+    }
+
+    /**
+     * @brief Sample a beat starts on, at the current tempo.
+     */
+    uint64_t sample_of_beat(uint64_t beat) const
+    {
+        return static_cast<uint64_t>(
+          anchor_sample +
+          static_cast<int64_t>((beat - anchor_beat) * beat_samples));
+    }
+
+    /**
+     * @brief Sample a tick starts on, at the current tempo; the first sample
+     * whose position has that tick.
+     */
+    uint64_t sample_of_tick(uint64_t beat, uint32_t tick) const
+    {
+        uint64_t into = (static_cast<uint64_t>(tick) * beat_samples + ppqn -
+                         1) /
+                        ppqn;
+        return sample_of_beat(beat) + into;
+    }
+
+    /**
+     * @brief First sample at or after now on the grid.
+     */
+    uint64_t next_boundary(quantize grid) const
+    {
+        return sample_of_beat(next_beat(grid));
+    }
+
+    /**
+     * @brief Queue an action for the next boundary of the grid, which may
+     * be the current sample.
+     *
+     * @return false if the queue is full
+     */
+    bool schedule(const Action& action, quantize grid)
+    {
+        if (grid == quantize::immediate) {
+            return insert({ action, clock, 0, grid });
+        }
+        uint64_t beat = next_beat(grid);
+        return insert({ action, sample_of_beat(beat), beat, grid });
+    }
+
+    /**
+     * @brief Queue an action for an exact sample, not at the past.
+     *
+     * @return false if the queue is full
+     */
+    bool schedule_at(const Action& action, uint64_t sample)
+    {
+        return insert(
+          { action, std::max(sample, clock), 0, quantize::immediate });
+    }
+
+    /**
+     * @brief Drop every queued action that matches.
+     */
+    template<typename Predicate>
+    void cancel_if(Predicate&& match)
+    {
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (!match(queue[i].action)) {
+                queue[kept++] = queue[i];
+            }
+        }
+        count = kept;
+    }
+
+    /**
+     * @brief The first queued action that matches, or nullptr.
+     */
+    template<typename Predicate>
+    const Action* find_if(Predicate&& match) const
+    {
+        for (std::size_t i = 0; i < count; ++i) {
+            if (match(queue[i].action)) {
+                return &queue[i].action;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Samples until the next queued action is due; zero if one is
+     * due now, the largest size_t if none is queued.
+     */
+    std::size_t samples_to_next_action() const
+    {
+        if (count == 0) {
+            return std::numeric_limits<std::size_t>::max();
+        }
+        return static_cast<std::size_t>(queue[0].at - clock);
+    }
+
+    /**
+     * @brief Hand every action due at the current sample to `fire`, oldest
+     * first. `fire` may queue more actions.
+     */
+    template<typename Fire>
+    void fire_due(Fire&& fire)
+    {
+        while (count > 0 && queue[0].at <= clock) {
+            Action action = queue[0].action;
+            std::copy(queue.begin() + 1, queue.begin() + count, queue.begin());
+            --count;
+            fire(action);
+        }
+    }
+
+    std::size_t pending() const { return count; }
+
+    uint64_t sample_clock() const { return clock; }
+
+    uint32_t samples_per_beat() const { return beat_samples; }
+
+    uint32_t beats_per_bar() const { return bar_beats; }
+
+    uint32_t sample_rate() const { return rate; }
+
+private:
+    struct entry
+    {
+        Action action{};
+        uint64_t at = 0;
+        uint64_t beat = 0;
+        quantize grid = quantize::immediate; //!< immediate for an exact sample
+    };
+
+    /**
+     * @brief Recompute when actions on the grid are due after the grid
+     * moved, keeping their beat or snapping them to the next boundary.
+     */
+    void reschedule(bool snap)
+    {
+        // count never exceeds Capacity; the bound is for the compiler
+        const std::size_t n = std::min(count, Capacity);
+        for (std::size_t i = 0; i < n; ++i) {
+            entry& e = queue[i];
+            if (e.grid == quantize::immediate) {
+                continue;
+            }
+            if (snap) {
+                e.beat = next_beat(e.grid);
+            }
+            e.at = std::max(sample_of_beat(e.beat), clock);
+        }
+        std::stable_sort(queue.begin(),
+                         queue.begin() + n,
+                         [](const entry& a, const entry& b) {
+                             return a.at < b.at;
+                         });
+    }
+
+    /**
+     * @brief The beat the next boundary of the grid falls on.
+     */
+    uint64_t next_beat(quantize grid) const
+    {
+        position p = now();
+        uint64_t beat = p.beats + (p.sample > 0 ? 1 : 0);
+        if (grid == quantize::bar) {
+            beat = (beat + bar_beats - 1) / bar_beats * bar_beats;
+        }
+        return beat;
+    }
+
+    bool insert(const entry& e)
+    {
+        if (count == Capacity) {
+            return false;
+        }
+        // After anything due at the same sample, so actions keep their order
+        std::size_t i = count;
+        while (i > 0 && queue[i - 1].at > e.at) {
+            queue[i] = queue[i - 1];
+            --i;
+        }
+        queue[i] = e;
+        ++count;
+        return true;
+    }
+
+    uint32_t rate;
+    uint32_t bar_beats;
+    uint32_t beat_samples;
+    uint64_t clock = 0;
+
+    // The grid: beat anchor_beat started at anchor_sample, which may be
+    // before sample zero after a tempo change
+    int64_t anchor_sample = 0;
+    uint64_t anchor_beat = 0;
+
+    std::array<entry, Capacity> queue{};
+    std::size_t count = 0;
+};
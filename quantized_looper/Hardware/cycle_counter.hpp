@@ -0,0 +1,51 @@
+/**
+ * @file cycle_counter.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Core clock cycle counter for on-target measurements.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <cstdint>
+
+// Hardware includes
+#include <stm32f7xx.h>
+
+/**
+ * @brief Thin wrapper over the DWT cycle counter.
+ *
+ * The counter runs at the core clock and wraps every 2^32 cycles, so a
+ * difference of two reads is exact for anything shorter than that.
+ */
+class cycle_counter
+{
+public:
+    /**
+     * @brief Turn on trace and start the counter. Safe to call repeatedly.
+     */
+    static void enable()
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        // The M7 locks the DWT registers until the key is written
+        DWT->LAR = 0xC5ACCE55;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    static uint32_t now() { return DWT->CYCCNT; }
+
+    /**
+     * @brief Average cycles per call of `fn` over `iterations` calls.
+     */
+    template<typename Fn>
+    static uint32_t measure(Fn&& fn, uint32_t iterations)
+    {
+        uint32_t start = now();
+        for (uint32_t i = 0; i < iterations; ++i) {
+            fn();
+        }
+        return (now() - start) / iterations;
+    }
+};
@@ -0,0 +1,410 @@
+/**
+ * @file eth_udp.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Broadcast UDP datagrams straight on the Ethernet MAC, without an IP
+ * stack.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Quantized looper includes
+#include <quantized_looper/Hardware/microsecond_timer.hpp>
+
+// Hardware includes
+#include <eth.h>
+#include <main.h>
+#include <stm32f7xx_hal.h>
+
+/**
+ * @brief Small UDP datagrams to and from every node on the LAN, on the MAC
+ * and PHY that MX_ETH_Init sets up (RMII to the Nucleo's LAN8742).
+ *
+ * Only broadcast is needed, so there is no ARP and no IP stack: send()
+ * writes a whole Ethernet, IPv4 and UDP frame to 255.255.255.255 and the
+ * MAC fills in both checksums, and poll() picks the datagrams for its port
+ * out of whatever arrives. Each unit takes a locally administered MAC
+ * address and a 169.254/16 source address from its device ID; CubeMX gives
+ * every board the same MAC, which switches would not forgive.
+ *
+ * Received frames land in a pool of buffers that the HAL claims and returns
+ * through its allocate and link callbacks, which main.cpp forwards here.
+ * The receive interrupt timestamps frames on microsecond_timer, as
+ * midi_uart timestamps clock bytes, so clock offsets measured over the
+ * network do not carry the main loop's polling jitter. Sent frames stay in
+ * their buffer until the DMA releases them.
+ *
+ * The MAC runs from init() on. The PHY is checked from poll() at most twice
+ * a second, and each time the link comes up the MAC is set to the speed and
+ * duplex it negotiated by writing its configuration register directly: the
+ * HAL's start, stop and configuration calls each wait out a millisecond
+ * delay or more per register, which poll() and send() never do, so both fit
+ * a background task's budget.
+ *
+ * @tparam RxBuffers Receive pool; at least ETH_RX_DESC_CNT plus the frame
+ * being read
+ * @tparam TxFrames Frames that may be in flight at once
+ */
+template<std::size_t RxBuffers = 8, std::size_t TxFrames = 4>
+class eth_udp
+{
+    static_assert(RxBuffers > ETH_RX_DESC_CNT,
+                  "The pool must refill every descriptor while a frame is "
+                  "read");
+
+public:
+    static constexpr std::size_t header_bytes = 14 + 20 + 8;
+    static constexpr std::size_t max_payload = 64;
+
+    /**
+     * @brief Take an address from the device ID and start the MAC. Call
+     * after MX_ETH_Init, before the scheduler starts.
+     *
+     * @param udp_port Port to send from and listen on
+     * @param irq_priority NVIC pre-emption priority of the ETH interrupt
+     */
+    void init(uint16_t udp_port, uint32_t irq_priority = 2)
+    {
+        port = udp_port;
+
+        const auto* uid = reinterpret_cast<const uint32_t*>(UID_BASE);
+        node = uid[0] ^ (uid[1] * 0x9E3779B1u) ^ (uid[2] * 0x85EBCA77u);
+        mac = { 0x02,
+                0x51,
+                static_cast<uint8_t>(node >> 24),
+                static_cast<uint8_t>(node >> 16),
+                static_cast<uint8_t>(node >> 8),
+                static_cast<uint8_t>(node) };
+        ip = { 169,
+               254,
+               static_cast<uint8_t>(1 + (node >> 8) % 254),
+               static_cast<uint8_t>(node) };
+        heth.Init.MACAddr = mac.data();
+        ETH->MACA0HR = (static_cast<uint32_t>(mac[5]) << 8) | mac[4];
+        ETH->MACA0LR = (static_cast<uint32_t>(mac[3]) << 24) |
+                       (static_cast<uint32_t>(mac[2]) << 16) |
+                       (static_cast<uint32_t>(mac[1]) << 8) | mac[0];
+
+        // As MX_ETH_Init's TxConfig
+        tx_config = {};
+        tx_config.Attributes =
+          ETH_TX_PACKETS_FEATURES_CSUM | ETH_TX_PACKETS_FEATURES_CRCPAD;
+        tx_config.ChecksumCtrl = ETH_CHECKSUM_IPHDR_PAYLOAD_INSERT_PHDR_CALC;
+        tx_config.CRCPadCtrl = ETH_CRC_PAD_INSERT;
+
+        for (std::size_t i = 0; i < RxBuffers; ++i) {
+            pool[i] = rx[i].data();
+        }
+        available = RxBuffers;
+
+        HAL_NVIC_SetPriority(ETH_IRQn, irq_priority, 0);
+        HAL_NVIC_EnableIRQ(ETH_IRQn);
+        started = HAL_ETH_Start_IT(&heth) == HAL_OK;
+    }
+
+    /**
+     * @brief Unique enough to tell the units on one LAN apart.
+     */
+    uint32_t id() const { return node; }
+
+    bool link_up() const { return started && up; }
+
+    /**
+     * @brief Follow the link, free sent frames, and hand every datagram for
+     * our port to `receive` with the time it arrived.
+     *
+     * @param now_us The current time, on the clock the stamps are given in
+     * @param receive Callable as receive(data, n, arrival_us)
+     */
+    template<typename Receive>
+    void poll(uint64_t now_us, Receive&& receive)
+    {
+        if (now_us - last_link_check >= link_check_us || !checked) {
+            checked = true;
+            last_link_check = now_us;
+            check_link();
+        }
+        if (!link_up()) {
+            return;
+        }
+        HAL_ETH_ReleaseTxPacket(&heth);
+
+        // The interrupt's stamp is the newest frame's; older frames in the
+        // same batch look late, which only makes them lose to better
+        // samples
+        const uint32_t age =
+          microsecond_timer::now() - stamp.load(std::memory_order_acquire);
+        const uint64_t arrival = now_us - age;
+
+        void* frame = nullptr;
+        while (HAL_ETH_ReadData(&heth, &frame) == HAL_OK && frame != nullptr) {
+            auto* data = static_cast<uint8_t*>(frame);
+            std::size_t payload = 0;
+            std::size_t n = datagram(data, rx_length, payload);
+            if (n > 0) {
+                receive(data + payload, n, arrival);
+            }
+            release(data);
+            frame = nullptr;
+        }
+    }
+
+    /**
+     * @brief Broadcast a datagram. From the same context as poll(), which
+     * also releases sent frames.
+     *
+     * @return false if the link is down or every frame is in flight
+     */
+    bool send(const uint8_t* data, std::size_t n)
+    {
+        if (!link_up() || n > max_payload) {
+            return false;
+        }
+        HAL_ETH_ReleaseTxPacket(&heth);
+        std::size_t slot = next_tx;
+        if (in_flight[slot]) {
+            return false;
+        }
+        next_tx = (next_tx + 1) % TxFrames;
+
+        uint8_t* frame = tx[slot].data();
+        const std::size_t length = header_bytes + n;
+        write_header(frame, n);
+        std::memcpy(frame + header_bytes, data, n);
+        SCB_CleanDCache_by_Addr(reinterpret_cast<uint32_t*>(frame),
+                                static_cast<int32_t>(tx[slot].size()));
+
+        ETH_BufferTypeDef buffer = {};
+        buffer.buffer = frame;
+        buffer.len = static_cast<uint32_t>(length);
+        tx_config.Length = static_cast<uint32_t>(length);
+        tx_config.TxBuffer = &buffer;
+        tx_config.pData = frame;
+        in_flight[slot] = true;
+        if (HAL_ETH_Transmit_IT(&heth, &tx_config) != HAL_OK) {
+            in_flight[slot] = false;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Call from ETH_IRQHandler.
+     */
+    void irq()
+    {
+        if (heth.Instance->DMASR & ETH_DMASR_RS) {
+            stamp.store(microsecond_timer::now(), std::memory_order_release);
+        }
+        HAL_ETH_IRQHandler(&heth);
+    }
+
+    /**
+     * @brief Call from HAL_ETH_RxAllocateCallback.
+     *
+     * @return A free receive buffer, or nullptr to have the HAL try later
+     */
+    uint8_t* rx_allocate()
+    {
+        return available > 0 ? pool[--available] : nullptr;
+    }
+
+    /**
+     * @brief Call from HAL_ETH_RxLinkCallback. A frame of ours always fits
+     * one buffer, so a longer one is released at once and never read.
+     */
+    void rx_link(void** start, void** end, uint8_t* buffer, uint16_t length)
+    {
+        SCB_InvalidateDCache_by_Addr(reinterpret_cast<uint32_t*>(buffer),
+                                     static_cast<int32_t>(buffer_bytes));
+        if (*start == nullptr) {
+            *start = buffer;
+            rx_length = length;
+        } else {
+            rx_length = 0;
+            release(buffer);
+        }
+        *end = buffer;
+    }
+
+    /**
+     * @brief Call from HAL_ETH_TxFreeCallback.
+     */
+    void tx_free(uint32_t* buffer)
+    {
+        for (std::size_t i = 0; i < TxFrames; ++i) {
+            if (reinterpret_cast<uint32_t*>(tx[i].data()) == buffer) {
+                in_flight[i] = false;
+            }
+        }
+    }
+
+private:
+    static constexpr uint32_t phy_address = 0;
+    static constexpr uint32_t phy_status = 1;         // Basic status
+    static constexpr uint32_t phy_special = 31;       // LAN8742 special
+    static constexpr uint32_t phy_link_up = 1u << 2;  // In basic status
+    static constexpr uint32_t phy_speed_100 = 1u << 3; // In special
+    static constexpr uint32_t phy_full_duplex = 1u << 4;
+    static constexpr uint64_t link_check_us = 500000;
+    // Whole cache lines, so invalidating one buffer never touches the next
+    static constexpr std::size_t buffer_bytes =
+      (ETH_RX_BUF_SIZE + 31) / 32 * 32;
+
+    /**
+     * @brief Follow the link, and set the MAC to the negotiated speed and
+     * duplex each time it comes up. Three management frames, about 30 us
+     * each, and no HAL delays.
+     */
+    void check_link()
+    {
+        uint32_t status = 0;
+        if (HAL_ETH_ReadPHYRegister(
+              &heth, phy_address, phy_status, &status) != HAL_OK) {
+            return;
+        }
+        // Link status latches low; the second read is the present state
+        HAL_ETH_ReadPHYRegister(&heth, phy_address, phy_status, &status);
+        bool linked = (status & phy_link_up) != 0;
+        if (linked == up) {
+            return;
+        }
+        up = linked;
+        if (!up) {
+            return;
+        }
+
+        uint32_t special = 0;
+        HAL_ETH_ReadPHYRegister(&heth, phy_address, phy_special, &special);
+        uint32_t config =
+          heth.Instance->MACCR & ~(ETH_MACCR_FES | ETH_MACCR_DM);
+        if (special & phy_speed_100) {
+            config |= ETH_MACCR_FES;
+        }
+        if (special & phy_full_duplex) {
+            config |= ETH_MACCR_DM;
+        }
+        // Speed and duplex change with the transmitter and receiver off
+        write_maccr(config & ~(ETH_MACCR_TE | ETH_MACCR_RE));
+        write_maccr(config);
+    }
+
+    /**
+     * @brief The MAC takes a register write four MII clocks later, 1.6 us at
+     * 10 Mb/s, where the HAL waits a tick for it.
+     */
+    void write_maccr(uint32_t value)
+    {
+        heth.Instance->MACCR = value;
+        const uint32_t written = microsecond_timer::now();
+        while (microsecond_timer::now() - written < 3) {
+        }
+    }
+
+    static uint16_t read16(const uint8_t* p)
+    {
+        return static_cast<uint16_t>((p[0] << 8) | p[1]);
+    }
+
+    static void write16(uint8_t* p, uint16_t v)
+    {
+        p[0] = static_cast<uint8_t>(v >> 8);
+        p[1] = static_cast<uint8_t>(v);
+    }
+
+    /**
+     * @brief Find the UDP payload of an unfragmented IPv4 datagram to our
+     * port.
+     *
+     * @return Payload bytes, 0 if the frame is anything else
+     */
+    std::size_t datagram(const uint8_t* frame,
+                         std::size_t n,
+                         std::size_t& payload) const
+    {
+        if (n < header_bytes || read16(frame + 12) != 0x0800) {
+            return 0;
+        }
+        const uint8_t* ip_header = frame + 14;
+        const std::size_t ihl = (ip_header[0] & 0x0F) * 4u;
+        if ((ip_header[0] >> 4) != 4 || ihl < 20 || ip_header[9] != 17 ||
+            (read16(ip_header + 6) & 0x3FFF) != 0) {
+            return 0;
+        }
+        const std::size_t udp = 14 + ihl;
+        if (n < udp + 8 || read16(frame + udp + 2) != port) {
+            return 0;
+        }
+        const std::size_t length = read16(frame + udp + 4);
+        if (length < 8 || udp + length > n) {
+            return 0;
+        }
+        payload = udp + 8;
+        return length - 8;
+    }
+
+    /**
+     * @brief Ethernet, IPv4 and UDP headers for a broadcast of `n` bytes.
+     * Both checksums are left zero for the MAC to insert.
+     */
+    void write_header(uint8_t* frame, std::size_t n)
+    {
+        std::memset(frame, 0xFF, 6);
+        std::memcpy(frame + 6, mac.data(), 6);
+        write16(frame + 12, 0x0800);
+
+        uint8_t* ip_header = frame + 14;
+        ip_header[0] = 0x45;
+        ip_header[1] = 0;
+        write16(ip_header + 2, static_cast<uint16_t>(20 + 8 + n));
+        write16(ip_header + 4, sequence++);
+        write16(ip_header + 6, 0x4000); // Don't fragment
+        ip_header[8] = 1;               // Never leaves the LAN
+        ip_header[9] = 17;
+        write16(ip_header + 10, 0);
+        std::memcpy(ip_header + 12, ip.data(), 4);
+        std::memset(ip_header + 16, 0xFF, 4);
+
+        uint8_t* udp = ip_header + 20;
+        write16(udp, port);
+        write16(udp + 2, port);
+        write16(udp + 4, static_cast<uint16_t>(8 + n));
+        write16(udp + 6, 0);
+    }
+
+    void release(uint8_t* buffer)
+    {
+        if (available < RxBuffers) {
+            pool[available++] = buffer;
+        }
+    }
+
+    uint16_t port = 0;
+    uint32_t node = 0;
+    std::array<uint8_t, 6> mac{};
+    std::array<uint8_t, 4> ip{};
+    uint16_t sequence = 0;
+
+    bool started = false;
+    bool up = false;
+    bool checked = false;
+    uint64_t last_link_check = 0;
+    std::atomic<uint32_t> stamp{ 0 };
+
+    alignas(32) std::array<std::array<uint8_t, buffer_bytes>, RxBuffers> rx{};
+    std::array<uint8_t*, RxBuffers> pool{};
+    std::size_t available = 0;
+    std::size_t rx_length = 0;
+
+    ETH_TxPacketConfigTypeDef tx_config = {};
+    alignas(32) std::array<std::array<uint8_t, 128>, TxFrames> tx{};
+    std::array<bool, TxFrames> in_flight{};
+    std::size_t next_tx = 0;
+};
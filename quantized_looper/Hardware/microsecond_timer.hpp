@@ -0,0 +1,81 @@
+/**
+ * @file microsecond_timer.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Free-running 32-bit microsecond counter on TIM2.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <cstdint>
+
+// Hardware includes
+#include <stm32f7xx.h>
+#include <stm32f7xx_hal.h>
+
+/**
+ * @brief Timestamps at 1 us resolution from TIM2, one of the two 32-bit
+ * timers, prescaled to 1 MHz.
+ *
+ * The counter wraps every 71 minutes, so the difference of two reads is
+ * exact for anything shorter. Reading it is a single load from the timer
+ * register, cheap enough for the first instruction of an ISR.
+ *
+ * The user button (PC13) has no timer channel, so it cannot be captured by
+ * the timer in hardware; its EXTI handler reads the counter on entry
+ * instead. The entry latency is a fixed few dozen core cycles, well under a
+ * microsecond, and cancels out of the intervals between taps. A footswitch
+ * on a TIM2 channel pin can use capture() to read the hardware capture
+ * register instead.
+ */
+class microsecond_timer
+{
+public:
+    /**
+     * @brief Start TIM2 counting microseconds from zero. Call after the
+     * clock tree is configured.
+     */
+    static void enable()
+    {
+        __HAL_RCC_TIM2_CLK_ENABLE();
+
+        // APB1 timers run at twice PCLK1 whenever APB1 is divided
+        uint32_t clock = HAL_RCC_GetPCLK1Freq();
+        if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+            clock *= 2;
+        }
+
+        TIM2->CR1 = 0;
+        TIM2->PSC = clock / 1000000 - 1;
+        TIM2->ARR = 0xFFFFFFFF;
+        TIM2->CNT = 0;
+        // Load the prescaler now rather than at the first overflow
+        TIM2->EGR = TIM_EGR_UG;
+        TIM2->CR1 = TIM_CR1_CEN;
+    }
+
+    static uint32_t now() { return TIM2->CNT; }
+
+    /**
+     * @brief Arm input capture of rising edges on a TIM2 channel, 1 to 4.
+     * The pin must already be in its TIM2 alternate function.
+     */
+    static void enable_capture(uint32_t channel)
+    {
+        uint32_t shift = 8 * ((channel - 1) % 2);
+        volatile uint32_t& ccmr = channel <= 2 ? TIM2->CCMR1 : TIM2->CCMR2;
+        // CCxS = 01: capture from the channel's own input, with the
+        // longest input filter to reject contact bounce at the edge
+        ccmr = (ccmr & ~(0xFFu << shift)) | ((0x1u | (0xFu << 4)) << shift);
+        TIM2->CCER |= TIM_CCER_CC1E << (4 * (channel - 1));
+    }
+
+    /**
+     * @brief Timestamp of the last captured edge on a channel.
+     */
+    static uint32_t capture(uint32_t channel)
+    {
+        return (&TIM2->CCR1)[channel - 1];
+    }
+};
@@ -0,0 +1,254 @@
+/**
+ * @file midi_uart.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief MIDI on USART6 with DMA in both directions and timestamped clocks.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Quantized looper includes
+#include <quantized_looper/Hardware/microsecond_timer.hpp>
+#include <quantized_looper/Software/midi_clock.hpp>
+#include <quantized_looper/Software/spsc_ring.hpp>
+
+// Hardware includes
+#include <main.h>
+#include <stm32f7xx_hal.h>
+
+/**
+ * @brief MIDI in and out at 31250 baud on USART6, without the CPU waiting
+ * on a byte in either direction. Pins on the Nucleo-F767ZI:
+ *
+ *   PG14 USART6_TX (D1), PG9 USART6_RX (D0)
+ *
+ * Reception runs on circular DMA; poll() reads whatever has arrived since
+ * its last call. DMA loses the time each byte arrived, which the clock PLL
+ * needs, so the USART's character match interrupt fires on every clock
+ * byte and timestamps it on microsecond_timer. The match is flagged as the
+ * byte completes, a fixed latency that cancels out of clock intervals.
+ * Errors are not enabled as interrupts, so line noise never stops the DMA;
+ * a bad byte is just a bad byte.
+ *
+ * Transmission queues bytes in a ring and sends them by DMA in chunks,
+ * starting the next chunk from the transfer complete callback, so send()
+ * returns at once, unlike HAL_UART_Transmit.
+ *
+ * The DMA streams are DMA2 stream 2 (RX) and stream 6 (TX), channel 5,
+ * clear of the SAI audio streams.
+ *
+ * @tparam RxBytes Receive ring in bytes; a multiple of the cache line.
+ * @tparam TxBytes Transmit queue in bytes; a power of two.
+ */
+template<std::size_t RxBytes = 64, std::size_t TxBytes = 64>
+class midi_uart
+{
+    static_assert(RxBytes % 32 == 0, "The receive ring is whole cache lines");
+
+public:
+    static constexpr uint32_t baud_rate = 31250;
+
+    /**
+     * @brief Set up clocks, pins, the USART and its DMA streams.
+     *
+     * @param irq_priority NVIC pre-emption priority of the USART and DMA
+     * interrupts
+     */
+    void init(uint32_t irq_priority = 2)
+    {
+        __HAL_RCC_USART6_CLK_ENABLE();
+        __HAL_RCC_GPIOG_CLK_ENABLE();
+        __HAL_RCC_DMA2_CLK_ENABLE();
+
+        GPIO_InitTypeDef pins = {};
+        pins.Pin = GPIO_PIN_9 | GPIO_PIN_14;
+        pins.Mode = GPIO_MODE_AF_PP;
+        pins.Pull = GPIO_PULLUP;
+        pins.Speed = GPIO_SPEED_FREQ_LOW;
+        pins.Alternate = GPIO_AF8_USART6;
+        HAL_GPIO_Init(GPIOG, &pins);
+
+        configure_dma(rx_dma, DMA2_Stream2, DMA_PERIPH_TO_MEMORY, DMA_CIRCULAR);
+        configure_dma(tx_dma, DMA2_Stream6, DMA_MEMORY_TO_PERIPH, DMA_NORMAL);
+        uart.hdmarx = &rx_dma;
+        uart.hdmatx = &tx_dma;
+
+        // As MX_USART3_UART_Init, at the MIDI rate; an overrun must not
+        // stop reception
+        uart.Instance = USART6;
+        uart.Init.BaudRate = baud_rate;
+        uart.Init.WordLength = UART_WORDLENGTH_8B;
+        uart.Init.StopBits = UART_STOPBITS_1;
+        uart.Init.Parity = UART_PARITY_NONE;
+        uart.Init.Mode = UART_MODE_TX_RX;
+        uart.Init.HwFlowCtl = UART_HWCONTROL_NONE;
+        uart.Init.OverSampling = UART_OVERSAMPLING_16;
+        uart.Init.OneBitSampling = UART_ONE_BIT_SAMPLE_DISABLE;
+        uart.AdvancedInit.AdvFeatureInit =
+          UART_ADVFEATURE_RXOVERRUNDISABLE_INIT;
+        uart.AdvancedInit.OverrunDisable = UART_ADVFEATURE_OVERRUN_DISABLE;
+        if (HAL_UART_Init(&uart) != HAL_OK) {
+            Error_Handler();
+        }
+
+        // Match the clock byte; the address field is only written with the
+        // USART disabled, and ADDM7 compares all its bits
+        __HAL_UART_DISABLE(&uart);
+        USART6->CR2 =
+          (USART6->CR2 & ~USART_CR2_ADD_Msk) | USART_CR2_ADDM7 |
+          (static_cast<uint32_t>(midi_realtime::clock) << USART_CR2_ADD_Pos);
+        __HAL_UART_ENABLE(&uart);
+
+        HAL_NVIC_SetPriority(USART6_IRQn, irq_priority, 0);
+        HAL_NVIC_EnableIRQ(USART6_IRQn);
+        HAL_NVIC_SetPriority(DMA2_Stream6_IRQn, irq_priority, 0);
+        HAL_NVIC_EnableIRQ(DMA2_Stream6_IRQn);
+    }
+
+    /**
+     * @brief Start receiving. The receive DMA's own interrupts are never
+     * enabled in the NVIC; poll() reads its position instead.
+     */
+    void start()
+    {
+        HAL_UART_Receive_DMA(&uart, rx.data(), RxBytes);
+        // HAL enables error interrupts for DMA reception and aborts it on
+        // the first one
+        CLEAR_BIT(USART6->CR1, USART_CR1_PEIE);
+        CLEAR_BIT(USART6->CR3, USART_CR3_EIE);
+        SET_BIT(USART6->CR1, USART_CR1_CMIE);
+    }
+
+    /**
+     * @brief Hand every byte received since the last call to `receive`,
+     * with its arrival time for clock bytes and 0 for the rest.
+     *
+     * Call often enough that the ring cannot fill in between: 64 bytes last
+     * 20 ms at the MIDI rate.
+     */
+    template<typename Receive>
+    void poll(Receive&& receive)
+    {
+        SCB_InvalidateDCache_by_Addr(reinterpret_cast<uint32_t*>(rx.data()),
+                                     RxBytes);
+        const std::size_t head = RxBytes - __HAL_DMA_GET_COUNTER(&rx_dma);
+        while (tail != head) {
+            uint8_t byte = rx[tail];
+            uint32_t stamp = 0;
+            if (byte == static_cast<uint8_t>(midi_realtime::clock) &&
+                !stamps.try_pop(stamp)) {
+                // Its match interrupt has not run yet; take it next time
+                return;
+            }
+            receive(byte, stamp);
+            tail = (tail + 1) % RxBytes;
+        }
+    }
+
+    /**
+     * @brief Queue a byte for transmission and start sending if idle.
+     * Main context only.
+     *
+     * @return false if the queue is full
+     */
+    bool send(uint8_t byte)
+    {
+        if (!queue.try_push(byte)) {
+            return false;
+        }
+        kick();
+        return true;
+    }
+
+    /**
+     * @brief Call from USART6_IRQHandler.
+     */
+    void irq()
+    {
+        if (USART6->ISR & USART_ISR_CMF) {
+            uint32_t now = microsecond_timer::now();
+            USART6->ICR = USART_ICR_CMCF;
+            stamps.try_push(now);
+        }
+        HAL_UART_IRQHandler(&uart);
+    }
+
+    /**
+     * @brief Call from DMA2_Stream6_IRQHandler.
+     */
+    void tx_dma_irq() { HAL_DMA_IRQHandler(&tx_dma); }
+
+    /**
+     * @brief Call from HAL_UART_TxCpltCallback for this UART.
+     */
+    void tx_complete()
+    {
+        busy.store(false, std::memory_order_release);
+        kick();
+    }
+
+    UART_HandleTypeDef* handle() { return &uart; }
+
+private:
+    void configure_dma(DMA_HandleTypeDef& dma,
+                       DMA_Stream_TypeDef* stream,
+                       uint32_t direction,
+                       uint32_t mode)
+    {
+        dma.Instance = stream;
+        dma.Init.Channel = DMA_CHANNEL_5;
+        dma.Init.Direction = direction;
+        dma.Init.PeriphInc = DMA_PINC_DISABLE;
+        dma.Init.MemInc = DMA_MINC_ENABLE;
+        dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+        dma.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+        dma.Init.Mode = mode;
+        dma.Init.Priority = DMA_PRIORITY_MEDIUM;
+        dma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+        dma.Parent = &uart;
+        if (HAL_DMA_Init(&dma) != HAL_OK) {
+            Error_Handler();
+        }
+    }
+
+    /**
+     * @brief Send the next chunk of the queue unless a transfer is running.
+     * The busy flag makes the main context and the completion interrupt
+     * take turns as the queue's consumer.
+     */
+    void kick()
+    {
+        if (busy.exchange(true, std::memory_order_acquire)) {
+            return;
+        }
+        std::size_t n = 0;
+        while (n < tx.size() && queue.try_pop(tx[n])) {
+            ++n;
+        }
+        if (n == 0) {
+            busy.store(false, std::memory_order_release);
+            return;
+        }
+        SCB_CleanDCache_by_Addr(reinterpret_cast<uint32_t*>(tx.data()),
+                                tx.size());
+        HAL_UART_Transmit_DMA(&uart, tx.data(), static_cast<uint16_t>(n));
+    }
+
+    UART_HandleTypeDef uart = {};
+    DMA_HandleTypeDef rx_dma = {};
+    DMA_HandleTypeDef tx_dma = {};
+
+    alignas(32) std::array<uint8_t, RxBytes> rx{};
+    alignas(32) std::array<uint8_t, 32> tx{};
+    std::size_t tail = 0;
+
+    spsc_ring<uint32_t, 16> stamps;
+    spsc_ring<uint8_t, TxBytes> queue;
+    std::atomic<bool> busy{ false };
+};
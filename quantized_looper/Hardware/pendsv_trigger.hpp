@@ -0,0 +1,44 @@
+/**
+ * @file pendsv_trigger.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief PendSV as the software interrupt of an interrupt_executor.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <cstdint>
+
+// Hardware includes
+#include <stm32f7xx.h>
+#include <stm32f7xx_hal.h>
+
+/**
+ * @brief Requests PendSV, for an interrupt_executor to run its jobs from
+ * PendSV_Handler.
+ *
+ * PendSV takes no peripheral and can be pended from thread mode or any
+ * handler. Pended from an interrupt it tail-chains once that returns, if
+ * nothing more urgent is pending; pended from thread mode it is taken
+ * straight away.
+ */
+struct pendsv_trigger
+{
+    /**
+     * @brief Set PendSV's pre-emption priority. It must be below every
+     * interrupt the foreground jobs must not hold up, e.g. the codec DMA.
+     */
+    static void enable(uint32_t irq_priority = 14)
+    {
+        HAL_NVIC_SetPriority(PendSV_IRQn, irq_priority, 0);
+    }
+
+    static void pend()
+    {
+        SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+        // Taken before the next instruction in thread mode
+        __DSB();
+        __ISB();
+    }
+};
@@ -0,0 +1,218 @@
+/**
+ * @file sai_audio.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief SAI1 I2S codec interface with circular DMA.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Quantized looper includes
+#include <quantized_looper/Audio/audio_io.hpp>
+
+// Hardware includes
+#include <main.h>
+#include <stm32f7xx_hal.h>
+
+/**
+ * @brief Full-duplex I2S on SAI1 with both directions on circular DMA.
+ *
+ * Block A is the master transmitter and drives MCLK/SCK/FS, block B receives
+ * synchronously from the same clocks. Pins on the Nucleo-F767ZI:
+ *
+ *   PE2 SAI1_MCLK_A, PE3 SAI1_SD_B, PE4 SAI1_FS_A, PE5 SAI1_SCK_A, PE6 SAI1_SD_A
+ *
+ * The HAL SAI driver is not part of this CubeMX project, so the SAI blocks are
+ * set up at register level; DMA goes through the HAL DMA driver. The receive
+ * stream's half/complete interrupts pace the audio_io callbacks: capture lags
+ * playback by the SAI FIFO depth and the skew between the two DMA starts, so
+ * only the receive interrupt says a whole capture half has landed. By then
+ * transmission is those few frames into the other half, and the half just
+ * captured is also the one it has finished sending.
+ *
+ * The SAI kernel clock comes from PLLSAI: 2 MHz * 344 / 7 / 1 = 98.29 MHz, and
+ * MCKDIV 4 gives MCLK = 12.286 MHz = 256 * 47.99 kHz.
+ *
+ * @tparam Sample int16_t for 16-bit or int32_t for 32-bit slots.
+ * @tparam BlockFrames Frames per half buffer.
+ */
+template<typename Sample, std::size_t BlockFrames>
+class sai_audio : public audio_io<Sample, BlockFrames, 2>
+{
+    static_assert(std::is_same_v<Sample, int16_t> ||
+                    std::is_same_v<Sample, int32_t>,
+                  "SAI transfers 16 or 32-bit samples");
+
+    using base = audio_io<Sample, BlockFrames, 2>;
+
+public:
+    /**
+     * @brief Set up clocks, pins, both SAI blocks and their DMA streams.
+     *
+     * @param irq_priority NVIC pre-emption priority of the DMA interrupts
+     */
+    void init(uint32_t irq_priority = 1)
+    {
+        RCC_PeriphCLKInitTypeDef clock = {};
+        clock.PeriphClockSelection = RCC_PERIPHCLK_SAI1;
+        clock.Sai1ClockSelection = RCC_SAI1CLKSOURCE_PLLSAI;
+        clock.PLLSAI.PLLSAIN = 344;
+        clock.PLLSAI.PLLSAIQ = 7;
+        clock.PLLSAI.PLLSAIP = RCC_PLLSAIP_DIV8;
+        clock.PLLSAIDivQ = 1;
+        if (HAL_RCCEx_PeriphCLKConfig(&clock) != HAL_OK) {
+            Error_Handler();
+        }
+
+        __HAL_RCC_SAI1_CLK_ENABLE();
+        __HAL_RCC_GPIOE_CLK_ENABLE();
+        __HAL_RCC_DMA2_CLK_ENABLE();
+
+        GPIO_InitTypeDef pins = {};
+        pins.Pin =
+          GPIO_PIN_2 | GPIO_PIN_3 | GPIO_PIN_4 | GPIO_PIN_5 | GPIO_PIN_6;
+        pins.Mode = GPIO_MODE_AF_PP;
+        pins.Pull = GPIO_NOPULL;
+        pins.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+        pins.Alternate = GPIO_AF6_SAI1;
+        HAL_GPIO_Init(GPIOE, &pins);
+
+        configure_block(SAI1_Block_A, 0);
+        configure_block(SAI1_Block_B, SAI_xCR1_MODE_0 | SAI_xCR1_MODE_1 |
+                                        SAI_xCR1_SYNCEN_0 | SAI_xCR1_CKSTR);
+
+        // SAI1_A: DMA2 stream 1 channel 0, SAI1_B: DMA2 stream 5 channel 0
+        configure_dma(tx_dma, DMA2_Stream1, DMA_MEMORY_TO_PERIPH);
+        configure_dma(rx_dma, DMA2_Stream5, DMA_PERIPH_TO_MEMORY);
+        rx_dma.XferHalfCpltCallback = rx_half_complete;
+        rx_dma.XferCpltCallback = rx_complete;
+
+        HAL_NVIC_SetPriority(DMA2_Stream1_IRQn, irq_priority, 0);
+        HAL_NVIC_EnableIRQ(DMA2_Stream1_IRQn);
+        HAL_NVIC_SetPriority(DMA2_Stream5_IRQn, irq_priority, 0);
+        HAL_NVIC_EnableIRQ(DMA2_Stream5_IRQn);
+    }
+
+    /**
+     * @brief Start streaming. Reception is enabled first so it is already
+     * waiting on the frame clock when the master starts it.
+     */
+    void start()
+    {
+        HAL_DMA_Start_IT(&rx_dma,
+                         reinterpret_cast<uint32_t>(&SAI1_Block_B->DR),
+                         reinterpret_cast<uint32_t>(base::rx.data()),
+                         base::buffer_samples());
+        HAL_DMA_Start_IT(&tx_dma,
+                         reinterpret_cast<uint32_t>(base::tx.data()),
+                         reinterpret_cast<uint32_t>(&SAI1_Block_A->DR),
+                         base::buffer_samples());
+
+        SAI1_Block_B->CR1 |= SAI_xCR1_DMAEN | SAI_xCR1_SAIEN;
+        SAI1_Block_A->CR1 |= SAI_xCR1_DMAEN | SAI_xCR1_SAIEN;
+    }
+
+    void stop()
+    {
+        SAI1_Block_A->CR1 &= ~(SAI_xCR1_DMAEN | SAI_xCR1_SAIEN);
+        SAI1_Block_B->CR1 &= ~(SAI_xCR1_DMAEN | SAI_xCR1_SAIEN);
+        HAL_DMA_Abort(&tx_dma);
+        HAL_DMA_Abort(&rx_dma);
+    }
+
+    /**
+     * @brief Forward to HAL_DMA_IRQHandler from DMA2_Stream1_IRQHandler.
+     */
+    void tx_irq() { HAL_DMA_IRQHandler(&tx_dma); }
+
+    /**
+     * @brief Forward to HAL_DMA_IRQHandler from DMA2_Stream5_IRQHandler.
+     */
+    void rx_irq() { HAL_DMA_IRQHandler(&rx_dma); }
+
+private:
+    static constexpr bool wide = sizeof(Sample) == sizeof(int32_t);
+
+    void configure_block(SAI_Block_TypeDef* block, uint32_t mode)
+    {
+        block->CR1 &= ~SAI_xCR1_SAIEN;
+        while (block->CR1 & SAI_xCR1_SAIEN) {
+        }
+
+        // Data size 16 (100b) or 32 (111b) bits, MCLK divided by 2 * 4
+        uint32_t data_size =
+          wide ? SAI_xCR1_DS_0 | SAI_xCR1_DS_1 | SAI_xCR1_DS_2 : SAI_xCR1_DS_2;
+        block->CR1 = mode | data_size | (4u << SAI_xCR1_MCKDIV_Pos);
+        block->CR2 = SAI_xCR2_FTH_1; // Half full FIFO threshold
+
+        // I2S framing: 64-bit frame, FS low for the left channel and asserted
+        // one bit before the first data bit
+        block->FRCR = (63u << SAI_xFRCR_FRL_Pos) |
+                      (31u << SAI_xFRCR_FSALL_Pos) | SAI_xFRCR_FSDEF |
+                      SAI_xFRCR_FSOFF;
+
+        // Two 32-bit slots, both active
+        block->SLOTR = SAI_xSLOTR_SLOTSZ_1 | (1u << SAI_xSLOTR_NBSLOT_Pos) |
+                       (0x3u << SAI_xSLOTR_SLOTEN_Pos);
+    }
+
+    void configure_dma(DMA_HandleTypeDef& dma,
+                       DMA_Stream_TypeDef* stream,
+                       uint32_t direction)
+    {
+        dma.Instance = stream;
+        dma.Init.Channel = DMA_CHANNEL_0;
+        dma.Init.Direction = direction;
+        dma.Init.PeriphInc = DMA_PINC_DISABLE;
+        dma.Init.MemInc = DMA_MINC_ENABLE;
+        dma.Init.PeriphDataAlignment =
+          wide ? DMA_PDATAALIGN_WORD : DMA_PDATAALIGN_HALFWORD;
+        dma.Init.MemDataAlignment =
+          wide ? DMA_MDATAALIGN_WORD : DMA_MDATAALIGN_HALFWORD;
+        dma.Init.Mode = DMA_CIRCULAR;
+        dma.Init.Priority = DMA_PRIORITY_HIGH;
+        dma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+        dma.Parent = this;
+        if (HAL_DMA_Init(&dma) != HAL_OK) {
+            Error_Handler();
+        }
+    }
+
+    static void rx_half_complete(DMA_HandleTypeDef* dma)
+    {
+        static_cast<sai_audio*>(dma->Parent)->dispatch_half(0);
+    }
+
+    static void rx_complete(DMA_HandleTypeDef* dma)
+    {
+        static_cast<sai_audio*>(dma->Parent)->dispatch_half(1);
+    }
+
+    void dispatch_half(std::size_t half)
+    {
+        constexpr int32_t half_bytes = base::block_samples * sizeof(Sample);
+        Sample* rx_half = base::rx.data() + half * base::block_samples;
+        Sample* tx_half = base::tx.data() + half * base::block_samples;
+
+        // DMA bypasses the data cache; drop stale lines of the capture half
+        // that just completed before the callback reads them, and push
+        // playback out after it writes
+        SCB_InvalidateDCache_by_Addr(reinterpret_cast<uint32_t*>(rx_half),
+                                     half_bytes);
+        if (half == 0) {
+            base::on_half_complete();
+        } else {
+            base::on_complete();
+        }
+        SCB_CleanDCache_by_Addr(reinterpret_cast<uint32_t*>(tx_half),
+                                half_bytes);
+    }
+
+    DMA_HandleTypeDef tx_dma = {};
+    DMA_HandleTypeDef rx_dma = {};
+};
@@ -0,0 +1,122 @@
+/**
+ * @file timer_clock.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief 64-bit clock on TIM5 that keeps counting while the core sleeps,
+ * with a compare alarm to wake it.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <cstdint>
+
+// Hardware includes
+#include <stm32f7xx.h>
+#include <stm32f7xx_hal.h>
+
+// Quantized looper includes
+#include <quantized_looper/Software/monotonic_clock.hpp>
+
+/**
+ * @brief TIM5, the other 32-bit timer, free-running at the timer clock as a
+ * monotonic_clock source.
+ *
+ * The DWT cycle counter is part of the core and stops with it in WFI, so
+ * it cannot time a sleep. TIM5 is on APB1, which keeps running in Sleep
+ * mode. Unprescaled it counts at the APB1 timer clock, and wraps every
+ * 44 s at 96 MHz.
+ */
+struct tim5_source
+{
+    /**
+     * @brief Start TIM5 counting from zero, with its compare interrupt
+     * ready for the alarm. Call after the clock tree is configured.
+     */
+    static void enable(uint32_t irq_priority = 15)
+    {
+        __HAL_RCC_TIM5_CLK_ENABLE();
+
+        // APB1 timers run at twice PCLK1 whenever APB1 is divided
+        hz = HAL_RCC_GetPCLK1Freq();
+        if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+            hz *= 2;
+        }
+
+        TIM5->CR1 = 0;
+        TIM5->PSC = 0;
+        TIM5->ARR = 0xFFFFFFFF;
+        TIM5->CNT = 0;
+        TIM5->DIER = 0;
+        TIM5->EGR = TIM_EGR_UG;
+        TIM5->SR = 0;
+        TIM5->CR1 = TIM_CR1_CEN;
+
+        HAL_NVIC_SetPriority(TIM5_IRQn, irq_priority, 0);
+        HAL_NVIC_EnableIRQ(TIM5_IRQn);
+    }
+
+    static uint32_t read() { return TIM5->CNT; }
+
+    static uint32_t frequency() { return hz; }
+
+    struct critical_section
+    {
+        critical_section()
+          : primask(__get_PRIMASK())
+        {
+            __disable_irq();
+        }
+
+        ~critical_section() { __set_PRIMASK(primask); }
+
+        uint32_t primask;
+    };
+
+    static inline uint32_t hz = 1;
+};
+
+/**
+ * @brief Timer ticks since tim5_source::enable(), in 64 bits.
+ */
+using timer_clock = monotonic_clock<tim5_source>;
+
+/**
+ * @brief Wake-up alarm on TIM5 channel 1 compare, for tickless_idle.
+ *
+ * The compare only sees the low 32 bits, so an alarm must be less than a
+ * counter wrap away.
+ */
+struct tim5_alarm
+{
+    using critical_section = tim5_source::critical_section;
+
+    static void set(timer_clock::tick_type at)
+    {
+        TIM5->SR = ~TIM_SR_CC1IF;
+        TIM5->CCR1 = static_cast<uint32_t>(at);
+        TIM5->DIER |= TIM_DIER_CC1IE;
+    }
+
+    static void cancel()
+    {
+        TIM5->DIER &= ~TIM_DIER_CC1IE;
+        TIM5->SR = ~TIM_SR_CC1IF;
+    }
+
+    /**
+     * @brief Sleep until an interrupt is pending. With interrupts masked,
+     * it still wakes, and the handler runs once they are unmasked.
+     */
+    static void wait()
+    {
+        __DSB();
+        __WFI();
+    }
+
+    /**
+     * @brief Call from TIM5_IRQHandler. Waking was the point, so there is
+     * nothing left to do but clear the flag.
+     */
+    static void irq() { cancel(); }
+};
@@ -0,0 +1,325 @@
+/**
+ * @file coroutine_task.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Stackless C++20 coroutine tasks on the timer wheel, with frames
+ * from a fixed pool.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <utility>
+
+/**
+ * @brief Fixed storage for coroutine frames, so tasks never touch the heap.
+ *
+ * Each of `Frames` blocks holds one frame of up to `FrameBytes`; a
+ * coroutine whose frame is bigger, or that finds the pool full, is not
+ * created (see co_task). high_water() shows the largest frame asked for,
+ * to size the blocks. Allocation is from task context only.
+ *
+ * @tparam FrameBytes Size of each block
+ * @tparam Frames Number of blocks, at most 32
+ */
+template<std::size_t FrameBytes, std::size_t Frames>
+class frame_pool
+{
+    static_assert(Frames > 0 && Frames <= 32, "free blocks are a 32-bit mask");
+
+public:
+    static void* allocate(std::size_t size)
+    {
+        high = std::max(high, size);
+        const uint32_t free = ~used & all;
+        if (size > FrameBytes || free == 0) {
+            return nullptr;
+        }
+        const auto block = static_cast<std::size_t>(std::countr_zero(free));
+        used |= uint32_t{ 1 } << block;
+        return storage[block].bytes;
+    }
+
+    static void deallocate(void* frame)
+    {
+        const auto* at = static_cast<const block_type*>(frame);
+        used &= ~(uint32_t{ 1 } << (at - storage.data()));
+    }
+
+    /**
+     * @brief Blocks holding a frame.
+     */
+    static std::size_t in_use() { return std::popcount(used); }
+
+    /**
+     * @brief Largest frame asked for, whether or not it fitted.
+     */
+    static std::size_t high_water() { return high; }
+
+    static constexpr std::size_t frame_bytes() { return FrameBytes; }
+
+private:
+    struct block_type
+    {
+        alignas(std::max_align_t) std::byte bytes[FrameBytes];
+    };
+
+    static constexpr uint32_t all =
+      Frames == 32 ? ~uint32_t{ 0 } : (uint32_t{ 1 } << Frames) - 1;
+
+    static inline std::array<block_type, Frames> storage{};
+    static inline uint32_t used = 0;
+    static inline std::size_t high = 0;
+};
+
+/**
+ * @brief What a coroutine task's awaitables need from the scheduler it
+ * runs on, filled in by coroutine_tasks.
+ *
+ * There is one scheduler per tick type, as there is one main loop.
+ */
+template<typename Tick>
+struct coroutine_runtime
+{
+    //! Table index of the coroutine being resumed
+    static inline std::size_t running = 0;
+    //! Run a table entry at a clock time
+    static inline void (*schedule)(std::size_t task, Tick at) = nullptr;
+    static inline Tick (*now)() = nullptr;
+};
+
+/**
+ * @brief `co_await sleep_until(at)`: resume at a clock time. Sleeping until
+ * the last wake-up plus a period keeps a loop on its phase.
+ */
+template<typename Tick>
+struct sleep_until
+{
+    Tick at;
+
+    bool await_ready() const { return false; }
+
+    void await_suspend(std::coroutine_handle<>) const
+    {
+        using runtime = coroutine_runtime<Tick>;
+        runtime::schedule(runtime::running, at);
+    }
+
+    void await_resume() const {}
+};
+
+/**
+ * @brief `co_await sleep_for(ticks)`: resume that long from now.
+ */
+template<typename Tick>
+struct sleep_for
+{
+    Tick ticks;
+
+    bool await_ready() const { return false; }
+
+    void await_suspend(std::coroutine_handle<>) const
+    {
+        using runtime = coroutine_runtime<Tick>;
+        runtime::schedule(runtime::running, runtime::now() + ticks);
+    }
+
+    void await_resume() const {}
+};
+
+/**
+ * @brief `co_await event` suspends a coroutine task until set() is called.
+ *
+ * Setting it wakes every task waiting, by the scheduler's next granule.
+ * Set with nobody waiting, it stays set and the next wait goes straight
+ * through, so a signal between waits is not lost. Set it from tasks only;
+ * an interrupt hands its events to a task through an event_queue.
+ *
+ * @tparam Tick The scheduler's clock ticks
+ */
+template<typename Tick>
+class task_event
+{
+public:
+    void set()
+    {
+        using runtime = coroutine_runtime<Tick>;
+        if (waiters == 0) {
+            signalled = true;
+            return;
+        }
+        const Tick now = runtime::now();
+        for (uint64_t w = std::exchange(waiters, 0); w != 0; w &= w - 1) {
+            runtime::schedule(static_cast<std::size_t>(std::countr_zero(w)),
+                              now);
+        }
+    }
+
+    bool waiting() const { return waiters != 0; }
+
+    bool await_ready() { return std::exchange(signalled, false); }
+
+    void await_suspend(std::coroutine_handle<>)
+    {
+        waiters |= uint64_t{ 1 } << coroutine_runtime<Tick>::running;
+    }
+
+    void await_resume() const {}
+
+private:
+    uint64_t waiters = 0;
+    bool signalled = false;
+};
+
+/**
+ * @brief A coroutine task: the return type of a function written as a loop
+ * that co_awaits sleep_for, sleep_until or a task_event.
+ *
+ * It starts suspended and is run by binding it to a coroutine_tasks entry.
+ * Its frame comes from `Pool`; if that has no room the task is empty, and
+ * tests false. Destroying the task frees the frame.
+ *
+ * @tparam Pool frame_pool the frame comes from
+ */
+template<typename Pool>
+class co_task
+{
+public:
+    struct promise_type
+    {
+        static void* operator new(std::size_t size) noexcept
+        {
+            return Pool::allocate(size);
+        }
+
+        static void operator delete(void* frame) { Pool::deallocate(frame); }
+
+        static co_task get_return_object_on_allocation_failure()
+        {
+            return co_task();
+        }
+
+        co_task get_return_object()
+        {
+            return co_task(
+              std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        // Kept until the task is destroyed, so a finished task is simply
+        // never resumed again
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        void return_void() {}
+
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    co_task() = default;
+
+    co_task(co_task&& other) noexcept
+      : coroutine(std::exchange(other.coroutine, nullptr))
+    {
+    }
+
+    co_task& operator=(co_task&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            coroutine = std::exchange(other.coroutine, nullptr);
+        }
+        return *this;
+    }
+
+    ~co_task() { reset(); }
+
+    explicit operator bool() const { return static_cast<bool>(coroutine); }
+
+    bool done() const { return coroutine && coroutine.done(); }
+
+    std::coroutine_handle<> handle() const { return coroutine; }
+
+private:
+    explicit co_task(std::coroutine_handle<promise_type> coroutine)
+      : coroutine(coroutine)
+    {
+    }
+
+    void reset()
+    {
+        if (coroutine) {
+            coroutine.destroy();
+            coroutine = nullptr;
+        }
+    }
+
+    std::coroutine_handle<promise_type> coroutine;
+};
+
+/**
+ * @brief Runs coroutine tasks as entries of a timer_wheel's task table.
+ *
+ * An entry for a coroutine is a one-shot wheel_task whose function is
+ * `resume<I>`, with I its own index, and whose offset is when it first
+ * runs. Each run resumes the coroutine bound to it, which runs until it
+ * next awaits and reschedules the entry itself; one that finishes is not
+ * run again. Plain function tasks share the table as before.
+ *
+ * @tparam Wheel The timer_wheel
+ */
+template<typename Wheel>
+class coroutine_tasks
+{
+public:
+    using tick_type = typename Wheel::tick_type;
+    using runtime = coroutine_runtime<tick_type>;
+
+    /**
+     * @brief Give the awaitables the wheel to schedule on. Call before it
+     * starts.
+     */
+    static void attach(Wheel& on)
+    {
+        wheel = &on;
+        runtime::schedule = [](std::size_t task, tick_type at) {
+            wheel->schedule(task, at);
+        };
+        runtime::now = [] { return wheel->now(); };
+    }
+
+    /**
+     * @brief Run a coroutine at table entry I; it must outlive the
+     * scheduler.
+     */
+    template<std::size_t I, typename Task>
+    static void bind(const Task& task)
+    {
+        static_assert(I < Wheel::size() && I < 64, "no such table entry");
+        handles[I] = task.handle();
+    }
+
+    /**
+     * @brief The wheel_task function of table entry I.
+     */
+    template<std::size_t I>
+    static void resume()
+    {
+        const std::coroutine_handle<> h = handles[I];
+        if (h && !h.done()) {
+            runtime::running = I;
+            h.resume();
+        }
+    }
+
+private:
+    static inline Wheel* wheel = nullptr;
+    static inline std::array<std::coroutine_handle<>, Wheel::size()> handles{};
+};
@@ -0,0 +1,236 @@
+/**
+ * @file event_queue.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Fixed-capacity queue of timestamped events, posted from anywhere
+ * and taken in time order by one consumer.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Events keyed by sample time, posted from interrupts or the main
+ * loop and taken by the audio callback as their time comes.
+ *
+ * Posting goes through a bounded multi-producer inbox, after Vyukov: each
+ * slot carries a sequence number that says whose turn it is, a producer
+ * claims a slot with one compare-and-swap on the enqueue index and
+ * publishes it by bumping the slot's sequence. An interrupt that preempts
+ * another producer mid-post simply claims the next slot, so nobody ever
+ * disables interrupts or waits on anyone. On the Cortex-M7 the CAS is an
+ * LDREX/STREX pair.
+ *
+ * The consumer moves published events from the inbox into a pending array
+ * kept sorted latest first, so the earliest event is always the last
+ * element: peeking and popping are O(1), and sorting costs a binary search
+ * and a move per insert, paid once per event as it leaves the inbox rather
+ * than in the audio callback's pop. Events due at the same sample come out
+ * in the order they were taken from the inbox.
+ *
+ * Nothing is dropped: when the pending array is full, events wait in the
+ * inbox, and when that is full too, post() fails.
+ *
+ * @tparam Event Payload, copied in and out
+ * @tparam Capacity Events pending at once
+ * @tparam Inbox Posts between two drains; a power of two
+ */
+template<typename Event, std::size_t Capacity, std::size_t Inbox = 32>
+class event_queue
+{
+    static_assert(Capacity > 0, "event_queue needs room for an event");
+    static_assert(Inbox >= 2 && (Inbox & (Inbox - 1)) == 0,
+                  "event_queue inbox must be a power of two");
+    static_assert(std::atomic<std::size_t>::is_always_lock_free,
+                  "event_queue indices must be lock-free");
+
+public:
+    event_queue()
+    {
+        for (std::size_t i = 0; i < Inbox; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    event_queue(event_queue const&) = delete;
+    void operator=(event_queue const&) = delete;
+
+    /**
+     * @brief Queue an event. Safe from any context, including several
+     * interrupts at once.
+     *
+     * @param at Sample time the event is due
+     * @param event Payload
+     * @return false if the inbox is full
+     */
+    bool post(uint64_t at, const Event& event)
+    {
+        std::size_t pos = enqueue.load(std::memory_order_relaxed);
+        for (;;) {
+            cell& c = cells[pos & mask];
+            const std::size_t seq = c.sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<std::ptrdiff_t>(seq - pos);
+            if (lag == 0) {
+                if (enqueue.compare_exchange_weak(
+                      pos, pos + 1, std::memory_order_relaxed)) {
+                    c.value = { at, event };
+                    c.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false;
+            } else {
+                pos = enqueue.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Move posted events into time order. Consumer only; pop_due()
+     * and next_due() call it.
+     *
+     * @return Events still waiting in the inbox because pending is full
+     */
+    std::size_t drain()
+    {
+        while (count < Capacity) {
+            cell& c = cells[dequeue & mask];
+            const std::size_t seq = c.sequence.load(std::memory_order_acquire);
+            if (seq != dequeue + 1) {
+                // Empty, or a producer has claimed the slot and not yet
+                // filled it; the rest waits for the next drain
+                return 0;
+            }
+            insert(c.value);
+            c.sequence.store(dequeue + Inbox, std::memory_order_release);
+            ++dequeue;
+        }
+        return enqueue.load(std::memory_order_relaxed) - dequeue;
+    }
+
+    /**
+     * @brief Hand every event due by `now` to `fire`, earliest first.
+     * Consumer only.
+     *
+     * @param now The current sample time
+     * @param fire Callable as fire(at, event)
+     * @return Events fired
+     */
+    template<typename Fire>
+    std::size_t pop_due(uint64_t now, Fire&& fire)
+    {
+        drain();
+        std::size_t n = 0;
+        while (count > 0 && pending[count - 1].at <= now) {
+            const item due = pending[--count];
+            fire(due.at, due.event);
+            ++n;
+            // Firing may post; anything due already goes out this call
+            drain();
+        }
+        return n;
+    }
+
+    /**
+     * @brief Take the earliest event if it is due. Consumer only.
+     *
+     * @return false if nothing is due by `now`
+     */
+    bool pop(uint64_t now, Event& event)
+    {
+        drain();
+        if (count == 0 || pending[count - 1].at > now) {
+            return false;
+        }
+        event = pending[--count].event;
+        return true;
+    }
+
+    /**
+     * @brief When the earliest pending event is due, e.g. to cut an audio
+     * block there. Consumer only.
+     *
+     * @return false if nothing is pending
+     */
+    bool next_due(uint64_t& at)
+    {
+        drain();
+        if (count == 0) {
+            return false;
+        }
+        at = pending[count - 1].at;
+        return true;
+    }
+
+    /**
+     * @brief Drop pending events matching a predicate. Consumer only; posts
+     * still in the inbox are drained first, so a cancel always covers
+     * everything posted before it.
+     *
+     * @return Events removed
+     */
+    template<typename Pred>
+    std::size_t cancel_if(Pred&& pred)
+    {
+        drain();
+        auto end = std::remove_if(
+          pending.begin(), pending.begin() + count, [&](const item& i) {
+              return pred(i.event);
+          });
+        const auto left = static_cast<std::size_t>(end - pending.begin());
+        const std::size_t removed = count - left;
+        count = left;
+        return removed;
+    }
+
+    /**
+     * @brief Events sorted and pending; posts in the inbox are not counted.
+     */
+    std::size_t pending_count() const { return count; }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    static constexpr std::size_t mask = Inbox - 1;
+    static constexpr std::size_t cache_line = 64;
+
+    struct item
+    {
+        uint64_t at;
+        Event event;
+    };
+
+    struct cell
+    {
+        std::atomic<std::size_t> sequence;
+        item value;
+    };
+
+    /**
+     * @brief Place an event ahead of everything due no later, so it pops
+     * after them.
+     */
+    void insert(const item& i)
+    {
+        auto begin = pending.begin();
+        auto end = begin + count;
+        auto at = std::lower_bound(
+          begin, end, i.at, [](const item& p, uint64_t t) { return p.at > t; });
+        std::move_backward(at, end, end + 1);
+        *at = i;
+        ++count;
+    }
+
+    alignas(cache_line) std::atomic<std::size_t> enqueue{ 0 };
+    alignas(cache_line) std::size_t dequeue = 0;
+    std::array<cell, Inbox> cells{};
+
+    std::array<item, Capacity> pending{};
+    std::size_t count = 0;
+};
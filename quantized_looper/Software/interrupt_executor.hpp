@@ -0,0 +1,101 @@
+/**
+ * @file interrupt_executor.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Time-critical jobs run from a software interrupt, ahead of the
+ * cooperative task loop.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief The foreground tier of a two-level executor: jobs posted here run
+ * from an interrupt, preempting whichever background task the scheduler
+ * loop is in, however long it takes or blocks.
+ *
+ * Posting sets the job's pending bit and requests the interrupt; its
+ * handler calls run(), which takes the lowest pending job first until
+ * none is left, so the job table is in priority order. A job posted again
+ * before it runs still runs once, and one posted while the foreground is
+ * running, including by a job, runs before the interrupt returns. post()
+ * may be called from any context, at any priority.
+ *
+ * Interrupts above the trigger's priority, like the codec DMA, preempt
+ * the jobs in turn. Anything a job shares with the background tasks needs
+ * the same care as data shared with an interrupt handler.
+ *
+ * A Trigger provides `static void pend()`, which requests the interrupt;
+ * pendsv_trigger on the target.
+ *
+ * @tparam Trigger The software interrupt
+ * @tparam Jobs Number of jobs, at most 32
+ */
+template<typename Trigger, std::size_t Jobs>
+class interrupt_executor
+{
+    static_assert(Jobs > 0 && Jobs <= 32, "pending jobs are a 32-bit mask");
+
+public:
+    using job_type = void (*)();
+
+    /**
+     * @brief Construct an executor over a job table.
+     *
+     * @param jobs Jobs, highest priority first
+     */
+    explicit interrupt_executor(const std::array<job_type, Jobs>& jobs)
+      : jobs(jobs)
+    {
+    }
+
+    /**
+     * @brief Ask for a job to run in the foreground.
+     *
+     * @param job Index in the table
+     */
+    void post(std::size_t job)
+    {
+        pending.fetch_or(uint32_t{ 1 } << job, std::memory_order_release);
+        Trigger::pend();
+    }
+
+    /**
+     * @brief Run every pending job. Call from the trigger's handler.
+     *
+     * @return Number of jobs run
+     */
+    uint32_t run()
+    {
+        uint32_t count = 0;
+        uint32_t bits;
+        while ((bits = pending.load(std::memory_order_acquire)) != 0) {
+            const auto job = static_cast<std::size_t>(std::countr_zero(bits));
+            pending.fetch_and(~(uint32_t{ 1 } << job),
+                              std::memory_order_acq_rel);
+            jobs[job]();
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Whether any job is waiting to run.
+     */
+    bool busy() const
+    {
+        return pending.load(std::memory_order_relaxed) != 0;
+    }
+
+    static constexpr std::size_t size() { return Jobs; }
+
+private:
+    std::array<job_type, Jobs> jobs;
+    std::atomic<uint32_t> pending{ 0 };
+};
@@ -0,0 +1,209 @@
+/**
+ * @file midi_clock.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief MIDI clock reception into a tempo, and transmission from a
+ * transport.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <cstdint>
+
+// Quantized looper includes
+#include <quantized_looper/Software/tempo_pll.hpp>
+
+/**
+ * @brief The MIDI system real-time bytes that run a clock.
+ *
+ * Real-time messages are single bytes that may appear anywhere in the
+ * stream, even between the bytes of another message, so they can be picked
+ * out without parsing anything else.
+ */
+enum class midi_realtime : uint8_t
+{
+    clock = 0xF8,  //!< 24 per quarter note
+    start = 0xFA,  //!< Play from the top; the next clock is the first beat
+    resume = 0xFB, //!< Continue from where it stopped
+    stop = 0xFC
+};
+
+/**
+ * @brief Clocks per quarter note, fixed by the MIDI specification.
+ */
+inline constexpr uint32_t midi_ppqn = 24;
+
+/**
+ * @brief Follows an incoming MIDI clock.
+ *
+ * Every clock byte, with the time it arrived, goes through a tempo_pll, so
+ * the beat period stays steady under the jitter of USB and UART links. The
+ * clock counts as present while pulses keep arriving, and it keeps its
+ * tempo through stops, since senders usually keep clocking while stopped.
+ */
+class midi_clock_in
+{
+public:
+    /**
+     * @brief Construct a new MIDI clock receiver
+     *
+     * @param min_beat_us Shortest beat accepted
+     * @param max_beat_us Longest beat accepted
+     */
+    midi_clock_in(uint32_t min_beat_us, uint32_t max_beat_us)
+      : pll(min_beat_us / midi_ppqn, max_beat_us / midi_ppqn)
+      , timeout_us(2 * max_beat_us / midi_ppqn)
+    {
+    }
+
+    /**
+     * @brief Take one received byte; anything but clock real-time messages
+     * is ignored.
+     *
+     * @param byte Received byte
+     * @param now_us When it arrived, from a free-running microsecond counter
+     */
+    void receive(uint8_t byte, uint32_t now_us)
+    {
+        switch (static_cast<midi_realtime>(byte)) {
+            case midi_realtime::clock:
+                pll.pulse(now_us);
+                last_pulse = now_us;
+                heard = true;
+                if (playing) {
+                    ++count;
+                }
+                break;
+            case midi_realtime::start:
+                playing = true;
+                count = 0;
+                break;
+            case midi_realtime::resume:
+                playing = true;
+                break;
+            case midi_realtime::stop:
+                playing = false;
+                break;
+            default:
+                break;
+        }
+    }
+
+    /**
+     * @brief Whether a locked clock is arriving, i.e. whether to follow it.
+     *
+     * @param now_us The current time on the receive timestamps' counter
+     */
+    bool present(uint32_t now_us) const
+    {
+        return heard && pll.locked() && now_us - last_pulse <= timeout_us;
+    }
+
+    /**
+     * @brief Beat period in microseconds, Q24.8.
+     */
+    uint32_t period_q8() const
+    {
+        return static_cast<uint32_t>(
+          (pll.period_q16() * midi_ppqn + (1 << 7)) >> 8);
+    }
+
+    /**
+     * @brief Beat period rounded to whole microseconds.
+     */
+    uint32_t period_us() const
+    {
+        return static_cast<uint32_t>(
+          (pll.period_q16() * midi_ppqn + (1 << 15)) >> 16);
+    }
+
+    /**
+     * @brief Whether the sender is playing, between Start or Continue and
+     * Stop.
+     */
+    bool running() const { return playing; }
+
+    /**
+     * @brief Clocks received while playing since the last Start.
+     */
+    uint32_t pulses() const { return count; }
+
+private:
+    tempo_pll pll;
+    uint32_t timeout_us;
+    uint32_t last_pulse = 0;
+    uint32_t count = 0;
+    bool heard = false;
+    bool playing = false;
+};
+
+/**
+ * @brief Sends MIDI clock for a transport's tempo.
+ *
+ * poll() is given the transport's current position and sends a clock for
+ * every 24th of a beat passed since the last call. The clocks follow the
+ * transport's beat grid, so they stay locked to the loops through tempo
+ * changes, and are late by at most one polling interval. If polling stalls
+ * for more than a beat, the missed clocks are dropped rather than sent in
+ * a burst.
+ *
+ * @tparam Transport The transport it follows, for its position type and
+ * resolution.
+ */
+template<typename Transport>
+class midi_clock_out
+{
+    static_assert(Transport::ppqn % midi_ppqn == 0,
+                  "The transport must resolve every MIDI clock");
+
+public:
+    static constexpr uint32_t ticks_per_clock = Transport::ppqn / midi_ppqn;
+
+    /**
+     * @brief Send the clocks due at a position.
+     *
+     * @param now Transport position
+     * @param send Called with each byte to transmit
+     */
+    template<typename Send>
+    void poll(const typename Transport::position& now, Send&& send)
+    {
+        uint64_t current = now.beats * midi_ppqn + now.tick / ticks_per_clock;
+        if (!started || current > next + midi_ppqn) {
+            // Nothing sent yet, or too late to catch up: the next clock
+            // is the following one
+            started = true;
+            next = current + 1;
+            return;
+        }
+        for (; next <= current; ++next) {
+            if (start_pending && next % midi_ppqn == 0) {
+                send(static_cast<uint8_t>(midi_realtime::start));
+                start_pending = false;
+            }
+            send(static_cast<uint8_t>(midi_realtime::clock));
+        }
+    }
+
+    /**
+     * @brief Send Start just before the clock on the next beat, so
+     * receivers start on the beat.
+     */
+    void start() { start_pending = true; }
+
+    /**
+     * @brief Send Stop now. Clocks carry on, so receivers keep the tempo.
+     */
+    template<typename Send>
+    void stop(Send&& send)
+    {
+        start_pending = false;
+        send(static_cast<uint8_t>(midi_realtime::stop));
+    }
+
+private:
+    uint64_t next = 0;
+    bool started = false;
+    bool start_pending = false;
+};
@@ -0,0 +1,87 @@
+/**
+ * @file monotonic_clock.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief 64-bit monotonic clock extended from a wrapping 32-bit counter.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <cstdint>
+
+/**
+ * @brief A 64-bit tick count that never wraps in practice, from a 32-bit
+ * hardware counter that does.
+ *
+ * Each read compares the counter with the previous read and carries into
+ * the high word when it has gone backwards, so the clock stays exact as long
+ * as it is read at least once per counter wrap. The extension runs inside
+ * the Source's critical section, so reads from interrupts and the main loop
+ * cannot carry twice.
+ *
+ * The clock is all static so that now() can be handed to anything taking a
+ * plain tick function, the way HAL_GetTick is.
+ *
+ * A Source provides:
+ *  - `static uint32_t read()`, the free-running counter;
+ *  - `static uint32_t frequency()`, its rate in Hz;
+ *  - `critical_section`, an RAII type that keeps now() from being
+ *    interrupted by another now().
+ *
+ * @tparam Source Counter the clock extends.
+ */
+template<typename Source>
+class monotonic_clock
+{
+public:
+    using tick_type = uint64_t;
+
+    /**
+     * @brief Ticks since the counter started.
+     */
+    static tick_type now()
+    {
+        [[maybe_unused]] typename Source::critical_section lock;
+        uint32_t low = Source::read();
+        if (low < last_low) {
+            ++high;
+        }
+        last_low = low;
+        return (static_cast<tick_type>(high) << 32) | low;
+    }
+
+    static tick_type microseconds(uint64_t us)
+    {
+        return us * Source::frequency() / 1000000;
+    }
+
+    static tick_type milliseconds(uint64_t ms)
+    {
+        return ms * Source::frequency() / 1000;
+    }
+
+    /**
+     * @brief Ticks to microseconds, rounded down.
+     */
+    static uint64_t to_microseconds(tick_type ticks)
+    {
+        // Split so the multiply cannot overflow for any 64-bit tick count
+        uint64_t f = Source::frequency();
+        return ticks / f * 1000000 + ticks % f * 1000000 / f;
+    }
+
+    /**
+     * @brief Forget the extension state, e.g. after restarting the counter.
+     */
+    static void reset()
+    {
+        [[maybe_unused]] typename Source::critical_section lock;
+        high = 0;
+        last_low = 0;
+    }
+
+private:
+    static inline uint32_t high = 0;
+    static inline uint32_t last_low = 0;
+};
@@ -0,0 +1,460 @@
+/**
+ * @file net_sync.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Tempo, beat phase and start/stop shared between loopers over any
+ * datagram link.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Timing of a net_sync node; positions are Q40.24 beats.
+ */
+struct net_sync_config
+{
+    uint32_t beacon_interval_us = 50000;
+    uint32_t ping_interval_us = 100000;
+    uint32_t leader_timeout_us = 1000000;
+    //! Beats over which a phase error is steered out
+    uint32_t steer_beats = 1;
+    //! Errors larger than this jump rather than steer
+    int64_t jump = (int64_t{ 1 } << 24) / 16;
+};
+
+/**
+ * @brief One looper's end of a shared timeline: the leader broadcasts its
+ * tempo and beat position, and every other node steers its own transport
+ * onto it.
+ *
+ * Positions are beats since a shared origin in Q40.24, and times are each
+ * node's own free-running microsecond clock. Three datagrams carry
+ * everything:
+ *  - beacon, broadcast by the leader: its time, its position at that time,
+ *    its beat period in ns, and whether it is running since which beat.
+ *  - ping, from each follower to the leader, carrying the follower's time.
+ *  - pong, the leader's reply, carrying when the ping arrived and when the
+ *    pong left.
+ * Each ping and pong give the clock offset to the leader to within half
+ * the round trip asymmetry. A follower keeps the last few and trusts the
+ * one with the shortest round trip, as NTP does, since queuing only ever
+ * adds delay. With the offset, a beacon tells it where the leader is at any
+ * local time.
+ *
+ * Followers first jump to the leader's position, then steer: steer() gives
+ * the leader's period shortened or lengthened in proportion to the phase
+ * error, so the error decays over about `steer_beats` beats without the
+ * audio ever jumping. A caller that would rather not retime its audio
+ * can run at period_ns() and take the error out of its beat grid instead,
+ * from the leader's `position` in the steering.
+ *
+ * Every node starts as a follower and leads if it hears no beacon for
+ * `leader_timeout_us`. A follower with a lower id than its leader takes
+ * over once it runs on the leader's timeline, and a leader that hears a
+ * lower id steps down, so the lowest id ends up leading without the
+ * timeline moving.
+ *
+ * The class only builds and parses datagrams; the caller moves them, with
+ * UDP on the Ethernet MAC on target and loopback sockets on the host.
+ */
+class net_sync
+{
+public:
+    static constexpr int64_t one_beat = int64_t{ 1 } << 24;
+    static constexpr std::size_t max_packet = 40;
+
+    using config = net_sync_config;
+
+    struct steering
+    {
+        uint32_t period_ns; //!< Beat period to run at
+        bool jump;          //!< Too far off to steer; locate to `position`
+        int64_t position;   //!< The leader's position now
+    };
+
+    /**
+     * @brief Construct a new node
+     *
+     * @param id Unique on the network; the lowest leads
+     * @param settings Intervals and steering
+     */
+    explicit net_sync(uint32_t id, const config& settings = config{})
+      : self(id)
+      , cfg(settings)
+    {
+    }
+
+    /**
+     * @brief Take a received datagram; anything malformed is ignored.
+     *
+     * @param data Datagram payload
+     * @param n Payload bytes
+     * @param now_us When it arrived
+     */
+    void receive(const uint8_t* data, std::size_t n, uint64_t now_us)
+    {
+        reader r{ data, n };
+        if (r.u32() != magic || r.u8() != version) {
+            return;
+        }
+        auto type = static_cast<packet>(r.u8());
+        uint8_t flags = r.u8();
+        r.u8();
+        uint32_t sender = r.u32();
+        if (sender == self) {
+            return;
+        }
+
+        switch (type) {
+            case packet::beacon: {
+                beacon b{
+                    r.u64(), r.i64(), r.u32(), r.i64(), (flags & 1) != 0
+                };
+                if (r.ok && b.period_ns > 0) {
+                    on_beacon(sender, b, now_us);
+                }
+                break;
+            }
+            case packet::ping: {
+                uint64_t t1 = r.u64();
+                if (r.ok && leading && pongs < pending.size()) {
+                    pending[pongs++] = { sender, t1, now_us };
+                }
+                break;
+            }
+            case packet::pong: {
+                uint32_t to = r.u32();
+                uint64_t t1 = r.u64();
+                uint64_t t2 = r.u64();
+                uint64_t t3 = r.u64();
+                if (r.ok && to == self && has_leader && sender == leader) {
+                    on_pong(t1, t2, t3, now_us);
+                }
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Send whatever is due.
+     *
+     * @param now_us The current time
+     * @param position This node's position now
+     * @param period_ns This node's beat period now
+     * @param running Whether this node plays, used while it leads
+     * @param send Called with each datagram to broadcast
+     */
+    template<typename Send>
+    void poll(uint64_t now_us,
+              int64_t position,
+              uint32_t period_ns,
+              bool running,
+              Send&& send)
+    {
+        if (!polled) {
+            polled = true;
+            born = now_us;
+        }
+        if (!leading) {
+            bool silent = !has_leader ||
+                          now_us - last_beacon > cfg.leader_timeout_us;
+            if (silent && now_us - born >= cfg.leader_timeout_us) {
+                lead(now_us);
+            } else if (has_leader && self < leader && synced(now_us) &&
+                       on_timeline(now_us, position)) {
+                lead(now_us);
+            }
+        }
+
+        std::array<uint8_t, max_packet> out{};
+        if (leading) {
+            if (running != state.running) {
+                // Start on the next whole beat, which every node agrees on
+                state.start = (position + one_beat - 1) & ~(one_beat - 1);
+                state.running = running;
+            }
+            if (now_us - last_sent >= cfg.beacon_interval_us) {
+                last_sent = now_us;
+                writer w = header(out, packet::beacon, state.running);
+                w.u64(now_us);
+                w.i64(position);
+                w.u32(period_ns);
+                w.i64(state.start);
+                send(out.data(), w.n);
+            }
+            for (std::size_t i = 0; i < pongs; ++i) {
+                writer w = header(out, packet::pong, false);
+                w.u32(pending[i].to);
+                w.u64(pending[i].t1);
+                w.u64(pending[i].t2);
+                w.u64(now_us);
+                send(out.data(), w.n);
+            }
+            pongs = 0;
+        } else if (has_leader &&
+                   now_us - last_sent >= cfg.ping_interval_us) {
+            last_sent = now_us;
+            writer w = header(out, packet::ping, false);
+            w.u64(now_us);
+            send(out.data(), w.n);
+        }
+    }
+
+    /**
+     * @brief How to run to line up with the leader. Only meaningful while
+     * synced().
+     *
+     * @param now_us The current time
+     * @param position This node's position now
+     */
+    steering steer(uint64_t now_us, int64_t position) const
+    {
+        int64_t target = leader_position(now_us);
+        int64_t error = target - position;
+        if (error > cfg.jump || error < -cfg.jump) {
+            return { state.period_ns, true, target };
+        }
+        // Behind runs short beats to catch up, ahead runs long ones
+        const int64_t period = state.period_ns;
+        int64_t trim = period * error / (one_beat * cfg.steer_beats);
+        trim = std::clamp<int64_t>(trim, -period / 100, period / 100);
+        return { static_cast<uint32_t>(period - trim), false, target };
+    }
+
+    /**
+     * @brief Whether this node follows a leader it has a clock offset for.
+     */
+    bool synced(uint64_t now_us) const
+    {
+        return !leading && has_leader && samples > 0 &&
+               now_us - last_beacon <= cfg.leader_timeout_us;
+    }
+
+    bool leads() const { return leading; }
+
+    /**
+     * @brief The leader's position at a local time.
+     */
+    int64_t leader_position(uint64_t now_us) const
+    {
+        int64_t elapsed = static_cast<int64_t>(now_us) + offset() -
+                          static_cast<int64_t>(state.time);
+        return state.position + elapsed * 1000 * one_beat / state.period_ns;
+    }
+
+    /**
+     * @brief Whether the leader plays, and since which beat.
+     */
+    bool running() const { return state.running; }
+
+    int64_t start_beat() const { return state.start; }
+
+    uint32_t period_ns() const { return state.period_ns; }
+
+    /**
+     * @brief Leader clock minus local clock, in microseconds, from the ping
+     * with the shortest round trip.
+     */
+    int64_t offset() const { return best().offset; }
+
+    /**
+     * @brief Round trip of the ping the offset comes from.
+     */
+    int64_t round_trip() const { return best().delay; }
+
+private:
+    static constexpr uint32_t magic = 0x59534C51; // "QLSY" on the wire
+    static constexpr uint8_t version = 1;
+    static constexpr std::size_t offset_samples = 8;
+
+    enum class packet : uint8_t
+    {
+        beacon = 1,
+        ping = 2,
+        pong = 3
+    };
+
+    struct beacon
+    {
+        uint64_t time;
+        int64_t position;
+        uint32_t period_ns;
+        int64_t start;
+        bool running;
+    };
+
+    struct sample
+    {
+        int64_t offset;
+        int64_t delay;
+    };
+
+    struct pong_due
+    {
+        uint32_t to;
+        uint64_t t1;
+        uint64_t t2;
+    };
+
+    // Little-endian fields, whatever the host
+    struct writer
+    {
+        uint8_t* p;
+        std::size_t n = 0;
+
+        void u8(uint8_t v) { p[n++] = v; }
+        void u32(uint32_t v)
+        {
+            for (int i = 0; i < 4; ++i) {
+                u8(static_cast<uint8_t>(v >> (8 * i)));
+            }
+        }
+        void u64(uint64_t v)
+        {
+            u32(static_cast<uint32_t>(v));
+            u32(static_cast<uint32_t>(v >> 32));
+        }
+        void i64(int64_t v) { u64(static_cast<uint64_t>(v)); }
+    };
+
+    struct reader
+    {
+        const uint8_t* p;
+        std::size_t n;
+        bool ok = true;
+
+        uint8_t u8()
+        {
+            if (n == 0) {
+                ok = false;
+                return 0;
+            }
+            --n;
+            return *p++;
+        }
+        uint32_t u32()
+        {
+            uint32_t v = 0;
+            for (int i = 0; i < 4; ++i) {
+                v |= static_cast<uint32_t>(u8()) << (8 * i);
+            }
+            return v;
+        }
+        uint64_t u64()
+        {
+            uint64_t low = u32();
+            return low | static_cast<uint64_t>(u32()) << 32;
+        }
+        int64_t i64() { return static_cast<int64_t>(u64()); }
+    };
+
+    writer header(std::array<uint8_t, max_packet>& out,
+                  packet type,
+                  bool flag)
+    {
+        writer w{ out.data() };
+        w.u32(magic);
+        w.u8(version);
+        w.u8(static_cast<uint8_t>(type));
+        w.u8(flag ? 1 : 0);
+        w.u8(0);
+        w.u32(self);
+        return w;
+    }
+
+    /**
+     * @brief Start beaconing. A synced follower's own timeline is the old
+     * leader's, so the others see no jump.
+     */
+    void lead(uint64_t now_us)
+    {
+        leading = true;
+        has_leader = false;
+        samples = 0;
+        last_sent = now_us - cfg.beacon_interval_us;
+    }
+
+    /**
+     * @brief Whether a follower has already been steered onto the leader's
+     * timeline, so taking over moves nobody.
+     */
+    bool on_timeline(uint64_t now_us, int64_t position) const
+    {
+        int64_t error = leader_position(now_us) - position;
+        return error <= cfg.jump && error >= -cfg.jump;
+    }
+
+    void on_beacon(uint32_t sender, const beacon& b, uint64_t now_us)
+    {
+        if (leading) {
+            if (sender > self) {
+                return;
+            }
+            leading = false;
+            pongs = 0;
+        }
+        bool stale = now_us - last_beacon > cfg.leader_timeout_us;
+        if (has_leader && sender != leader && sender > leader && !stale) {
+            return;
+        }
+        if (!has_leader || sender != leader) {
+            leader = sender;
+            has_leader = true;
+            samples = 0;
+            last_sent = now_us - cfg.ping_interval_us;
+        }
+        state = b;
+        last_beacon = now_us;
+    }
+
+    void on_pong(uint64_t t1, uint64_t t2, uint64_t t3, uint64_t t4)
+    {
+        int64_t out = static_cast<int64_t>(t2 - t1);
+        int64_t back = static_cast<int64_t>(t3 - t4);
+        int64_t delay = static_cast<int64_t>(t4 - t1) -
+                        static_cast<int64_t>(t3 - t2);
+        if (delay < 0) {
+            return;
+        }
+        offsets[next_sample] = { (out + back) / 2, delay };
+        next_sample = (next_sample + 1) % offset_samples;
+        samples = std::min(samples + 1, offset_samples);
+    }
+
+    sample best() const
+    {
+        sample b{ 0, 0 };
+        for (std::size_t i = 0; i < samples; ++i) {
+            if (i == 0 || offsets[i].delay < b.delay) {
+                b = offsets[i];
+            }
+        }
+        return b;
+    }
+
+    uint32_t self;
+    config cfg;
+    bool polled = false;
+    uint64_t born = 0;
+
+    bool leading = false;
+    bool has_leader = false;
+    uint32_t leader = 0;
+    uint64_t last_beacon = 0;
+    uint64_t last_sent = 0;
+    // The leader's last beacon, or this node's own timeline while leading
+    beacon state{ 0, 0, 500000000, 0, false };
+
+    std::array<sample, offset_samples> offsets{};
+    std::size_t next_sample = 0;
+    std::size_t samples = 0;
+
+    std::array<pong_due, 4> pending{};
+    std::size_t pongs = 0;
+};
@@ -0,0 +1,211 @@
+/**
+ * @file rtos2_tasks.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Runs a task table as prioritized CMSIS-RTOS2 threads, each
+ * released by a periodic kernel timer.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// CMSIS includes
+#include <cmsis_os2.h>
+
+// Quantized looper includes
+#include <quantized_looper/Software/timer_wheel.hpp>
+
+/**
+ * @brief How one task runs as a thread.
+ */
+struct rtos2_thread_config
+{
+    osPriority_t priority = osPriorityNormal;
+    uint32_t stack_size = 0; //!< 0 for the kernel's default
+};
+
+/**
+ * @brief The preemptive alternative to wheel_scheduler: every entry of a
+ * wheel_task table gets its own thread at its own priority, and a periodic
+ * kernel timer that releases it with a thread flag.
+ *
+ * A thread sleeps until its offset, runs its task, then runs it once per
+ * timer period; a release that comes while it is still running is merged
+ * into the next one and counted as an overrun. A task with no period runs
+ * once. Periods and offsets are converted from the table's clock ticks to
+ * kernel ticks, so they must be whole kernel ticks. Coroutine entries,
+ * which reschedule themselves on the wheel, cannot run here.
+ *
+ * Threads wait for start() to have created every thread before they run,
+ * so no timer can release a thread whose id is not published yet.
+ *
+ * The tasks now run concurrently: anything they share needs the same
+ * care as data shared with an interrupt. When a wait fails because the
+ * kernel is going away, the thread stops its timer and exits.
+ *
+ * @tparam Tick The table's clock ticks
+ * @tparam Tasks Number of tasks in the table
+ */
+template<typename Tick, std::size_t Tasks>
+class rtos2_tasks
+{
+public:
+    using task_type = wheel_task<Tick>;
+    using table_type = std::array<task_type, Tasks>;
+    using config_type = std::array<rtos2_thread_config, Tasks>;
+
+    /**
+     * @brief Construct the threads' description. Nothing runs until
+     * start().
+     *
+     * @param table Tasks to run; must outlive the threads
+     * @param config Priority and stack of each task's thread
+     * @param ticks_per_kernel_tick Table clock ticks in a kernel tick
+     */
+    rtos2_tasks(table_type& table,
+                const config_type& config,
+                Tick ticks_per_kernel_tick)
+      : tasks(&table)
+      , config(config)
+      , per_tick(ticks_per_kernel_tick)
+    {
+    }
+
+    rtos2_tasks(rtos2_tasks const&) = delete;
+    void operator=(rtos2_tasks const&) = delete;
+
+    /**
+     * @brief Create every task's thread and timer, then let the threads
+     * run. Call once the kernel is initialized, before or after it starts.
+     *
+     * @param names Thread names, or null
+     * @return false if a period is not a whole number of kernel ticks, or
+     * the kernel could not create a thread or timer; no task runs then
+     */
+    bool start(const std::array<const char*, Tasks>* names = nullptr)
+    {
+        for (std::size_t i = 0; i < Tasks; ++i) {
+            const task_type& task = (*tasks)[i];
+            if (task.period % per_tick != 0 || task.release % per_tick != 0) {
+                return false;
+            }
+            slot& s = slots[i];
+            s.owner = this;
+            s.index = i;
+            if (task.period != 0) {
+                s.timer = osTimerNew(release, osTimerPeriodic, &s, nullptr);
+                if (s.timer == nullptr) {
+                    return false;
+                }
+            }
+            osThreadAttr_t attr{};
+            attr.name = names ? (*names)[i] : nullptr;
+            attr.stack_size = config[i].stack_size;
+            attr.priority = config[i].priority;
+            s.thread = osThreadNew(run, &s, &attr);
+            if (s.thread == nullptr) {
+                return false;
+            }
+        }
+        for (slot& s : slots) {
+            osThreadFlagsSet(s.thread, start_flag);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Times a task has run.
+     */
+    uint32_t runs(std::size_t task) const
+    {
+        return slots[task].runs.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Releases that found a task still running its last one.
+     */
+    uint32_t overruns(std::size_t task) const
+    {
+        return slots[task].overruns.load(std::memory_order_relaxed);
+    }
+
+    osThreadId_t thread(std::size_t task) const { return slots[task].thread; }
+
+    static constexpr std::size_t size() { return Tasks; }
+
+private:
+    static constexpr uint32_t release_flag = 1;
+    static constexpr uint32_t start_flag = 2;
+
+    struct slot
+    {
+        rtos2_tasks* owner = nullptr;
+        std::size_t index = 0;
+        osThreadId_t thread = nullptr;
+        osTimerId_t timer = nullptr;
+        std::atomic<uint32_t> runs{ 0 };
+        std::atomic<uint32_t> overruns{ 0 };
+        std::atomic<bool> waiting{ false };
+    };
+
+    uint32_t kernel_ticks(Tick ticks) const
+    {
+        return static_cast<uint32_t>(ticks / per_tick);
+    }
+
+    // A task's thread; it must not return, so it ends with osThreadExit()
+    static void run(void* argument)
+    {
+        slot& s = *static_cast<slot*>(argument);
+        rtos2_tasks& self = *s.owner;
+        task_type& task = (*self.tasks)[s.index];
+
+        const uint32_t go =
+          osThreadFlagsWait(start_flag, osFlagsWaitAny, osWaitForever);
+        if ((go & osFlagsError) != 0) {
+            osThreadExit();
+        }
+        const uint32_t offset = self.kernel_ticks(task.release);
+        if (offset != 0 && osDelay(offset) != osOK) {
+            osThreadExit();
+        }
+        task.function();
+        s.runs.fetch_add(1, std::memory_order_relaxed);
+        if (task.period == 0 ||
+            osTimerStart(s.timer, self.kernel_ticks(task.period)) != osOK) {
+            osThreadExit();
+        }
+        for (;;) {
+            s.waiting.store(true, std::memory_order_relaxed);
+            const uint32_t flags =
+              osThreadFlagsWait(release_flag, osFlagsWaitAny, osWaitForever);
+            s.waiting.store(false, std::memory_order_relaxed);
+            if ((flags & osFlagsError) != 0) {
+                osTimerStop(s.timer);
+                osThreadExit();
+            }
+            task.function();
+            s.runs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // A task's timer callback, in the kernel's timer thread
+    static void release(void* argument)
+    {
+        slot& s = *static_cast<slot*>(argument);
+        if (!s.waiting.load(std::memory_order_relaxed)) {
+            s.overruns.fetch_add(1, std::memory_order_relaxed);
+        }
+        osThreadFlagsSet(s.thread, release_flag);
+    }
+
+    table_type* tasks;
+    config_type config;
+    Tick per_tick;
+    std::array<slot, Tasks> slots{};
+};
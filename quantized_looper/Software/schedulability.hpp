@@ -0,0 +1,150 @@
+/**
+ * @file schedulability.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Compile-time response time analysis of the two-tier task table.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief A task's timing for the analysis, in any one unit of time.
+ */
+struct task_budget
+{
+    uint64_t period;       //!< Release interval, or shortest sleep
+    uint64_t wcet = 0;     //!< Worst-case run time; 0 if not budgeted
+    uint64_t deadline = 0; //!< Latest finish after release; 0 for the period
+
+    constexpr uint64_t due() const { return deadline ? deadline : period; }
+};
+
+/**
+ * @brief Response time that does not meet the deadline.
+ */
+inline constexpr uint64_t no_response = std::numeric_limits<uint64_t>::max();
+
+namespace detail {
+
+constexpr uint64_t ceil_div(uint64_t a, uint64_t b)
+{
+    return (a + b - 1) / b;
+}
+
+} // namespace detail
+
+/**
+ * @brief Worst-case response time of a foreground job.
+ *
+ * Foreground jobs preempt each other by index, lowest first, and preempt
+ * every background task. Standard fixed-priority analysis: the job's own
+ * run, plus every run of a higher priority job released while it waits.
+ *
+ * @param foreground Jobs in priority order
+ * @param job Index of the job
+ * @return The bound, or no_response if it passes the deadline
+ */
+template<std::size_t F>
+constexpr uint64_t foreground_response(
+  const std::array<task_budget, F>& foreground,
+  std::size_t job)
+{
+    const task_budget& t = foreground[job];
+    uint64_t r = t.wcet;
+    for (;;) {
+        uint64_t next = t.wcet;
+        for (std::size_t h = 0; h < job; ++h) {
+            next += detail::ceil_div(r, foreground[h].period) *
+                    foreground[h].wcet;
+        }
+        if (next > t.due()) {
+            return no_response;
+        }
+        if (next == r) {
+            return r;
+        }
+        r = next;
+    }
+}
+
+/**
+ * @brief Worst-case response time of a background task.
+ *
+ * Background tasks run to completion in release order. Each has a single
+ * entry on the timer wheel, so at most one run of every other task can be
+ * queued or running ahead of this one, and one released later waits
+ * behind it. All of them are preempted by the foreground. The release
+ * itself is late by up to `jitter`, the scheduler's granule and wake-up.
+ *
+ * @param background Cooperative tasks
+ * @param foreground Jobs that preempt them
+ * @param task Index of the background task
+ * @param jitter Release latency
+ * @return The bound, or no_response if it passes the deadline
+ */
+template<std::size_t B, std::size_t F>
+constexpr uint64_t background_response(
+  const std::array<task_budget, B>& background,
+  const std::array<task_budget, F>& foreground,
+  std::size_t task,
+  uint64_t jitter = 0)
+{
+    uint64_t work = jitter;
+    for (const task_budget& b : background) {
+        work += b.wcet;
+    }
+
+    const uint64_t due = background[task].due();
+    uint64_t r = work;
+    for (;;) {
+        uint64_t next = work;
+        for (const task_budget& f : foreground) {
+            next += detail::ceil_div(r, f.period) * f.wcet;
+        }
+        if (next > due) {
+            return no_response;
+        }
+        if (next == r) {
+            return r;
+        }
+        r = next;
+    }
+}
+
+/**
+ * @brief Whether every job and task meets its deadline, for a
+ * static_assert on the task table.
+ */
+template<std::size_t B, std::size_t F>
+constexpr bool schedulable(const std::array<task_budget, B>& background,
+                           const std::array<task_budget, F>& foreground,
+                           uint64_t jitter = 0)
+{
+    for (std::size_t f = 0; f < F; ++f) {
+        if (foreground_response(foreground, f) == no_response) {
+            return false;
+        }
+    }
+    for (std::size_t b = 0; b < B; ++b) {
+        if (background_response(background, foreground, b, jitter) ==
+            no_response) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief A measured run time in cycles as whole microseconds, rounded up,
+ * to compare with a budget.
+ */
+constexpr uint64_t cycles_to_us(uint64_t cycles, uint64_t hz)
+{
+    return detail::ceil_div(cycles * 1000000, hz);
+}
@@ -0,0 +1,163 @@
+/**
+ * @file spsc_ring.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Wait-free single-producer/single-consumer ring buffer.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief Fixed-capacity, allocation-free ring buffer for exactly one producer
+ * and one consumer.
+ *
+ * The producer only ever writes `head` and the consumer only ever writes
+ * `tail`, so neither side has to disable interrupts or retry: every call
+ * completes in a bounded number of steps. On the Cortex-M7 the indices are
+ * plain aligned word accesses, and the acquire/release ordering compiles to a
+ * DMB. The same code runs on the host, where the two sides may be threads.
+ *
+ * Elements can either be copied in and out with try_push() / try_pop(), or
+ * filled in place with write_slot() / commit_write() and read in place with
+ * read_slot() / commit_read(), which is what the audio path uses so that whole
+ * blocks are never copied.
+ *
+ * @tparam T Element type, e.g. a fixed-size audio block.
+ * @tparam Capacity Number of slots; must be a power of two.
+ */
+template<typename T, std::size_t Capacity>
+class spsc_ring
+{
+    static_assert(Capacity >= 2, "spsc_ring needs at least two slots");
+    static_assert((Capacity & (Capacity - 1)) == 0,
+                  "spsc_ring capacity must be a power of two");
+    static_assert(std::atomic<std::size_t>::is_always_lock_free,
+                  "spsc_ring indices must be lock-free");
+
+public:
+    constexpr spsc_ring() = default;
+
+    spsc_ring(spsc_ring const&) = delete;
+    void operator=(spsc_ring const&) = delete;
+
+    /**
+     * @brief Copy an element in. Producer side only.
+     *
+     * @param value Element to append
+     * @return true if stored, false if the ring was full
+     */
+    bool try_push(const T& value)
+    {
+        T* slot = write_slot();
+        if (slot == nullptr) {
+            return false;
+        }
+        *slot = value;
+        commit_write();
+        return true;
+    }
+
+    /**
+     * @brief Copy the oldest element out. Consumer side only.
+     *
+     * @param value Destination for the element
+     * @return true if an element was removed, false if the ring was empty
+     */
+    bool try_pop(T& value)
+    {
+        const T* slot = read_slot();
+        if (slot == nullptr) {
+            return false;
+        }
+        value = *slot;
+        commit_read();
+        return true;
+    }
+
+    /**
+     * @brief Get the next free slot to fill in place. Producer side only.
+     *
+     * The slot is not visible to the consumer until commit_write() is called.
+     *
+     * @return Pointer to the slot, or nullptr if the ring is full
+     */
+    T* write_slot()
+    {
+        const std::size_t head = head_index.load(std::memory_order_relaxed);
+        const std::size_t tail = tail_index.load(std::memory_order_acquire);
+        if (head - tail == Capacity) {
+            return nullptr;
+        }
+        return &slots[head & mask];
+    }
+
+    /**
+     * @brief Publish the slot returned by write_slot(). Producer side only.
+     */
+    void commit_write()
+    {
+        const std::size_t head = head_index.load(std::memory_order_relaxed);
+        head_index.store(head + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Get the oldest element to read in place. Consumer side only.
+     *
+     * The slot stays owned by the consumer until commit_read() is called.
+     *
+     * @return Pointer to the element, or nullptr if the ring is empty
+     */
+    const T* read_slot() const
+    {
+        const std::size_t tail = tail_index.load(std::memory_order_relaxed);
+        const std::size_t head = head_index.load(std::memory_order_acquire);
+        if (head == tail) {
+            return nullptr;
+        }
+        return &slots[tail & mask];
+    }
+
+    /**
+     * @brief Release the slot returned by read_slot(). Consumer side only.
+     */
+    void commit_read()
+    {
+        const std::size_t tail = tail_index.load(std::memory_order_relaxed);
+        tail_index.store(tail + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Number of elements currently queued.
+     *
+     * Exact when called from either side; from anywhere else it is only a
+     * snapshot.
+     */
+    std::size_t size() const
+    {
+        const std::size_t tail = tail_index.load(std::memory_order_acquire);
+        const std::size_t head = head_index.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    bool full() const { return size() == Capacity; }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    static constexpr std::size_t mask = Capacity - 1;
+
+    // Keep the two indices on separate cache lines so the producer and the
+    // consumer do not invalidate each other's line on every access.
+    static constexpr std::size_t cache_line = 64;
+
+    alignas(cache_line) std::atomic<std::size_t> head_index{ 0 };
+    alignas(cache_line) std::atomic<std::size_t> tail_index{ 0 };
+    alignas(cache_line) std::array<T, Capacity> slots{};
+};
@@ -0,0 +1,144 @@
+/**
+ * @file static_scheduler.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Task table fixed at compile time, dispatched without indirection.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+/**
+ * @brief A task for static_scheduler: a function called directly every
+ * `Period` clock ticks, first `Offset` ticks after the start.
+ *
+ * Any type with `static constexpr` period and offset and a call operator
+ * is a task too, so a task can keep its state in members.
+ */
+template<auto Function, uint64_t Period, uint64_t Offset = 0>
+struct static_task
+{
+    static constexpr uint64_t period = Period;
+    static constexpr uint64_t offset = Offset;
+
+    void operator()() const { Function(); }
+};
+
+template<typename Clock, typename Tasks>
+class static_scheduler;
+
+/**
+ * @brief Runs a tuple of periodic tasks whose periods are known at compile
+ * time.
+ *
+ * Where the timer_wheel's table holds a function pointer and a clock
+ * pointer per task, here every task is a type: poll() is a fold over the
+ * tuple, so each check and call is direct, task bodies can be inlined,
+ * and the period arithmetic folds to constants. The table cannot change
+ * while it runs, and every task shares the one Clock.
+ *
+ * Tasks run in tuple order when due together. A task that falls behind
+ * skips the releases it missed and keeps its phase, as on the wheel.
+ *
+ * @tparam Clock Type with `tick_type` and `static tick_type now()`, e.g.
+ * monotonic_clock
+ * @tparam Tasks Task types
+ */
+template<typename Clock, typename... Tasks>
+class static_scheduler<Clock, std::tuple<Tasks...>>
+{
+    static_assert(sizeof...(Tasks) > 0, "nothing to schedule");
+    static_assert(((Tasks::period > 0) && ...), "tasks must be periodic");
+
+public:
+    using tick_type = typename Clock::tick_type;
+    using tasks_type = std::tuple<Tasks...>;
+
+    explicit static_scheduler(tasks_type tasks = {})
+      : tasks(std::move(tasks))
+    {
+    }
+
+    /**
+     * @brief Release every task at its offset from now.
+     */
+    void start(tick_type now)
+    {
+        release = { static_cast<tick_type>(now + Tasks::offset)... };
+    }
+
+    /**
+     * @brief Run every task due by `now`.
+     *
+     * @return Tasks run
+     */
+    std::size_t poll(tick_type now)
+    {
+        return [&]<std::size_t... I>(std::index_sequence<I...>) {
+            std::size_t ran = 0;
+            ((ran += dispatch<I>(now)), ...);
+            return ran;
+        }(std::index_sequence_for<Tasks...>());
+    }
+
+    /**
+     * @brief When the next task is due.
+     */
+    tick_type next_release() const
+    {
+        return *std::min_element(release.begin(), release.end());
+    }
+
+    template<std::size_t I>
+    auto& task()
+    {
+        return std::get<I>(tasks);
+    }
+
+    static constexpr std::size_t size() { return sizeof...(Tasks); }
+
+private:
+    template<std::size_t I>
+    std::size_t dispatch(tick_type now)
+    {
+        constexpr auto period =
+          static_cast<tick_type>(std::tuple_element_t<I, tasks_type>::period);
+        tick_type& due = release[I];
+        if (now < due) {
+            return 0;
+        }
+        std::get<I>(tasks)();
+        due += period;
+        if (due <= now) {
+            due += ((now - due) / period + 1) * period;
+        }
+        return 1;
+    }
+
+    tasks_type tasks;
+    std::array<tick_type, sizeof...(Tasks)> release{};
+};
+
+/**
+ * @brief Run a static_scheduler forever on its clock.
+ *
+ * @param idle Called between passes as idle(pending, at), like the
+ * wheel_scheduler's, with the next release
+ */
+template<typename Clock, typename Tasks, typename Idle>
+[[noreturn]] void static_scheduler_loop(static_scheduler<Clock, Tasks>& tasks,
+                                        Idle&& idle)
+{
+    tasks.start(Clock::now());
+    for (;;) {
+        tasks.poll(Clock::now());
+        idle(true, tasks.next_release());
+    }
+}
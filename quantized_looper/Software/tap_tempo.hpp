@@ -0,0 +1,220 @@
+/**
+ * @file tap_tempo.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Robust tap tempo from microsecond timestamps, in integer math.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Fits a tempo to the last few taps, ignoring sloppy and missed ones.
+ *
+ * Each tap() is given a free-running microsecond timestamp. The estimate
+ * comes from the last Taps taps in three steps:
+ *  - The median interval gives a rough period that one bad tap cannot move.
+ *  - Every tap gets a beat number by rounding its distance from the
+ *    previous one to whole rough periods, so a missed tap counts as two
+ *    beats. Taps further than an eighth of a period from where the rough
+ *    period puts them are dropped.
+ *  - A least-squares line through the remaining (beat, time) points gives
+ *    the period, to 1/256 us.
+ *
+ * A tap closer than the minimum period to the previous one is a bounce and
+ * is ignored. A gap longer than the maximum period starts a new sequence,
+ * so changing tempo after a pause takes effect from the second tap.
+ *
+ * Everything is integer arithmetic on fixed arrays, with a bounded number
+ * of steps per tap, so tap() can run in the timestamping ISR without
+ * touching the FPU. The period is published through an atomic word, so
+ * another context can read it at any time.
+ *
+ * @tparam Taps Taps fitted at once; more averages more jitter away, fewer
+ * follows tempo changes sooner.
+ */
+template<std::size_t Taps = 8>
+class tap_tempo
+{
+    static_assert(Taps >= 3 && Taps <= 32, "tap_tempo fits 3 to 32 taps");
+
+public:
+    /**
+     * @brief Construct a new tap tempo
+     *
+     * @param min_period_us Shortest beat accepted; closer taps are bounces.
+     * At least 1, so two taps at the same time never make a zero period
+     * @param max_period_us Longest beat accepted; longer gaps restart
+     * @param initial_period_us Period reported before the first estimate
+     */
+    tap_tempo(uint32_t min_period_us,
+              uint32_t max_period_us,
+              uint32_t initial_period_us)
+      : min_period(std::max<uint32_t>(min_period_us, 1))
+      , max_period(max_period_us)
+      , period(initial_period_us << 8)
+    {
+    }
+
+    /**
+     * @brief Register a tap.
+     *
+     * @param now_us Timestamp of the tap from a free-running microsecond
+     * counter; wraps at 2^32
+     * @return true if the period was updated
+     */
+    bool tap(uint32_t now_us)
+    {
+        if (count > 0) {
+            uint32_t gap = now_us - times[newest()];
+            if (gap < min_period) {
+                return false;
+            }
+            if (gap > max_period) {
+                count = 0;
+            }
+        }
+
+        first = count == Taps ? (first + 1) % Taps : first;
+        count = std::min(count + 1, Taps);
+        times[newest()] = now_us;
+        if (count < 2) {
+            return false;
+        }
+
+        uint32_t fitted = fit();
+        if (fitted == 0) {
+            return false;
+        }
+        period.store(fitted, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Forget the current sequence; the period is kept.
+     */
+    void reset() { count = 0; }
+
+    /**
+     * @brief Beat period in microseconds, Q24.8.
+     */
+    uint32_t period_q8() const
+    {
+        return period.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Beat period rounded to whole microseconds.
+     */
+    uint32_t period_us() const { return (period_q8() + 128) >> 8; }
+
+    /**
+     * @brief Taps in the current sequence, up to Taps.
+     */
+    std::size_t taps() const { return count; }
+
+private:
+    std::size_t newest() const { return (first + count - 1) % Taps; }
+
+    /**
+     * @brief Period of the taps held, Q24.8, or 0 if they do not agree on
+     * one.
+     */
+    uint32_t fit() const
+    {
+        // Offsets from the oldest tap; a sequence spans at most
+        // Taps * max_period, far inside 32 bits for any sane maximum
+        std::array<uint32_t, Taps> offset{};
+        std::array<uint32_t, Taps> interval{};
+        for (std::size_t i = 1; i < count; ++i) {
+            offset[i] = times[(first + i) % Taps] - times[first];
+            interval[i - 1] = offset[i] - offset[i - 1];
+        }
+
+        const std::size_t intervals = count - 1;
+        uint32_t rough = median(interval, intervals);
+
+        // Beat numbers, with a missed tap counting as two beats
+        std::array<uint32_t, Taps> beat{};
+        for (std::size_t i = 1; i < count; ++i) {
+            uint32_t beats = (interval[i - 1] + rough / 2) / rough;
+            beat[i] = beat[i - 1] + std::max<uint32_t>(beats, 1);
+        }
+
+        // Where the rough period puts each tap, relative to the line through
+        // the median residual
+        std::array<int32_t, Taps> residual{};
+        for (std::size_t i = 0; i < count; ++i) {
+            residual[i] = static_cast<int32_t>(offset[i] - beat[i] * rough);
+        }
+        std::array<int32_t, Taps> sorted = residual;
+        const std::size_t held = std::min(count, Taps);
+        std::sort(sorted.begin(), sorted.begin() + held);
+        int32_t centre = sorted[held / 2];
+        const int32_t tolerance = static_cast<int32_t>(rough / 8);
+
+        int64_t n = 0;
+        int64_t sum_b = 0;
+        int64_t sum_t = 0;
+        int64_t sum_bb = 0;
+        int64_t sum_bt = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            int32_t error = residual[i] - centre;
+            if (error > tolerance || error < -tolerance) {
+                continue;
+            }
+            int64_t b = beat[i];
+            int64_t t = offset[i];
+            ++n;
+            sum_b += b;
+            sum_t += t;
+            sum_bb += b * b;
+            sum_bt += b * t;
+        }
+
+        int64_t den = n * sum_bb - sum_b * sum_b;
+        uint64_t q8;
+        if (n >= 2 && den > 0) {
+            int64_t num = n * sum_bt - sum_b * sum_t;
+            if (num <= 0) {
+                return 0;
+            }
+            q8 = (static_cast<uint64_t>(num) * 256 + den / 2) / den;
+        } else {
+            q8 = static_cast<uint64_t>(rough) << 8;
+        }
+
+        if (q8 < (static_cast<uint64_t>(min_period) << 8) ||
+            q8 > (static_cast<uint64_t>(max_period) << 8)) {
+            return 0;
+        }
+        return static_cast<uint32_t>(q8);
+    }
+
+    /**
+     * @brief Median of the first n values; the mean of the middle two for
+     * even n.
+     */
+    static uint32_t median(std::array<uint32_t, Taps> values, std::size_t n)
+    {
+        n = std::min(n, Taps);
+        std::sort(values.begin(), values.begin() + n);
+        if (n % 2 == 1) {
+            return values[n / 2];
+        }
+        return values[n / 2 - 1] + (values[n / 2] - values[n / 2 - 1]) / 2;
+    }
+
+    uint32_t min_period;
+    uint32_t max_period;
+    std::array<uint32_t, Taps> times{};
+    std::size_t first = 0;
+    std::size_t count = 0;
+    std::atomic<uint32_t> period;
+};
@@ -0,0 +1,180 @@
+/**
+ * @file task_stats.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Per-task execution time and start lateness, for timer_wheel.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+
+/**
+ * @brief What one task has cost and how late it has started.
+ *
+ * Lateness is in scheduler clock ticks and goes into log2 buckets: bucket
+ * 0 counts starts on time, bucket b > 0 starts from 2^(b-1) up to 2^b
+ * ticks late, and the last bucket everything later.
+ */
+template<std::size_t Buckets>
+struct task_record
+{
+    uint32_t runs = 0;
+    uint32_t min_cycles = std::numeric_limits<uint32_t>::max();
+    uint32_t max_cycles = 0;
+    uint64_t total_cycles = 0;
+    uint32_t min_late = std::numeric_limits<uint32_t>::max();
+    uint32_t max_late = 0;
+    std::array<uint32_t, Buckets> late{};
+
+    uint32_t mean_cycles() const
+    {
+        return runs == 0 ? 0 : static_cast<uint32_t>(total_cycles / runs);
+    }
+
+    /**
+     * @brief Spread of start times, the difference of the latest and
+     * earliest start.
+     */
+    uint32_t jitter() const { return runs == 0 ? 0 : max_late - min_late; }
+};
+
+/**
+ * @brief timer_wheel's instrumentation when it is turned off: every hook
+ * is empty and the scheduler compiles to what it was without it.
+ */
+struct no_task_stats
+{
+    static constexpr bool enabled = false;
+
+    static uint32_t start() { return 0; }
+
+    static void finish(std::size_t, uint32_t, uint64_t) {}
+};
+
+/**
+ * @brief Records each task's execution time in cycles and how late it
+ * started, for a timer_wheel to fill in as it runs them.
+ *
+ * Execution time comes from a free-running 32-bit Counter, the DWT cycle
+ * counter on the target, so tasks up to a counter wrap are timed exactly.
+ * Everything is updated from the scheduler loop only; reading the records
+ * from a task, e.g. to dump them, is consistent.
+ *
+ * @tparam Tasks Number of tasks in the table
+ * @tparam Counter Type with `static uint32_t now()`, e.g. cycle_counter
+ * @tparam Buckets Lateness histogram buckets
+ */
+template<std::size_t Tasks, typename Counter, std::size_t Buckets = 24>
+class task_stats
+{
+public:
+    using record_type = task_record<Buckets>;
+
+    static constexpr bool enabled = true;
+
+    /**
+     * @brief Timestamp before a task runs.
+     */
+    static uint32_t start() { return Counter::now(); }
+
+    /**
+     * @brief Account a run of a task.
+     *
+     * @param task Index in the table
+     * @param started start() from before the task ran
+     * @param late Clock ticks between its release and its start
+     */
+    void finish(std::size_t task, uint32_t started, uint64_t late)
+    {
+        const uint32_t cycles = Counter::now() - started;
+        const auto ticks = static_cast<uint32_t>(
+          std::min<uint64_t>(late, std::numeric_limits<uint32_t>::max()));
+        record_type& r = records[task];
+        ++r.runs;
+        r.min_cycles = std::min(r.min_cycles, cycles);
+        r.max_cycles = std::max(r.max_cycles, cycles);
+        r.total_cycles += cycles;
+        r.min_late = std::min(r.min_late, ticks);
+        r.max_late = std::max(r.max_late, ticks);
+        ++r.late[bucket(ticks)];
+    }
+
+    const record_type& operator[](std::size_t task) const
+    {
+        return records[task];
+    }
+
+    void reset() { records.fill(record_type{}); }
+
+    /**
+     * @brief Histogram bucket for a lateness.
+     */
+    static std::size_t bucket(uint32_t ticks)
+    {
+        return std::min<std::size_t>(std::bit_width(ticks), Buckets - 1);
+    }
+
+    /**
+     * @brief Write every task's record as text, two lines per task that
+     * has run: its costs, then the non-empty lateness buckets.
+     *
+     * @param names Task names, in table order
+     * @param write Callable as write(const char* line), without newline
+     */
+    template<typename Write>
+    void dump(const std::array<const char*, Tasks>& names, Write&& write) const
+    {
+        char line[160];
+        for (std::size_t t = 0; t < Tasks; ++t) {
+            const record_type& r = records[t];
+            if (r.runs == 0) {
+                continue;
+            }
+            snprintf(line,
+                     sizeof(line),
+                     "%s: %lu runs, %lu/%lu/%lu cycles min/mean/max, "
+                     "late %lu..%lu ticks, jitter %lu",
+                     names[t],
+                     static_cast<unsigned long>(r.runs),
+                     static_cast<unsigned long>(r.min_cycles),
+                     static_cast<unsigned long>(r.mean_cycles()),
+                     static_cast<unsigned long>(r.max_cycles),
+                     static_cast<unsigned long>(r.min_late),
+                     static_cast<unsigned long>(r.max_late),
+                     static_cast<unsigned long>(r.jitter()));
+            write(static_cast<const char*>(line));
+
+            // "<2^b:count" for each bucket with any starts in it
+            int n = snprintf(line, sizeof(line), "%s late", names[t]);
+            for (std::size_t b = 0; b < Buckets; ++b) {
+                if (r.late[b] == 0 || n < 0 ||
+                    static_cast<std::size_t>(n) >= sizeof(line)) {
+                    continue;
+                }
+                const auto count = static_cast<unsigned long>(r.late[b]);
+                if (b + 1 < Buckets) {
+                    n += snprintf(line + n,
+                                  sizeof(line) - n,
+                                  " <%lu:%lu",
+                                  1ul << b,
+                                  count);
+                } else {
+                    n += snprintf(
+                      line + n, sizeof(line) - n, " more:%lu", count);
+                }
+            }
+            write(static_cast<const char*>(line));
+        }
+    }
+
+private:
+    std::array<record_type, Tasks> records{};
+};
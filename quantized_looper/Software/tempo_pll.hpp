@@ -0,0 +1,285 @@
+/**
+ * @file tempo_pll.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Phase-locked loop that turns jittery pulse timestamps into a steady
+ * period, in integer math.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+/**
+ * @brief Second-order PLL over pulse timestamps: it predicts each pulse,
+ * and corrects its phase and period by fractions of the prediction error.
+ *
+ * Both corrections are powers of two. The loop starts wide, with big
+ * corrections, so it locks within a few pulses. After every run of
+ * `shift_pulses` pulses close to their prediction it shifts to the next
+ * narrower gear, down to one that averages the jitter over hundreds of
+ * pulses. Two pulses in a row far from their prediction, as after a tempo
+ * change, drop it back to the widest gear; a single one, a hiccup on the
+ * link, is corrected in the current gear. Being second order, it follows a
+ * steady tempo ramp without a lasting phase error.
+ *
+ * Once locked, a pulse that comes one to three periods late counts as
+ * following missed pulses. A pulse more than half a period early is taken
+ * as a duplicate and ignored, unless several come in a row. A gap of more
+ * than twice the longest period starts over.
+ *
+ * Timestamps come from a free-running microsecond counter and may wrap.
+ * The period is kept in Q16 microseconds, and every step is integer
+ * arithmetic with a bounded number of operations.
+ */
+class tempo_pll
+{
+public:
+    /**
+     * @brief Pulses near their prediction needed to shift to a narrower gear
+     */
+    static constexpr uint32_t shift_pulses = 24;
+
+    /**
+     * @brief Construct a new tempo PLL
+     *
+     * @param min_period_us Shortest pulse period accepted
+     * @param max_period_us Longest pulse period accepted
+     */
+    tempo_pll(uint32_t min_period_us, uint32_t max_period_us)
+      : min_period(static_cast<int64_t>(min_period_us) << 16)
+      , max_period(static_cast<int64_t>(max_period_us) << 16)
+      , period(max_period)
+    {
+    }
+
+    /**
+     * @brief Register a pulse.
+     *
+     * @param now_us Timestamp of the pulse
+     * @return true if it updated the period
+     */
+    bool pulse(uint32_t now_us)
+    {
+        uint32_t dt = now_us - last;
+        if (count == 0 || dt > 2 * static_cast<uint64_t>(max_period >> 16)) {
+            restart(now_us);
+            return false;
+        }
+
+        if (count == 1) {
+            // The first interval seeds the period, if it is one
+            int64_t first = static_cast<int64_t>(dt) << 16;
+            if (first < min_period || first > max_period) {
+                restart(now_us);
+                return false;
+            }
+            period = first;
+            expected = first;
+            count = 2;
+            last = now_us;
+            return true;
+        }
+
+        int64_t error = (static_cast<int64_t>(dt) << 16) - expected;
+        if (locked()) {
+            if (error < -period / 2) {
+                if (++early < 3) {
+                    return false;
+                }
+                restart(now_us);
+                return false;
+            }
+            for (int missed = 0; missed < 3 && error > period / 2; ++missed) {
+                error -= period;
+            }
+            if (error > period / 2) {
+                restart(now_us);
+                return false;
+            }
+        }
+        early = 0;
+
+        shift(error);
+        period = std::clamp(period + (error >> gears[gear].frequency),
+                            min_period,
+                            max_period);
+        // Next pulse, from this one's filtered phase rather than its
+        // raw timestamp
+        expected = period - error + (error >> gears[gear].phase);
+        last = now_us;
+        return true;
+    }
+
+    /**
+     * @brief Forget the pulses so far; the period is kept.
+     */
+    void reset() { count = 0; }
+
+    /**
+     * @brief Whether the loop has settled since it last started over. It
+     * stays locked while it re-acquires after a tempo change.
+     */
+    bool locked() const { return count >= 2 && settled; }
+
+    /**
+     * @brief Pulse period in microseconds, Q16.
+     */
+    int64_t period_q16() const { return period; }
+
+    /**
+     * @brief Pulse period rounded to whole microseconds.
+     */
+    uint32_t period_us() const
+    {
+        return static_cast<uint32_t>((period + (1 << 15)) >> 16);
+    }
+
+    /**
+     * @brief Gear from 0, the widest, to the narrowest.
+     */
+    std::size_t stage() const { return gear; }
+
+private:
+    struct gain
+    {
+        int phase;     //!< Phase correction is error / 2^phase
+        int frequency; //!< Period correction is error / 2^frequency
+    };
+
+    // Each near critically damped; the last averages over ~500 pulses
+    static constexpr gain gears[] = { { 1, 3 }, { 2, 5 }, { 3, 7 }, { 4, 9 } };
+    static constexpr std::size_t top_gear = std::size(gears) - 1;
+
+    void restart(uint32_t now_us)
+    {
+        last = now_us;
+        count = 1;
+        gear = 0;
+        steady = 0;
+        early = 0;
+        outliers = 0;
+        settled = false;
+    }
+
+    void shift(int64_t error)
+    {
+        int64_t size = error < 0 ? -error : error;
+        if (size > period / 4) {
+            steady = 0;
+            if (++outliers == 2) {
+                gear = 0;
+                outliers = 0;
+            }
+            return;
+        }
+        outliers = 0;
+        if (gear < top_gear && ++steady == shift_pulses) {
+            ++gear;
+            steady = 0;
+            settled = true;
+        }
+    }
+
+    int64_t min_period;
+    int64_t max_period;
+    int64_t period;
+    // When the next pulse is due, relative to the last one
+    int64_t expected = 0;
+    uint32_t last = 0;
+    uint32_t count = 0;
+    std::size_t gear = 0;
+    uint32_t steady = 0;
+    uint32_t early = 0;
+    uint32_t outliers = 0;
+    bool settled = false;
+};
+
+/**
+ * @brief Hysteresis between a tracked tempo and the looper, so the loops are
+ * only retimed for real tempo changes and not for every wobble of the
+ * estimate.
+ *
+ * A period that moves past `threshold_ppm` from the one held is taken at
+ * once. A smaller offset is taken only once it has stayed on the same side
+ * of the held period for `persist` updates in a row, so a sender a little
+ * off the held tempo is still followed, in one step, while an estimate
+ * that wanders around it is not.
+ */
+class tempo_hold
+{
+public:
+    /**
+     * @brief Construct a new tempo hold, holding nothing yet
+     *
+     * @param threshold_ppm Change taken at once, in parts per million
+     * @param persist Updates a smaller change must last to be taken
+     */
+    tempo_hold(uint32_t threshold_ppm, uint32_t persist)
+      : threshold(threshold_ppm)
+      , persist(persist)
+    {
+    }
+
+    /**
+     * @brief Offer the latest period.
+     *
+     * @param period_us Tracked period; any unit, as long as it stays the same
+     * @return true if the held period changed
+     */
+    bool update(uint32_t period_us)
+    {
+        if (held == 0) {
+            take(period_us);
+            return true;
+        }
+        int64_t diff =
+          static_cast<int64_t>(period_us) - static_cast<int64_t>(held);
+        int64_t size = diff < 0 ? -diff : diff;
+        if (size * 1000000 > static_cast<int64_t>(threshold) * held) {
+            take(period_us);
+            return true;
+        }
+        int side = (diff > 0) - (diff < 0);
+        if (side != last_side) {
+            last_side = side;
+            run = 0;
+        }
+        if (side == 0) {
+            return false;
+        }
+        if (++run < persist) {
+            return false;
+        }
+        take(period_us);
+        return true;
+    }
+
+    /**
+     * @brief Forget the held period, so the next one offered is taken.
+     */
+    void release() { held = 0; }
+
+    /**
+     * @brief Held period, 0 when none is held.
+     */
+    uint32_t period_us() const { return held; }
+
+private:
+    void take(uint32_t period_us)
+    {
+        held = period_us;
+        last_side = 0;
+        run = 0;
+    }
+
+    uint32_t threshold;
+    uint32_t persist;
+    uint32_t held = 0;
+    uint32_t run = 0;
+    int last_side = 0;
+};
@@ -0,0 +1,129 @@
+/**
+ * @file tickless_idle.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Sleep between scheduler passes until the next task is due or an
+ * interrupt arrives.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * @brief The scheduler's idle step: works out when the next task is due,
+ * sets an alarm for it and waits for an interrupt, so the core sleeps
+ * instead of spinning and no periodic tick is needed.
+ *
+ * The alarm is set early by the wake-up latency so tasks still start on
+ * time, and sleeps shorter than it is worth are skipped. Nothing scheduled,
+ * or a task far off, still wakes within `max_sleep`; that must be shorter
+ * than the clock's counter wrap, since the wake-up is what reads the clock
+ * and carries it.
+ *
+ * The deadline is worked out and the alarm set with interrupts masked, so
+ * an interrupt that makes work between the decision and the wait is not
+ * lost: it stays pending and the wait returns at once. Its handler runs as
+ * soon as the mask lifts, and the scheduler polls again.
+ *
+ * A Clock provides `tick_type` and `static tick_type now()`, e.g.
+ * monotonic_clock. An Alarm provides:
+ *  - `static void set(tick_type at)`, an interrupt at `at`;
+ *  - `static void cancel()`;
+ *  - `static void wait()`, sleep until any interrupt is pending, WFI on
+ *    the target;
+ *  - `critical_section`, an RAII type that masks interrupts.
+ *
+ * @tparam Clock Clock the scheduler runs on
+ * @tparam Alarm Wake-up source on the same clock
+ */
+template<typename Clock, typename Alarm>
+class tickless_idle
+{
+public:
+    using tick_type = typename Clock::tick_type;
+
+    /**
+     * @brief When to wake, if at all.
+     */
+    struct plan
+    {
+        bool sleep;
+        tick_type wake;
+    };
+
+    /**
+     * @brief Construct an idle step.
+     *
+     * @param min_sleep Shortest sleep worth taking, in clock ticks
+     * @param max_sleep Longest sleep, in clock ticks
+     * @param latency Time from the alarm to the scheduler running again
+     */
+    tickless_idle(tick_type min_sleep, tick_type max_sleep, tick_type latency)
+      : min_sleep(min_sleep)
+      , max_sleep(max_sleep)
+      , latency(latency)
+    {
+    }
+
+    /**
+     * @brief Work out the wake-up time for the next release.
+     *
+     * @param now The current time
+     * @param pending Whether any task is scheduled
+     * @param next When the next task may be due
+     */
+    plan deadline(tick_type now, bool pending, tick_type next) const
+    {
+        tick_type wake = now + max_sleep;
+        if (pending) {
+            wake = std::min(wake, next > latency ? next - latency : 0);
+        }
+        if (wake <= now || wake - now < min_sleep) {
+            return { false, 0 };
+        }
+        return { true, wake };
+    }
+
+    /**
+     * @brief Sleep until the next release or the next interrupt, whichever
+     * comes first. Takes the scheduler's idle(pending, at) arguments.
+     */
+    void operator()(bool pending, tick_type next)
+    {
+        [[maybe_unused]] typename Alarm::critical_section lock;
+        const tick_type start = Clock::now();
+        const plan p = deadline(start, pending, next);
+        if (!p.sleep) {
+            return;
+        }
+        Alarm::set(p.wake);
+        // An alarm set after its time would not fire until the counter
+        // came round again
+        if (Clock::now() < p.wake) {
+            Alarm::wait();
+        }
+        Alarm::cancel();
+        ++sleeps;
+        slept += Clock::now() - start;
+    }
+
+    /**
+     * @brief Times the core has slept.
+     */
+    uint32_t sleep_count() const { return sleeps; }
+
+    /**
+     * @brief Clock ticks spent asleep, to compare with the time elapsed.
+     */
+    tick_type slept_ticks() const { return slept; }
+
+private:
+    tick_type min_sleep;
+    tick_type max_sleep;
+    tick_type latency;
+    uint32_t sleeps = 0;
+    tick_type slept = 0;
+};
@@ -0,0 +1,452 @@
+/**
+ * @file timer_wheel.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Hierarchical timer wheel that runs periodic tasks with O(1) insert
+ * and expiry, however many there are.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+// Quantized looper includes
+#include <quantized_looper/Software/task_stats.hpp>
+
+/**
+ * @brief A task for timer_wheel, built the same way as a
+ * task_control_block: a function, the clock it runs on, its period and the
+ * offset of its first run.
+ *
+ * A period of zero makes a one-shot task, run once at its offset and then
+ * again only when scheduled.
+ *
+ * @tparam Tick Unsigned tick count of a clock that does not wrap
+ */
+template<typename Tick>
+struct wheel_task
+{
+    using function_type = void (*)();
+    using clock_type = Tick (*)();
+
+    wheel_task(function_type function,
+               clock_type clock,
+               Tick period,
+               Tick offset)
+      : function(function)
+      , clock(clock)
+      , period(period)
+      , release(offset)
+    {
+    }
+
+    function_type function;
+    clock_type clock;
+    Tick period;
+    Tick release; //!< Offset until started, then the next time it is due
+};
+
+/**
+ * @brief Runs a fixed table of tasks, each when its release time comes,
+ * without looking at the tasks that are not due.
+ *
+ * Time is counted in granules of 2^shift clock ticks. Tasks sit in Levels
+ * wheels of 2^SlotBits slots, each an intrusive list. Level 0 holds tasks
+ * due within the current revolution of its slots, one granule per slot;
+ * level 1 holds the ones due within the current revolution of level 1, a
+ * level 0 revolution per slot, and so on. A task goes on the lowest level
+ * whose revolution covers how far off it is, found from the highest set
+ * bit of that distance, so insert and removal are a few instructions and
+ * a list link.
+ *
+ * Each time level 0 comes round, the next slot of level 1 is cascaded:
+ * its tasks are reinserted and drop to level 0, and likewise up the
+ * levels. A task is moved at most once per level before it runs. A bitmap
+ * of occupied slots lets poll() skip straight over empty granules, so
+ * catching up after a long stall costs a step per level 0 revolution, not
+ * per granule.
+ *
+ * A task is placed in the first granule that starts at or after its
+ * release, so it never runs early and runs at most a granule plus the
+ * polling interval late. Periodic tasks keep their phase: the next release
+ * is the last plus the period, and releases missed while the loop was
+ * stalled are skipped rather than run in a burst. Tasks due further out
+ * than the wheels reach wait in the top level and are reinserted as it
+ * comes round.
+ *
+ * With a task_stats for Stats, every run is timed and its lateness against
+ * its release recorded; the default no_task_stats leaves nothing behind.
+ *
+ * @tparam Tick Unsigned tick count of a clock that does not wrap
+ * @tparam Tasks Number of tasks in the table
+ * @tparam Stats Instrumentation, task_stats or no_task_stats
+ * @tparam SlotBits log2 of slots per level, at most 6
+ * @tparam Levels Number of levels
+ */
+template<typename Tick,
+         std::size_t Tasks,
+         typename Stats = no_task_stats,
+         unsigned SlotBits = 6,
+         unsigned Levels = 4>
+class timer_wheel
+{
+    static_assert(std::is_unsigned_v<Tick>, "Tick must be unsigned");
+    static_assert(SlotBits > 0 && SlotBits <= 6,
+                  "a level's occupancy must fit in 64 bits");
+    static_assert(Levels > 0 && SlotBits * Levels < 64,
+                  "granules must fit in 64 bits");
+
+public:
+    using tick_type = Tick;
+    using task_type = wheel_task<Tick>;
+    using table_type = std::array<task_type, Tasks>;
+
+    /**
+     * @brief Construct a wheel over a task table. Nothing runs until
+     * start().
+     *
+     * @param table Tasks to run; must outlive the wheel
+     * @param shift log2 of clock ticks per granule
+     */
+    timer_wheel(table_type& table, unsigned shift)
+      : tasks(&table)
+      , shift(shift)
+    {
+        heads.fill(none);
+        where.fill(none);
+    }
+
+    timer_wheel(timer_wheel const&) = delete;
+    void operator=(timer_wheel const&) = delete;
+
+    /**
+     * @brief Schedule every task at its offset from now.
+     */
+    void start(Tick now)
+    {
+        current = now >> shift;
+        for (std::size_t i = 0; i < Tasks; ++i) {
+            schedule(i, now + (*tasks)[i].release);
+        }
+    }
+
+    /**
+     * @brief Run every task due by `now`, in release order granule by
+     * granule.
+     *
+     * @return Tasks run
+     */
+    std::size_t poll(Tick now)
+    {
+        const uint64_t target = now >> shift;
+        std::size_t ran = 0;
+        while (current <= target) {
+            if ((current & mask) == 0) {
+                for (unsigned level = 1; level < Levels; ++level) {
+                    cascade(level);
+                    if (digit(current, level) != 0) {
+                        break;
+                    }
+                }
+            }
+            ran += expire(now);
+
+            // On to the next occupied slot of this revolution, or the start
+            // of the next one to cascade there
+            ++current;
+            const unsigned from = digit(current, 0);
+            if (from != 0) {
+                const uint64_t ahead = occupied[0] >> from;
+                const uint64_t next = ahead != 0
+                                        ? current + std::countr_zero(ahead)
+                                        : (current | mask) + 1;
+                current = std::min(next, target + 1);
+            }
+        }
+        return ran;
+    }
+
+    /**
+     * @brief Run a task at a given time, replacing its pending release.
+     * Safe from inside a task.
+     *
+     * @param task Index in the table
+     * @param at Clock time to run it; a time already past runs it in the
+     * next granule, which from inside a task is never the current one
+     */
+    void schedule(std::size_t task, Tick at)
+    {
+        cancel(task);
+        (*tasks)[task].release = at;
+        insert(static_cast<index_type>(task));
+    }
+
+    /**
+     * @brief Take a task off the wheel until scheduled again. Safe from
+     * inside a task.
+     */
+    void cancel(std::size_t task)
+    {
+        if (task == running) {
+            touched = true;
+        }
+        if (where[task] != none) {
+            unlink(static_cast<index_type>(task));
+        }
+    }
+
+    bool scheduled(std::size_t task) const { return where[task] != none; }
+
+    /**
+     * @brief Earliest clock time poll() may have anything to do, e.g. to
+     * sleep until then.
+     *
+     * Exact for a task due within the current revolution of level 0;
+     * otherwise it is when the slot holding the next task cascades, which
+     * is no later than the task's release. Polling any earlier does
+     * nothing.
+     *
+     * @param at Set to the time, if anything is scheduled
+     * @return false if no task is scheduled
+     */
+    bool next_release(Tick& at) const
+    {
+        uint64_t best = std::numeric_limits<uint64_t>::max();
+        for (unsigned level = 0; level < Levels; ++level) {
+            const uint64_t bits = occupied[level];
+            if (bits == 0) {
+                continue;
+            }
+            const unsigned width = level * SlotBits;
+            const uint64_t below = (uint64_t{ 1 } << width) - 1;
+            const unsigned d = digit(current, level);
+            // A slot is next due in this revolution of its level if it is
+            // ahead of the current one, or is the current one not yet
+            // reached
+            const unsigned first = (current & below) == 0 ? d : d + 1;
+            const uint64_t ahead = first < slots ? bits >> first << first : 0;
+            const uint64_t revolution = current >> (width + SlotBits)
+                                                 << (width + SlotBits);
+            const uint64_t slot = static_cast<uint64_t>(
+              ahead != 0 ? std::countr_zero(ahead)
+                         : slots + std::countr_zero(bits));
+            const uint64_t granule = revolution + (slot << width);
+            best = std::min(best, granule);
+        }
+        if (best == std::numeric_limits<uint64_t>::max()) {
+            return false;
+        }
+        at = static_cast<Tick>(best << shift);
+        return true;
+    }
+
+    /**
+     * @brief Clock ticks per granule.
+     */
+    Tick resolution() const { return Tick{ 1 } << shift; }
+
+    static constexpr std::size_t size() { return Tasks; }
+
+    /**
+     * @brief The first task's clock, which the scheduler runs on.
+     */
+    Tick now() const { return tasks->front().clock(); }
+
+    /**
+     * @brief Run times and lateness per task, with task_stats.
+     */
+    const Stats& statistics() const { return stats; }
+
+    Stats& statistics() { return stats; }
+
+private:
+    using index_type =
+      std::conditional_t<(Tasks < std::numeric_limits<uint16_t>::max()),
+                         uint16_t,
+                         uint32_t>;
+
+    static constexpr index_type none = std::numeric_limits<index_type>::max();
+    static constexpr uint64_t slots = uint64_t{ 1 } << SlotBits;
+    static constexpr uint64_t mask = slots - 1;
+    static constexpr uint64_t horizon = uint64_t{ 1 } << (SlotBits * Levels);
+
+    static unsigned digit(uint64_t granule, unsigned level)
+    {
+        return static_cast<unsigned>((granule >> (level * SlotBits)) & mask);
+    }
+
+    /**
+     * @brief Put a task in the slot for its release granule, rounded up so
+     * it never runs early.
+     */
+    void insert(index_type task)
+    {
+        const Tick release = (*tasks)[task].release;
+        uint64_t due = (static_cast<uint64_t>(release) >> shift) +
+                       ((release & (resolution() - 1)) != 0);
+        // A release already past goes in the next granule poll() reaches,
+        // which from inside a task is the one after the current
+        due = std::max(due, running != none ? current + 1 : current);
+
+        uint64_t ahead = due - current;
+        if (ahead >= horizon) {
+            // Past the top level's reach: wait in the last slot it reaches
+            // and be reinserted from there
+            ahead = horizon - 1;
+            due = current + ahead;
+        }
+        const unsigned level =
+          ahead < slots ? 0 : (std::bit_width(ahead) - 1) / SlotBits;
+        link(task, level * slots + digit(due, level));
+    }
+
+    void link(index_type task, std::size_t bucket)
+    {
+        const index_type head = heads[bucket];
+        next_of[task] = head;
+        prev_of[task] = none;
+        if (head != none) {
+            prev_of[head] = task;
+        }
+        heads[bucket] = task;
+        where[task] = static_cast<index_type>(bucket);
+        occupied[bucket / slots] |= uint64_t{ 1 } << (bucket % slots);
+    }
+
+    void unlink(index_type task)
+    {
+        const std::size_t bucket = where[task];
+        const index_type next = next_of[task];
+        const index_type prev = prev_of[task];
+        if (prev != none) {
+            next_of[prev] = next;
+        } else {
+            heads[bucket] = next;
+        }
+        if (next != none) {
+            prev_of[next] = prev;
+        }
+        where[task] = none;
+        if (heads[bucket] == none) {
+            occupied[bucket / slots] &= ~(uint64_t{ 1 } << (bucket % slots));
+        }
+    }
+
+    /**
+     * @brief Reinsert the tasks of a level's current slot, which now fall
+     * in lower levels.
+     */
+    void cascade(unsigned level)
+    {
+        const std::size_t bucket = level * slots + digit(current, level);
+        while (heads[bucket] != none) {
+            const index_type task = heads[bucket];
+            unlink(task);
+            insert(task);
+        }
+    }
+
+    /**
+     * @brief Run the tasks due in the current granule. A periodic task is
+     * reinserted at its next release after `now`, so never back here.
+     */
+    std::size_t expire(Tick now)
+    {
+        const std::size_t bucket = digit(current, 0);
+        std::size_t ran = 0;
+        while (heads[bucket] != none) {
+            const index_type i = heads[bucket];
+            unlink(i);
+            task_type& task = (*tasks)[i];
+            running = i;
+            touched = false;
+            if constexpr (Stats::enabled) {
+                const Tick late = task.clock() - task.release;
+                const uint32_t started = stats.start();
+                task.function();
+                stats.finish(i, started, late);
+            } else {
+                task.function();
+            }
+            running = none;
+            ++ran;
+            // Unless the task rescheduled or cancelled itself
+            if (task.period != 0 && !touched) {
+                task.release += task.period;
+                if (task.release <= now) {
+                    const Tick behind = now - task.release;
+                    task.release += (behind / task.period + 1) * task.period;
+                }
+                insert(i);
+            }
+        }
+        return ran;
+    }
+
+    table_type* tasks;
+    unsigned shift;
+    uint64_t current = 0;
+    index_type running = none;
+    bool touched = false;
+    [[no_unique_address]] Stats stats;
+    std::array<index_type, Levels * slots> heads{};
+    std::array<uint64_t, Levels> occupied{};
+    std::array<index_type, Tasks> next_of{};
+    std::array<index_type, Tasks> prev_of{};
+    std::array<index_type, Tasks> where{};
+};
+
+/**
+ * @brief Run a timer wheel forever, on its first task's clock.
+ *
+ * @param wheel Wheel over the task table, not yet started
+ * @param idle Called between passes as idle(pending, at), with whether a
+ * task is scheduled and timer_wheel::next_release(); returns when the
+ * loop should poll again, e.g. after sleeping until `at`
+ */
+template<typename Wheel, typename Idle>
+[[noreturn]] void wheel_scheduler(Wheel& wheel, Idle&& idle)
+{
+    static_assert(Wheel::size() > 0, "nothing to schedule");
+    wheel.start(wheel.now());
+    for (;;) {
+        wheel.poll(wheel.now());
+        decltype(wheel.now()) at = 0;
+        bool pending = wheel.next_release(at);
+        idle(pending, at);
+    }
+}
+
+/**
+ * @brief Run a task table on a timer wheel forever, on the first task's
+ * clock.
+ *
+ * @param tasks Task table, as for the linear scheduler
+ * @param shift log2 of clock ticks per granule
+ * @param idle As for the wheel overload
+ */
+template<typename Tick, std::size_t Tasks, typename Idle>
+[[noreturn]] void wheel_scheduler(std::array<wheel_task<Tick>, Tasks>& tasks,
+                                  unsigned shift,
+                                  Idle&& idle)
+{
+    timer_wheel<Tick, Tasks> wheel(tasks, shift);
+    wheel_scheduler(wheel, idle);
+}
+
+/**
+ * @brief Run a task table on a timer wheel forever, polling flat out.
+ */
+template<typename Tick, std::size_t Tasks>
+[[noreturn]] void wheel_scheduler(std::array<wheel_task<Tick>, Tasks>& tasks,
+                                  unsigned shift)
+{
+    wheel_scheduler(tasks, shift, [](bool, Tick) {});
+}
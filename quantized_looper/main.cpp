@@ -1,17 +1,45 @@
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 #include <memory>
 #include <vector>
 
-#include <reusable_synth/software/task.hpp>
 #include <reusable_synth/utils/logger.hpp>
 
 #include "stm32f767xx.h"
 #include "stm32f7xx_hal.h"
+#include <eth.h>
 #include <gpio.h>
 #include <main.h>
+#include <quantized_looper/Audio/audio_graph.hpp>
+#include <quantized_looper/Audio/loop_engine.hpp>
+#include <quantized_looper/Audio/mix_kernels.hpp>
+#include <quantized_looper/Audio/onset_tempo.hpp>
+#include <quantized_looper/Audio/polyphase_resampler.hpp>
+#include <quantized_looper/Audio/time_stretch.hpp>
+#include <quantized_looper/Audio/track_bank.hpp>
+#include <quantized_looper/Hardware/cycle_counter.hpp>
+#include <quantized_looper/Hardware/eth_udp.hpp>
 #include <quantized_looper/Hardware/led.hpp>
+#include <quantized_looper/Hardware/microsecond_timer.hpp>
+#include <quantized_looper/Hardware/midi_uart.hpp>
+#include <quantized_looper/Hardware/pendsv_trigger.hpp>
+#include <quantized_looper/Hardware/sai_audio.hpp>
+#include <quantized_looper/Hardware/timer_clock.hpp>
+#include <quantized_looper/Software/coroutine_task.hpp>
+#include <quantized_looper/Software/interrupt_executor.hpp>
+#include <quantized_looper/Software/midi_clock.hpp>
+#include <quantized_looper/Software/net_sync.hpp>
+#include <quantized_looper/Software/schedulability.hpp>
+#include <quantized_looper/Software/spsc_ring.hpp>
+#include <quantized_looper/Software/tap_tempo.hpp>
+#include <quantized_looper/Software/task_stats.hpp>
+#include <quantized_looper/Software/tempo_pll.hpp>
+#include <quantized_looper/Software/tickless_idle.hpp>
+#include <quantized_looper/Software/timer_wheel.hpp>
 #include <tim.h>
 #include <usart.h>
 
@@ -42,113 +70,867 @@ auto logger = LoggerSingleton::getLogger();
 
 std::vector<std::unique_ptr<ledBase>>* g_leds = nullptr;
 
-// Tap tempo globals
-static volatile uint32_t last_tap_time = 0;
-static volatile uint32_t cycle_time_ms = 1000; // Default 60 BPM (1 second)
-static constexpr uint32_t MIN_CYCLE_TIME = 60;
-static constexpr uint32_t MAX_CYCLE_TIME = 3000; // Min 20 BPM
-
-// LED cycle tracking
-static uint32_t last_update_time = 0;
+// Tap tempo, fitted over the last eight taps; starts at 60 BPM
+static constexpr uint32_t MIN_CYCLE_TIME_US = 60000;
+static constexpr uint32_t MAX_CYCLE_TIME_US = 3000000; // Min 20 BPM
+static constexpr uint32_t DEFAULT_CYCLE_TIME_US = 1000000;
+static tap_tempo<8> tempo(MIN_CYCLE_TIME_US,
+                          MAX_CYCLE_TIME_US,
+                          DEFAULT_CYCLE_TIME_US);
+// Taps the fit took, so a tempo found by ear is kept until the next one
+static std::atomic<uint32_t> taps{ 0 };
 
 extern UART_HandleTypeDef huart3;
 
-void fade_led0()
+// Audio path: DMA interrupt <-> block queue <-> loop engine in PendSV
+static constexpr uint32_t SAMPLE_RATE = 48000;
+static constexpr std::size_t AUDIO_BLOCK_FRAMES = 32;
+static constexpr uint32_t AUDIO_BLOCK_US =
+  static_cast<uint32_t>(AUDIO_BLOCK_FRAMES * 1000000 / SAMPLE_RATE);
+// Four one-second tracks take 375 KB, most of the SRAM
+static constexpr std::size_t LOOP_TRACKS = 4;
+// A track holds the longest loop. SRAM cannot hold a 4/4 bar at the slowest
+// tap tempo, 12 s at 20 BPM: one second holds a bar from 240 BPM up, and a
+// single beat at the default 60 BPM. A quantized recording that outgrows the
+// buffer closes where the buffer fills, which need not be on a beat.
+static constexpr std::size_t LOOP_SECONDS = 1;
+static_assert(LOOP_SECONDS * 1000000 >= DEFAULT_CYCLE_TIME_US,
+              "a track must hold at least a beat at the default tempo");
+static constexpr std::size_t LOOP_FADE_FRAMES = 96; // 2 ms
+// 48 KB of 512-sample undo pages shared by all tracks. Overdubs can be undone
+// on loops up to half a second, a beat at 120 BPM; an overdub on a longer
+// loop gets no undo layer and the track keeps its earlier ones. A pool for a
+// whole track would cost one of the four tracks
+static constexpr std::size_t LOOP_UNDO_PAGES = 48;
+
+using audio_t = sai_audio<int16_t, AUDIO_BLOCK_FRAMES>;
+using looper_t = track_bank<int16_t,
+                            LOOP_TRACKS,
+                            SAMPLE_RATE * LOOP_SECONDS,
+                            LOOP_FADE_FRAMES,
+                            polyphase_resampler<int16_t>,
+                            LOOP_UNDO_PAGES>;
+static_assert(looper_t::undo_frames >= SAMPLE_RATE / 2,
+              "overdubs on a half-second loop must be undoable");
+
+template<std::size_t Frames>
+using looper_graph_t = audio_graph<audio_block<int16_t, Frames, 2>,
+                                   gain_node<int16_t>,
+                                   loop_node<looper_t>,
+                                   onset_node<onset_tempo<>>>;
+
+static audio_t audio;
+static audio_block_queue<audio_t> audio_queue;
+static looper_t looper(SAMPLE_RATE);
+// Listens to the first loop as it is recorded, for its tempo
+static onset_tempo<> onsets(SAMPLE_RATE);
+static looper_graph_t<AUDIO_BLOCK_FRAMES> graph(
+  gain_node<int16_t>(gain_node<int16_t>::unity),
+  loop_node<looper_t>(looper),
+  onset_node<onset_tempo<>>(onsets));
+
+// MIDI clock: followed when one comes in, sent from the looper otherwise
+static midi_uart<> midi;
+static midi_clock_in midi_in(MIN_CYCLE_TIME_US, MAX_CYCLE_TIME_US);
+static midi_clock_out<looper_t::transport_type> midi_out;
+// The locked clock still wobbles by up to 0.1% on a DAW link. The loops are
+// retimed at once for a step past 0.2%, and for a smaller offset once it has
+// held for two seconds, rather than on every block
+static constexpr uint32_t TEMPO_HOLD_PPM = 2000;
+static constexpr uint32_t TEMPO_HOLD_BLOCKS = 2000000 / AUDIO_BLOCK_US;
+static tempo_hold midi_tempo(TEMPO_HOLD_PPM, TEMPO_HOLD_BLOCKS);
+
+// Network sync: tempo, beat phase and start/stop shared with the other
+// loopers on the LAN, the lowest device ID leading. The Ethernet and the
+// protocol run in a background task, since the PHY is read over a slow
+// management bus; the audio job only hands the task its position and
+// applies the steering the task last sent back
+static constexpr uint16_t SYNC_PORT = 47600;
+static constexpr uint32_t SYNC_PERIOD_US = 10000;
+static eth_udp<> eth;
+static net_sync* network = nullptr;
+// A follower runs at the leader's tempo, retimed through the same hold as
+// the MIDI clock, and takes out phase errors by moving its beat grid rather
+// than by retiming the loops: at most a sample per block, and not for the
+// couple of samples the clock offset is measured to
+static tempo_hold network_tempo(TEMPO_HOLD_PPM, 2000000 / SYNC_PERIOD_US);
+static constexpr int64_t SYNC_DEADBAND_SAMPLES = 2;
+static constexpr int64_t SYNC_SLIP_SAMPLES = 1;
+
+// The transport after each block, from the audio job to the sync task
+struct sync_position
+{
+    uint32_t block_us = 0; // When the codec took the block
+    uint64_t beats = 0;
+    uint32_t sample = 0;
+    uint32_t samples_per_beat = 0;
+    int64_t slipped = 0; // Every grid slip so far
+    bool external = false;
+    bool running = true;
+};
+
+// From the sync task to the audio job
+struct sync_steering
 {
-    static float led_pct = 0.0f;
-    static int direction = 1;
+    bool synced = false;
+    bool running = true;
+    uint32_t period_us = 0; // The leader's tempo, held
+    int64_t error = 0;      // Samples to slip the grid, behind positive
+    int64_t slipped = 0;    // The slips the error was measured after
+    bool jump = false;      // Slip all at once
+};
 
-    uint32_t current_time = HAL_GetTick();
+// Fifteen blocks to a run of the task, which keeps the newest position
+static spsc_ring<sync_position, 32> sync_positions;
+static spsc_ring<sync_steering, 4> sync_steerings;
 
-    if (last_update_time == 0) {
-        last_update_time = current_time;
-    }
+// When the codec last took a block. The transport's position is exact at
+// that instant and runs on at the tempo from there, so the position given
+// to net_sync does not step by whole blocks
+static std::atomic<uint32_t> block_time_us{ 0 };
 
-    uint32_t elapsed = current_time - last_update_time;
-    float change = direction * 2.0f * (float)elapsed / (float)cycle_time_ms;
+// Two tiers: time-critical jobs run from PendSV, below the peripheral
+// interrupts, and preempt the cooperative task loop however long a task
+// takes, e.g. a blocking UART write; the rest stay in the loop
+void task_process_audio();
+#ifdef QL_BENCHMARK
+void job_probe();
+#endif
+enum foreground_job : std::size_t
+{
+    JOB_AUDIO,
+#ifdef QL_BENCHMARK
+    JOB_PROBE,
+#endif
+    JOB_COUNT
+};
+// Each job's period and worst-case run time in microseconds, by priority;
+// audio has half of every block
+static constexpr std::array<task_budget, JOB_COUNT> JOB_BUDGETS = {
+    task_budget{ AUDIO_BLOCK_US, AUDIO_BLOCK_US / 2 },
+#ifdef QL_BENCHMARK
+    task_budget{ 1000000, 1 },
+#endif
+};
+#ifdef QL_TASK_STATS
+static volatile uint32_t audio_max_cycles = 0;
+#endif
+static interrupt_executor<pendsv_trigger, JOB_COUNT> foreground({
+  task_process_audio,
+#ifdef QL_BENCHMARK
+  job_probe,
+#endif
+});
 
-    led_pct += change;
+extern "C" void foreground_irq(void)
+{
+    foreground.run();
+}
 
-    if (led_pct >= 1.0f) {
-        led_pct = 2.0f - led_pct; // Reflect over 1.0
-        direction = -1;
-    } else if (led_pct < 0.0f) {
-        led_pct = -led_pct; // Reflect over 0
-        direction = 1;
-    }
+// Every block the codec hands over is processed straight away
+static void exchange_block(const int16_t* in, int16_t* out, void* context)
+{
+    block_time_us.store(microsecond_timer::now(), std::memory_order_relaxed);
+    audio_block_queue<audio_t>::exchange(in, out, context);
+    foreground.post(JOB_AUDIO);
+}
+
+void fade_led0()
+{
+    // Triangle over each beat of the looper's transport, so the LED and the
+    // loops cannot drift apart
+    auto now = looper.transport().now();
+    float phase = (float)now.sample / (float)looper.samples_per_beat();
+    float led_pct = phase < 0.5f ? 2.0f * phase : 2.0f - 2.0f * phase;
 
     auto range = (*g_leds)[0]->getRange();
     int final_amt = range.first + (int)((range.second - range.first) * led_pct);
 
     (*g_leds)[0]->setIntensity(final_amt);
-    last_update_time = current_time; // CRITICAL: Update for next call
 }
 
-// Task: Toggle LED 1 and log
-void toggle_led1()
+// Move the beat grid by a few samples, ahead when positive
+static void slip_grid(int64_t samples)
+{
+    auto now = looper.transport().now();
+    uint32_t spb = looper.samples_per_beat();
+    int64_t at = static_cast<int64_t>(now.beats) * spb + now.sample + samples;
+    at = std::max<int64_t>(at, 0);
+    looper.locate(static_cast<uint64_t>(at / spb),
+                  static_cast<uint32_t>(at % spb));
+}
+
+// Start or stop every recorded loop on the beat when the shared transport
+// does
+static void follow_run_state(bool running)
+{
+    static bool was_running = true;
+    if (running == was_running) {
+        return;
+    }
+    was_running = running;
+    for (std::size_t t = 0; t < LOOP_TRACKS; ++t) {
+        if (looper.length(t) > 0) {
+            looper.arm(t,
+                       running ? loop_command::play : loop_command::stop,
+                       quantize::beat);
+        }
+    }
+}
+
+// Hand the sync task the transport, and follow its last steering
+// @return Whether the tempo came from the network
+static bool follow_network(bool external)
 {
-    static bool led_state = false;
-    if (led_state) {
-        (*g_leds)[1]->off();
+    static sync_steering steering;
+    static int64_t slipped = 0;
+    static int64_t pending = 0;
+    static uint32_t period_us = 0;
+    bool fresh = false;
+    while (sync_steerings.try_pop(steering)) {
+        fresh = true;
+    }
+    // While an external MIDI clock drives this unit, its stop and start
+    // go out to the others
+    bool running = !external || midi_in.running();
+    if (external || !steering.synced) {
+        period_us = 0;
+        pending = 0;
+        follow_run_state(running);
     } else {
-        (*g_leds)[1]->on();
+        if (steering.period_us != period_us) {
+            period_us = steering.period_us;
+            looper.set_tempo_us(period_us);
+        }
+        if (fresh) {
+            // Less what was slipped since the task measured it
+            pending = steering.error - (slipped - steering.slipped);
+            if (!steering.jump && pending <= SYNC_DEADBAND_SAMPLES &&
+                pending >= -SYNC_DEADBAND_SAMPLES) {
+                pending = 0;
+            }
+        }
+        int64_t slip = steering.jump ? pending
+                                     : std::clamp(pending,
+                                                  -SYNC_SLIP_SAMPLES,
+                                                  SYNC_SLIP_SAMPLES);
+        if (slip != 0) {
+            slip_grid(slip);
+            slipped += slip;
+            pending -= slip;
+        }
+        follow_run_state(steering.running);
+    }
+
+    auto now = looper.transport().now();
+    sync_position position;
+    position.block_us = block_time_us.load(std::memory_order_relaxed);
+    position.beats = now.beats;
+    position.sample = now.sample;
+    position.samples_per_beat = looper.samples_per_beat();
+    position.slipped = slipped;
+    position.external = external;
+    position.running = running;
+    sync_positions.try_push(position);
+    return !external && steering.synced;
+}
+
+// Task: Exchange sync datagrams, and work out how the audio job should
+// steer onto the leader's timeline
+void task_sync_network()
+{
+    static sync_position latest;
+    static bool started = false;
+    while (sync_positions.try_pop(latest)) {
+        started = true;
+    }
+    uint64_t now = timer_clock::to_microseconds(timer_clock::now());
+    eth.poll(now, [](const uint8_t* data, std::size_t n, uint64_t at) {
+        network->receive(data, n, at);
+    });
+    if (!started) {
+        return;
     }
-    led_state = !led_state;
-    logger->info("LED 1 toggled");
+
+    // In Q40.24 beats, run on from the block at the tempo
+    const uint32_t spb = latest.samples_per_beat;
+    uint32_t since_block = microsecond_timer::now() - latest.block_us;
+    uint64_t sample = latest.sample + static_cast<uint64_t>(since_block) *
+                                        SAMPLE_RATE / 1000000;
+    int64_t position =
+      static_cast<int64_t>(latest.beats) * net_sync::one_beat +
+      static_cast<int64_t>((sample << 24) / spb);
+    uint32_t period_ns = static_cast<uint32_t>(
+      static_cast<uint64_t>(spb) * 1000000000 / SAMPLE_RATE);
+    network->poll(
+      now,
+      position,
+      period_ns,
+      latest.running,
+      [](const uint8_t* data, std::size_t n) { eth.send(data, n); });
+
+    sync_steering steering;
+    steering.slipped = latest.slipped;
+    if (latest.external || !network->synced(now)) {
+        network_tempo.release();
+        sync_steerings.try_push(steering);
+        return;
+    }
+    network_tempo.update(network->period_ns() / 1000);
+    auto steer = network->steer(now, position);
+    // Within a sixteenth of a beat unless it is a jump
+    int64_t error = ((steer.position - position) * spb) >> 24;
+    steering.synced = true;
+    steering.running = network->running();
+    steering.period_us = network_tempo.period_us();
+    steering.error = error;
+    steering.jump = steer.jump;
+    sync_steerings.try_push(steering);
+}
+
+// Listen to the first loop while it is recorded with no clock coming in,
+// and take its tempo when it closes; the loop is kept as recorded
+// @return Whether the tempo came from the recording and no tap has
+// replaced it since
+static bool follow_onsets(bool external, bool networked)
+{
+    static bool found = false;
+    static uint32_t taps_then = 0;
+    auto& listener = graph.node<2>();
+    bool first_take = false;
+    if (looper.base_length() == 0) {
+        for (std::size_t t = 0; t < LOOP_TRACKS; ++t) {
+            first_take |= looper.state(t) == loop_state::recording;
+        }
+    }
+    bool free = !external && !networked;
+    if (first_take && free) {
+        if (!listener.listens()) {
+            onsets.reset();
+            listener.listen(true);
+        }
+        return false;
+    }
+    if (listener.listens()) {
+        listener.listen(false);
+        uint32_t spb = looper.base_length() > 0 && free
+                         ? onsets.samples_per_beat(looper.base_length())
+                         : 0;
+        if (spb > 0) {
+            looper.adopt_tempo(spb);
+            found = true;
+            taps_then = taps.load(std::memory_order_relaxed);
+        }
+    }
+    found &= taps.load(std::memory_order_relaxed) == taps_then;
+    return found;
 }
 
-// Task: Toggle LED 2 and log
-void toggle_led2()
+// Foreground job: Run every captured block through the looper
+void task_process_audio()
 {
-    static bool led_state = false;
-    if (led_state) {
-        (*g_leds)[2]->off();
+#ifdef QL_TASK_STATS
+    const uint32_t started = cycle_counter::now();
+#endif
+    // An incoming MIDI clock overrides the network, which overrides the
+    // tempo of the first loop and then tap tempo, and the looper's own
+    // clock goes out only while none is coming in, so two units never
+    // chase each other
+    midi.poll([](uint8_t byte, uint32_t now) { midi_in.receive(byte, now); });
+    bool external = midi_in.present(microsecond_timer::now());
+    audio_queue.process([](const int16_t* in, int16_t* out) {
+        graph.process_interleaved(in, out);
+    });
+    // After processing, so the transport is at the block the codec took
+    // last; the tempo applies from the next block
+    bool networked = follow_network(external);
+    bool recorded = follow_onsets(external, networked);
+    // present() holds only while the clock's PLL is locked
+    if (external) {
+        if (midi_tempo.update(midi_in.period_us())) {
+            looper.set_tempo_us(midi_tempo.period_us());
+        }
     } else {
-        (*g_leds)[2]->on();
+        midi_tempo.release();
+        if (!networked && !recorded) {
+            looper.set_tempo_us(tempo.period_us());
+        }
+    }
+    if (!external) {
+        midi_out.poll(looper.transport().now(),
+                      [](uint8_t byte) { midi.send(byte); });
+    }
+#ifdef QL_TASK_STATS
+    const uint32_t cycles = cycle_counter::now() - started;
+    if (cycles > audio_max_cycles) {
+        audio_max_cycles = cycles;
+    }
+#endif
+}
+
+#ifdef QL_BENCHMARK
+// Log the cost of the looper graph per sample at each block size
+template<std::size_t Frames>
+void benchmark_graph()
+{
+    static looper_graph_t<Frames> bench(
+      gain_node<int16_t>(gain_node<int16_t>::unity),
+      loop_node<looper_t>(looper),
+      onset_node<onset_tempo<>>(onsets));
+    static audio_block<int16_t, Frames, 2> block;
+    uint32_t cycles = cycle_counter::measure([] { bench.process(block); }, 256);
+
+    static char msg[LoggerSingleton::logLen];
+    snprintf(msg,
+             sizeof(msg),
+             "graph %u frames: %lu cycles/block, %lu cycles/frame",
+             static_cast<unsigned>(Frames),
+             static_cast<unsigned long>(cycles),
+             static_cast<unsigned long>(cycles / Frames));
+    logger->info(msg);
+}
+
+// Log the track mix cost at each active track count, against the cycles
+// available for one block
+template<std::size_t Frames>
+void benchmark_tracks()
+{
+    static int16_t in[Frames];
+    static int16_t out[Frames];
+    const uint32_t budget = static_cast<uint32_t>(
+      static_cast<uint64_t>(SystemCoreClock) * Frames / SAMPLE_RATE);
+
+    static char msg[LoggerSingleton::logLen];
+    for (std::size_t active = 1; active <= LOOP_TRACKS; ++active) {
+        for (std::size_t t = 0; t < LOOP_TRACKS; ++t) {
+            looper.clear(t);
+        }
+        for (std::size_t t = 0; t < active; ++t) {
+            looper.arm(t, loop_command::record, quantize::immediate);
+            looper.process(in, out, Frames);
+            looper.arm(t, loop_command::overdub, quantize::immediate);
+        }
+        uint32_t cycles = cycle_counter::measure(
+          [] { looper.process(in, out, Frames); }, 256);
+
+        snprintf(msg,
+                 sizeof(msg),
+                 "%u tracks, %u frames: %lu of %lu cycles/block",
+                 static_cast<unsigned>(active),
+                 static_cast<unsigned>(Frames),
+                 static_cast<unsigned long>(cycles),
+                 static_cast<unsigned long>(budget));
+        logger->info(msg);
+    }
+    for (std::size_t t = 0; t < LOOP_TRACKS; ++t) {
+        looper.clear(t);
+    }
+}
+
+// Log what one track costs to resample per block, against the cycles
+// available for the block
+void benchmark_resample()
+{
+    constexpr std::size_t n = AUDIO_BLOCK_FRAMES;
+    static int16_t out[n];
+    const uint32_t budget = static_cast<uint32_t>(
+      static_cast<uint64_t>(SystemCoreClock) * n / SAMPLE_RATE);
+
+    static char msg[LoggerSingleton::logLen];
+    for (uint32_t percent : { 80u, 95u, 105u, 120u, 150u }) {
+        static resample_pos step;
+        step = resample_one * percent / 100;
+        uint32_t cycles = cycle_counter::measure(
+          [] {
+              polyphase_resampler<int16_t>::process(
+                looper.data(0), looper.capacity(), 0, step, out, n);
+          },
+          256);
+
+        snprintf(msg,
+                 sizeof(msg),
+                 "resample %lu%%, %u frames: %lu of %lu cycles/block per track",
+                 static_cast<unsigned long>(percent),
+                 static_cast<unsigned>(n),
+                 static_cast<unsigned long>(cycles),
+                 static_cast<unsigned long>(budget));
+        logger->info(msg);
     }
-    led_state = !led_state;
-    logger->info("LED 2 toggled");
 }
 
+// Log time-stretch cycles per block for one track, averaged over enough
+// blocks to include the hops that run the FFTs
+void benchmark_stretch()
+{
+    constexpr std::size_t n = AUDIO_BLOCK_FRAMES;
+    static int16_t out[n];
+    static time_stretch<int16_t> stretch;
+    const uint32_t budget = static_cast<uint32_t>(
+      static_cast<uint64_t>(SystemCoreClock) * n / SAMPLE_RATE);
+
+    static char msg[LoggerSingleton::logLen];
+    for (uint32_t percent : { 80u, 95u, 105u, 120u, 150u }) {
+        static resample_pos step;
+        static resample_pos pos;
+        step = resample_one * percent / 100;
+        pos = 0;
+        uint32_t cycles = cycle_counter::measure(
+          [] {
+              pos = stretch.process(
+                looper.data(0), looper.capacity(), pos, step, out, n);
+          },
+          256);
+
+        snprintf(msg,
+                 sizeof(msg),
+                 "stretch %lu%%, %u frames: %lu of %lu cycles/block per track",
+                 static_cast<unsigned long>(percent),
+                 static_cast<unsigned>(n),
+                 static_cast<unsigned long>(cycles),
+                 static_cast<unsigned long>(budget));
+        logger->info(msg);
+    }
+}
+
+// Log what listening for the tempo costs per block: on average, and on the
+// worst block, which finishes a hop and a correlation chunk
+void benchmark_onsets()
+{
+    constexpr std::size_t n = AUDIO_BLOCK_FRAMES;
+    static onset_tempo<> bench(SAMPLE_RATE);
+    static std::size_t offset;
+    offset = 0;
+    uint32_t mean = cycle_counter::measure(
+      [] {
+          bench.feed(looper.data(0) + offset, n);
+          offset = (offset + n) % (looper.capacity() - n);
+      },
+      2048);
+
+    uint32_t worst = 0;
+    for (std::size_t block = 0; block < 2048; ++block) {
+        uint32_t start = cycle_counter::now();
+        bench.feed(looper.data(0) + offset, n);
+        worst = std::max(worst, cycle_counter::now() - start);
+        offset = (offset + n) % (looper.capacity() - n);
+    }
+
+    static char msg[LoggerSingleton::logLen];
+    snprintf(msg,
+             sizeof(msg),
+             "onsets %u frames: %lu cycles/block, worst %lu",
+             static_cast<unsigned>(n),
+             static_cast<unsigned long>(mean),
+             static_cast<unsigned long>(worst));
+    logger->info(msg);
+}
+
+// How long a foreground job waits when a background task is busy: posted
+// at points through a millisecond of spinning in thread mode, the probe
+// logs the cycles from each post to it starting
+static volatile uint32_t probe_posted = 0;
+static volatile uint32_t probe_wait = 0;
+
+void job_probe()
+{
+    probe_wait = cycle_counter::now() - probe_posted;
+}
+
+void benchmark_foreground()
+{
+    constexpr uint32_t background = 96000;
+    constexpr uint32_t probes = 16;
+    uint32_t worst = 0;
+    uint32_t total = 0;
+    uint32_t start = cycle_counter::now();
+    uint32_t next = 0;
+    for (uint32_t p = 0; p < probes;) {
+        uint32_t elapsed = cycle_counter::now() - start;
+        if (elapsed >= background) {
+            break;
+        }
+        if (elapsed >= next) {
+            probe_posted = cycle_counter::now();
+            foreground.post(JOB_PROBE);
+            worst = std::max(worst, static_cast<uint32_t>(probe_wait));
+            total += probe_wait;
+            next += background / probes;
+            ++p;
+        }
+    }
+
+    static char msg[LoggerSingleton::logLen];
+    snprintf(msg,
+             sizeof(msg),
+             "foreground behind a %lu cycle task: %lu cycles mean, worst %lu",
+             static_cast<unsigned long>(background),
+             static_cast<unsigned long>(total / probes),
+             static_cast<unsigned long>(worst));
+    logger->info(msg);
+}
+
+// Log packed against scalar cycles for the mix kernels on one stereo block
+void benchmark_kernels()
+{
+    constexpr std::size_t n = 2 * AUDIO_BLOCK_FRAMES;
+    static int16_t a[n];
+    static int16_t b[n];
+    static int32_t a31[n];
+    static int32_t b31[n];
+
+    struct
+    {
+        const char* name;
+        uint32_t scalar;
+        uint32_t packed;
+    } results[] = {
+        { "mix_q15",
+          cycle_counter::measure([] { mix_q15_scalar(a, b, n); }, 256),
+          cycle_counter::measure([] { mix_q15(a, b, n); }, 256) },
+        { "overdub_q15",
+          cycle_counter::measure(
+            [] { overdub_q15_scalar(a, b, 29000, n); }, 256),
+          cycle_counter::measure([] { overdub_q15(a, b, 29000, n); }, 256) },
+        { "mix2_q15",
+          cycle_counter::measure(
+            [] { mix2_q15_scalar(a, a, 23170, b, 23170, n); }, 256),
+          cycle_counter::measure([] { mix2_q15(a, a, 23170, b, 23170, n); },
+                                 256) },
+        { "mix_q31",
+          cycle_counter::measure([] { mix_q31_scalar(a31, b31, n); }, 256),
+          cycle_counter::measure([] { mix_q31(a31, b31, n); }, 256) },
+        { "overdub_q31",
+          cycle_counter::measure(
+            [] { overdub_q31_scalar(a31, b31, 1900000000, n); }, 256),
+          cycle_counter::measure([] { overdub_q31(a31, b31, 1900000000, n); },
+                                 256) },
+    };
+
+    static char msg[LoggerSingleton::logLen];
+    for (const auto& r : results) {
+        snprintf(msg,
+                 sizeof(msg),
+                 "%s %u samples: scalar %lu cycles, packed %lu cycles",
+                 r.name,
+                 static_cast<unsigned>(n),
+                 static_cast<unsigned long>(r.scalar),
+                 static_cast<unsigned long>(r.packed));
+        logger->info(msg);
+    }
+}
+#endif
+
+// The log goes out on the ST-LINK UART a chunk per run, so the task holds
+// the loop up for 1.4 ms at a time rather than up to 17 ms for a full line.
+// At a chunk every 10 ms the log drains at most 1.6 kB/s
+static constexpr uint32_t LOG_BAUD = 115200;
+static constexpr std::size_t LOG_CHUNK = 16;
+static constexpr uint32_t LOG_CHUNK_US = LOG_CHUNK * 10 * 1000000 / LOG_BAUD;
+
+// Task: Send the oldest log line, a chunk at a time
 void task_print_logs()
 {
-    auto log = logger->remove_log();
-    if (log.has_value()) {
-        const char* msg = log->pBuffer();
-        HAL_UART_Transmit(&huart3, (uint8_t*)msg, strlen(msg), 100);
-        HAL_UART_Transmit(&huart3, (uint8_t*)"\r\n", 2, 100);
+    static char line[LoggerSingleton::logLen + 2];
+    static std::size_t length = 0;
+    static std::size_t sent = 0;
+    if (sent == length) {
+        auto log = logger->remove_log();
+        if (!log.has_value()) {
+            return;
+        }
+        length = strnlen(log->pBuffer(), LoggerSingleton::logLen);
+        memcpy(line, log->pBuffer(), length);
+        line[length++] = '\r';
+        line[length++] = '\n';
+        sent = 0;
+    }
+    std::size_t n = std::min(LOG_CHUNK, length - sent);
+    HAL_UART_Transmit(&huart3, (uint8_t*)line + sent, n, 100);
+    sent += n;
+}
+
+// Build with QL_TASK_STATS to time every task in core cycles and histogram
+// how late it starts, dumped to the log every ten seconds; without it the
+// scheduler carries no instrumentation at all
+#ifdef QL_TASK_STATS
+static constexpr std::size_t TASK_COUNT = 6;
+using task_stats_t = task_stats<TASK_COUNT, cycle_counter>;
+#else
+static constexpr std::size_t TASK_COUNT = 5;
+using task_stats_t = no_task_stats;
+#endif
+
+// Every task's period and worst-case run time budget in microseconds, in
+// table order. The build fails unless each can finish within its period
+// under the scheduler's policy, audio preempting and each task waiting for
+// one run of every other; QL_TASK_STATS logs any measured worst case over
+// its budget
+static constexpr std::array<task_budget, TASK_COUNT> TASK_BUDGETS = {
+    task_budget{ 20000, 50 },                 // fade_led0
+    task_budget{ 800000, 50 },                // LED 1 blink
+    task_budget{ 600000, 50 },                // LED 2 blink
+    task_budget{ 10000, LOG_CHUNK_US + 100 }, // task_print_logs
+    task_budget{ SYNC_PERIOD_US, 500 },       // task_sync_network
+#ifdef QL_TASK_STATS
+    task_budget{ 10000000, 2000 }, // task_report_stats
+#endif
+};
+// A release is up to a wheel granule and a wake-up late
+static constexpr uint64_t RELEASE_JITTER_US = 12;
+static_assert(schedulable(TASK_BUDGETS, JOB_BUDGETS, RELEASE_JITTER_US),
+              "the task table cannot meet its deadlines; see TASK_BUDGETS");
+
+using tcb_t = wheel_task<timer_clock::tick_type>;
+using wheel_t = timer_wheel<timer_clock::tick_type, TASK_COUNT, task_stats_t>;
+static wheel_t* scheduler = nullptr;
+
+// Tasks written as loops run as coroutines at their own table entries, with
+// frames from a pool rather than the 512-byte heap
+using coroutines = coroutine_tasks<wheel_t>;
+using task_frames = frame_pool<128, 2>;
+
+// Task: Toggle an LED every period, and log it
+static co_task<task_frames> blink(std::size_t led,
+                                  timer_clock::tick_type period,
+                                  const char* msg)
+{
+    auto next = timer_clock::now();
+    for (;;) {
+        (*g_leds)[led]->on();
+        logger->info(msg);
+        next += period;
+        co_await sleep_until{ next };
+        (*g_leds)[led]->off();
+        logger->info(msg);
+        next += period;
+        co_await sleep_until{ next };
     }
 }
 
+#ifdef QL_TASK_STATS
+static constexpr std::array<const char*, TASK_COUNT> task_names = {
+    "fade_led0",  "blink_led1",   "blink_led2",
+    "print_logs", "sync_network", "report_stats"
+};
+
+// Log a worst case over its budget, which needs raising in the table
+static void check_budget(const char* name, uint32_t cycles, uint64_t budget)
+{
+    uint64_t us = cycles_to_us(cycles, SystemCoreClock);
+    if (us <= budget) {
+        return;
+    }
+    static char msg[LoggerSingleton::logLen];
+    snprintf(msg,
+             sizeof(msg),
+             "%s over budget: %lu us, budget %lu us",
+             name,
+             static_cast<unsigned long>(us),
+             static_cast<unsigned long>(budget));
+    logger->info(msg);
+}
+
+// Task: Log each task's run time and lateness since the last report, and
+// any worst case over its budget
+void task_report_stats()
+{
+    auto& stats = scheduler->statistics();
+    stats.dump(task_names, [](const char* line) { logger->info(line); });
+    for (std::size_t t = 0; t < TASK_COUNT; ++t) {
+        check_budget(task_names[t], stats[t].max_cycles, TASK_BUDGETS[t].wcet);
+    }
+    check_budget(
+      "process_audio", audio_max_cycles, JOB_BUDGETS[JOB_AUDIO].wcet);
+    stats.reset();
+    audio_max_cycles = 0;
+}
+#endif
+
 extern "C" void EXTI15_10_IRQHandler(void)
 {
     HAL_GPIO_EXTI_IRQHandler(USER_Btn_Pin);
 }
 
-extern "C" void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+// SysTick keeps the HAL tick until the scheduler starts and stops it; from
+// then on the tick is read off the timer clock, carrying on from there
+static bool tickless = false;
+static uint32_t tick_offset_ms = 0;
+
+extern "C" uint32_t HAL_GetTick(void)
 {
-    if (GPIO_Pin == USER_Btn_Pin) {
-        uint32_t current_time = HAL_GetTick();
+    if (!tickless) {
+        return uwTick;
+    }
+    return tick_offset_ms +
+           static_cast<uint32_t>(
+             timer_clock::to_microseconds(timer_clock::now()) / 1000);
+}
 
-        // Debounce: ignore presses within 200ms of last press
-        static uint32_t last_press_time = 0;
-        if (current_time - last_press_time < 50) {
-            return; // Too soon, ignore
-        }
+extern "C" void TIM5_IRQHandler(void)
+{
+    tim5_alarm::irq();
+}
+
+extern "C" void DMA2_Stream1_IRQHandler(void)
+{
+    audio.tx_irq();
+}
+
+extern "C" void DMA2_Stream5_IRQHandler(void)
+{
+    audio.rx_irq();
+}
 
-        last_press_time = current_time;
+extern "C" void USART6_IRQHandler(void)
+{
+    midi.irq();
+}
 
-        if (last_tap_time > 0) {
-            uint32_t time_diff = current_time - last_tap_time;
+extern "C" void DMA2_Stream6_IRQHandler(void)
+{
+    midi.tx_dma_irq();
+}
 
-            // Clamp to reasonable BPM range
-            if (time_diff >= MIN_CYCLE_TIME && time_diff <= MAX_CYCLE_TIME) {
-                cycle_time_ms = time_diff;
-                logger->info("BPM updated");
-            }
-        }
+extern "C" void ETH_IRQHandler(void)
+{
+    eth.irq();
+}
 
-        last_tap_time = current_time;
+extern "C" void HAL_ETH_RxAllocateCallback(uint8_t** buff)
+{
+    *buff = eth.rx_allocate();
+}
+
+extern "C" void HAL_ETH_RxLinkCallback(void** pStart,
+                                       void** pEnd,
+                                       uint8_t* buff,
+                                       uint16_t Length)
+{
+    eth.rx_link(pStart, pEnd, buff, Length);
+}
+
+extern "C" void HAL_ETH_TxFreeCallback(uint32_t* buff)
+{
+    eth.tx_free(buff);
+}
+
+extern "C" void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart)
+{
+    if (huart == midi.handle()) {
+        midi.tx_complete();
+    }
+}
+
+extern "C" void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    if (GPIO_Pin == USER_Btn_Pin) {
+        // Timestamp first, so the rest of the handler adds no jitter.
+        // Bounces closer than the shortest beat are rejected by the fit
+        uint32_t now = microsecond_timer::now();
+        if (tempo.tap(now)) {
+            taps.fetch_add(1, std::memory_order_relaxed);
+            logger->info("BPM updated");
+        }
     }
 }
 
@@ -159,10 +941,42 @@ int main()
     SystemClock_Config();
 
     MX_GPIO_Init();
+    cycle_counter::enable();
+    tim5_source::enable();
+    pendsv_trigger::enable();
+    timer_clock::reset();
+    microsecond_timer::enable();
     HAL_NVIC_SetPriority(EXTI15_10_IRQn, 5, 0); // Lower priority than system
     HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
     MX_TIM3_Init();
     MX_USART3_UART_Init();
+    midi.init();
+    midi.start();
+    MX_ETH_Init();
+    eth.init(SYNC_PORT);
+    static net_sync node(eth.id());
+    network = &node;
+
+#ifdef QL_BENCHMARK
+    looper.arm(0, loop_command::record, quantize::immediate);
+    benchmark_graph<16>();
+    benchmark_graph<32>();
+    benchmark_graph<64>();
+    benchmark_graph<128>();
+    benchmark_kernels();
+    benchmark_resample();
+    benchmark_stretch();
+    benchmark_onsets();
+    benchmark_foreground();
+    benchmark_tracks<16>();
+    benchmark_tracks<32>();
+    benchmark_tracks<64>();
+    benchmark_tracks<128>();
+#endif
+
+    audio.init();
+    audio.set_callback(exchange_block, &audio_queue);
+    audio.start();
 
     std::vector<std::unique_ptr<ledBase>> leds;
     leds.push_back(std::make_unique<led<TIM_HandleTypeDef>>(
@@ -173,24 +987,59 @@ int main()
 
     g_leds = &leds;
 
-    std::array<task_control_block<uint32_t>, 4> tasks = {
-        task_control_block<uint32_t>(fade_led0,
-                                     HAL_GetTick,
-                                     timer<uint32_t>::milliseconds(20),
-                                     timer<uint32_t>::milliseconds(0)),
-        task_control_block<uint32_t>(toggle_led1,
-                                     HAL_GetTick,
-                                     timer<uint32_t>::milliseconds(800),
-                                     timer<uint32_t>::milliseconds(0)),
-        task_control_block<uint32_t>(toggle_led2,
-                                     HAL_GetTick,
-                                     timer<uint32_t>::milliseconds(600),
-                                     timer<uint32_t>::milliseconds(0)),
-        task_control_block<uint32_t>(task_print_logs,
-                                     HAL_GetTick,
-                                     timer<uint32_t>::milliseconds(100),
-                                     timer<uint32_t>::milliseconds(0))
+    // Scheduled on the 64-bit timer clock: periods finer than a millisecond
+    // and no wrap. Audio is not among them; it runs from PendSV. A timer
+    // wheel only looks at the tasks that are due, however many there are;
+    // granules of 2^10 ticks are about 10.7 us at 96 MHz
+    std::array<tcb_t, TASK_COUNT> tasks = {
+        tcb_t(fade_led0,
+              timer_clock::now,
+              timer_clock::microseconds(TASK_BUDGETS[0].period),
+              timer_clock::milliseconds(0)),
+        tcb_t(coroutines::resume<1>, timer_clock::now, 0, 0),
+        tcb_t(coroutines::resume<2>, timer_clock::now, 0, 0),
+        tcb_t(task_print_logs,
+              timer_clock::now,
+              timer_clock::microseconds(TASK_BUDGETS[3].period),
+              timer_clock::milliseconds(0)),
+        tcb_t(task_sync_network,
+              timer_clock::now,
+              timer_clock::microseconds(TASK_BUDGETS[4].period),
+              timer_clock::milliseconds(0)),
+#ifdef QL_TASK_STATS
+        tcb_t(task_report_stats,
+              timer_clock::now,
+              timer_clock::microseconds(TASK_BUDGETS[5].period),
+              timer_clock::milliseconds(10000)),
+#endif
     };
+    static wheel_t wheel(tasks, 10);
+    scheduler = &wheel;
+    static auto led1 = blink(
+      1, timer_clock::microseconds(TASK_BUDGETS[1].period), "LED 1 toggled");
+    static auto led2 = blink(
+      2, timer_clock::microseconds(TASK_BUDGETS[2].period), "LED 2 toggled");
+    if (!led1 || !led2) {
+        logger->info("No room for the LED tasks' coroutine frames");
+    }
+    coroutines::attach(wheel);
+    coroutines::bind<1>(led1);
+    coroutines::bind<2>(led2);
 
-    scheduler(tasks);
+    // Between tasks the core sleeps until the next is due or an interrupt
+    // comes, so SysTick is not needed; every wake-up reads the clock, and
+    // the 100 ms cap is far inside its 44 s wrap
+    static tickless_idle<timer_clock, tim5_alarm> idle(
+      timer_clock::microseconds(5),
+      timer_clock::milliseconds(100),
+      timer_clock::microseconds(1));
+    {
+        tim5_source::critical_section lock;
+        tick_offset_ms =
+          uwTick - static_cast<uint32_t>(
+                     timer_clock::to_microseconds(timer_clock::now()) / 1000);
+        tickless = true;
+        HAL_SuspendTick();
+    }
+    wheel_scheduler(wheel, idle);
 }
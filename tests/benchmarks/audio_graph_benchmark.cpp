@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <quantized_looper/Audio/audio_graph.hpp>
+#include <quantized_looper/Audio/loop_engine.hpp>
+
+namespace {
+
+using looper_t = loop_engine<int16_t, 48000>;
+
+template<std::size_t Frames>
+using looper_graph_t = audio_graph<audio_block<int16_t, Frames, 2>,
+                                   gain_node<int16_t>,
+                                   loop_node<looper_t>>;
+
+// Same graph as main.cpp, with the looper overdubbing so every node does work
+template<std::size_t Frames>
+void BM_LooperGraph(benchmark::State& state)
+{
+    static looper_t looper(48000);
+    looper.arm(loop_command::record, quantize::immediate);
+    looper_graph_t<Frames> graph(gain_node<int16_t>(30000),
+                                 loop_node<looper_t>(looper));
+    audio_block<int16_t, Frames, 2> block;
+    for (std::size_t i = 0; i < Frames; ++i) {
+        block.data[0][i] = static_cast<int16_t>(i * 64);
+        block.data[1][i] = static_cast<int16_t>(-i * 64);
+    }
+    for (std::size_t i = 0; i < 1000; ++i) {
+        graph.process(block);
+    }
+    looper.arm(loop_command::overdub, quantize::immediate);
+
+    for (auto _ : state) {
+        graph.process(block);
+        benchmark::DoNotOptimize(block);
+    }
+    state.SetItemsProcessed(state.iterations() * Frames);
+}
+
+BENCHMARK_TEMPLATE(BM_LooperGraph, 16);
+BENCHMARK_TEMPLATE(BM_LooperGraph, 32);
+BENCHMARK_TEMPLATE(BM_LooperGraph, 64);
+BENCHMARK_TEMPLATE(BM_LooperGraph, 128);
+
+// Same work, saturating as gain_node does, with the block size only known
+// at run time, to show what the constant trip count buys
+void BM_RuntimeBlockGain(benchmark::State& state)
+{
+    const std::size_t frames = static_cast<std::size_t>(state.range(0));
+    std::vector<int16_t> samples(2 * frames, 1000);
+    volatile int32_t gain = 30000;
+    for (auto _ : state) {
+        int32_t g = gain;
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            const int64_t y = (static_cast<int64_t>(samples[i]) * g) >> 15;
+            samples[i] = static_cast<int16_t>(
+              std::clamp<int64_t>(y, INT16_MIN, INT16_MAX));
+        }
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.SetItemsProcessed(state.iterations() * frames);
+}
+
+template<std::size_t Frames>
+void BM_FixedBlockGain(benchmark::State& state)
+{
+    audio_block<int16_t, Frames, 2> block;
+    block.data[0].fill(1000);
+    block.data[1].fill(1000);
+    gain_node<int16_t> gain(30000);
+    for (auto _ : state) {
+        gain.process(block);
+        benchmark::DoNotOptimize(block);
+    }
+    state.SetItemsProcessed(state.iterations() * Frames);
+}
+
+BENCHMARK(BM_RuntimeBlockGain)->Arg(16)->Arg(32)->Arg(64)->Arg(128);
+BENCHMARK_TEMPLATE(BM_FixedBlockGain, 16);
+BENCHMARK_TEMPLATE(BM_FixedBlockGain, 32);
+BENCHMARK_TEMPLATE(BM_FixedBlockGain, 64);
+BENCHMARK_TEMPLATE(BM_FixedBlockGain, 128);
+
+} // namespace
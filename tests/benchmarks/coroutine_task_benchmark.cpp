@@ -0,0 +1,132 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <coroutine>
+#include <cstdint>
+
+#include <quantized_looper/Software/coroutine_task.hpp>
+#include <quantized_looper/Software/timer_wheel.hpp>
+
+namespace {
+
+using frames = frame_pool<256, 8>;
+
+// The LED toggles as the looper has them: state in a static, and as a
+// coroutine loop
+uint64_t sim_now = 0;
+bool led_state = false;
+
+uint64_t sim_clock()
+{
+    return sim_now;
+}
+
+void toggle()
+{
+    static bool state = false;
+    state = !state;
+    led_state = state;
+}
+
+co_task<frames> toggle_loop()
+{
+    bool state = false;
+    for (;;) {
+        state = !state;
+        led_state = state;
+        co_await std::suspend_always{};
+    }
+}
+
+// One call through a function pointer, as the scheduler runs a task
+void BM_FunctionResume(benchmark::State& state)
+{
+    void (*volatile task)() = toggle;
+    for (auto _ : state) {
+        task();
+    }
+    benchmark::DoNotOptimize(led_state);
+}
+
+BENCHMARK(BM_FunctionResume);
+
+// One resume of a suspended coroutine and its suspend again
+void BM_CoroutineResume(benchmark::State& state)
+{
+    auto loop = toggle_loop();
+    std::coroutine_handle<> handle = loop.handle();
+    for (auto _ : state) {
+        handle.resume();
+    }
+    benchmark::DoNotOptimize(led_state);
+}
+
+BENCHMARK(BM_CoroutineResume);
+
+// Whole runs on the timer wheel: four tasks due every granule, as periodic
+// function tasks or as coroutines sleeping until their next release
+using task_t = wheel_task<uint64_t>;
+using wheel_t = timer_wheel<uint64_t, 4>;
+using coroutines = coroutine_tasks<wheel_t>;
+constexpr unsigned shift = 4;
+constexpr uint64_t period = uint64_t{ 1 } << shift;
+
+co_task<frames> periodic_loop()
+{
+    uint64_t next = sim_clock();
+    for (;;) {
+        toggle();
+        next += period;
+        co_await sleep_until{ next };
+    }
+}
+
+void BM_FunctionTasksOnWheel(benchmark::State& state)
+{
+    sim_now = 0;
+    std::array<task_t, 4> tasks = { task_t(toggle, sim_clock, period, 0),
+                                    task_t(toggle, sim_clock, period, 0),
+                                    task_t(toggle, sim_clock, period, 0),
+                                    task_t(toggle, sim_clock, period, 0) };
+    wheel_t wheel(tasks, shift);
+    wheel.start(sim_now);
+    for (auto _ : state) {
+        sim_now += period;
+        wheel.poll(sim_now);
+    }
+    benchmark::DoNotOptimize(led_state);
+    state.SetItemsProcessed(state.iterations() * 4);
+}
+
+BENCHMARK(BM_FunctionTasksOnWheel);
+
+void BM_CoroutineTasksOnWheel(benchmark::State& state)
+{
+    sim_now = 0;
+    std::array<co_task<frames>, 4> loops = {
+        periodic_loop(), periodic_loop(), periodic_loop(), periodic_loop()
+    };
+    std::array<task_t, 4> tasks = {
+        task_t(coroutines::resume<0>, sim_clock, 0, 0),
+        task_t(coroutines::resume<1>, sim_clock, 0, 0),
+        task_t(coroutines::resume<2>, sim_clock, 0, 0),
+        task_t(coroutines::resume<3>, sim_clock, 0, 0)
+    };
+    wheel_t wheel(tasks, shift);
+    coroutines::attach(wheel);
+    coroutines::bind<0>(loops[0]);
+    coroutines::bind<1>(loops[1]);
+    coroutines::bind<2>(loops[2]);
+    coroutines::bind<3>(loops[3]);
+    wheel.start(sim_now);
+    for (auto _ : state) {
+        sim_now += period;
+        wheel.poll(sim_now);
+    }
+    benchmark::DoNotOptimize(led_state);
+    state.SetItemsProcessed(state.iterations() * 4);
+}
+
+BENCHMARK(BM_CoroutineTasksOnWheel);
+
+} // namespace
@@ -0,0 +1,109 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+
+#include <quantized_looper/Audio/transport.hpp>
+#include <quantized_looper/Software/event_queue.hpp>
+
+namespace {
+
+constexpr std::size_t pending = 1024;
+
+// Due times spread over a few seconds of audio ahead
+std::vector<uint64_t> times(std::size_t n)
+{
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<uint64_t> ahead(1, 4 * 48000);
+    std::vector<uint64_t> t(n);
+    for (auto& v : t) {
+        v = ahead(rng);
+    }
+    return t;
+}
+
+// What the audio callback pays each block: one check, nothing due
+void BM_EventQueueNothingDue(benchmark::State& state)
+{
+    event_queue<int, pending> q;
+    for (uint64_t t : times(pending)) {
+        while (!q.post(t + 48000, 0)) {
+            q.drain();
+        }
+    }
+    q.drain();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(q.pop_due(0, [](uint64_t, int) {}));
+    }
+}
+BENCHMARK(BM_EventQueueNothingDue);
+
+// Steady state with 1k pending: post one event, fire the earliest
+void BM_EventQueueChurn(benchmark::State& state)
+{
+    event_queue<int, pending + 1> q;
+    auto t = times(pending);
+    for (uint64_t v : t) {
+        while (!q.post(v, 0)) {
+            q.drain();
+        }
+    }
+    q.drain();
+    uint64_t now = 0;
+    std::size_t i = 0;
+    for (auto _ : state) {
+        q.post(now + t[i], 1);
+        i = (i + 1) % pending;
+        uint64_t at = 0;
+        q.next_due(at);
+        now = at;
+        benchmark::DoNotOptimize(q.pop_due(now, [](uint64_t, int) {}));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EventQueueChurn);
+
+// Only the pop, refilled outside the timing: O(1) whatever is pending
+void BM_EventQueuePop(benchmark::State& state)
+{
+    event_queue<int, pending> q;
+    auto t = times(pending);
+    int e = 0;
+    for (auto _ : state) {
+        if (q.pending_count() == 0) {
+            state.PauseTiming();
+            for (uint64_t v : t) {
+                while (!q.post(v, 0)) {
+                    q.drain();
+                }
+            }
+            q.drain();
+            state.ResumeTiming();
+        }
+        benchmark::DoNotOptimize(q.pop(~uint64_t{ 0 }, e));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EventQueuePop);
+
+// The transport's queue under the same churn, for comparison: its insert
+// scans from the back and its pop shifts the array down
+void BM_TransportQueueChurn(benchmark::State& state)
+{
+    transport<int, pending + 1> tr(48000);
+    auto t = times(pending);
+    for (uint64_t v : t) {
+        tr.schedule_at(0, v);
+    }
+    std::size_t i = 0;
+    for (auto _ : state) {
+        tr.schedule_at(1, tr.sample_clock() + t[i]);
+        i = (i + 1) % pending;
+        tr.advance(tr.samples_to_next_action());
+        tr.fire_due([](int a) { benchmark::DoNotOptimize(a); });
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TransportQueueChurn);
+
+} // namespace
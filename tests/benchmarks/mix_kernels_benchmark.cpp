@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include <quantized_looper/Audio/mix_kernels.hpp>
+
+namespace {
+
+// One block of a 32-frame stereo stream, the size the firmware runs at
+constexpr std::size_t samples = 64;
+
+template<typename T>
+std::vector<T> ramp(std::size_t n, T step)
+{
+    std::vector<T> v(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        v[i] = static_cast<T>(i * step);
+    }
+    return v;
+}
+
+template<void (*Kernel)(int16_t*, const int16_t*, std::size_t)>
+void BM_MixQ15(benchmark::State& state)
+{
+    auto dst = ramp<int16_t>(samples, 97);
+    auto src = ramp<int16_t>(samples, 131);
+    for (auto _ : state) {
+        Kernel(dst.data(), src.data(), samples);
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * samples);
+}
+BENCHMARK(BM_MixQ15<mix_q15_scalar>);
+BENCHMARK(BM_MixQ15<mix_q15>);
+
+template<void (*Kernel)(int16_t*, const int16_t*, int16_t, std::size_t)>
+void BM_OverdubQ15(benchmark::State& state)
+{
+    auto loop = ramp<int16_t>(samples, 97);
+    auto in = ramp<int16_t>(samples, 131);
+    for (auto _ : state) {
+        Kernel(loop.data(), in.data(), 29000, samples);
+        benchmark::DoNotOptimize(loop.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * samples);
+}
+BENCHMARK(BM_OverdubQ15<overdub_q15_scalar>);
+BENCHMARK(BM_OverdubQ15<overdub_q15>);
+
+template<void (*Kernel)(
+  int16_t*, const int16_t*, int16_t, const int16_t*, int16_t, std::size_t)>
+void BM_Mix2Q15(benchmark::State& state)
+{
+    auto a = ramp<int16_t>(samples, 97);
+    auto b = ramp<int16_t>(samples, 131);
+    std::vector<int16_t> dst(samples);
+    for (auto _ : state) {
+        Kernel(dst.data(), a.data(), 23170, b.data(), 23170, samples);
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * samples);
+}
+BENCHMARK(BM_Mix2Q15<mix2_q15_scalar>);
+BENCHMARK(BM_Mix2Q15<mix2_q15>);
+
+template<void (*Kernel)(int32_t*, const int32_t*, std::size_t)>
+void BM_MixQ31(benchmark::State& state)
+{
+    auto dst = ramp<int32_t>(samples, 97 << 16);
+    auto src = ramp<int32_t>(samples, 131 << 16);
+    for (auto _ : state) {
+        Kernel(dst.data(), src.data(), samples);
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * samples);
+}
+BENCHMARK(BM_MixQ31<mix_q31_scalar>);
+BENCHMARK(BM_MixQ31<mix_q31>);
+
+template<void (*Kernel)(int32_t*, const int32_t*, int32_t, std::size_t)>
+void BM_OverdubQ31(benchmark::State& state)
+{
+    auto loop = ramp<int32_t>(samples, 97 << 16);
+    auto in = ramp<int32_t>(samples, 131 << 16);
+    for (auto _ : state) {
+        Kernel(loop.data(), in.data(), 1900000000, samples);
+        benchmark::DoNotOptimize(loop.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * samples);
+}
+BENCHMARK(BM_OverdubQ31<overdub_q31_scalar>);
+BENCHMARK(BM_OverdubQ31<overdub_q31>);
+
+} // namespace
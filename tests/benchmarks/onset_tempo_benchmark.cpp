@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <quantized_looper/Audio/onset_tempo.hpp>
+
+namespace {
+
+constexpr std::size_t frames = 32;
+
+std::vector<int16_t> make_take()
+{
+    std::vector<int16_t> take(48000);
+    for (std::size_t i = 0; i < take.size(); ++i) {
+        take[i] = static_cast<int16_t>(i * 97);
+    }
+    return take;
+}
+
+// Listening cost per audio block, averaging the blocks that only buffer
+// with those that finish a hop or a correlation chunk
+void BM_OnsetBlock(benchmark::State& state)
+{
+    const std::vector<int16_t> take = make_take();
+    auto detector = std::make_unique<onset_tempo<>>(48000);
+    std::size_t offset = 0;
+    for (auto _ : state) {
+        detector->feed(take.data() + offset, frames);
+        offset = (offset + frames) % (take.size() - frames);
+    }
+    state.SetItemsProcessed(state.iterations() * frames);
+}
+
+BENCHMARK(BM_OnsetBlock);
+
+// The worst block, the one the audio callback has to fit: it finishes a
+// hop, whose transform completes a chunk of the envelope to correlate
+void BM_OnsetWorstBlock(benchmark::State& state)
+{
+    const std::vector<int16_t> take = make_take();
+    auto detector = std::make_unique<onset_tempo<>>(48000);
+    // The first chunk lands after one frame and 31 more hops
+    constexpr std::size_t first =
+      onset_tempo<>::frame + 31 * onset_tempo<>::hop;
+    constexpr std::size_t chunk = 32 * onset_tempo<>::hop;
+    // Where the audio comes from does not change the cost
+    auto at = [&](std::size_t pos) {
+        return take.data() + pos % (take.size() - chunk);
+    };
+    detector->feed(at(0), first - frames);
+    std::size_t pos = first - frames;
+    for (auto _ : state) {
+        detector->feed(at(pos), frames);
+        state.PauseTiming();
+        detector->feed(at(pos + frames), chunk - frames);
+        pos += chunk;
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * frames);
+}
+
+BENCHMARK(BM_OnsetWorstBlock);
+
+// Picking the tempo when the loop closes, with everything else done
+void BM_OnsetPick(benchmark::State& state)
+{
+    std::vector<float> take(4 * 48000);
+    for (std::size_t i = 0; i < take.size(); i += 24000) {
+        take[i] = 1.0f;
+    }
+    auto detector = std::make_unique<onset_tempo<>>(48000);
+    detector->feed(take.data(), take.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(detector->samples_per_beat(take.size()));
+    }
+}
+
+BENCHMARK(BM_OnsetPick);
+
+} // namespace
@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include <quantized_looper/Audio/polyphase_resampler.hpp>
+#include <quantized_looper/Audio/track_bank.hpp>
+
+namespace {
+
+constexpr std::size_t frames = 32;
+
+// One track's resampling cost per block; state.range(0) is the step in
+// percent of the recorded rate
+void BM_ResampleBlock(benchmark::State& state)
+{
+    std::vector<int16_t> loop(48000);
+    for (std::size_t i = 0; i < loop.size(); ++i) {
+        loop[i] = static_cast<int16_t>(i * 97);
+    }
+    const resample_pos step = resample_one * state.range(0) / 100;
+    std::vector<int16_t> out(frames);
+    resample_pos pos = 0;
+    for (auto _ : state) {
+        pos = polyphase_resampler<int16_t>::process(
+          loop.data(), loop.size(), pos, step, out.data(), frames);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * frames);
+}
+
+BENCHMARK(BM_ResampleBlock)->Arg(80)->Arg(95)->Arg(105)->Arg(120)->Arg(150);
+
+// Whole track mix with every track retimed, against BM_TrackMix at the same
+// track count for the unresampled cost
+void BM_TrackMixResampled(benchmark::State& state)
+{
+    const std::size_t active = static_cast<std::size_t>(state.range(0));
+    static track_bank<int16_t, 8, 48000> bank(48000);
+    for (std::size_t t = 0; t < bank.tracks(); ++t) {
+        bank.clear(t);
+    }
+    bank.set_samples_per_beat(4800);
+
+    std::vector<int16_t> in(4800, 1000);
+    std::vector<int16_t> out(4800);
+    for (std::size_t t = 0; t < active; ++t) {
+        bank.arm(t, loop_command::record, quantize::immediate);
+        bank.process(in.data(), out.data(), in.size());
+        bank.arm(t, loop_command::play, quantize::immediate);
+    }
+    bank.process(in.data(), out.data(), 0);
+    bank.set_samples_per_beat(4400);
+
+    for (auto _ : state) {
+        bank.process(in.data(), out.data(), frames);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * frames);
+}
+
+BENCHMARK(BM_TrackMixResampled)->Arg(1)->Arg(2)->Arg(4)->Arg(8);
+
+} // namespace
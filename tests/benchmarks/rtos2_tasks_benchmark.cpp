@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include <cmsis_os2.h>
+#include <cmsis_os2_host.h>
+#include <quantized_looper/Software/rtos2_tasks.hpp>
+#include <quantized_looper/Software/timer_wheel.hpp>
+
+namespace {
+
+// Real time in microseconds, as the looper's table counts it
+uint64_t host_us()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch())
+      .count();
+}
+
+constexpr uint64_t fast_period = 1000;
+constexpr uint64_t slow_period = 20000;
+constexpr uint64_t slow_cost = 5000;
+constexpr uint64_t run_time = 200000;
+
+// How much later than a period after its last run the 1 ms task runs.
+// Both schedulers drop releases they miss, so the run count shows those
+struct lateness
+{
+    uint64_t last = 0;
+    uint64_t runs = 0;
+    uint64_t worst = 0;
+
+    void record()
+    {
+        const uint64_t now = host_us();
+        if (runs != 0 && now - last > fast_period) {
+            worst = std::max(worst, now - last - fast_period);
+        }
+        last = now;
+        ++runs;
+    }
+};
+
+lateness fast_late;
+
+void fast()
+{
+    fast_late.record();
+}
+
+// A 5 ms job, say a flash page write, that does not yield
+void slow()
+{
+    const uint64_t end = host_us() + slow_cost;
+    while (host_us() < end) {
+    }
+}
+
+using task_t = wheel_task<uint64_t>;
+
+std::array<task_t, 2> table()
+{
+    return { task_t(fast, host_us, fast_period, 0),
+             task_t(slow, host_us, slow_period, 0) };
+}
+
+// The cooperative scheduler: the 1 ms task waits out every slow run
+void BM_WheelLateness(benchmark::State& state)
+{
+    for (auto _ : state) {
+        fast_late = {};
+        auto tasks = table();
+        timer_wheel<uint64_t, 2> wheel(tasks, 4);
+        const uint64_t end = host_us() + run_time;
+        wheel.start(host_us());
+        while (host_us() < end) {
+            wheel.poll(host_us());
+        }
+    }
+    state.counters["max_late_us"] = static_cast<double>(fast_late.worst);
+    state.counters["runs"] = static_cast<double>(fast_late.runs);
+}
+
+BENCHMARK(BM_WheelLateness)
+  ->Iterations(1)
+  ->UseRealTime()
+  ->Unit(benchmark::kMillisecond);
+
+// The same table as RTOS2 threads, the 1 ms task at the higher priority.
+// Run as root, the host kernel gives the threads SCHED_FIFO so it
+// preempts the slow task as on the target; otherwise it is up to Linux
+void BM_Rtos2Lateness(benchmark::State& state)
+{
+    bool realtime = false;
+    for (auto _ : state) {
+        fast_late = {};
+        auto tasks = table();
+        rtos2_tasks<uint64_t, 2>::config_type config{};
+        config[0].priority = osPriorityHigh;
+        rtos2_tasks<uint64_t, 2> threads(tasks, config, 1000);
+        osHostSetRealtime(1);
+        osKernelInitialize();
+        threads.start();
+        realtime = osHostRealtime() != 0;
+        osKernelStart();
+        std::this_thread::sleep_for(std::chrono::microseconds(run_time));
+        osHostShutdown();
+    }
+    state.counters["max_late_us"] = static_cast<double>(fast_late.worst);
+    state.counters["runs"] = static_cast<double>(fast_late.runs);
+    state.counters["realtime"] = realtime ? 1 : 0;
+}
+
+BENCHMARK(BM_Rtos2Lateness)
+  ->Iterations(1)
+  ->UseRealTime()
+  ->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,109 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+#include <tuple>
+
+#include <quantized_looper/Software/static_scheduler.hpp>
+#include <quantized_looper/Software/timer_wheel.hpp>
+
+namespace {
+
+// Simulated 96 MHz cycle clock, moved on by each main loop pass
+struct sim_clock
+{
+    using tick_type = uint64_t;
+
+    static tick_type now() { return value; }
+
+    static inline tick_type value = 0;
+};
+
+uint64_t work[5] = {};
+
+template<int I>
+void job()
+{
+    ++work[I];
+}
+
+// The looper's table: LED fade, two blinks, audio and the log
+constexpr uint64_t ms = 96000;
+constexpr uint64_t fade = 20 * ms;
+constexpr uint64_t blink1 = 800 * ms;
+constexpr uint64_t blink2 = 600 * ms;
+constexpr uint64_t audio = 32000;
+constexpr uint64_t logs = 100 * ms;
+
+// Main loop passes 2 us apart
+constexpr uint64_t pass = 192;
+
+using task_t = wheel_task<uint64_t>;
+
+std::array<task_t, 5> table()
+{
+    return { task_t(job<0>, sim_clock::now, fade, 0),
+             task_t(job<1>, sim_clock::now, blink1, 0),
+             task_t(job<2>, sim_clock::now, blink2, 0),
+             task_t(job<3>, sim_clock::now, audio, 0),
+             task_t(job<4>, sim_clock::now, logs, 0) };
+}
+
+// The std::array table as the task_control_block loop ran it: each task's
+// clock and function through pointers
+void BM_ArrayPass(benchmark::State& state)
+{
+    auto tasks = table();
+    sim_clock::value = 0;
+    for (auto _ : state) {
+        sim_clock::value += pass;
+        for (auto& t : tasks) {
+            if (t.clock() >= t.release) {
+                t.function();
+                t.release += t.period;
+            }
+        }
+    }
+    benchmark::DoNotOptimize(work);
+}
+
+BENCHMARK(BM_ArrayPass);
+
+// The same table on the timer wheel the looper runs now
+void BM_WheelPass(benchmark::State& state)
+{
+    auto tasks = table();
+    sim_clock::value = 0;
+    timer_wheel<uint64_t, 5> wheel(tasks, 10);
+    wheel.start(sim_clock::value);
+    for (auto _ : state) {
+        sim_clock::value += pass;
+        wheel.poll(wheel.now());
+    }
+    benchmark::DoNotOptimize(work);
+}
+
+BENCHMARK(BM_WheelPass);
+
+// And as types, dispatched by a fold
+void BM_StaticPass(benchmark::State& state)
+{
+    static_scheduler<sim_clock,
+                     std::tuple<static_task<job<0>, fade>,
+                                static_task<job<1>, blink1>,
+                                static_task<job<2>, blink2>,
+                                static_task<job<3>, audio>,
+                                static_task<job<4>, logs>>>
+      tasks;
+    sim_clock::value = 0;
+    tasks.start(sim_clock::value);
+    for (auto _ : state) {
+        sim_clock::value += pass;
+        tasks.poll(sim_clock::now());
+    }
+    benchmark::DoNotOptimize(work);
+}
+
+BENCHMARK(BM_StaticPass);
+
+} // namespace
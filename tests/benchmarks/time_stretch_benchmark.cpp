@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <quantized_looper/Audio/real_fft.hpp>
+#include <quantized_looper/Audio/time_stretch.hpp>
+
+namespace {
+
+constexpr std::size_t frames = 32;
+
+// One track's time-stretch cost per block, averaging the hops that run a
+// transform with those that only read out; state.range(0) is the step in
+// percent of the recorded rate
+void BM_StretchBlock(benchmark::State& state)
+{
+    std::vector<int16_t> loop(48000);
+    for (std::size_t i = 0; i < loop.size(); ++i) {
+        loop[i] = static_cast<int16_t>(i * 97);
+    }
+    const resample_pos step = resample_one * state.range(0) / 100;
+    auto stretch = std::make_unique<time_stretch<int16_t>>();
+    std::vector<int16_t> out(frames);
+    resample_pos pos = 0;
+    for (auto _ : state) {
+        pos = stretch->process(
+          loop.data(), loop.size(), pos, step, out.data(), frames);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * frames);
+}
+
+BENCHMARK(BM_StretchBlock)->Arg(80)->Arg(95)->Arg(105)->Arg(120)->Arg(150);
+
+// One forward and inverse transform pair, the bulk of each hop
+template<std::size_t N>
+void BM_RealFftPair(benchmark::State& state)
+{
+    real_fft<N> fft;
+    std::vector<float> time(N, 1.0f);
+    std::vector<float> spectrum(N);
+    for (auto _ : state) {
+        fft.forward(time.data(), spectrum.data());
+        fft.inverse(spectrum.data(), time.data());
+        benchmark::DoNotOptimize(time.data());
+    }
+    state.SetItemsProcessed(state.iterations() * N);
+}
+
+BENCHMARK(BM_RealFftPair<256>);
+BENCHMARK(BM_RealFftPair<512>);
+BENCHMARK(BM_RealFftPair<1024>);
+
+} // namespace
@@ -0,0 +1,101 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <utility>
+
+#include <quantized_looper/Software/timer_wheel.hpp>
+
+namespace {
+
+// Simulated 96 MHz cycle clock, moved on by each main loop pass
+uint64_t sim_now = 0;
+uint64_t work = 0;
+
+uint64_t sim_clock()
+{
+    return sim_now;
+}
+
+void job()
+{
+    ++work;
+}
+
+using task_t = wheel_task<uint64_t>;
+
+// Main loop passes 2 us apart, and granules of 1024 cycles, about 10.7 us
+constexpr uint64_t pass = 192;
+constexpr unsigned shift = 10;
+
+template<std::size_t N, std::size_t... I>
+std::array<task_t, N> blank_tasks(std::index_sequence<I...>)
+{
+    return { ((void)I, task_t(job, sim_clock, 0, 0))... };
+}
+
+// Periods spread evenly in log from 1 ms to 1 s, like meters, LEDs, MIDI
+// and telemetry, at random phases
+template<std::size_t N>
+std::unique_ptr<std::array<task_t, N>> make_tasks()
+{
+    std::mt19937 rng(N);
+    std::uniform_real_distribution<double> octaves(0.0, std::log2(1000.0));
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    auto tasks = std::make_unique<std::array<task_t, N>>(
+      blank_tasks<N>(std::make_index_sequence<N>()));
+    for (auto& t : *tasks) {
+        t.period = static_cast<uint64_t>(96000.0 * std::exp2(octaves(rng)));
+        t.release = static_cast<uint64_t>(t.period * unit(rng));
+    }
+    return tasks;
+}
+
+// The scheduler as it was: every pass reads each task's clock and runs the
+// ones whose release has come
+template<std::size_t N>
+void BM_LinearPass(benchmark::State& state)
+{
+    auto tasks = make_tasks<N>();
+    sim_now = 0;
+    for (auto _ : state) {
+        sim_now += pass;
+        for (auto& t : *tasks) {
+            if (t.clock() >= t.release) {
+                t.function();
+                t.release += t.period;
+            }
+        }
+    }
+    benchmark::DoNotOptimize(work);
+    state.counters["tasks"] = static_cast<double>(N);
+}
+
+BENCHMARK(BM_LinearPass<4>);
+BENCHMARK(BM_LinearPass<64>);
+BENCHMARK(BM_LinearPass<512>);
+
+// The same table on the timer wheel: a pass only touches what is due
+template<std::size_t N>
+void BM_WheelPass(benchmark::State& state)
+{
+    auto tasks = make_tasks<N>();
+    sim_now = 0;
+    auto wheel = std::make_unique<timer_wheel<uint64_t, N>>(*tasks, shift);
+    wheel->start(sim_now);
+    for (auto _ : state) {
+        sim_now += pass;
+        wheel->poll(sim_clock());
+    }
+    benchmark::DoNotOptimize(work);
+    state.counters["tasks"] = static_cast<double>(N);
+}
+
+BENCHMARK(BM_WheelPass<4>);
+BENCHMARK(BM_WheelPass<64>);
+BENCHMARK(BM_WheelPass<512>);
+
+} // namespace
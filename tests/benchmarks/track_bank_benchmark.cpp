@@ -0,0 +1,44 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include <quantized_looper/Audio/track_bank.hpp>
+
+namespace {
+
+constexpr std::size_t max_tracks = 8;
+using bank_t = track_bank<int16_t, max_tracks, 48000>;
+
+// Mixing cost with the first state.range(0) tracks playing, the rest stopped,
+// at a block size of state.range(1) frames. Divide a block period by the
+// time per block to get the headroom at that track count.
+void BM_TrackMix(benchmark::State& state)
+{
+    const std::size_t active = static_cast<std::size_t>(state.range(0));
+    const std::size_t frames = static_cast<std::size_t>(state.range(1));
+
+    static bank_t bank(48000);
+    bank.set_samples_per_beat(4800);
+    std::vector<int16_t> in(frames, 1000);
+    std::vector<int16_t> out(frames);
+    for (std::size_t t = 0; t < max_tracks; ++t) {
+        bank.clear(t);
+    }
+    for (std::size_t t = 0; t < active; ++t) {
+        bank.arm(t, loop_command::record, quantize::immediate);
+        bank.process(in.data(), out.data(), frames);
+        bank.arm(t, loop_command::overdub, quantize::immediate);
+    }
+    // Every loop is one block long, so each block is a single piece
+
+    for (auto _ : state) {
+        bank.process(in.data(), out.data(), frames);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * frames);
+}
+
+BENCHMARK(BM_TrackMix)->ArgsProduct({ { 1, 2, 4, 8 }, { 16, 32, 64, 128 } });
+
+} // namespace
@@ -0,0 +1,29 @@
+/**
+ * @file led.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Stand-in for the reusable_synth LED interface, for checking
+ * main.cpp on the host without the submodule.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <utility>
+
+/**
+ * @brief What Hardware/led.hpp's specializations override.
+ */
+class ledBase
+{
+public:
+    virtual ~ledBase() = default;
+    virtual void on() = 0;
+    virtual void off() = 0;
+    virtual void setIntensity(int value) = 0;
+    virtual void setIntensity(float value) = 0;
+    virtual std::pair<int, int> getRange() const = 0;
+};
+
+template<typename Handle>
+class led;
@@ -0,0 +1,37 @@
+/**
+ * @file logger.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Stand-in for the reusable_synth logger, for checking main.cpp on
+ * the host without the submodule.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <array>
+#include <optional>
+
+/**
+ * @brief The part of the logger's interface main.cpp uses. Logs go nowhere.
+ *
+ * @tparam Logs Lines the queue holds
+ * @tparam Length Characters per line
+ */
+template<int Logs, int Length>
+class Logger
+{
+public:
+    class log
+    {
+    public:
+        const char* pBuffer() const { return buffer.data(); }
+
+    private:
+        std::array<char, Length> buffer{};
+    };
+
+    void info(const char*) {}
+
+    std::optional<log> remove_log() { return std::nullopt; }
+};
@@ -0,0 +1,117 @@
+/**
+ * @file wav_audio_io.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Host stand-in for sai_audio that streams WAV files.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// Quantized looper includes
+#include <quantized_looper/Audio/audio_io.hpp>
+
+// Mock includes
+#include "wav_file.hpp"
+
+/**
+ * @brief Plays a WAV file into the audio_io callbacks and records what they
+ * send back.
+ *
+ * The backend walks the same circular buffers that the DMA does and fires
+ * on_half_complete() / on_complete() in the same order. With `realtime` set it
+ * also waits one block period between callbacks, so code that runs beside the
+ * audio path sees the same timing as on the board. Without it the file is
+ * processed as fast as possible.
+ *
+ * Latency matches the hardware too: a callback refills the half that has just
+ * been played, which goes out again only after the other half, so the output
+ * trails the input by two blocks.
+ *
+ * @tparam BlockFrames Frames per half buffer.
+ * @tparam Channels Interleaved channels per frame.
+ */
+template<std::size_t BlockFrames, std::size_t Channels>
+class wav_audio_io : public audio_io<int16_t, BlockFrames, Channels>
+{
+    using base = audio_io<int16_t, BlockFrames, Channels>;
+
+public:
+    /**
+     * @brief Open the input and output files.
+     *
+     * @param in_path WAV file to capture from; must have `Channels` channels
+     * @param out_path WAV file to write the playback stream to
+     */
+    wav_audio_io(const std::string& in_path, const std::string& out_path)
+      : reader(in_path)
+      , writer(out_path, Channels, reader.is_open() ? reader.sample_rate() : 48000)
+    {
+    }
+
+    bool is_open() const
+    {
+        return reader.is_open() && reader.channels() == Channels &&
+               writer.is_open();
+    }
+
+    uint32_t sample_rate() const { return reader.sample_rate(); }
+
+    /**
+     * @brief Stream the whole input file.
+     *
+     * The last partial block is padded with silence.
+     *
+     * @param realtime Pace the callbacks at the file's sample rate
+     * @return Number of blocks processed
+     */
+    uint32_t run(bool realtime = false)
+    {
+        if (!is_open()) {
+            return 0;
+        }
+
+        const auto period = std::chrono::nanoseconds(
+          1000000000ull * BlockFrames / reader.sample_rate());
+        auto next = std::chrono::steady_clock::now();
+
+        uint32_t n_blocks = 0;
+        for (std::size_t half = 0;; half ^= 1) {
+            int16_t* rx_half = base::rx.data() + half * base::block_samples;
+            int16_t* tx_half = base::tx.data() + half * base::block_samples;
+
+            std::size_t got = reader.read(rx_half, base::block_samples);
+            if (got == 0) {
+                break;
+            }
+            std::fill(rx_half + got, rx_half + base::block_samples, 0);
+
+            if (realtime) {
+                next += period;
+                std::this_thread::sleep_until(next);
+            }
+
+            // The half being refilled has just gone out on the wire
+            writer.write(tx_half, base::block_samples);
+            if (half == 0) {
+                base::on_half_complete();
+            } else {
+                base::on_complete();
+            }
+            ++n_blocks;
+        }
+        writer.close();
+        return n_blocks;
+    }
+
+private:
+    wav_reader reader;
+    wav_writer writer;
+};
@@ -0,0 +1,214 @@
+/**
+ * @file wav_file.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Minimal 16-bit PCM WAV reader and writer for host audio runs.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+/**
+ * @brief Streams interleaved 16-bit PCM frames out of a WAV file.
+ *
+ * Only the canonical layout is understood (RIFF, a PCM "fmt " chunk and a
+ * "data" chunk); other chunks in between are skipped.
+ */
+class wav_reader
+{
+public:
+    explicit wav_reader(const std::string& path)
+      : file(path, std::ios::binary)
+    {
+        valid = file.is_open() && parse_header();
+    }
+
+    bool is_open() const { return valid; }
+
+    uint16_t channels() const { return n_channels; }
+
+    uint32_t sample_rate() const { return rate; }
+
+    /**
+     * @brief Total number of frames in the data chunk.
+     */
+    std::size_t frames() const { return data_bytes / frame_bytes(); }
+
+    /**
+     * @brief Read up to `n` interleaved samples.
+     *
+     * @return Number of samples read; less than `n` at the end of the data
+     */
+    std::size_t read(int16_t* dst, std::size_t n)
+    {
+        std::size_t available = remaining_bytes / sizeof(int16_t);
+        n = n < available ? n : available;
+        file.read(reinterpret_cast<char*>(dst), n * sizeof(int16_t));
+        std::size_t got = static_cast<std::size_t>(file.gcount()) / sizeof(int16_t);
+        remaining_bytes -= got * sizeof(int16_t);
+        return got;
+    }
+
+private:
+    std::size_t frame_bytes() const
+    {
+        return n_channels > 0 ? n_channels * sizeof(int16_t) : 1;
+    }
+
+    uint32_t read_u32()
+    {
+        uint8_t b[4] = {};
+        file.read(reinterpret_cast<char*>(b), 4);
+        return b[0] | (b[1] << 8) | (b[2] << 16) | (uint32_t(b[3]) << 24);
+    }
+
+    uint16_t read_u16()
+    {
+        uint8_t b[2] = {};
+        file.read(reinterpret_cast<char*>(b), 2);
+        return static_cast<uint16_t>(b[0] | (b[1] << 8));
+    }
+
+    bool read_tag(const char* tag)
+    {
+        char id[4] = {};
+        file.read(id, 4);
+        return file && std::memcmp(id, tag, 4) == 0;
+    }
+
+    bool parse_header()
+    {
+        if (!read_tag("RIFF")) {
+            return false;
+        }
+        read_u32();
+        if (!read_tag("WAVE")) {
+            return false;
+        }
+
+        bool have_format = false;
+        while (file) {
+            char id[4] = {};
+            file.read(id, 4);
+            uint32_t size = read_u32();
+            if (!file) {
+                return false;
+            }
+            if (std::memcmp(id, "fmt ", 4) == 0) {
+                uint16_t format = read_u16();
+                n_channels = read_u16();
+                rate = read_u32();
+                read_u32(); // Byte rate
+                read_u16(); // Block align
+                uint16_t bits = read_u16();
+                file.seekg(size - 16, std::ios::cur);
+                if (format != 1 || bits != 16 || n_channels == 0) {
+                    return false;
+                }
+                have_format = true;
+            } else if (std::memcmp(id, "data", 4) == 0) {
+                data_bytes = size;
+                remaining_bytes = size;
+                return have_format;
+            } else {
+                file.seekg(size + (size & 1), std::ios::cur);
+            }
+        }
+        return false;
+    }
+
+    std::ifstream file;
+    bool valid = false;
+    uint16_t n_channels = 0;
+    uint32_t rate = 0;
+    std::size_t data_bytes = 0;
+    std::size_t remaining_bytes = 0;
+};
+
+/**
+ * @brief Writes interleaved 16-bit PCM frames to a WAV file.
+ *
+ * The RIFF and data sizes are patched in when the writer is closed or
+ * destroyed.
+ */
+class wav_writer
+{
+public:
+    wav_writer(const std::string& path, uint16_t channels, uint32_t sample_rate)
+      : file(path, std::ios::binary | std::ios::trunc)
+      , n_channels(channels)
+      , rate(sample_rate)
+    {
+        if (file.is_open()) {
+            write_header();
+        }
+    }
+
+    ~wav_writer() { close(); }
+
+    wav_writer(wav_writer const&) = delete;
+    void operator=(wav_writer const&) = delete;
+
+    bool is_open() const { return file.is_open(); }
+
+    void write(const int16_t* src, std::size_t n)
+    {
+        file.write(reinterpret_cast<const char*>(src), n * sizeof(int16_t));
+        data_bytes += static_cast<uint32_t>(n * sizeof(int16_t));
+    }
+
+    void close()
+    {
+        if (!file.is_open()) {
+            return;
+        }
+        write_header();
+        file.close();
+    }
+
+private:
+    void write_u32(uint32_t v)
+    {
+        uint8_t b[4] = { uint8_t(v), uint8_t(v >> 8), uint8_t(v >> 16),
+                         uint8_t(v >> 24) };
+        file.write(reinterpret_cast<const char*>(b), 4);
+    }
+
+    void write_u16(uint16_t v)
+    {
+        uint8_t b[2] = { uint8_t(v), uint8_t(v >> 8) };
+        file.write(reinterpret_cast<const char*>(b), 2);
+    }
+
+    void write_header()
+    {
+        auto end = file.tellp();
+        file.seekp(0);
+        file.write("RIFF", 4);
+        write_u32(36 + data_bytes);
+        file.write("WAVEfmt ", 8);
+        write_u32(16);
+        write_u16(1); // PCM
+        write_u16(n_channels);
+        write_u32(rate);
+        write_u32(rate * n_channels * sizeof(int16_t));
+        write_u16(static_cast<uint16_t>(n_channels * sizeof(int16_t)));
+        write_u16(16);
+        file.write("data", 4);
+        write_u32(data_bytes);
+        if (data_bytes > 0) {
+            file.seekp(end);
+        }
+    }
+
+    std::ofstream file;
+    uint16_t n_channels;
+    uint32_t rate;
+    uint32_t data_bytes = 0;
+};
@@ -0,0 +1,39 @@
+/**
+ * @file cmsis_os2_host.h
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Host-only controls of the POSIX CMSIS-RTOS2 kernel.
+ * @date 2026-10-17
+ */
+
+#ifndef CMSIS_OS2_HOST_H_
+#define CMSIS_OS2_HOST_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Ask for threads created from now on to run under SCHED_FIFO at
+ * their RTOS2 priorities, so a higher priority preempts a lower one as on
+ * the target. Without the privilege for it they run as normal threads.
+ */
+void osHostSetRealtime(int enable);
+
+/**
+ * @brief Whether the last thread created got a realtime priority.
+ */
+int osHostRealtime(void);
+
+/**
+ * @brief Stop the kernel and wait for every thread to return: each wait
+ * and delay fails with osErrorResource from now on. The kernel is then
+ * inactive and can be initialized again.
+ */
+void osHostShutdown(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CMSIS_OS2_HOST_H_
@@ -0,0 +1,621 @@
+/**
+ * @file cmsis_os2_posix.cpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief CMSIS-RTOS2 kernel, thread, flag, delay and timer functions on
+ * POSIX threads, to run RTOS2 code on the host.
+ * @date 2026-10-17
+ *
+ * The kernel tick is 1 ms of the steady clock. osKernelStart() returns on
+ * the host, once the threads created so far are released, so a test can
+ * watch them and then call osHostShutdown(). Timer callbacks run in one
+ * timer thread, as in RTX. Only the functions here are provided; RTOS2
+ * objects beyond threads and timers are not.
+ */
+
+#include <cmsis_os2.h>
+#include <cmsis_os2_host.h>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+using host_clock = std::chrono::steady_clock;
+using kernel_tick = std::chrono::milliseconds;
+
+constexpr uint32_t tick_hz = 1000;
+constexpr uint32_t flag_mask = 0x7FFFFFFF;
+
+struct host_thread
+{
+    osThreadFunc_t func;
+    void* argument;
+    std::string name;
+    osPriority_t priority;
+    pthread_t handle{};
+    osThreadState_t state = osThreadReady;
+    uint32_t flags = 0;
+    uint32_t wait_flags = 0;
+    uint32_t wait_options = 0;
+    std::condition_variable wake;
+
+    bool satisfied() const
+    {
+        const uint32_t got = flags & wait_flags;
+        return (wait_options & osFlagsWaitAll) ? got == wait_flags : got != 0;
+    }
+};
+
+struct host_timer
+{
+    osTimerFunc_t func;
+    osTimerType_t type;
+    void* argument;
+    std::string name;
+    bool running = false;
+    bool deleted = false;
+    uint32_t ticks = 0;
+    host_clock::time_point due;
+};
+
+// Everything is guarded by the one lock, as a kernel runs one thing at a
+// time
+struct host_kernel
+{
+    std::mutex lock;
+    std::condition_variable changed;
+    osKernelState_t state = osKernelInactive;
+    bool stopping = false;
+    bool want_realtime = false;
+    bool realtime = false;
+    host_clock::time_point epoch = host_clock::now();
+    std::vector<std::unique_ptr<host_thread>> threads;
+    std::vector<std::unique_ptr<host_timer>> timers;
+    pthread_t timer_thread{};
+    bool timer_started = false;
+};
+
+host_kernel& kernel()
+{
+    static host_kernel k;
+    return k;
+}
+
+thread_local host_thread* self = nullptr;
+
+uint32_t ticks_now(const host_kernel& k)
+{
+    return static_cast<uint32_t>(
+      std::chrono::duration_cast<kernel_tick>(host_clock::now() - k.epoch)
+        .count());
+}
+
+host_thread* find_thread(host_kernel& k, osThreadId_t id)
+{
+    for (auto& t : k.threads) {
+        if (t.get() == id) {
+            return t.get();
+        }
+    }
+    return nullptr;
+}
+
+host_timer* find_timer(host_kernel& k, osTimerId_t id)
+{
+    for (auto& t : k.timers) {
+        if (t.get() == id && !t->deleted) {
+            return t.get();
+        }
+    }
+    return nullptr;
+}
+
+// Block the caller until `until` or shutdown
+osStatus_t sleep_until(host_clock::time_point until)
+{
+    host_kernel& k = kernel();
+    std::unique_lock<std::mutex> lock(k.lock);
+    std::condition_variable& cv = self ? self->wake : k.changed;
+    cv.wait_until(lock, until, [&] { return k.stopping; });
+    return k.stopping ? osErrorResource : osOK;
+}
+
+// Map an RTOS2 priority onto the SCHED_FIFO range
+int fifo_priority(osPriority_t priority)
+{
+    const int low = sched_get_priority_min(SCHED_FIFO);
+    const int high = sched_get_priority_max(SCHED_FIFO);
+    const int p = std::clamp(static_cast<int>(priority),
+                             static_cast<int>(osPriorityIdle),
+                             static_cast<int>(osPriorityISR));
+    return low + (high - low) * (p - osPriorityIdle) /
+                   (osPriorityISR - osPriorityIdle);
+}
+
+bool spawn(pthread_t* handle,
+           void* (*body)(void*),
+           void* argument,
+           osPriority_t priority,
+           bool realtime)
+{
+    if (realtime) {
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        sched_param param{};
+        param.sched_priority = fifo_priority(priority);
+        pthread_attr_setschedparam(&attr, &param);
+        const int error = pthread_create(handle, &attr, body, argument);
+        pthread_attr_destroy(&attr);
+        if (error == 0) {
+            return true;
+        }
+    }
+    return pthread_create(handle, nullptr, body, argument) == 0;
+}
+
+void* thread_body(void* argument)
+{
+    host_kernel& k = kernel();
+    auto* t = static_cast<host_thread*>(argument);
+    self = t;
+    {
+        std::unique_lock<std::mutex> lock(k.lock);
+        k.changed.wait(lock, [&] {
+            return k.state == osKernelRunning || k.stopping;
+        });
+        if (k.stopping) {
+            t->state = osThreadTerminated;
+            return nullptr;
+        }
+        t->state = osThreadRunning;
+    }
+    t->func(t->argument);
+    std::lock_guard<std::mutex> lock(k.lock);
+    t->state = osThreadTerminated;
+    return nullptr;
+}
+
+// Fire each timer when due, with the lock released around its callback
+void* timer_body(void*)
+{
+    host_kernel& k = kernel();
+    std::unique_lock<std::mutex> lock(k.lock);
+    while (!k.stopping) {
+        host_timer* next = nullptr;
+        for (auto& t : k.timers) {
+            if (t->running && (!next || t->due < next->due)) {
+                next = t.get();
+            }
+        }
+        if (next == nullptr) {
+            k.changed.wait(lock);
+            continue;
+        }
+        if (host_clock::now() < next->due) {
+            k.changed.wait_until(lock, next->due);
+            continue;
+        }
+        if (next->type == osTimerPeriodic) {
+            next->due += kernel_tick(next->ticks);
+        } else {
+            next->running = false;
+        }
+        osTimerFunc_t func = next->func;
+        void* arg = next->argument;
+        lock.unlock();
+        func(arg);
+        lock.lock();
+    }
+    return nullptr;
+}
+
+} // namespace
+
+extern "C"
+{
+
+    osStatus_t osKernelInitialize(void)
+    {
+        host_kernel& k = kernel();
+        std::lock_guard<std::mutex> lock(k.lock);
+        if (k.state != osKernelInactive) {
+            return osError;
+        }
+        k.state = osKernelReady;
+        k.stopping = false;
+        k.epoch = host_clock::now();
+        return osOK;
+    }
+
+    osStatus_t osKernelGetInfo(osVersion_t* version,
+                               char* id_buf,
+                               uint32_t id_size)
+    {
+        if (version) {
+            version->api = 20010003;
+            version->kernel = 10000000;
+        }
+        if (id_buf && id_size > 0) {
+            std::strncpy(id_buf, "POSIX host", id_size - 1);
+            id_buf[id_size - 1] = '\0';
+        }
+        return osOK;
+    }
+
+    osKernelState_t osKernelGetState(void)
+    {
+        host_kernel& k = kernel();
+        std::lock_guard<std::mutex> lock(k.lock);
+        return k.state;
+    }
+
+    osStatus_t osKernelStart(void)
+    {
+        host_kernel& k = kernel();
+        std::lock_guard<std::mutex> lock(k.lock);
+        if (k.state != osKernelReady) {
+            return osError;
+        }
+        if (!spawn(&k.timer_thread,
+                   timer_body,
+                   nullptr,
+                   osPriorityRealtime7,
+                   k.want_realtime)) {
+            return osError;
+        }
+        k.timer_started = true;
+        k.state = osKernelRunning;
+        k.changed.notify_all();
+        return osOK;
+    }
+
+    uint32_t osKernelGetTickCount(void)
+    {
+        return ticks_now(kernel());
+    }
+
+    uint32_t osKernelGetTickFreq(void)
+    {
+        return tick_hz;
+    }
+
+    uint32_t osKernelGetSysTimerCount(void)
+    {
+        return static_cast<uint32_t>(
+          std::chrono::duration_cast<std::chrono::microseconds>(
+            host_clock::now() - kernel().epoch)
+            .count());
+    }
+
+    uint32_t osKernelGetSysTimerFreq(void)
+    {
+        return 1000000;
+    }
+
+    osThreadId_t osThreadNew(osThreadFunc_t func,
+                             void* argument,
+                             const osThreadAttr_t* attr)
+    {
+        host_kernel& k = kernel();
+        if (func == nullptr) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(k.lock);
+        if (k.state != osKernelReady && k.state != osKernelRunning) {
+            return nullptr;
+        }
+        auto t = std::make_unique<host_thread>();
+        t->func = func;
+        t->argument = argument;
+        t->name = attr && attr->name ? attr->name : "";
+        t->priority = attr && attr->priority != osPriorityNone
+                        ? attr->priority
+                        : osPriorityNormal;
+        k.realtime = k.want_realtime;
+        if (!spawn(&t->handle, thread_body, t.get(), t->priority, k.realtime)) {
+            return nullptr;
+        }
+        if (k.realtime) {
+            int policy = 0;
+            sched_param param{};
+            pthread_getschedparam(t->handle, &policy, &param);
+            k.realtime = policy == SCHED_FIFO;
+        }
+        k.threads.push_back(std::move(t));
+        return k.threads.back().get();
+    }
+
+    const char* osThreadGetName(osThreadId_t thread_id)
+    {
+        host_kernel& k = kernel();
+        std::lock_guard<std::mutex> lock(k.lock);
+        host_thread* t = find_thread(k, thread_id);
+        return t ? t->name.c_str() : nullptr;
+    }
+
+    osThreadId_t osThreadGetId(void)
+    {
+        return self;
+    }
+
+    void osThreadExit(void)
+    {
+        host_kernel& k = kernel();
+        if (self != nullptr) {
+            std::lock_guard<std::mutex> lock(k.lock);
+            self->state = osThreadTerminated;
+        }
+        pthread_exit(nullptr);
+    }
+
+    osThreadState_t osThreadGetState(osThreadId_t thread_id)
+    {
+        host_kernel& k = kernel();
+        std::lock_guard<std::mutex> lock(k.lock);
+        host_thread* t = find_thread(k, thread_id);
+        return t ? t->state : osThreadError;
+    }
+
+    osPriority_t osThreadGetPriority(osThreadId_t thread_id)
+    {
+        host_kernel& k = kernel();
+        std::lock_guard<std::mutex> lock(k.lock);
+        host_thread* t = find_thread(k, thread_id);
+        return t ? t->priority : osPriorityError;
+    }
+
+    osStatus_t osThreadYield(void)
+    {
+        sched_yield();
+        return osOK;
+    }
+
+    uint32_t osThreadGetCount(void)
+    {
+        host_kernel& k = kernel();
+        std::lock_guard<std::mutex> lock(k.lock);
+        return static_cast<uint32_t>(
+          std::count_if(k.threads.begin(), k.threads.end(), [](auto& t) {
+              return t->state != osThreadTerminated;
+          }));
+    }
+
+    uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags)
+    {
+        host_kernel& k = kernel();
+        if ((flags & ~flag_mask) != 0) {
+            return osFlagsErrorParameter;
+        }
+        std::lock_guard<std::mutex> lock(k.lock);
+        host_thread* t = find_thread(k, thread_id);
+        if (t == nullptr) {
+            return osFlagsErrorParameter;
+        }
+        t->flags |= flags;
+        // Ready from here, as on a kernel, not from when the host runs it
+        if (t->state == osThreadBlocked && t->wait_flags != 0 &&
+            t->satisfied()) {
+            t->state = osThreadReady;
+        }
+        t->wake.notify_all();
+        return t->flags;
+    }
+
+    uint32_t osThreadFlagsClear(uint32_t flags)
+    {
+        host_kernel& k = kernel();
+        if (self == nullptr) {
+            return osFlagsErrorUnknown;
+        }
+        std::lock_guard<std::mutex> lock(k.lock);
+        const uint32_t was = self->flags;
+        self->flags &= ~flags;
+        return was;
+    }
+
+    uint32_t osThreadFlagsGet(void)
+    {
+        host_kernel& k = kernel();
+        if (self == nullptr) {
+            return 0;
+        }
+        std::lock_guard<std::mutex> lock(k.lock);
+        return self->flags;
+    }
+
+    uint32_t osThreadFlagsWait(uint32_t flags,
+                               uint32_t options,
+                               uint32_t timeout)
+    {
+        host_kernel& k = kernel();
+        if (self == nullptr) {
+            return osFlagsErrorUnknown;
+        }
+        if ((flags & ~flag_mask) != 0) {
+            return osFlagsErrorParameter;
+        }
+        std::unique_lock<std::mutex> lock(k.lock);
+        host_thread* t = self;
+        t->wait_flags = flags;
+        t->wait_options = options;
+        auto done = [&] { return k.stopping || t->satisfied(); };
+        if (timeout == osWaitForever) {
+            t->state = osThreadBlocked;
+            t->wake.wait(lock, done);
+        } else if (timeout != 0) {
+            t->state = osThreadBlocked;
+            t->wake.wait_until(
+              lock, host_clock::now() + kernel_tick(timeout), done);
+        }
+        t->state = osThreadRunning;
+        const bool got = t->satisfied();
+        t->wait_flags = 0;
+        if (k.stopping) {
+            return osFlagsErrorResource;
+        }
+        if (!got) {
+            return timeout == 0 ? osFlagsErrorResource : osFlagsErrorTimeout;
+        }
+        const uint32_t was = t->flags;
+        if ((options & osFlagsNoClear) == 0) {
+            t->flags &= ~flags;
+        }
+        return was;
+    }
+
+    osStatus_t osDelay(uint32_t ticks)
+    {
+        if (ticks == 0) {
+            return osOK;
+        }
+        return sleep_until(host_clock::now() + kernel_tick(ticks));
+    }
+
+    osStatus_t osDelayUntil(uint32_t ticks)
+    {
+        host_kernel& k = kernel();
+        const uint32_t ahead = ticks - ticks_now(k);
+        if (ahead == 0 || ahead > flag_mask) {
+            return osErrorParameter;
+        }
+        return sleep_until(k.epoch + kernel_tick(ticks));
+    }
+
+    osTimerId_t osTimerNew(osTimerFunc_t func,
+                           osTimerType_t type,
+                           void* argument,
+                           const osTimerAttr_t* attr)
+    {
+        host_kernel& k = kernel();
+        if (func == nullptr) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(k.lock);
+        if (k.state != osKernelReady && k.state != osKernelRunning) {
+            return nullptr;
+        }
+        auto t = std::make_unique<host_timer>();
+        t->func = func;
+        t->type = type;
+        t->argument = argument;
+        t->name = attr && attr->name ? attr->name : "";
+        k.timers.push_back(std::move(t));
+        return k.timers.back().get();
+    }
+
+    const char* osTimerGetName(osTimerId_t timer_id)
+    {
+        host_kernel& k = kernel();
+        std::lock_guard<std::mutex> lock(k.lock);
+        host_timer* t = find_timer(k, timer_id);
+        return t ? t->name.c_str() : nullptr;
+    }
+
+    osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks)
+    {
+        host_kernel& k = kernel();
+        if (ticks == 0) {
+            return osErrorParameter;
+        }
+        std::lock_guard<std::mutex> lock(k.lock);
+        host_timer* t = find_timer(k, timer_id);
+        if (t == nullptr) {
+            return osErrorParameter;
+        }
+        t->ticks = ticks;
+        t->due = host_clock::now() + kernel_tick(ticks);
+        t->running = true;
+        k.changed.notify_all();
+        return osOK;
+    }
+
+    osStatus_t osTimerStop(osTimerId_t timer_id)
+    {
+        host_kernel& k = kernel();
+        std::lock_guard<std::mutex> lock(k.lock);
+        host_timer* t = find_timer(k, timer_id);
+        if (t == nullptr) {
+            return osErrorParameter;
+        }
+        if (!t->running) {
+            return osErrorResource;
+        }
+        t->running = false;
+        k.changed.notify_all();
+        return osOK;
+    }
+
+    uint32_t osTimerIsRunning(osTimerId_t timer_id)
+    {
+        host_kernel& k = kernel();
+        std::lock_guard<std::mutex> lock(k.lock);
+        host_timer* t = find_timer(k, timer_id);
+        return t && t->running ? 1 : 0;
+    }
+
+    // Freed at shutdown, since the timer thread may be in its callback
+    osStatus_t osTimerDelete(osTimerId_t timer_id)
+    {
+        host_kernel& k = kernel();
+        std::lock_guard<std::mutex> lock(k.lock);
+        host_timer* t = find_timer(k, timer_id);
+        if (t == nullptr) {
+            return osErrorParameter;
+        }
+        t->running = false;
+        t->deleted = true;
+        return osOK;
+    }
+
+    void osHostSetRealtime(int enable)
+    {
+        host_kernel& k = kernel();
+        std::lock_guard<std::mutex> lock(k.lock);
+        k.want_realtime = enable != 0;
+    }
+
+    int osHostRealtime(void)
+    {
+        host_kernel& k = kernel();
+        std::lock_guard<std::mutex> lock(k.lock);
+        return k.realtime ? 1 : 0;
+    }
+
+    void osHostShutdown(void)
+    {
+        host_kernel& k = kernel();
+        std::vector<pthread_t> handles;
+        {
+            std::lock_guard<std::mutex> lock(k.lock);
+            k.stopping = true;
+            k.changed.notify_all();
+            for (auto& t : k.threads) {
+                t->wake.notify_all();
+                handles.push_back(t->handle);
+            }
+            if (k.timer_started) {
+                handles.push_back(k.timer_thread);
+            }
+        }
+        for (pthread_t h : handles) {
+            pthread_join(h, nullptr);
+        }
+        std::lock_guard<std::mutex> lock(k.lock);
+        k.threads.clear();
+        k.timers.clear();
+        k.timer_started = false;
+        k.realtime = false;
+        k.state = osKernelInactive;
+    }
+}
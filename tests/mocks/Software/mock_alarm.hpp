@@ -0,0 +1,66 @@
+/**
+ * @file mock_alarm.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Simulated wake-up alarm and WFI for tickless_idle on the host.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+
+/**
+ * @brief An alarm on a mock_counter whose wait() is a simulated sleep: it
+ * moves the counter on to the alarm, or to an interrupt a test has queued
+ * if that comes first.
+ *
+ * @tparam Counter mock_counter the clock reads
+ * @tparam Clock monotonic_clock on the counter
+ */
+template<typename Counter, typename Clock>
+struct mock_alarm
+{
+    using critical_section = typename Counter::critical_section;
+
+    static void set(uint64_t at)
+    {
+        armed = true;
+        alarm = at;
+    }
+
+    static void cancel() { armed = false; }
+
+    static void wait()
+    {
+        const uint64_t now = Clock::now();
+        uint64_t until =
+          armed ? alarm : std::numeric_limits<uint64_t>::max();
+        if (interrupt && *interrupt < until) {
+            until = std::max(*interrupt, now);
+            interrupt.reset();
+        }
+        if (until == std::numeric_limits<uint64_t>::max()) {
+            throw std::logic_error("slept with nothing to wake it");
+        }
+        ++waits;
+        Counter::advance(until - now);
+    }
+
+    static void reset()
+    {
+        armed = false;
+        interrupt.reset();
+        waits = 0;
+    }
+
+    static inline bool armed = false;
+    static inline uint64_t alarm = 0;
+    //! When the next interrupt arrives, if one will
+    static inline std::optional<uint64_t> interrupt;
+    static inline int waits = 0;
+};
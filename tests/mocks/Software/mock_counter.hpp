@@ -0,0 +1,41 @@
+/**
+ * @file mock_counter.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Simulated 32-bit hardware counter for monotonic_clock on the host.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <cstdint>
+
+/**
+ * @brief A counter that only moves when a test moves it.
+ *
+ * Every Tag is a separate counter with its own clock state, so tests can
+ * each start from zero.
+ *
+ * @tparam Frequency Simulated counter rate in Hz.
+ * @tparam Tag Distinguishes independent counters.
+ */
+template<uint32_t Frequency, typename Tag = void>
+struct mock_counter
+{
+    static uint32_t read() { return value; }
+
+    static uint32_t frequency() { return Frequency; }
+
+    struct critical_section
+    {};
+
+    /**
+     * @brief Move the counter on, wrapping at 2^32 like the hardware.
+     */
+    static void advance(uint64_t ticks)
+    {
+        value = static_cast<uint32_t>(value + ticks);
+    }
+
+    static inline uint32_t value = 0;
+};
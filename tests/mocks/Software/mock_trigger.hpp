@@ -0,0 +1,61 @@
+/**
+ * @file mock_trigger.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Simulated software interrupt for interrupt_executor on the host.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+/**
+ * @brief A software interrupt whose handler runs as soon as it is pended,
+ * the way the NVIC preempts thread mode, unless it is masked or already
+ * active; then it runs when unmasked, or straight after it returns.
+ *
+ * @tparam Tag Distinguishes independent triggers
+ */
+template<typename Tag>
+struct mock_trigger
+{
+    static void pend()
+    {
+        requested = true;
+        take();
+    }
+
+    static void mask() { masked = true; }
+
+    static void unmask()
+    {
+        masked = false;
+        take();
+    }
+
+    static void reset()
+    {
+        handler = nullptr;
+        requested = false;
+        masked = false;
+        active = false;
+        entries = 0;
+    }
+
+    static inline void (*handler)() = nullptr;
+    static inline bool requested = false;
+    static inline bool masked = false;
+    static inline bool active = false;
+    //! Times the handler has been entered
+    static inline int entries = 0;
+
+private:
+    static void take()
+    {
+        while (requested && !masked && !active && handler) {
+            requested = false;
+            active = true;
+            ++entries;
+            handler();
+            active = false;
+        }
+    }
+};
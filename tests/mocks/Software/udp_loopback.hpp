@@ -0,0 +1,108 @@
+/**
+ * @file udp_loopback.hpp
+ * @author Chris DeFrancisci (chrisdefrancisci@gmail.com)
+ * @brief Host stand-in for eth_udp: datagrams between sockets on 127.0.0.1.
+ * @date 2026-10-17
+ */
+
+#pragma once
+
+// Library includes
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+// POSIX includes
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * @brief A non-blocking UDP socket on the loopback interface with the same
+ * send() and poll() as eth_udp.
+ *
+ * Loopback has no broadcast, so send() goes to every peer added instead.
+ * Each socket binds an ephemeral port, so tests never collide.
+ */
+class udp_loopback
+{
+public:
+    udp_loopback()
+    {
+        fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd < 0) {
+            throw std::runtime_error("socket");
+        }
+        sockaddr_in self = address(0);
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&self), sizeof(self)) !=
+            0) {
+            ::close(fd);
+            throw std::runtime_error("bind");
+        }
+        socklen_t length = sizeof(self);
+        ::getsockname(fd, reinterpret_cast<sockaddr*>(&self), &length);
+        bound = ntohs(self.sin_port);
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+
+    ~udp_loopback() { ::close(fd); }
+
+    udp_loopback(udp_loopback const&) = delete;
+    void operator=(udp_loopback const&) = delete;
+
+    uint16_t port() const { return bound; }
+
+    void add_peer(uint16_t peer) { peers.push_back(peer); }
+
+    /**
+     * @brief Send a datagram to every peer.
+     */
+    bool send(const uint8_t* data, std::size_t n)
+    {
+        bool ok = true;
+        for (uint16_t peer : peers) {
+            sockaddr_in to = address(peer);
+            ok &= ::sendto(fd,
+                           data,
+                           n,
+                           0,
+                           reinterpret_cast<sockaddr*>(&to),
+                           sizeof(to)) == static_cast<ssize_t>(n);
+        }
+        return ok;
+    }
+
+    /**
+     * @brief Hand every datagram waiting to `receive`.
+     */
+    template<typename Receive>
+    void poll(Receive&& receive)
+    {
+        std::array<uint8_t, 1500> buffer;
+        for (;;) {
+            ssize_t n = ::recv(fd, buffer.data(), buffer.size(), 0);
+            if (n < 0) {
+                return;
+            }
+            receive(buffer.data(), static_cast<std::size_t>(n));
+        }
+    }
+
+private:
+    static sockaddr_in address(uint16_t port)
+    {
+        sockaddr_in a{};
+        a.sin_family = AF_INET;
+        a.sin_port = htons(port);
+        a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return a;
+    }
+
+    int fd;
+    uint16_t bound = 0;
+    std::vector<uint16_t> peers;
+};
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include <quantized_looper/Audio/audio_graph.hpp>
+
+namespace {
+
+using block_t = audio_block<int16_t, 8, 2>;
+
+// Records the order nodes ran in by appending its id to channel 1
+struct tag_node
+{
+    int16_t id;
+    std::size_t* calls;
+
+    template<typename Block>
+    void process(Block& block)
+    {
+        block.data[1][(*calls)++] = id;
+    }
+};
+
+} // namespace
+
+TEST(AudioBlock, InterleaveRoundTrip)
+{
+    std::vector<int16_t> interleaved(16);
+    for (std::size_t i = 0; i < interleaved.size(); ++i) {
+        interleaved[i] = static_cast<int16_t>(i);
+    }
+
+    block_t block;
+    block.deinterleave(interleaved.data());
+    for (std::size_t i = 0; i < block_t::frames; ++i) {
+        EXPECT_EQ(block.data[0][i], static_cast<int16_t>(2 * i));
+        EXPECT_EQ(block.data[1][i], static_cast<int16_t>(2 * i + 1));
+    }
+
+    std::vector<int16_t> out(16);
+    block.interleave(out.data());
+    EXPECT_EQ(out, interleaved);
+}
+
+TEST(AudioGraph, NodesRunInOrder)
+{
+    std::size_t calls = 0;
+    audio_graph<block_t, tag_node, tag_node, tag_node> graph(
+      tag_node{ 10, &calls }, tag_node{ 20, &calls }, tag_node{ 30, &calls });
+
+    block_t block;
+    graph.process(block);
+    EXPECT_EQ(calls, 3u);
+    EXPECT_EQ(block.data[1][0], 10);
+    EXPECT_EQ(block.data[1][1], 20);
+    EXPECT_EQ(block.data[1][2], 30);
+}
+
+TEST(AudioGraph, GainScalesEveryChannel)
+{
+    audio_graph<block_t, gain_node<int16_t>> graph(gain_node<int16_t>(16384));
+    block_t block;
+    block.data[0].fill(1000);
+    block.data[1].fill(-1000);
+    graph.process(block);
+    for (std::size_t i = 0; i < block_t::frames; ++i) {
+        EXPECT_EQ(block.data[0][i], 500);
+        EXPECT_EQ(block.data[1][i], -500);
+    }
+
+    audio_graph<audio_block<float, 4, 1>, gain_node<float>> float_graph(
+      gain_node<float>(0.25f));
+    audio_block<float, 4, 1> float_block;
+    float_block.data[0].fill(2.0f);
+    float_graph.process(float_block);
+    EXPECT_FLOAT_EQ(float_block.data[0][3], 0.5f);
+}
+
+TEST(AudioGraph, UnityGainPassesSamplesThrough)
+{
+    audio_graph<block_t, gain_node<int16_t>> graph(
+      gain_node<int16_t>(gain_node<int16_t>::unity));
+    block_t block;
+    block.data[0].fill(32767);
+    block.data[1].fill(-32768);
+    block.data[0][1] = -1;
+    graph.process(block);
+    EXPECT_EQ(block.data[0][0], 32767);
+    EXPECT_EQ(block.data[0][1], -1);
+    EXPECT_EQ(block.data[1][0], -32768);
+}
+
+TEST(AudioGraph, GainAboveUnitySaturates)
+{
+    // Four times unity: 20000 * 131072 overflows 32 bits before the shift
+    audio_graph<block_t, gain_node<int16_t>> graph(gain_node<int16_t>(131072));
+    block_t block;
+    block.data[0].fill(20000);
+    block.data[1].fill(-20000);
+    block.data[0][0] = 1000;
+    graph.process(block);
+    EXPECT_EQ(block.data[0][0], 4000);
+    EXPECT_EQ(block.data[0][1], 32767);
+    EXPECT_EQ(block.data[1][1], -32768);
+
+    audio_graph<audio_block<int32_t, 4, 1>, gain_node<int32_t>> wide_graph(
+      gain_node<int32_t>(65536));
+    audio_block<int32_t, 4, 1> wide_block;
+    wide_block.data[0].fill(1 << 20);
+    wide_block.data[0][1] = INT32_MAX;
+    wide_graph.process(wide_block);
+    EXPECT_EQ(wide_block.data[0][0], 1 << 21);
+    EXPECT_EQ(wide_block.data[0][1], INT32_MAX);
+}
+
+TEST(AudioGraph, LoopNodeMonitorsInputOverLoop)
+{
+    using looper_t = loop_engine<int16_t, 64>;
+    static looper_t looper(48000);
+    looper.set_samples_per_beat(8);
+    looper.arm(loop_command::record, quantize::immediate);
+
+    audio_graph<block_t, loop_node<looper_t>> graph{ loop_node<looper_t>(looper) };
+
+    // Record one block on the left channel, then loop it under silence
+    std::vector<int16_t> in(16, 0);
+    std::vector<int16_t> out(16);
+    for (std::size_t i = 0; i < 8; ++i) {
+        in[2 * i] = static_cast<int16_t>(100 + i);
+    }
+    graph.process_interleaved(in.data(), out.data());
+    EXPECT_EQ(out[0], 100); // Monitored input
+    EXPECT_EQ(out[1], 0);
+
+    looper.arm(loop_command::play, quantize::immediate);
+    std::fill(in.begin(), in.end(), 0);
+    graph.process_interleaved(in.data(), out.data());
+    for (std::size_t i = 0; i < 8; ++i) {
+        EXPECT_EQ(out[2 * i], static_cast<int16_t>(100 + i));
+        EXPECT_EQ(out[2 * i + 1], static_cast<int16_t>(100 + i));
+    }
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <Hardware/wav_audio_io.hpp>
+#include <quantized_looper/Audio/loop_engine.hpp>
+
+namespace {
+
+constexpr std::size_t block = 32;
+constexpr std::size_t channels = 2;
+
+std::string temp_path(const std::string& name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Stereo file where left counts up and right counts down
+std::vector<int16_t> write_ramp(const std::string& path, std::size_t frames)
+{
+    std::vector<int16_t> samples(frames * channels);
+    for (std::size_t i = 0; i < frames; ++i) {
+        samples[2 * i] = static_cast<int16_t>(i);
+        samples[2 * i + 1] = static_cast<int16_t>(-static_cast<int>(i));
+    }
+    wav_writer writer(path, channels, 48000);
+    writer.write(samples.data(), samples.size());
+    return samples;
+}
+
+std::vector<int16_t> read_all(const std::string& path)
+{
+    wav_reader reader(path);
+    std::vector<int16_t> samples(reader.frames() * reader.channels());
+    reader.read(samples.data(), samples.size());
+    return samples;
+}
+
+void pass_through(const int16_t* in, int16_t* out, void*)
+{
+    std::copy_n(in, block * channels, out);
+}
+
+} // namespace
+
+TEST(WavFile, RoundTrip)
+{
+    auto path = temp_path("ql_wav_round_trip.wav");
+    auto written = write_ramp(path, 1000);
+
+    wav_reader reader(path);
+    ASSERT_TRUE(reader.is_open());
+    EXPECT_EQ(reader.channels(), channels);
+    EXPECT_EQ(reader.sample_rate(), 48000u);
+    EXPECT_EQ(reader.frames(), 1000u);
+    EXPECT_EQ(read_all(path), written);
+}
+
+TEST(WavAudioIo, CallbacksAlternateHalves)
+{
+    auto in_path = temp_path("ql_halves_in.wav");
+    write_ramp(in_path, 10 * block);
+
+    wav_audio_io<block, channels> io(in_path, temp_path("ql_halves_out.wav"));
+    ASSERT_TRUE(io.is_open());
+
+    struct record
+    {
+        const int16_t* rx;
+        std::vector<const int16_t*> in;
+    } seen{ io.rx_buffer(), {} };
+    io.set_callback(
+      [](const int16_t* in, int16_t*, void* context) {
+          static_cast<record*>(context)->in.push_back(in);
+      },
+      &seen);
+
+    EXPECT_EQ(io.run(), 10u);
+    ASSERT_EQ(seen.in.size(), 10u);
+    for (std::size_t i = 0; i < seen.in.size(); ++i) {
+        EXPECT_EQ(seen.in[i], seen.rx + (i % 2) * block * channels);
+    }
+}
+
+TEST(WavAudioIo, PassThroughIsDelayedTwoBlocks)
+{
+    auto in_path = temp_path("ql_pass_in.wav");
+    auto out_path = temp_path("ql_pass_out.wav");
+    auto input = write_ramp(in_path, 20 * block);
+
+    {
+        wav_audio_io<block, channels> io(in_path, out_path);
+        io.set_callback(pass_through);
+        EXPECT_EQ(io.run(), 20u);
+    }
+
+    auto output = read_all(out_path);
+    const std::size_t latency = 2 * block * channels;
+    ASSERT_EQ(output.size(), input.size());
+    for (std::size_t i = 0; i < latency; ++i) {
+        ASSERT_EQ(output[i], 0);
+    }
+    for (std::size_t i = latency; i < output.size(); ++i) {
+        ASSERT_EQ(output[i], input[i - latency]) << i;
+    }
+}
+
+TEST(WavAudioIo, PartialLastBlockIsPadded)
+{
+    auto in_path = temp_path("ql_partial_in.wav");
+    write_ramp(in_path, 3 * block + 5);
+
+    wav_audio_io<block, channels> io(in_path, temp_path("ql_partial_out.wav"));
+    EXPECT_EQ(io.run(), 4u);
+}
+
+// Full path: interrupt-side exchange, task-side engine, loop played back
+TEST(WavAudioIo, BlockQueueFeedsLoopEngine)
+{
+    using io_t = wav_audio_io<block, 1>;
+    auto in_path = temp_path("ql_engine_in.wav");
+    auto out_path = temp_path("ql_engine_out.wav");
+
+    constexpr std::size_t beat = 4 * block;
+    {
+        std::vector<int16_t> samples(8 * beat);
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            samples[i] = static_cast<int16_t>(i < beat ? i + 1 : 0);
+        }
+        wav_writer writer(in_path, 1, 48000);
+        writer.write(samples.data(), samples.size());
+    }
+
+    struct context
+    {
+        audio_block_queue<io_t> queue;
+        loop_engine<int16_t, 1024> engine{ 48000 };
+    } ctx;
+    ctx.engine.set_samples_per_beat(beat);
+    ctx.engine.arm(loop_command::record, quantize::immediate);
+
+    io_t io(in_path, out_path);
+    io.set_callback(
+      [](const int16_t* in, int16_t* out, void* p) {
+          auto* c = static_cast<context*>(p);
+          decltype(c->queue)::exchange(in, out, &c->queue);
+          c->queue.process([c](const int16_t* in, int16_t* out) {
+              if (c->engine.sample_clock() == block) {
+                  c->engine.arm(loop_command::play, quantize::beat);
+              }
+              c->engine.process(in, out, block);
+          });
+      },
+      &ctx);
+    io.run();
+
+    EXPECT_EQ(ctx.queue.overruns(), 0u);
+    EXPECT_EQ(ctx.queue.underruns(), 0u);
+    EXPECT_EQ(ctx.engine.length(), beat);
+
+    // Two blocks of DMA latency plus the primed block in the queue
+    auto output = read_all(out_path);
+    const std::size_t latency = 3 * block;
+    for (std::size_t i = beat + latency; i < output.size(); ++i) {
+        ASSERT_EQ(output[i], static_cast<int16_t>((i - latency) % beat + 1))
+          << i;
+    }
+}
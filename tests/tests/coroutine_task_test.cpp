@@ -0,0 +1,252 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <quantized_looper/Software/coroutine_task.hpp>
+#include <quantized_looper/Software/timer_wheel.hpp>
+
+namespace {
+
+// Simulated clock, and every run as (task, clock time)
+uint64_t sim_now = 0;
+std::vector<std::pair<int, uint64_t>> runs;
+
+uint64_t sim_clock()
+{
+    return sim_now;
+}
+
+using task_t = wheel_task<uint64_t>;
+using wheel_t = timer_wheel<uint64_t, 3>;
+using coroutines = coroutine_tasks<wheel_t>;
+using frames = frame_pool<256, 4>;
+
+// 16 ticks per granule
+constexpr unsigned shift = 4;
+
+void run_until(wheel_t& wheel, uint64_t end)
+{
+    while (sim_now < end) {
+        ++sim_now;
+        wheel.poll(sim_now);
+    }
+}
+
+std::vector<uint64_t> times_of(int task)
+{
+    std::vector<uint64_t> t;
+    for (auto [i, at] : runs) {
+        if (i == task) {
+            t.push_back(at);
+        }
+    }
+    return t;
+}
+
+// A blinking LED as a loop, on its phase
+co_task<frames> blink(int id, uint64_t period)
+{
+    uint64_t next = sim_clock();
+    for (;;) {
+        runs.emplace_back(id, sim_now);
+        next += period;
+        co_await sleep_until{ next };
+    }
+}
+
+co_task<frames> pause(int id, uint64_t ticks, int times)
+{
+    for (int i = 0; i < times; ++i) {
+        runs.emplace_back(id, sim_now);
+        co_await sleep_for{ ticks };
+    }
+}
+
+task_event<uint64_t> ready;
+
+co_task<frames> consume(int id)
+{
+    for (;;) {
+        co_await ready;
+        runs.emplace_back(id, sim_now);
+    }
+}
+
+void produce()
+{
+    runs.emplace_back(2, sim_now);
+    ready.set();
+}
+
+void nothing() {}
+
+} // namespace
+
+TEST(FramePool, HandsOutBlocksUntilFull)
+{
+    using pool = frame_pool<64, 3>;
+    void* a = pool::allocate(64);
+    void* b = pool::allocate(10);
+    void* c = pool::allocate(1);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    ASSERT_NE(c, nullptr);
+    EXPECT_EQ(pool::allocate(1), nullptr);
+    EXPECT_EQ(pool::in_use(), 3u);
+
+    pool::deallocate(b);
+    EXPECT_EQ(pool::allocate(5), b);
+    pool::deallocate(a);
+    pool::deallocate(b);
+    pool::deallocate(c);
+    EXPECT_EQ(pool::in_use(), 0u);
+}
+
+TEST(FramePool, TooBigIsRefusedButRecorded)
+{
+    using pool = frame_pool<64, 2>;
+    EXPECT_EQ(pool::allocate(65), nullptr);
+    EXPECT_EQ(pool::in_use(), 0u);
+    EXPECT_EQ(pool::high_water(), 65u);
+}
+
+TEST(CoroutineTask, FrameComesFromThePool)
+{
+    {
+        auto task = blink(0, 10);
+        EXPECT_TRUE(task);
+        EXPECT_EQ(frames::in_use(), 1u);
+        EXPECT_LE(frames::high_water(), frames::frame_bytes());
+    }
+    EXPECT_EQ(frames::in_use(), 0u);
+}
+
+TEST(CoroutineTask, FullPoolGivesAnEmptyTask)
+{
+    std::array<co_task<frames>, 4> held = {
+        blink(0, 1), blink(0, 1), blink(0, 1), blink(0, 1)
+    };
+    auto extra = blink(0, 1);
+    EXPECT_FALSE(extra);
+    EXPECT_FALSE(extra.done());
+    held[2] = co_task<frames>();
+    EXPECT_TRUE(blink(0, 1));
+}
+
+TEST(CoroutineTask, LoopKeepsItsPhaseLikeAPeriodicTask)
+{
+    sim_now = 0;
+    runs.clear();
+    auto a = blink(0, 800);
+    auto b = blink(1, 160);
+    std::array<task_t, 3> tasks = {
+        task_t(nothing, sim_clock, 0, 0),
+        task_t(coroutines::resume<1>, sim_clock, 0, 0),
+        task_t(coroutines::resume<2>, sim_clock, 0, 32)
+    };
+    wheel_t wheel(tasks, shift);
+    coroutines::attach(wheel);
+    coroutines::bind<1>(a);
+    coroutines::bind<2>(b);
+    wheel.start(sim_now);
+    run_until(wheel, 8000);
+
+    // Each release by the granule after it, with no drift
+    auto slow = times_of(0);
+    auto fast = times_of(1);
+    ASSERT_EQ(slow.size(), 10u);
+    ASSERT_EQ(fast.size(), 50u);
+    for (std::size_t i = 0; i < slow.size(); ++i) {
+        EXPECT_GE(slow[i], 800 * i);
+        EXPECT_LE(slow[i], 800 * i + 16);
+    }
+    for (std::size_t i = 0; i < fast.size(); ++i) {
+        EXPECT_GE(fast[i], 32 + 160 * i);
+        EXPECT_LE(fast[i], 32 + 160 * i + 16);
+    }
+}
+
+TEST(CoroutineTask, SleepForAndFinish)
+{
+    sim_now = 0;
+    runs.clear();
+    auto p = pause(0, 100, 3);
+    std::array<task_t, 3> tasks = {
+        task_t(nothing, sim_clock, 0, 0),
+        task_t(coroutines::resume<1>, sim_clock, 0, 0),
+        task_t(nothing, sim_clock, 0, 0)
+    };
+    wheel_t wheel(tasks, shift);
+    coroutines::attach(wheel);
+    coroutines::bind<1>(p);
+    wheel.start(sim_now);
+    run_until(wheel, 1000);
+
+    // Three runs about 100 ticks apart, then the loop ends and is not run
+    // again
+    auto t = times_of(0);
+    ASSERT_EQ(t.size(), 3u);
+    for (std::size_t i = 1; i < t.size(); ++i) {
+        EXPECT_GE(t[i] - t[i - 1], 100u);
+        EXPECT_LT(t[i] - t[i - 1], 100u + 16);
+    }
+    EXPECT_TRUE(p.done());
+    EXPECT_FALSE(wheel.scheduled(1));
+}
+
+TEST(CoroutineTask, EventWakesTheWaiter)
+{
+    sim_now = 0;
+    runs.clear();
+    ready = task_event<uint64_t>();
+    auto c = consume(1);
+    std::array<task_t, 3> tasks = {
+        task_t(nothing, sim_clock, 0, 0),
+        task_t(coroutines::resume<1>, sim_clock, 0, 0),
+        task_t(produce, sim_clock, 300, 100)
+    };
+    wheel_t wheel(tasks, shift);
+    coroutines::attach(wheel);
+    coroutines::bind<1>(c);
+    wheel.start(sim_now);
+    run_until(wheel, 1000);
+
+    // Waiting since its first run, it wakes by the granule after each set()
+    auto sets = times_of(2);
+    auto wakes = times_of(1);
+    ASSERT_EQ(sets.size(), 3u);
+    ASSERT_EQ(wakes.size(), 3u);
+    for (std::size_t i = 0; i < sets.size(); ++i) {
+        EXPECT_GE(wakes[i], sets[i]);
+        EXPECT_LE(wakes[i], sets[i] + 16);
+    }
+    EXPECT_TRUE(ready.waiting());
+    EXPECT_FALSE(wheel.scheduled(1));
+}
+
+TEST(CoroutineTask, EventSetBeforeTheWaitIsKept)
+{
+    sim_now = 0;
+    runs.clear();
+    ready = task_event<uint64_t>();
+    auto c = consume(1);
+    std::array<task_t, 3> tasks = {
+        task_t(nothing, sim_clock, 0, 0),
+        task_t(coroutines::resume<1>, sim_clock, 0, 50),
+        task_t(produce, sim_clock, 0, 0)
+    };
+    wheel_t wheel(tasks, shift);
+    coroutines::attach(wheel);
+    coroutines::bind<1>(c);
+    wheel.start(sim_now);
+    run_until(wheel, 200);
+
+    // Set once, before the consumer first waited: one wake-up, at once
+    auto wakes = times_of(1);
+    ASSERT_EQ(wakes.size(), 1u);
+    EXPECT_LT(wakes[0], 50u + 16);
+    EXPECT_TRUE(ready.waiting());
+}
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <quantized_looper/Software/event_queue.hpp>
+
+namespace {
+
+struct command
+{
+    uint32_t source;
+    uint32_t sequence;
+};
+
+} // namespace
+
+TEST(EventQueue, PopsInTimeOrder)
+{
+    event_queue<int, 8> q;
+    EXPECT_TRUE(q.post(300, 3));
+    EXPECT_TRUE(q.post(100, 1));
+    EXPECT_TRUE(q.post(200, 2));
+
+    uint64_t at = 0;
+    ASSERT_TRUE(q.next_due(at));
+    EXPECT_EQ(at, 100u);
+
+    int e = 0;
+    EXPECT_FALSE(q.pop(99, e));
+    EXPECT_TRUE(q.pop(100, e));
+    EXPECT_EQ(e, 1);
+
+    std::vector<int> fired;
+    EXPECT_EQ(q.pop_due(1000, [&](uint64_t, int v) { fired.push_back(v); }),
+              2u);
+    EXPECT_EQ(fired, (std::vector<int>{ 2, 3 }));
+    EXPECT_FALSE(q.next_due(at));
+}
+
+TEST(EventQueue, SameTimeKeepsPostOrder)
+{
+    event_queue<int, 16> q;
+    for (int i = 0; i < 10; ++i) {
+        q.post(i % 2 == 0 ? 50 : 40, i);
+    }
+    std::vector<int> fired;
+    q.pop_due(50, [&](uint64_t, int v) { fired.push_back(v); });
+    EXPECT_EQ(fired, (std::vector<int>{ 1, 3, 5, 7, 9, 0, 2, 4, 6, 8 }));
+}
+
+TEST(EventQueue, FullPendingWaitsInInbox)
+{
+    event_queue<int, 4, 4> q;
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(q.post(10 + i, i));
+    }
+    q.drain();
+    EXPECT_EQ(q.pending_count(), 4u);
+
+    // Pending is full: posts stay in the inbox until it fills
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(q.post(i, 100 + i));
+    }
+    EXPECT_FALSE(q.post(0, 200));
+    EXPECT_EQ(q.drain(), 4u);
+
+    // Each pop makes room for one held post, which is overdue and goes
+    // next; an overfull queue is late, but loses nothing
+    std::vector<int> fired;
+    q.pop_due(100, [&](uint64_t, int v) { fired.push_back(v); });
+    EXPECT_EQ(fired, (std::vector<int>{ 0, 100, 101, 102, 103, 1, 2, 3 }));
+}
+
+TEST(EventQueue, FiringMayPostDueEvents)
+{
+    event_queue<int, 8> q;
+    q.post(10, 1);
+    std::vector<int> fired;
+    q.pop_due(10, [&](uint64_t at, int v) {
+        fired.push_back(v);
+        if (v == 1) {
+            q.post(at, 2);
+            q.post(at + 1, 3);
+        }
+    });
+    EXPECT_EQ(fired, (std::vector<int>{ 1, 2 }));
+    EXPECT_EQ(q.pending_count(), 1u);
+}
+
+TEST(EventQueue, CancelCoversInbox)
+{
+    event_queue<int, 8> q;
+    q.post(10, 1);
+    q.drain();
+    q.post(20, 2);
+    q.post(30, 1);
+    EXPECT_EQ(q.cancel_if([](int v) { return v == 1; }), 2u);
+    int e = 0;
+    EXPECT_TRUE(q.pop(100, e));
+    EXPECT_EQ(e, 2);
+    EXPECT_FALSE(q.pop(100, e));
+}
+
+// Three producers post at random times with no pacing while the consumer
+// sweeps time forward: every event comes out once and none before its time.
+// A post racing the sweep may land after its time has passed; it goes out
+// on the next pop.
+TEST(EventQueue, ConcurrentProducersLoseNothing)
+{
+    constexpr uint32_t producers = 3;
+    constexpr uint32_t per_producer = 20000;
+    static event_queue<command, 1024, 64> q;
+    std::atomic<uint64_t> now{ 0 };
+
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            std::mt19937 rng(p);
+            std::uniform_int_distribution<uint64_t> ahead(0, 2000);
+            for (uint32_t i = 0; i < per_producer;) {
+                uint64_t at = now.load() + 1 + ahead(rng);
+                if (q.post(at, { p, i })) {
+                    ++i;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<std::vector<bool>> seen(
+      producers, std::vector<bool>(per_producer, false));
+    uint64_t received = 0;
+    uint32_t early = 0;
+    uint32_t duplicates = 0;
+    while (received < producers * per_producer) {
+        uint64_t t = now.load() + 4;
+        now.store(t);
+        q.pop_due(t, [&](uint64_t at, const command& c) {
+            early += at > t ? 1 : 0;
+            duplicates += seen[c.source][c.sequence] ? 1 : 0;
+            seen[c.source][c.sequence] = true;
+            ++received;
+        });
+        std::this_thread::yield();
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(early, 0u);
+    EXPECT_EQ(duplicates, 0u);
+    EXPECT_EQ(q.pending_count(), 0u);
+    for (const auto& s : seen) {
+        EXPECT_EQ(std::count(s.begin(), s.end(), true),
+                  static_cast<std::ptrdiff_t>(per_producer));
+    }
+}
+
+// The same race with time held still: once everything is in, events come
+// out in time order, and each producer's events due together in the order
+// it posted them.
+TEST(EventQueue, ConcurrentProducersComeOutSorted)
+{
+    constexpr uint32_t producers = 3;
+    constexpr uint32_t per_producer = 2000;
+    static event_queue<command, producers * per_producer, 16> q;
+
+    std::atomic<uint32_t> done{ 0 };
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            std::mt19937 rng(p);
+            // Few distinct times, so many events tie
+            std::uniform_int_distribution<uint64_t> time(1, 50);
+            for (uint32_t i = 0; i < per_producer;) {
+                if (q.post(time(rng), { p, i })) {
+                    ++i;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            done.fetch_add(1);
+        });
+    }
+    while (done.load() < producers) {
+        q.drain();
+        std::this_thread::yield();
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    std::vector<uint64_t> previous_at(producers, 0);
+    std::vector<int64_t> previous(producers, -1);
+    uint64_t last = 0;
+    uint32_t out_of_order = 0;
+    std::size_t n = q.pop_due(50, [&](uint64_t at, const command& c) {
+        out_of_order += at < last ? 1 : 0;
+        out_of_order += at == previous_at[c.source] &&
+                            c.sequence < previous[c.source]
+                          ? 1
+                          : 0;
+        last = at;
+        previous_at[c.source] = at;
+        previous[c.source] = c.sequence;
+    });
+    EXPECT_EQ(n, producers * per_producer);
+    EXPECT_EQ(out_of_order, 0u);
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include <quantized_looper/Audio/fade_table.hpp>
+#include <quantized_looper/Audio/loop_engine.hpp>
+#include <quantized_looper/Audio/track_bank.hpp>
+
+namespace {
+
+constexpr std::size_t fade = 64;
+constexpr uint32_t sample_rate = 48000;
+
+// A 440 Hz tone at half scale moves at most this much between samples
+constexpr int max_tone_step = 929;
+
+// Any jump this big is a click
+constexpr int click = 3000;
+
+std::vector<int16_t> tone(std::size_t n, std::size_t offset = 0)
+{
+    std::vector<int16_t> x(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        double t = static_cast<double>(i + offset) / sample_rate;
+        x[i] = static_cast<int16_t>(16384 * std::sin(2 * M_PI * 440 * t));
+    }
+    return x;
+}
+
+int largest_step(const std::vector<int16_t>& x)
+{
+    int step = 0;
+    for (std::size_t i = 1; i < x.size(); ++i) {
+        step = std::max(step, std::abs(x[i] - x[i - 1]));
+    }
+    return step;
+}
+
+// Record a 440 Hz tone into a loop that is not a whole number of cycles long,
+// then play it back for a few passes. Without a crossfade the wrap jumps.
+template<typename Engine>
+std::vector<int16_t> loop_tone(Engine& engine)
+{
+    constexpr std::size_t length = 1000;
+    engine.set_samples_per_beat(length);
+    engine.arm(loop_command::record, quantize::immediate);
+    auto in = tone(4 * length);
+    std::vector<int16_t> out(in.size());
+    engine.process(in.data(), out.data(), length);
+    engine.arm(loop_command::play, quantize::beat);
+    engine.process(&in[length], &out[length], 3 * length);
+    return { out.begin() + 2 * length, out.end() };
+}
+
+} // namespace
+
+TEST(FadeTable, TablesAreComplementary)
+{
+    const auto& linear = fade_table<float, fade_curve::linear, fade>;
+    const auto& power = fade_table<float, fade_curve::equal_power, fade>;
+    for (std::size_t i = 0; i < fade; ++i) {
+        float in = linear[i];
+        float out = linear[fade - 1 - i];
+        EXPECT_NEAR(in + out, 1.0f, 1e-6f) << i;
+
+        in = power[i];
+        out = power[fade - 1 - i];
+        EXPECT_NEAR(in * in + out * out, 1.0f, 1e-6f) << i;
+    }
+}
+
+TEST(FadeTable, Q15TablesRiseMonotonically)
+{
+    const auto& power = fade_table<int16_t, fade_curve::equal_power, fade>;
+    EXPECT_GT(power.front(), 0);
+    EXPECT_LT(power.back(), 32767);
+    for (std::size_t i = 1; i < fade; ++i) {
+        ASSERT_GT(power[i], power[i - 1]) << i;
+    }
+    EXPECT_NEAR(power[fade / 2],
+                32767 * std::sin(M_PI / 2 * (fade / 2 + 1) / (fade + 1)),
+                1.0);
+}
+
+TEST(FadeTable, TablesAreBuiltAtCompileTime)
+{
+    static_assert(fade_table<int16_t, fade_curve::linear, 3>[1] == 16384);
+    static_assert(fade_table<int16_t, fade_curve::equal_power, 1>[0] == 23170);
+}
+
+TEST(FadeTable, CrossfadeMovesFromOneSourceToTheOther)
+{
+    fade_ramp<int16_t, fade> ramp(fade_curve::linear);
+    std::vector<int16_t> from(fade, 10000);
+    std::vector<int16_t> to(fade, -10000);
+    // Applied in two pieces, as it would be across blocks
+    ramp.crossfade(to.data(), from.data(), 0, 20);
+    ramp.crossfade(to.data() + 20, from.data() + 20, 20, fade - 20);
+    EXPECT_NEAR(to.front(), 10000, 400);
+    EXPECT_NEAR(to.back(), -10000, 400);
+    EXPECT_LE(largest_step(to), 400);
+}
+
+TEST(FadeTable, LoopWrapWithoutFadeClicks)
+{
+    loop_engine<int16_t, 4096> engine(sample_rate);
+    EXPECT_GT(largest_step(loop_tone(engine)), click);
+}
+
+TEST(FadeTable, LoopWrapIsCrossfaded)
+{
+    for (fade_curve curve : { fade_curve::linear, fade_curve::equal_power }) {
+        loop_engine<int16_t, 4096, fade> engine(sample_rate);
+        engine.set_fade_curve(curve);
+        EXPECT_LT(largest_step(loop_tone(engine)), 2 * max_tone_step);
+    }
+}
+
+TEST(FadeTable, PunchInAndOutAreFaded)
+{
+    loop_engine<int16_t, 4096, fade> engine(sample_rate);
+    engine.set_samples_per_beat(1000);
+
+    // A silent loop, so everything in it afterwards came from the punch
+    std::vector<int16_t> silence(1000, 0);
+    std::vector<int16_t> out(1000);
+    engine.arm(loop_command::record, quantize::immediate);
+    engine.process(silence.data(), out.data(), 1000);
+    engine.arm(loop_command::play, quantize::beat);
+    engine.process(silence.data(), out.data(), 300);
+
+    // Full-scale DC punched in and out mid-loop
+    std::vector<int16_t> dc(1000, 30000);
+    engine.arm(loop_command::overdub, quantize::immediate);
+    engine.process(dc.data(), out.data(), 400);
+    engine.arm(loop_command::play, quantize::immediate);
+    engine.process(dc.data(), out.data(), 300);
+
+    std::vector<int16_t> loop(engine.data(), engine.data() + engine.length());
+    EXPECT_EQ(loop[500], 30000);
+    EXPECT_LT(largest_step(loop), 30000 / fade * 2);
+}
+
+TEST(FadeTable, TrackBankWrapIsCrossfaded)
+{
+    track_bank<int16_t, 2, 4096, fade> bank(sample_rate);
+    constexpr std::size_t length = 1000;
+    auto in = tone(4 * length);
+    std::vector<int16_t> out(in.size());
+    bank.arm(0, loop_command::record, quantize::immediate);
+    bank.process(in.data(), out.data(), length);
+    bank.arm(0, loop_command::play, quantize::immediate);
+    bank.process(&in[length], &out[length], 3 * length);
+
+    std::vector<int16_t> played(out.begin() + 2 * length, out.end());
+    EXPECT_LT(largest_step(played), 2 * max_tone_step);
+}
@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <Software/mock_trigger.hpp>
+#include <quantized_looper/Software/interrupt_executor.hpp>
+#include <quantized_looper/Software/timer_wheel.hpp>
+
+namespace {
+
+struct order_tag;
+using order_trigger = mock_trigger<order_tag>;
+using order_executor = interrupt_executor<order_trigger, 3>;
+
+std::vector<int> order;
+order_executor* current = nullptr;
+
+template<int I>
+void note()
+{
+    order.push_back(I);
+}
+
+// Posts the highest priority job from inside a lower one
+void post_first()
+{
+    order.push_back(2);
+    current->post(0);
+}
+
+order_executor& make_executor(const std::array<void (*)(), 3>& jobs)
+{
+    static std::optional<order_executor> executor;
+    executor.emplace(jobs);
+    order.clear();
+    order_trigger::reset();
+    current = &*executor;
+    order_trigger::handler = [] { current->run(); };
+    return *executor;
+}
+
+} // namespace
+
+TEST(InterruptExecutor, PostedJobRunsAtOnce)
+{
+    auto& ex = make_executor({ note<0>, note<1>, note<2> });
+    ex.post(1);
+    EXPECT_EQ(order, std::vector<int>({ 1 }));
+    EXPECT_FALSE(ex.busy());
+}
+
+TEST(InterruptExecutor, RunsPendingJobsInPriorityOrder)
+{
+    auto& ex = make_executor({ note<0>, note<1>, note<2> });
+    order_trigger::mask();
+    ex.post(2);
+    ex.post(0);
+    ex.post(1);
+    EXPECT_TRUE(order.empty());
+    EXPECT_TRUE(ex.busy());
+
+    order_trigger::unmask();
+    EXPECT_EQ(order, std::vector<int>({ 0, 1, 2 }));
+    EXPECT_EQ(order_trigger::entries, 1);
+}
+
+TEST(InterruptExecutor, PostingTwiceRunsOnce)
+{
+    auto& ex = make_executor({ note<0>, note<1>, note<2> });
+    order_trigger::mask();
+    ex.post(1);
+    ex.post(1);
+    order_trigger::unmask();
+    EXPECT_EQ(order, std::vector<int>({ 1 }));
+}
+
+TEST(InterruptExecutor, JobPostedByAJobRunsBeforeReturning)
+{
+    auto& ex = make_executor({ note<0>, note<1>, post_first });
+    ex.post(2);
+    EXPECT_EQ(order, std::vector<int>({ 2, 0 }));
+    // Nothing left for the interrupt that post pended
+    EXPECT_EQ(ex.run(), 0u);
+}
+
+// The harness: a codec DMA interrupt every 667 us hands over a block, and
+// the audio job must take it while a background task is stuck for 20 ms in
+// a blocking UART write. The time from each DMA interrupt to the audio job
+// starting on its block is the wait.
+namespace {
+
+struct harness_tag;
+using harness_trigger = mock_trigger<harness_tag>;
+
+constexpr uint64_t dma_period = 667;
+constexpr uint64_t audio_poll = dma_period / 2;
+constexpr uint64_t audio_cost = 50;
+constexpr uint64_t log_period = 100000;
+constexpr uint64_t log_block = 20000;
+constexpr uint64_t duration = 1000000;
+
+uint64_t sim_us = 0;
+bool preemptive = false;
+std::vector<uint64_t> blocks;
+std::vector<uint64_t> waits;
+interrupt_executor<harness_trigger, 1>* foreground = nullptr;
+
+void dma_irq()
+{
+    blocks.push_back(sim_us);
+    if (preemptive) {
+        foreground->post(0);
+    }
+}
+
+// Let `us` of time pass, with the DMA interrupt when it is due
+void busy(uint64_t us)
+{
+    for (uint64_t i = 0; i < us; ++i) {
+        ++sim_us;
+        if (sim_us % dma_period == 0) {
+            dma_irq();
+        }
+    }
+}
+
+uint64_t sim_clock()
+{
+    return sim_us;
+}
+
+void process_audio()
+{
+    if (blocks.empty()) {
+        return;
+    }
+    auto taken = std::move(blocks);
+    blocks.clear();
+    for (uint64_t at : taken) {
+        waits.push_back(sim_us - at);
+    }
+    busy(audio_cost);
+}
+
+void print_logs()
+{
+    busy(log_block);
+}
+
+// The main loop for a second: the wheel, each pass costing a microsecond.
+// Cooperative, the audio task polls on the wheel as it used to; preemptive,
+// the DMA interrupt posts it to the foreground
+uint64_t max_wait(bool run_in_foreground)
+{
+    using task_t = wheel_task<uint64_t>;
+    sim_us = 0;
+    preemptive = run_in_foreground;
+    blocks.clear();
+    waits.clear();
+    harness_trigger::reset();
+    interrupt_executor<harness_trigger, 1> executor({ process_audio });
+    foreground = &executor;
+    harness_trigger::handler = [] { foreground->run(); };
+
+    std::array<task_t, 2> tasks = {
+        task_t(print_logs, sim_clock, log_period, 0),
+        task_t(preemptive ? [] {} : process_audio, sim_clock, audio_poll, 0)
+    };
+    timer_wheel<uint64_t, 2> wheel(tasks, 4);
+    wheel.start(sim_us);
+    while (sim_us < duration) {
+        wheel.poll(sim_us);
+        busy(1);
+    }
+    EXPECT_GE(waits.size(), duration / dma_period - 1);
+    return *std::max_element(waits.begin(), waits.end());
+}
+
+} // namespace
+
+TEST(InterruptExecutor, AudioWaitsBehindABlockingTaskWhenCooperative)
+{
+    // Up to the whole 20 ms the UART write blocks
+    EXPECT_GT(max_wait(false), log_block - dma_period);
+}
+
+TEST(InterruptExecutor, AudioPreemptsABlockingTaskInTheForeground)
+{
+    // Started on the interrupt, except while the job is already running
+    // on the previous block
+    EXPECT_LE(max_wait(true), audio_cost);
+}
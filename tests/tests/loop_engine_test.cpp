@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include <quantized_looper/Audio/loop_engine.hpp>
+
+namespace {
+
+constexpr uint32_t sample_rate = 48000;
+constexpr uint32_t beat = 100; // Samples per beat, keeps the numbers readable
+constexpr uint32_t bar = 4 * beat;
+
+using engine_t = loop_engine<int16_t, 4096>;
+
+// Input that encodes its own sample index, so a recording shows exactly which
+// sample it started on.
+class ramp_source
+{
+public:
+    void fill(int16_t* dst, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            dst[i] = static_cast<int16_t>(next++ % 30000);
+        }
+    }
+
+private:
+    uint32_t next = 0;
+};
+
+// Run the engine in fixed blocks until its clock reaches `until`, returning
+// everything it played.
+std::vector<int16_t> run_until(engine_t& engine,
+                               ramp_source& source,
+                               uint64_t until,
+                               std::size_t block = 32)
+{
+    std::vector<int16_t> played;
+    std::vector<int16_t> in(block);
+    std::vector<int16_t> out(block);
+    while (engine.sample_clock() < until) {
+        std::size_t n = std::min<std::size_t>(block, until - engine.sample_clock());
+        source.fill(in.data(), n);
+        engine.process(in.data(), out.data(), n);
+        played.insert(played.end(), out.begin(), out.begin() + n);
+    }
+    return played;
+}
+
+} // namespace
+
+TEST(LoopEngine, TempoFromTapPeriod)
+{
+    engine_t engine(sample_rate);
+    engine.set_tempo_ms(500);
+    EXPECT_EQ(engine.samples_per_beat(), 24000u);
+}
+
+TEST(LoopEngine, ArmedCommandWaitsForBoundary)
+{
+    engine_t engine(sample_rate);
+    engine.set_samples_per_beat(beat);
+    ramp_source source;
+
+    run_until(engine, source, 30);
+    engine.arm(loop_command::record, quantize::beat);
+    EXPECT_EQ(engine.armed_at(), beat);
+
+    run_until(engine, source, beat - 1);
+    EXPECT_EQ(engine.state(), loop_state::idle);
+    run_until(engine, source, beat + 1);
+    EXPECT_EQ(engine.state(), loop_state::recording);
+    EXPECT_EQ(engine.armed(), loop_command::none);
+}
+
+TEST(LoopEngine, RecordingStartsOnExactSample)
+{
+    engine_t engine(sample_rate);
+    engine.set_samples_per_beat(beat);
+    ramp_source source;
+
+    // Odd block size so the boundary lands mid-block
+    run_until(engine, source, 57, 19);
+    engine.arm(loop_command::record, quantize::bar);
+    run_until(engine, source, bar + 250, 19);
+    engine.arm(loop_command::play, quantize::bar);
+    run_until(engine, source, 2 * bar, 19);
+
+    ASSERT_EQ(engine.length(), bar);
+    for (std::size_t i = 0; i < engine.length(); ++i) {
+        ASSERT_EQ(engine.data()[i], static_cast<int16_t>(bar + i)) << i;
+    }
+}
+
+TEST(LoopEngine, LoopLengthIsWholeBars)
+{
+    engine_t engine(sample_rate);
+    engine.set_samples_per_beat(beat);
+    ramp_source source;
+
+    engine.arm(loop_command::record, quantize::bar);
+    run_until(engine, source, 2 * bar + 10);
+    engine.arm(loop_command::play, quantize::bar);
+    run_until(engine, source, 3 * bar);
+    EXPECT_EQ(engine.state(), loop_state::playing);
+    EXPECT_EQ(engine.length(), 3 * bar);
+}
+
+TEST(LoopEngine, PlaybackRepeatsRecording)
+{
+    engine_t engine(sample_rate);
+    engine.set_samples_per_beat(beat);
+    ramp_source source;
+
+    engine.arm(loop_command::record, quantize::immediate);
+    run_until(engine, source, 7);
+    engine.arm(loop_command::play, quantize::beat);
+    run_until(engine, source, beat);
+    ASSERT_EQ(engine.length(), beat);
+
+    auto played = run_until(engine, source, 4 * beat, 13);
+    ASSERT_EQ(played.size(), 3 * beat);
+    for (std::size_t i = 0; i < played.size(); ++i) {
+        ASSERT_EQ(played[i], static_cast<int16_t>(i % beat)) << i;
+    }
+}
+
+TEST(LoopEngine, OverdubSumsIntoLoopAndSaturates)
+{
+    engine_t engine(sample_rate);
+    engine.set_samples_per_beat(4);
+
+    std::vector<int16_t> in = { 1000, -1000, 30000, -30000 };
+    std::vector<int16_t> out(4);
+    engine.arm(loop_command::record, quantize::immediate);
+    engine.process(in.data(), out.data(), 4);
+    engine.arm(loop_command::overdub, quantize::beat);
+    engine.process(in.data(), out.data(), 4);
+    EXPECT_EQ(out, in);
+    EXPECT_EQ(engine.state(), loop_state::overdubbing);
+
+    engine.arm(loop_command::play, quantize::beat);
+    engine.process(in.data(), out.data(), 4);
+    std::vector<int16_t> expected = { 2000, -2000, 32767, -32768 };
+    EXPECT_EQ(out, expected);
+}
+
+TEST(LoopEngine, OverdubOnAnEmptyRecordingStops)
+{
+    engine_t engine(sample_rate);
+    engine.set_samples_per_beat(4);
+
+    std::vector<int16_t> in = { 1000, -1000, 2000, -2000 };
+    std::vector<int16_t> out(4);
+    // Record and overdub armed for the same sample: the recording closes
+    // before it has taken any input
+    engine.arm(loop_command::record, quantize::immediate);
+    engine.process(in.data(), out.data(), 0);
+    engine.arm(loop_command::overdub, quantize::immediate);
+    engine.process(in.data(), out.data(), 4);
+    EXPECT_EQ(engine.state(), loop_state::idle);
+    EXPECT_EQ(engine.length(), 0u);
+    EXPECT_EQ(out, std::vector<int16_t>(4, 0));
+
+    // And it can record again from there
+    engine.arm(loop_command::record, quantize::immediate);
+    engine.process(in.data(), out.data(), 4);
+    engine.arm(loop_command::overdub, quantize::immediate);
+    engine.process(in.data(), out.data(), 4);
+    EXPECT_EQ(engine.state(), loop_state::overdubbing);
+    EXPECT_EQ(engine.length(), 4u);
+}
+
+TEST(LoopEngine, FullBufferClosesLoop)
+{
+    loop_engine<int16_t, 64> engine(sample_rate);
+    engine.set_samples_per_beat(beat);
+    ramp_source source;
+    std::vector<int16_t> in(100);
+    std::vector<int16_t> out(100);
+
+    engine.arm(loop_command::record, quantize::immediate);
+    source.fill(in.data(), in.size());
+    engine.process(in.data(), out.data(), in.size());
+    EXPECT_EQ(engine.state(), loop_state::playing);
+    EXPECT_EQ(engine.length(), 64u);
+    EXPECT_EQ(out[64], 0);
+    EXPECT_EQ(out[99], 35);
+}
+
+TEST(LoopEngine, StopSilencesAndKeepsLoop)
+{
+    engine_t engine(sample_rate);
+    engine.set_samples_per_beat(beat);
+    ramp_source source;
+
+    engine.arm(loop_command::record, quantize::immediate);
+    run_until(engine, source, 10);
+    engine.arm(loop_command::play, quantize::beat);
+    run_until(engine, source, beat);
+    engine.arm(loop_command::stop, quantize::beat);
+    auto played = run_until(engine, source, 3 * beat);
+    EXPECT_EQ(engine.state(), loop_state::idle);
+    EXPECT_EQ(engine.length(), beat);
+    for (std::size_t i = beat; i < played.size(); ++i) {
+        ASSERT_EQ(played[i], 0);
+    }
+}
+
+TEST(LoopEngine, OverdubFeedbackFadesOldLoop)
+{
+    engine_t engine(sample_rate);
+    engine.set_samples_per_beat(4);
+    engine.set_feedback(0.5f);
+
+    std::vector<int16_t> in = { 1000, -1000, 2000, -2000 };
+    std::vector<int16_t> silence(4, 0);
+    std::vector<int16_t> out(4);
+    engine.arm(loop_command::record, quantize::immediate);
+    engine.process(in.data(), out.data(), 4);
+    engine.arm(loop_command::overdub, quantize::beat);
+    engine.process(silence.data(), out.data(), 4);
+    engine.process(silence.data(), out.data(), 4);
+
+    std::vector<int16_t> expected = { 500, -500, 1000, -1000 };
+    EXPECT_EQ(out, expected);
+}
@@ -0,0 +1,378 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <quantized_looper/Audio/transport.hpp>
+#include <quantized_looper/Software/midi_clock.hpp>
+#include <quantized_looper/Software/tempo_pll.hpp>
+
+namespace {
+
+constexpr uint32_t min_beat = 60000;
+constexpr uint32_t max_beat = 3000000;
+
+// Arrival times of clock bytes as seen over different links, for a sender
+// whose own clock is perfect. The jitter figures are typical of each link.
+enum class midi_link
+{
+    // DIN: mostly on time, sometimes queued behind a three-byte message
+    din,
+    // USB-MIDI: delivered on 1 ms frames, plus host scheduling delay
+    usb,
+    // A DAW clocking from its audio callback: bunched onto 256-sample
+    // buffers at 44.1 kHz
+    daw
+};
+
+std::vector<uint32_t> stream(midi_link kind,
+                             double beat_us,
+                             std::size_t pulses,
+                             unsigned seed,
+                             uint32_t start = 1000)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const double pulse = beat_us / midi_ppqn;
+    std::vector<uint32_t> t(pulses);
+    double previous = 0.0;
+    for (std::size_t i = 0; i < pulses; ++i) {
+        double ideal = i * pulse;
+        double arrival = ideal;
+        switch (kind) {
+            case midi_link::din:
+                arrival += unit(rng) < 0.2 ? 960.0 * unit(rng) : 0.0;
+                break;
+            case midi_link::usb:
+                arrival = std::ceil((ideal + 400.0 * unit(rng)) / 1000.0) *
+                          1000.0;
+                break;
+            case midi_link::daw:
+                arrival = std::ceil(ideal / 5805.0) * 5805.0 + 50.0 * unit(rng);
+                break;
+        }
+        // Bytes on one link never overtake each other
+        previous = std::max(arrival, previous);
+        t[i] = start + static_cast<uint32_t>(previous);
+    }
+    return t;
+}
+
+struct errors
+{
+    double fitted; // Worst beat period error of the PLL, relative
+    double naive;  // Worst error of 24 times the last interval
+};
+
+// Errors after the first `settle` beats
+errors measure(const std::vector<uint32_t>& t,
+               double beat_us,
+               std::size_t settle)
+{
+    midi_clock_in in(min_beat, max_beat);
+    errors e{ 0.0, 0.0 };
+    for (std::size_t i = 0; i < t.size(); ++i) {
+        in.receive(0xF8, t[i]);
+        if (i < settle * midi_ppqn) {
+            continue;
+        }
+        double fitted = in.period_q8() / 256.0;
+        double naive = 24.0 * (t[i] - t[i - 1]);
+        e.fitted = std::max(e.fitted, std::abs(fitted - beat_us) / beat_us);
+        e.naive = std::max(e.naive, std::abs(naive - beat_us) / beat_us);
+    }
+    return e;
+}
+
+using transport_t = transport<int, 4>;
+
+std::vector<uint8_t> poll(midi_clock_out<transport_t>& out,
+                          transport_t& t,
+                          std::size_t samples,
+                          std::size_t block)
+{
+    std::vector<uint8_t> sent;
+    for (std::size_t done = 0; done < samples; done += block) {
+        t.advance(block);
+        out.poll(t.now(), [&](uint8_t b) { sent.push_back(b); });
+    }
+    return sent;
+}
+
+} // namespace
+
+TEST(TempoPll, ExactPulsesGiveExactPeriod)
+{
+    tempo_pll pll(1000, 100000);
+    for (uint32_t i = 0; i < 100; ++i) {
+        pll.pulse(5000 + i * 20833);
+    }
+    EXPECT_EQ(pll.period_us(), 20833u);
+    EXPECT_EQ(pll.period_q16(), int64_t{ 20833 } << 16);
+    EXPECT_TRUE(pll.locked());
+}
+
+TEST(TempoPll, ShiftsToNarrowGearsWhenSteady)
+{
+    tempo_pll pll(1000, 100000);
+    uint32_t t = 0;
+    std::size_t n = 0;
+    for (; pll.stage() < 3 && n < 1000; ++n, t += 20000) {
+        pll.pulse(t);
+    }
+    EXPECT_LE(n, 4 * tempo_pll::shift_pulses + 2);
+}
+
+TEST(TempoPll, MissedPulsesKeepLock)
+{
+    tempo_pll pll(1000, 100000);
+    uint32_t t = 0;
+    for (int i = 0; i < 200; ++i, t += 20000) {
+        if (i != 150 && i != 170 && i != 171) {
+            pll.pulse(t);
+        }
+    }
+    EXPECT_TRUE(pll.locked());
+    EXPECT_EQ(pll.stage(), 3u);
+    EXPECT_EQ(pll.period_us(), 20000u);
+}
+
+TEST(TempoPll, DuplicatePulseIsIgnored)
+{
+    tempo_pll pll(1000, 100000);
+    uint32_t t = 0;
+    for (int i = 0; i < 200; ++i, t += 20000) {
+        pll.pulse(t);
+        if (i == 150) {
+            EXPECT_FALSE(pll.pulse(t + 100));
+        }
+    }
+    EXPECT_EQ(pll.period_us(), 20000u);
+    EXPECT_EQ(pll.stage(), 3u);
+}
+
+TEST(TempoPll, LongGapStartsOver)
+{
+    tempo_pll pll(1000, 100000);
+    uint32_t t = 0;
+    for (int i = 0; i < 100; ++i, t += 20000) {
+        pll.pulse(t);
+    }
+    t += 500000;
+    pll.pulse(t);
+    EXPECT_FALSE(pll.locked());
+    for (int i = 1; i < 60; ++i) {
+        pll.pulse(t + i * 25000);
+    }
+    EXPECT_TRUE(pll.locked());
+    EXPECT_EQ(pll.period_us(), 25000u);
+}
+
+TEST(TempoPll, CounterWrapIsSeamless)
+{
+    tempo_pll pll(1000, 100000);
+    uint32_t t = 0xFFFFFFFFu - 1000000u;
+    for (int i = 0; i < 200; ++i, t += 20000) {
+        pll.pulse(t);
+    }
+    EXPECT_EQ(pll.period_us(), 20000u);
+}
+
+TEST(MidiClockIn, SmoothsJitteryLinks)
+{
+    // 120 BPM, 64 beats, with four beats to settle
+    constexpr double beat = 500000.0;
+    struct
+    {
+        midi_link kind;
+        const char* name;
+        double limit;
+    } links[] = {
+        { midi_link::din, "din", 0.0005 },
+        { midi_link::usb, "usb", 0.0005 },
+        { midi_link::daw, "daw", 0.001 },
+    };
+    for (const auto& l : links) {
+        double worst = 0.0;
+        double naive = 0.0;
+        for (unsigned seed = 0; seed < 20; ++seed) {
+            auto e = measure(stream(l.kind, beat, 64 * 24, seed), beat, 4);
+            worst = std::max(worst, e.fitted);
+            naive = std::max(naive, e.naive);
+        }
+        RecordProperty(std::string(l.name) + "_worst_ppm",
+                       static_cast<int>(worst * 1e6));
+        RecordProperty(std::string(l.name) + "_naive_ppm",
+                       static_cast<int>(naive * 1e6));
+        EXPECT_LT(worst, l.limit) << l.name;
+        EXPECT_LT(worst * 20, naive) << l.name;
+    }
+}
+
+TEST(MidiClockIn, FollowsTempoChange)
+{
+    // 120 to 132 BPM over USB, a step the sender makes between two clocks
+    auto slow = stream(midi_link::usb, 500000.0, 32 * 24, 1);
+    auto fast = stream(midi_link::usb,
+                       500000.0 / 1.1,
+                       32 * 24,
+                       2,
+                       slow.back() + static_cast<uint32_t>(500000.0 / 24));
+    midi_clock_in in(min_beat, max_beat);
+    for (uint32_t t : slow) {
+        in.receive(0xF8, t);
+    }
+    EXPECT_NEAR(in.period_us(), 500000.0, 500.0);
+
+    int beats_to_settle = 0;
+    for (std::size_t i = 0; i < fast.size(); ++i) {
+        in.receive(0xF8, fast[i]);
+        EXPECT_TRUE(in.present(fast[i]));
+        if (std::abs(in.period_us() - 500000.0 / 1.1) > 500000.0 / 1.1 / 200) {
+            beats_to_settle = static_cast<int>(i / 24 + 1);
+        }
+    }
+    RecordProperty("beats_to_settle", beats_to_settle);
+    EXPECT_LE(beats_to_settle, 4);
+}
+
+TEST(MidiClockIn, StartStopAndPresence)
+{
+    midi_clock_in in(min_beat, max_beat);
+    EXPECT_FALSE(in.present(0));
+    // Real-time bytes arrive between the bytes of a note on
+    std::vector<uint8_t> bytes = { 0x90, 0xF8, 0x3C, 0xFA, 0x64 };
+    uint32_t t = 0;
+    for (int i = 0; i < 96; ++i, t += 20833) {
+        for (uint8_t b : bytes) {
+            in.receive(b, t);
+        }
+        bytes = { 0xF8 };
+    }
+    EXPECT_TRUE(in.running());
+    EXPECT_EQ(in.pulses(), 95u);
+    EXPECT_TRUE(in.present(t));
+    EXPECT_EQ(in.period_us(), 499992u);
+
+    in.receive(0xFC, t);
+    EXPECT_FALSE(in.running());
+    in.receive(0xF8, t);
+    EXPECT_EQ(in.pulses(), 95u);
+    in.receive(0xFB, t);
+    EXPECT_TRUE(in.running());
+
+    // No clock for a while: the looper goes back to its own tempo
+    EXPECT_FALSE(in.present(t + 300000));
+}
+
+TEST(TempoHold, StepPastTheThresholdIsTakenAtOnce)
+{
+    tempo_hold hold(2000, 4);
+    EXPECT_TRUE(hold.update(500000));
+    EXPECT_EQ(hold.period_us(), 500000u);
+    EXPECT_FALSE(hold.update(500999));
+    EXPECT_TRUE(hold.update(501001));
+    EXPECT_EQ(hold.period_us(), 501001u);
+
+    hold.release();
+    EXPECT_EQ(hold.period_us(), 0u);
+    EXPECT_TRUE(hold.update(400000));
+}
+
+TEST(TempoHold, SmallOffsetIsTakenOnceItLasts)
+{
+    tempo_hold hold(2000, 4);
+    hold.update(500000);
+    // Wandering around the held period is ignored however long it goes on
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_FALSE(hold.update(i % 2 ? 500300 : 499700));
+    }
+    EXPECT_FALSE(hold.update(500200));
+    EXPECT_FALSE(hold.update(500300));
+    EXPECT_FALSE(hold.update(500000));
+    EXPECT_FALSE(hold.update(500200));
+    EXPECT_FALSE(hold.update(500300));
+    EXPECT_FALSE(hold.update(500200));
+    EXPECT_TRUE(hold.update(500250));
+    EXPECT_EQ(hold.period_us(), 500250u);
+}
+
+TEST(TempoHold, LockedClockRetimesRarely)
+{
+    // 120 BPM from a DAW, 64 beats, held for two seconds of updates. The
+    // clock counts as locked from the first gear shift, and the loops may
+    // follow its last swings for a few beats after that
+    constexpr double beat = 500000.0;
+    constexpr std::size_t settle = 4 * midi_ppqn;
+    for (unsigned seed = 0; seed < 20; ++seed) {
+        auto t = stream(midi_link::daw, beat, 64 * 24, seed);
+        midi_clock_in in(min_beat, max_beat);
+        tempo_hold hold(2000, 96);
+        int changes = 0;
+        for (std::size_t i = 0; i < t.size(); ++i) {
+            in.receive(0xF8, t[i]);
+            if (in.present(t[i]) && hold.update(in.period_us())) {
+                changes += i >= settle;
+            }
+        }
+        EXPECT_NEAR(hold.period_us(), beat, beat * 0.001) << seed;
+        EXPECT_LE(changes, 2) << seed;
+    }
+}
+
+TEST(MidiClockOut, TwentyFourClocksPerBeat)
+{
+    transport_t t(48000);
+    t.set_samples_per_beat(24000);
+    midi_clock_out<transport_t> out;
+    out.poll(t.now(), [](uint8_t) { FAIL(); });
+
+    auto sent = poll(out, t, 24000 * 4, 32);
+    EXPECT_EQ(std::count(sent.begin(), sent.end(), 0xF8), 4 * 24);
+    EXPECT_EQ(sent.size(), 4u * 24u);
+}
+
+TEST(MidiClockOut, ClocksFollowTempoChangeWithoutBurst)
+{
+    transport_t t(48000);
+    t.set_samples_per_beat(24000);
+    midi_clock_out<transport_t> out;
+    out.poll(t.now(), [](uint8_t) {});
+    poll(out, t, 36000, 32);
+    t.set_samples_per_beat(12000);
+
+    // Half a slow beat was sent; the rest of that beat and three more go
+    // at the new tempo, one clock per poll at most
+    std::vector<uint8_t> sent;
+    for (std::size_t done = 0; done < 6000 + 3 * 12000; done += 32) {
+        t.advance(32);
+        std::size_t before = sent.size();
+        out.poll(t.now(), [&](uint8_t b) { sent.push_back(b); });
+        EXPECT_LE(sent.size() - before, 1u);
+    }
+    EXPECT_EQ(sent.size(), 12u + 3u * 24u);
+}
+
+TEST(MidiClockOut, StartGoesOutOnTheBeat)
+{
+    transport_t t(48000);
+    t.set_samples_per_beat(2400);
+    midi_clock_out<transport_t> out;
+    out.poll(t.now(), [](uint8_t) {});
+    poll(out, t, 1000, 10);
+    out.start();
+
+    auto sent = poll(out, t, 2400, 10);
+    auto start = std::find(sent.begin(), sent.end(), 0xFA);
+    ASSERT_NE(start, sent.end());
+    // Clocks 11 to 23 of the first beat, then Start and the downbeat clock
+    EXPECT_EQ(start - sent.begin(), 13);
+    EXPECT_EQ(*(start + 1), 0xF8);
+
+    out.stop([&](uint8_t b) { sent.push_back(b); });
+    EXPECT_EQ(sent.back(), 0xFC);
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <quantized_looper/Audio/mix_kernels.hpp>
+
+namespace {
+
+// Odd lengths exercise the scalar tails after the packed loops
+constexpr std::size_t lengths[] = { 0, 1, 2, 3, 5, 32, 63, 257 };
+
+template<typename T>
+std::vector<T> random_samples(std::size_t n, std::mt19937& rng)
+{
+    std::uniform_int_distribution<int64_t> any(std::numeric_limits<T>::min(),
+                                               std::numeric_limits<T>::max());
+    std::uniform_int_distribution<int> pick(0, 9);
+    std::vector<T> v(n);
+    for (auto& x : v) {
+        // Plenty of full-scale values so the saturation paths get hit
+        int p = pick(rng);
+        x = p == 0   ? std::numeric_limits<T>::min()
+            : p == 1 ? std::numeric_limits<T>::max()
+                     : static_cast<T>(any(rng));
+    }
+    return v;
+}
+
+} // namespace
+
+TEST(DspIntrinsics, PackedLanesSaturateIndependently)
+{
+    uint32_t x = dsp::pack(32000, -32000);
+    uint32_t y = dsp::pack(1000, -1000);
+    uint32_t sum = dsp::qadd16(x, y);
+    EXPECT_EQ(dsp::lane0(sum), INT16_MAX);
+    EXPECT_EQ(dsp::lane1(sum), INT16_MIN);
+
+    EXPECT_EQ(dsp::smuad(dsp::pack(3, 5), dsp::pack(7, 11)), 3 * 7 + 5 * 11);
+    EXPECT_EQ(dsp::smuadx(dsp::pack(3, 5), dsp::pack(7, 11)), 3 * 11 + 5 * 7);
+    EXPECT_EQ(dsp::smlad(dsp::pack(-2, 4), dsp::pack(6, -8), 100), 100 - 12 - 32);
+    EXPECT_EQ(dsp::qadd(INT32_MAX, 1), INT32_MAX);
+    EXPECT_EQ(dsp::qadd(INT32_MIN, -1), INT32_MIN);
+    EXPECT_EQ(dsp::smmla(INT32_MIN, INT32_MIN, 0), 1 << 30);
+    EXPECT_EQ(dsp::pkhtb(dsp::pack(1, 2), dsp::pack(3, 4)), dsp::pack(4, 2));
+}
+
+TEST(MixKernels, MixQ15MatchesScalar)
+{
+    std::mt19937 rng(1);
+    for (std::size_t n : lengths) {
+        auto dst = random_samples<int16_t>(n, rng);
+        auto src = random_samples<int16_t>(n, rng);
+        auto expected = dst;
+        mix_q15_scalar(expected.data(), src.data(), n);
+        mix_q15(dst.data(), src.data(), n);
+        EXPECT_EQ(dst, expected) << n;
+    }
+}
+
+TEST(MixKernels, OverdubQ15MatchesScalar)
+{
+    std::mt19937 rng(2);
+    for (int16_t feedback : { 0, 1, 16384, 29000, 32767 }) {
+        for (std::size_t n : lengths) {
+            auto loop = random_samples<int16_t>(n, rng);
+            auto in = random_samples<int16_t>(n, rng);
+            auto expected = loop;
+            overdub_q15_scalar(expected.data(), in.data(), feedback, n);
+            overdub_q15(loop.data(), in.data(), feedback, n);
+            EXPECT_EQ(loop, expected) << n << " " << feedback;
+        }
+    }
+}
+
+TEST(MixKernels, Mix2Q15MatchesScalar)
+{
+    std::mt19937 rng(3);
+    const int16_t gains[][2] = {
+        { 32767, 0 }, { 0, 32767 }, { 23170, 23170 }, { -32767, 32767 }, { 100, -5 }
+    };
+    for (auto& g : gains) {
+        for (std::size_t n : lengths) {
+            auto a = random_samples<int16_t>(n, rng);
+            auto b = random_samples<int16_t>(n, rng);
+            std::vector<int16_t> expected(n);
+            std::vector<int16_t> dst(n);
+            mix2_q15_scalar(expected.data(), a.data(), g[0], b.data(), g[1], n);
+            mix2_q15(dst.data(), a.data(), g[0], b.data(), g[1], n);
+            EXPECT_EQ(dst, expected) << n << " " << g[0] << " " << g[1];
+        }
+    }
+}
+
+TEST(MixKernels, MixQ31MatchesScalar)
+{
+    std::mt19937 rng(4);
+    for (std::size_t n : lengths) {
+        auto dst = random_samples<int32_t>(n, rng);
+        auto src = random_samples<int32_t>(n, rng);
+        auto expected = dst;
+        mix_q31_scalar(expected.data(), src.data(), n);
+        mix_q31(dst.data(), src.data(), n);
+        EXPECT_EQ(dst, expected) << n;
+    }
+}
+
+TEST(MixKernels, OverdubQ31MatchesScalar)
+{
+    std::mt19937 rng(5);
+    for (int32_t feedback : { 0, 1, 1 << 30, 2000000000, INT32_MAX }) {
+        for (std::size_t n : lengths) {
+            auto loop = random_samples<int32_t>(n, rng);
+            auto in = random_samples<int32_t>(n, rng);
+            auto expected = loop;
+            overdub_q31_scalar(expected.data(), in.data(), feedback, n);
+            overdub_q31(loop.data(), in.data(), feedback, n);
+            EXPECT_EQ(loop, expected) << n << " " << feedback;
+        }
+    }
+}
+
+TEST(MixKernels, OverdubQ15FadesAndSaturates)
+{
+    std::vector<int16_t> loop = { 1000, -1000, 32767, -32768 };
+    std::vector<int16_t> in = { 0, 0, 32767, -32768 };
+    overdub_q15(loop.data(), in.data(), 16384, loop.size());
+    std::vector<int16_t> expected = { 500, -500, 32767, -32768 };
+    EXPECT_EQ(loop, expected);
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include <Software/mock_counter.hpp>
+#include <quantized_looper/Software/monotonic_clock.hpp>
+
+namespace {
+
+// The F767 at its top speed of 216 MHz, where the counter wraps every 20 s
+constexpr uint32_t core_hz = 216000000;
+
+template<typename Tag>
+using counter_t = mock_counter<core_hz, Tag>;
+
+template<typename Tag>
+using sim_clock = monotonic_clock<counter_t<Tag>>;
+
+// A task that runs every `period` ticks of Clock, as the scheduler does it:
+// due once now() has reached the next release time
+template<typename Clock>
+struct periodic
+{
+    typename Clock::tick_type period;
+    typename Clock::tick_type next;
+    int runs = 0;
+
+    void poll()
+    {
+        auto now = Clock::now();
+        if (now >= next) {
+            ++runs;
+            next += period;
+        }
+    }
+};
+
+} // namespace
+
+TEST(MonotonicClock, FollowsCounter)
+{
+    struct tag;
+    using clk = sim_clock<tag>;
+    EXPECT_EQ(clk::now(), 0u);
+    counter_t<tag>::advance(1234);
+    EXPECT_EQ(clk::now(), 1234u);
+}
+
+TEST(MonotonicClock, ExtendsPastWrap)
+{
+    struct tag;
+    using clk = sim_clock<tag>;
+    counter_t<tag>::advance(0xFFFFFF00u);
+    EXPECT_EQ(clk::now(), 0xFFFFFF00u);
+    counter_t<tag>::advance(0x200);
+    EXPECT_EQ(clk::now(), 0x100000100u);
+}
+
+TEST(MonotonicClock, StaysExactOverManyWraps)
+{
+    struct tag;
+    using clk = sim_clock<tag>;
+    // An hour of simulated time read every 7 s, against a 20 s wrap
+    const uint64_t step = 7ull * core_hz;
+    uint64_t expected = 0;
+    uint64_t previous = 0;
+    for (int i = 0; i < 3600 / 7; ++i) {
+        counter_t<tag>::advance(step);
+        expected += step;
+        uint64_t now = clk::now();
+        ASSERT_EQ(now, expected);
+        ASSERT_GT(now, previous);
+        previous = now;
+    }
+    EXPECT_GT(previous, uint64_t{ 1 } << 32);
+}
+
+TEST(MonotonicClock, ConvertsUnits)
+{
+    struct tag;
+    using clk = sim_clock<tag>;
+    EXPECT_EQ(clk::microseconds(1), 216u);
+    EXPECT_EQ(clk::milliseconds(20), 20u * 216000u);
+    EXPECT_EQ(clk::to_microseconds(clk::microseconds(333)), 333u);
+
+    // Far past 2^64 / 10^6 ticks, where a plain multiply would overflow
+    uint64_t days = 1000ull * 86400 * core_hz;
+    EXPECT_EQ(clk::to_microseconds(days), 1000ull * 86400 * 1000000);
+}
+
+TEST(MonotonicClock, MicrosecondPeriodsSurviveWrap)
+{
+    struct tag;
+    using clk = sim_clock<tag>;
+    // Start just before the counter wraps; a 333 us task keeps its rate
+    // through it
+    counter_t<tag>::advance(0xFFFFFFFFu - clk::milliseconds(10));
+    periodic<clk> task{ clk::microseconds(333), clk::now() };
+
+    const uint64_t tick = clk::microseconds(10);
+    for (int i = 0; i < 10000; ++i) {
+        counter_t<tag>::advance(tick);
+        task.poll();
+    }
+    // 100 ms at 333 us per run
+    EXPECT_NEAR(task.runs, 100000 / 333, 1);
+}
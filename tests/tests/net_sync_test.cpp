@@ -0,0 +1,257 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <Software/udp_loopback.hpp>
+#include <quantized_looper/Software/net_sync.hpp>
+
+namespace {
+
+constexpr double beat_q24 = static_cast<double>(net_sync::one_beat);
+
+// One looper on the simulated LAN: its own crystal, its own transport, and
+// a real socket. Datagrams are held back for a random network delay, in
+// simulated time, before net_sync sees them.
+struct node
+{
+    node(uint32_t id, double offset_us, double ppm, double bpm, double beat)
+      : sync(id)
+      , offset(offset_us)
+      , rate(1.0 + ppm * 1e-6)
+      , period_ns(60e9 / bpm)
+      , position(beat)
+    {
+    }
+
+    uint64_t local(double true_us) const
+    {
+        return static_cast<uint64_t>(offset + true_us * rate);
+    }
+
+    int64_t position_q24() const
+    {
+        return static_cast<int64_t>(std::llround(position * beat_q24));
+    }
+
+    udp_loopback socket;
+    net_sync sync;
+    double offset;
+    double rate;
+    double period_ns;
+    double position;
+    bool running = true;
+    bool active = true;
+    int jumps = 0;
+    std::multimap<double, std::vector<uint8_t>> inbox;
+};
+
+struct lan
+{
+    explicit lan(unsigned seed)
+      : rng(seed)
+    {
+    }
+
+    node& add(uint32_t id, double offset, double ppm, double bpm, double beat)
+    {
+        auto n = std::make_unique<node>(id, offset, ppm, bpm, beat);
+        for (auto& other : nodes) {
+            other->socket.add_peer(n->socket.port());
+            n->socket.add_peer(other->socket.port());
+        }
+        nodes.push_back(std::move(n));
+        return *nodes.back();
+    }
+
+    // 80-200 us through the switch, and now and then a few ms behind
+    // other traffic
+    double delay()
+    {
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        double d = 80.0 + 120.0 * unit(rng);
+        if (unit(rng) < 0.1) {
+            d += 1000.0 + 2000.0 * unit(rng);
+        }
+        return d;
+    }
+
+    void step()
+    {
+        for (auto& n : nodes) {
+            if (!n->active) {
+                n->socket.poll([](const uint8_t*, std::size_t) {});
+                continue;
+            }
+            node& self = *n;
+            self.socket.poll([&](const uint8_t* data, std::size_t size) {
+                self.inbox.emplace(now + delay(),
+                                   std::vector<uint8_t>(data, data + size));
+            });
+            while (!self.inbox.empty() && self.inbox.begin()->first <= now) {
+                const auto& d = self.inbox.begin()->second;
+                self.sync.receive(d.data(), d.size(), self.local(now));
+                self.inbox.erase(self.inbox.begin());
+            }
+
+            uint64_t t = self.local(now);
+            self.sync.poll(t,
+                           self.position_q24(),
+                           static_cast<uint32_t>(self.period_ns),
+                           self.running,
+                           [&](const uint8_t* data, std::size_t size) {
+                               self.socket.send(data, size);
+                           });
+            if (self.sync.synced(t)) {
+                auto s = self.sync.steer(t, self.position_q24());
+                if (s.jump) {
+                    self.position = s.position / beat_q24;
+                    ++self.jumps;
+                }
+                self.period_ns = s.period_ns;
+            }
+            self.position += dt * self.rate * 1000.0 / self.period_ns;
+        }
+        now += dt;
+    }
+
+    void run(double us)
+    {
+        for (double end = now + us; now < end;) {
+            step();
+        }
+    }
+
+    // Phase error of a node against another, in microseconds at the
+    // leader's tempo
+    double error_us(const node& n, const node& leader) const
+    {
+        return (n.position - leader.position) * leader.period_ns / 1000.0;
+    }
+
+    static constexpr double dt = 100.0;
+    std::mt19937 rng;
+    double now = 0.0;
+    std::vector<std::unique_ptr<node>> nodes;
+};
+
+} // namespace
+
+TEST(NetSync, FollowersLockToLeaderPhase)
+{
+    lan net(1);
+    node& a = net.add(1, 5e6, 40.0, 120.0, 0.0);
+    node& b = net.add(2, 123456789.0, -35.0, 100.0, 7.3);
+    node& c = net.add(3, 42.0, 10.0, 90.0, 2.9);
+
+    // All three come up together, lead, and settle on the lowest id
+    net.run(4e6);
+    EXPECT_TRUE(a.sync.leads());
+    EXPECT_FALSE(b.sync.leads());
+    EXPECT_FALSE(c.sync.leads());
+    EXPECT_NEAR(b.period_ns, a.period_ns, a.period_ns * 0.001);
+
+    double worst = 0.0;
+    for (int i = 0; i < 100000; ++i) {
+        net.step();
+        worst = std::max({ worst,
+                           std::abs(net.error_us(b, a)),
+                           std::abs(net.error_us(c, a)) });
+    }
+    RecordProperty("worst_phase_error_us", static_cast<int>(worst));
+    EXPECT_LT(worst, 250.0);
+    EXPECT_EQ(b.jumps, 1);
+    EXPECT_EQ(c.jumps, 1);
+}
+
+TEST(NetSync, StartStopPropagates)
+{
+    lan net(2);
+    node& a = net.add(1, 0.0, 0.0, 120.0, 0.0);
+    node& b = net.add(2, 777.0, 20.0, 120.0, 0.0);
+    a.running = false;
+    net.run(3e6);
+    EXPECT_FALSE(b.sync.running());
+
+    a.running = true;
+    net.run(200000);
+    EXPECT_TRUE(b.sync.running());
+    // Both start on the same whole beat, after the one playing now
+    int64_t start = b.sync.start_beat();
+    EXPECT_EQ(start % net_sync::one_beat, 0);
+    EXPECT_GT(start, a.position_q24() - net_sync::one_beat);
+    EXPECT_EQ(start, a.sync.start_beat());
+
+    a.running = false;
+    net.run(200000);
+    EXPECT_FALSE(b.sync.running());
+}
+
+TEST(NetSync, LowerIdTakesOverWithoutJump)
+{
+    lan net(3);
+    node& a = net.add(5, 1000.0, 30.0, 128.0, 0.0);
+    net.run(2e6);
+    ASSERT_TRUE(a.sync.leads());
+
+    node& b = net.add(2, 9e6, -30.0, 90.0, 3.4);
+    net.run(4e6);
+    EXPECT_TRUE(b.sync.leads());
+    EXPECT_FALSE(a.sync.leads());
+    EXPECT_EQ(a.jumps, 0);
+    EXPECT_EQ(b.jumps, 1);
+
+    double worst = 0.0;
+    for (int i = 0; i < 20000; ++i) {
+        net.step();
+        worst = std::max(worst, std::abs(net.error_us(a, b)));
+    }
+    EXPECT_LT(worst, 250.0);
+    EXPECT_NEAR(60e9 / a.period_ns, 128.0, 0.2);
+}
+
+TEST(NetSync, LeaderLossKeepsTimeline)
+{
+    lan net(4);
+    node& a = net.add(1, 0.0, 0.0, 120.0, 0.0);
+    node& b = net.add(2, 100.0, 25.0, 120.0, 0.5);
+    node& c = net.add(3, 200.0, -25.0, 120.0, 0.25);
+    net.run(4e6);
+    ASSERT_TRUE(a.sync.leads());
+
+    a.active = false;
+    net.run(3e6);
+    EXPECT_TRUE(b.sync.leads());
+    EXPECT_FALSE(c.sync.leads());
+    EXPECT_EQ(c.jumps, 1);
+
+    double worst = 0.0;
+    for (int i = 0; i < 20000; ++i) {
+        net.step();
+        worst = std::max(worst, std::abs(net.error_us(c, b)));
+    }
+    EXPECT_LT(worst, 250.0);
+}
+
+TEST(NetSync, IgnoresForeignDatagrams)
+{
+    net_sync sync(1);
+    std::vector<uint8_t> junk = { 'Q', 'L', 'S', 'Y', 1, 1, 0, 0, 2, 0 };
+    sync.receive(junk.data(), junk.size(), 0);
+    std::vector<uint8_t> other(40, 0xAB);
+    sync.receive(other.data(), other.size(), 0);
+    EXPECT_FALSE(sync.synced(0));
+
+    // With nothing heard, it leads once the timeout passes
+    int sent = 0;
+    auto count = [&](const uint8_t*, std::size_t) { ++sent; };
+    sync.poll(0, 0, 500000000, true, count);
+    EXPECT_FALSE(sync.leads());
+    sync.poll(1000000, 0, 500000000, true, count);
+    EXPECT_TRUE(sync.leads());
+    EXPECT_EQ(sent, 1);
+}
@@ -0,0 +1,252 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <quantized_looper/Audio/audio_graph.hpp>
+#include <quantized_looper/Audio/onset_tempo.hpp>
+
+namespace {
+
+constexpr uint32_t sample_rate = 48000;
+constexpr double pi = 3.14159265358979323846;
+
+// A drum pattern on a sixteenth-note grid, one character per step: 'k'
+// kick, 's' snare, 'h' closed hat, 'o' open hat, 'x' kick and hat
+struct pattern
+{
+    double bpm;
+    std::string steps; // one bar of sixteenths
+    double swing;      // fraction of a sixteenth the off-beat ones lag
+};
+
+void add_kick(std::vector<float>& x, std::size_t at, std::mt19937&)
+{
+    double phase = 0.0;
+    for (std::size_t i = 0; at + i < x.size() && i < 12000; ++i) {
+        double t = static_cast<double>(i) / sample_rate;
+        double f = 50.0 + 100.0 * std::exp(-t / 0.03);
+        phase += 2.0 * pi * f / sample_rate;
+        x[at + i] += static_cast<float>(0.8 * std::sin(phase) *
+                                        std::exp(-t / 0.12));
+    }
+}
+
+void add_noise(std::vector<float>& x,
+               std::size_t at,
+               std::mt19937& rng,
+               double level,
+               double decay,
+               bool bright)
+{
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    float last = 0.0f;
+    for (std::size_t i = 0; at + i < x.size() && i < 20000; ++i) {
+        double t = static_cast<double>(i) / sample_rate;
+        float n = unit(rng);
+        // A first difference tilts the noise up to a hat's hiss
+        float v = bright ? n - last : n;
+        last = n;
+        x[at + i] += static_cast<float>(level * v * std::exp(-t / decay));
+    }
+}
+
+void add_snare(std::vector<float>& x, std::size_t at, std::mt19937& rng)
+{
+    add_noise(x, at, rng, 0.4, 0.08, false);
+    for (std::size_t i = 0; at + i < x.size() && i < 8000; ++i) {
+        double t = static_cast<double>(i) / sample_rate;
+        x[at + i] += static_cast<float>(0.3 * std::sin(2.0 * pi * 190.0 * t) *
+                                        std::exp(-t / 0.05));
+    }
+}
+
+// `bars` bars of the pattern over a bed of quiet noise, the length a loop
+// recorded in time would have
+std::vector<float> render(const pattern& p, std::size_t bars, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    const double beat = 60.0 * sample_rate / p.bpm;
+    const double step = beat / 4.0;
+    const auto length = static_cast<std::size_t>(std::lround(bars * 4 * beat));
+    std::vector<float> loop(length, 0.0f);
+
+    std::normal_distribution<float> bed(0.0f, 0.01f);
+    for (auto& v : loop) {
+        v = bed(rng);
+    }
+    for (std::size_t bar = 0; bar < bars; ++bar) {
+        for (std::size_t s = 0; s < p.steps.size(); ++s) {
+            double at = (bar * 16 + s) * step;
+            if (s % 2 == 1) {
+                at += p.swing * step;
+            }
+            auto i = static_cast<std::size_t>(at);
+            switch (p.steps[s]) {
+                case 'k':
+                    add_kick(loop, i, rng);
+                    break;
+                case 's':
+                    add_snare(loop, i, rng);
+                    break;
+                case 'h':
+                    add_noise(loop, i, rng, 0.15, 0.02, true);
+                    break;
+                case 'o':
+                    add_noise(loop, i, rng, 0.15, 0.12, true);
+                    break;
+                case 'x':
+                    add_kick(loop, i, rng);
+                    add_noise(loop, i, rng, 0.15, 0.02, true);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    return loop;
+}
+
+// Feed a loop the way the audio callback would, one block at a time
+template<typename Detector>
+void listen(Detector& detector, const std::vector<float>& audio)
+{
+    constexpr std::size_t block = 32;
+    for (std::size_t i = 0; i < audio.size(); i += block) {
+        detector.feed(audio.data() + i, std::min(block, audio.size() - i));
+    }
+}
+
+double bpm_of(uint32_t samples_per_beat)
+{
+    return 60.0 * sample_rate / samples_per_beat;
+}
+
+const pattern rock{ 120.0, "x-h-s-h-x-x-s-h-", 0.0 };
+const pattern hip_hop{ 90.0, "k-h-s-hkh-k-s-h-", 0.33 };
+const pattern house{ 128.0, "k-o-x-o-k-o-x-o-", 0.0 };
+const pattern syncopated{ 100.0, "k-hk-hs-h-kh-hsk", 0.0 };
+
+} // namespace
+
+TEST(OnsetTempo, CorrelateMatchesDirectSum)
+{
+    std::vector<float> a = { 1, 2, 3, 4, 5, 6 };
+    std::vector<float> b = { 1, -1, 2 };
+    std::vector<float> dst(2 * a.size() - 1, 0.0f);
+    correlate_f32(a.data(), a.size(), b.data(), b.size(), dst.data());
+
+    const auto m = static_cast<int>(a.size());
+    const auto n = static_cast<int>(b.size());
+    for (int lag = -(n - 1); lag < m; ++lag) {
+        float sum = 0.0f;
+        for (int j = 0; j < m; ++j) {
+            if (j - lag >= 0 && j - lag < n) {
+                sum += a[j] * b[j - lag];
+            }
+        }
+        EXPECT_FLOAT_EQ(dst[m - 1 + lag], sum) << "lag " << lag;
+    }
+}
+
+TEST(OnsetTempo, CorrelateKeepsTheCmsisLayout)
+{
+    // Worked by hand from arm_correlate_f32.c; the first two are skipped
+    std::vector<float> a = { 1, 2, 3, 4 };
+    std::vector<float> b = { 1, 10 };
+    std::vector<float> dst(2 * a.size() - 1, -1.0f);
+    correlate_f32(a.data(), a.size(), b.data(), b.size(), dst.data());
+    std::vector<float> expected = { -1, -1, 10, 21, 32, 43, 4 };
+    EXPECT_EQ(dst, expected);
+}
+
+TEST(OnsetTempo, RockLoop)
+{
+    std::vector<float> loop = render(rock, 4, 1);
+    onset_tempo<> detector(sample_rate);
+    listen(detector, loop);
+    EXPECT_NEAR(bpm_of(detector.samples_per_beat(loop.size())),
+                120.0,
+                1.2);
+    EXPECT_NEAR(bpm_of(detector.samples_per_beat()), 120.0, 2.4);
+}
+
+TEST(OnsetTempo, SwungHipHopLoop)
+{
+    std::vector<float> loop = render(hip_hop, 2, 2);
+    onset_tempo<> detector(sample_rate);
+    listen(detector, loop);
+    EXPECT_NEAR(bpm_of(detector.samples_per_beat(loop.size())),
+                90.0,
+                0.9);
+    EXPECT_NEAR(bpm_of(detector.samples_per_beat()), 90.0, 1.8);
+}
+
+TEST(OnsetTempo, HouseLoop)
+{
+    std::vector<float> loop = render(house, 4, 3);
+    onset_tempo<> detector(sample_rate);
+    listen(detector, loop);
+    EXPECT_NEAR(bpm_of(detector.samples_per_beat(loop.size())),
+                128.0,
+                1.3);
+    EXPECT_NEAR(bpm_of(detector.samples_per_beat()), 128.0, 2.6);
+}
+
+TEST(OnsetTempo, SyncopatedLoopNeedsItsLength)
+{
+    std::vector<float> loop = render(syncopated, 2, 4);
+    onset_tempo<> detector(sample_rate);
+    listen(detector, loop);
+    EXPECT_NEAR(bpm_of(detector.samples_per_beat(loop.size())),
+                100.0,
+                1.0);
+}
+
+TEST(OnsetTempo, SilenceHasNoTempo)
+{
+    onset_tempo<> detector(sample_rate);
+    std::vector<float> silence(sample_rate * 2, 0.0f);
+    listen(detector, silence);
+    EXPECT_EQ(detector.samples_per_beat(), 0u);
+    EXPECT_EQ(detector.samples_per_beat(silence.size()), 0u);
+}
+
+TEST(OnsetTempo, ResetForgetsTheLastTake)
+{
+    onset_tempo<> detector(sample_rate);
+    listen(detector, render(house, 4, 5));
+    detector.reset();
+    EXPECT_EQ(detector.onsets(), 0u);
+
+    std::vector<float> loop = render(hip_hop, 2, 6);
+    listen(detector, loop);
+    EXPECT_NEAR(bpm_of(detector.samples_per_beat(loop.size())),
+                90.0,
+                0.9);
+}
+
+TEST(OnsetTempo, NodeFeedsOnlyWhileListening)
+{
+    using block_t = audio_block<int16_t, 32, 2>;
+    onset_tempo<> detector(sample_rate);
+    audio_graph<block_t, onset_node<onset_tempo<>>> graph{
+        onset_node<onset_tempo<>>(detector)
+    };
+    block_t block;
+    for (int i = 0; i < 16; ++i) {
+        graph.process(block);
+    }
+    EXPECT_EQ(detector.onsets(), 0u);
+
+    graph.node<0>().listen(true);
+    for (int i = 0; i < 24; ++i) {
+        graph.process(block);
+    }
+    // 768 samples: one full frame, then a hop
+    EXPECT_EQ(detector.onsets(), 2u);
+}
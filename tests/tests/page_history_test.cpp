@@ -0,0 +1,309 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include <quantized_looper/Audio/page_history.hpp>
+#include <quantized_looper/Audio/track_bank.hpp>
+
+namespace {
+
+// Two tracks of 64 samples in 8-sample pages, with room for 8 pages
+using history_t = page_history<int16_t, 2, 64, 8, 8, 4>;
+
+std::vector<int16_t> ramp()
+{
+    std::vector<int16_t> x(64);
+    std::iota(x.begin(), x.end(), 0);
+    return x;
+}
+
+// Write `value` over [first, first + n) as layer content
+void write(history_t& history,
+           std::size_t track,
+           std::vector<int16_t>& loop,
+           std::size_t first,
+           std::size_t n,
+           int16_t value)
+{
+    history.save(track, loop.data(), first, n);
+    std::fill_n(loop.begin() + first, n, value);
+}
+
+constexpr uint32_t sample_rate = 48000;
+constexpr uint32_t beat = 600;
+
+using bank_t =
+  track_bank<int16_t, 2, 4800, 0, polyphase_resampler<int16_t>, 8>;
+
+using faded_bank_t =
+  track_bank<int16_t, 1, 4800, 32, polyphase_resampler<int16_t>, 8>;
+
+template<typename Bank>
+std::vector<int16_t> run(Bank& bank, int16_t level, std::size_t n)
+{
+    std::vector<int16_t> in(n, level);
+    std::vector<int16_t> out(n);
+    bank.process(in.data(), out.data(), n);
+    return out;
+}
+
+template<typename Bank>
+void command(Bank& bank, std::size_t track, loop_command c)
+{
+    bank.arm(track, c, quantize::immediate);
+    run(bank, 0, 0);
+}
+
+} // namespace
+
+TEST(PageHistory, CopiesOnlyTouchedPages)
+{
+    history_t history;
+    auto loop = ramp();
+    history.begin(0);
+    write(history, 0, loop, 6, 4, 100);
+    EXPECT_EQ(history.free_pages(), 6u);
+
+    // Writing the same pages again copies nothing more
+    write(history, 0, loop, 4, 10, 200);
+    EXPECT_EQ(history.free_pages(), 6u);
+}
+
+TEST(PageHistory, UndoAndRedoSwapLayers)
+{
+    history_t history;
+    auto loop = ramp();
+    const auto original = loop;
+
+    history.begin(0);
+    write(history, 0, loop, 0, 8, 100);
+    const auto first = loop;
+    history.begin(0);
+    write(history, 0, loop, 4, 16, 200);
+    const auto second = loop;
+    EXPECT_EQ(history.undo_levels(0), 2u);
+
+    EXPECT_TRUE(history.undo(0, loop.data()));
+    EXPECT_EQ(loop, first);
+    EXPECT_TRUE(history.undo(0, loop.data()));
+    EXPECT_EQ(loop, original);
+    EXPECT_FALSE(history.undo(0, loop.data()));
+
+    EXPECT_TRUE(history.redo(0, loop.data()));
+    EXPECT_EQ(loop, first);
+    EXPECT_TRUE(history.redo(0, loop.data()));
+    EXPECT_EQ(loop, second);
+    EXPECT_FALSE(history.redo(0, loop.data()));
+}
+
+TEST(PageHistory, NewLayerDropsRedo)
+{
+    history_t history;
+    auto loop = ramp();
+    history.begin(0);
+    write(history, 0, loop, 0, 8, 100);
+    history.undo(0, loop.data());
+    EXPECT_EQ(history.redo_levels(0), 1u);
+
+    history.begin(0);
+    EXPECT_EQ(history.redo_levels(0), 0u);
+    EXPECT_EQ(history.free_pages(), 8u);
+}
+
+TEST(PageHistory, TracksAreIndependent)
+{
+    history_t history;
+    auto a = ramp();
+    auto b = ramp();
+    const auto original = ramp();
+
+    history.begin(0);
+    write(history, 0, a, 0, 8, 100);
+    history.begin(1);
+    write(history, 1, b, 0, 8, 200);
+
+    EXPECT_TRUE(history.undo(0, a.data()));
+    EXPECT_EQ(a, original);
+    EXPECT_EQ(b[0], 200);
+    EXPECT_EQ(history.undo_levels(1), 1u);
+}
+
+TEST(PageHistory, FullPoolDropsOldestLayer)
+{
+    history_t history;
+    auto loop = ramp();
+    history.begin(0);
+    write(history, 0, loop, 0, 32, 100);
+    const auto first = loop;
+    history.begin(0);
+    write(history, 0, loop, 32, 32, 200);
+    EXPECT_EQ(history.free_pages(), 0u);
+
+    // A third layer needs pages, so the first layer goes
+    history.begin(0);
+    write(history, 0, loop, 0, 8, 300);
+    EXPECT_EQ(history.undo_levels(0), 2u);
+    history.undo(0, loop.data());
+    history.undo(0, loop.data());
+    EXPECT_EQ(loop, first);
+}
+
+TEST(PageHistory, LayerLargerThanPoolIsRefused)
+{
+    page_history<int16_t, 1, 64, 4, 8, 4> history;
+    std::vector<int16_t> loop(64);
+    EXPECT_TRUE(history.begin(0, 8));
+    history.save(0, loop.data(), 0, 8);
+
+    // Eight pages could never fit in four, so the earlier layer stays
+    EXPECT_FALSE(history.begin(0, 64));
+    history.save(0, loop.data(), 0, 64);
+    EXPECT_EQ(history.undo_levels(0), 1u);
+    EXPECT_EQ(history.free_pages(), 3u);
+}
+
+TEST(PageHistory, LayerThatRunsOutOfPagesIsDropped)
+{
+    page_history<int16_t, 2, 64, 4, 8, 4> history;
+    std::vector<int16_t> loop(64);
+    history.begin(1);
+    history.save(1, loop.data(), 0, 8);
+
+    // A layer that writes past what it said at begin takes the other
+    // track's layer to make room, then gives up on its own
+    EXPECT_TRUE(history.begin(0, 32));
+    history.save(0, loop.data(), 0, 40);
+    EXPECT_EQ(history.undo_levels(0), 0u);
+    EXPECT_EQ(history.free_pages(), 4u);
+    EXPECT_FALSE(history.undo(0, loop.data()));
+}
+
+TEST(PageHistory, LayerCountIsBounded)
+{
+    history_t history;
+    auto loop = ramp();
+    for (int16_t i = 0; i < 6; ++i) {
+        history.begin(0);
+        write(history, 0, loop, 0, 1, i);
+    }
+    EXPECT_EQ(history.undo_levels(0), 4u);
+    EXPECT_EQ(history.free_pages(), 4u);
+}
+
+TEST(TrackBankUndo, UndoRemovesLastOverdub)
+{
+    bank_t bank(sample_rate);
+    bank.set_samples_per_beat(beat);
+    command(bank, 0, loop_command::record);
+    run(bank, 1000, beat);
+    command(bank, 0, loop_command::play);
+
+    // Overdub the first half of the loop only
+    command(bank, 0, loop_command::overdub);
+    run(bank, 500, beat / 2);
+    command(bank, 0, loop_command::play);
+    run(bank, 0, beat / 2);
+    EXPECT_EQ(run(bank, 0, 1)[0], 1500);
+    EXPECT_EQ(bank.undo_levels(0), 1u);
+
+    command(bank, 0, loop_command::undo);
+    EXPECT_EQ(bank.undo_levels(0), 0u);
+    EXPECT_EQ(bank.redo_levels(0), 1u);
+    for (std::size_t i = 0; i < beat; ++i) {
+        ASSERT_EQ(bank.data(0)[i], 1000) << i;
+    }
+
+    command(bank, 0, loop_command::redo);
+    EXPECT_EQ(bank.data(0)[0], 1500);
+    EXPECT_EQ(bank.data(0)[beat - 1], 1000);
+}
+
+TEST(TrackBankUndo, UndoDuringOverdubEndsIt)
+{
+    bank_t bank(sample_rate);
+    bank.set_samples_per_beat(beat);
+    command(bank, 0, loop_command::record);
+    run(bank, 1000, beat);
+    command(bank, 0, loop_command::overdub);
+    run(bank, 500, beat / 3);
+
+    command(bank, 0, loop_command::undo);
+    EXPECT_EQ(bank.state(0), loop_state::playing);
+    run(bank, 500, beat);
+    for (std::size_t i = 0; i < beat; ++i) {
+        ASSERT_EQ(bank.data(0)[i], 1000) << i;
+    }
+}
+
+TEST(TrackBankUndo, RecordingClearsHistory)
+{
+    bank_t bank(sample_rate);
+    bank.set_samples_per_beat(beat);
+    command(bank, 0, loop_command::record);
+    run(bank, 1000, beat);
+    command(bank, 0, loop_command::overdub);
+    run(bank, 500, beat);
+    command(bank, 0, loop_command::play);
+    EXPECT_EQ(bank.undo_levels(0), 1u);
+
+    command(bank, 0, loop_command::record);
+    EXPECT_EQ(bank.undo_levels(0), 0u);
+}
+
+TEST(TrackBankUndo, OverdubLongerThanThePoolKeepsHistory)
+{
+    // 4800-sample tracks are ten pages, the pool eight
+    static_assert(bank_t::undo_frames == 8 * 512);
+    bank_t bank(sample_rate);
+    bank.set_samples_per_beat(beat);
+    command(bank, 0, loop_command::record);
+    run(bank, 1000, beat);
+    command(bank, 0, loop_command::overdub);
+    run(bank, 500, beat);
+    command(bank, 0, loop_command::play);
+    EXPECT_EQ(bank.undo_levels(0), 1u);
+
+    // Eight times the first loop fills track 1
+    bank.set_length_multiplier(1, 8);
+    command(bank, 1, loop_command::record);
+    run(bank, 0, 8 * beat);
+    EXPECT_EQ(bank.length(1), 8 * beat);
+    command(bank, 1, loop_command::overdub);
+    run(bank, 100, 8 * beat);
+    command(bank, 1, loop_command::play);
+    EXPECT_EQ(bank.undo_levels(1), 0u);
+
+    // Track 0 still undoes its own overdub
+    EXPECT_EQ(bank.undo_levels(0), 1u);
+    command(bank, 0, loop_command::undo);
+    for (std::size_t i = 0; i < beat; ++i) {
+        ASSERT_EQ(bank.data(0)[i], 1000) << i;
+    }
+}
+
+TEST(TrackBankUndo, UndoKeepsTheLoopWrapFade)
+{
+    // The same performance with and without an overdub straight out of the
+    // recording; undoing the overdub leaves the loop the other one has
+    faded_bank_t played(sample_rate);
+    faded_bank_t overdubbed(sample_rate);
+    for (auto* bank : { &played, &overdubbed }) {
+        bank->set_samples_per_beat(beat);
+        command(*bank, 0, loop_command::record);
+        run(*bank, 1000, beat);
+    }
+    command(played, 0, loop_command::play);
+    command(overdubbed, 0, loop_command::overdub);
+    run(played, -2000, beat / 2);
+    run(overdubbed, -2000, beat / 2);
+    command(overdubbed, 0, loop_command::play);
+    run(overdubbed, 0, beat / 4);
+
+    command(overdubbed, 0, loop_command::undo);
+    for (std::size_t i = 0; i < beat; ++i) {
+        ASSERT_EQ(overdubbed.data(0)[i], played.data(0)[i]) << i;
+    }
+    EXPECT_NE(played.data(0)[0], 1000);
+}
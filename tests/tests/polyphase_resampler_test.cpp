@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <quantized_looper/Audio/polyphase_resampler.hpp>
+#include <quantized_looper/Audio/track_bank.hpp>
+
+namespace {
+
+using resampler_t = polyphase_resampler<int16_t>;
+
+constexpr double sample_rate = 48000;
+
+// 1 kHz at half scale; 4800 samples hold exactly 100 cycles, so the loop
+// wraps without a seam
+constexpr std::size_t loop_length = 4800;
+constexpr double tone_hz = 1000;
+
+std::vector<int16_t> tone_loop()
+{
+    std::vector<int16_t> x(loop_length);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        x[i] = static_cast<int16_t>(
+          std::lround(16384 * std::sin(2 * M_PI * tone_hz * i / sample_rate)));
+    }
+    return x;
+}
+
+// RMS difference from the ideal tone at the positions the resampler read
+double error_rms(const std::vector<int16_t>& out, double step)
+{
+    double sum = 0;
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        double pos = std::fmod(i * step, static_cast<double>(loop_length));
+        double ideal = 16384 * std::sin(2 * M_PI * tone_hz * pos / sample_rate);
+        sum += (out[i] - ideal) * (out[i] - ideal);
+    }
+    return std::sqrt(sum / out.size());
+}
+
+} // namespace
+
+TEST(PolyphaseResampler, EveryPhaseHasUnityDcGain)
+{
+    for (double ratio : { 0.9, 1.1, 1.4, 1.9 }) {
+        auto step = static_cast<resample_pos>(ratio * resample_one);
+        const auto& table = resampler_t::table_for(step);
+        for (const auto& phase : table) {
+            int32_t sum = 0;
+            for (int16_t h : phase) {
+                sum += h;
+            }
+            ASSERT_NEAR(sum, 32768, 8) << ratio;
+        }
+    }
+}
+
+TEST(PolyphaseResampler, StepFromTempo)
+{
+    EXPECT_EQ(resample_step(100, 100), resample_one);
+    EXPECT_EQ(resample_step(100, 200), resample_one / 2);
+    EXPECT_EQ(resample_step(150, 100), resample_one + resample_one / 2);
+}
+
+TEST(PolyphaseResampler, TracksIdealToneAtAnyRatio)
+{
+    auto loop = tone_loop();
+    for (double ratio : { 0.7, 0.93, 1.0, 1.07, 1.25, 1.6 }) {
+        resample_pos step = static_cast<resample_pos>(ratio * resample_one);
+        std::vector<int16_t> out(3 * loop_length);
+        resampler_t::process(
+          loop.data(), loop.size(), 0, step, out.data(), out.size());
+        // About -60 dB below the tone, through every wrap
+        EXPECT_LT(error_rms(out, static_cast<double>(step) / resample_one), 16)
+          << ratio;
+    }
+}
+
+TEST(PolyphaseResampler, PositionContinuesAcrossCalls)
+{
+    auto loop = tone_loop();
+    const resample_pos step = resample_step(41, 37);
+    std::vector<int16_t> whole(1000);
+    std::vector<int16_t> pieces(1000);
+    resample_pos end = resampler_t::process(
+      loop.data(), loop.size(), 0, step, whole.data(), whole.size());
+
+    resample_pos pos = 0;
+    for (std::size_t i = 0; i < pieces.size(); i += 100) {
+        pos = resampler_t::process(
+          loop.data(), loop.size(), pos, step, &pieces[i], 100);
+    }
+    EXPECT_EQ(pieces, whole);
+    EXPECT_EQ(pos, end);
+}
+
+TEST(PolyphaseResampler, PositionWrapsAtLoopEnd)
+{
+    std::vector<int16_t> loop(100, 1000);
+    std::vector<int16_t> out(150);
+    resample_pos pos = resampler_t::process(
+      loop.data(), loop.size(), 0, resample_one, out.data(), out.size());
+    EXPECT_EQ(pos, resample_pos{ 50 } << 32);
+    for (int16_t x : out) {
+        ASSERT_NEAR(x, 1000, 1);
+    }
+}
+
+TEST(PolyphaseResampler, RoundsToTheNearestPhase)
+{
+    auto loop = tone_loop();
+    constexpr resample_pos phase = resample_one / resampler_t::phases;
+    auto at = [&](resample_pos pos) {
+        int16_t out = 0;
+        resampler_t::process(loop.data(), loop.size(), pos, 0, &out, 1);
+        return out;
+    };
+
+    // Three quarters of the way to phase 6 uses phase 6
+    const resample_pos base = (resample_pos{ 10 } << 32) + 5 * phase;
+    EXPECT_EQ(at(base + 3 * phase / 4), at(base + phase));
+    EXPECT_EQ(at(base + phase / 4), at(base));
+    // Past the last phase of a sample is the next sample, also at the wrap
+    const resample_pos last = (resample_pos{ 11 } << 32) - phase / 4;
+    EXPECT_EQ(at(last), at(resample_pos{ 11 } << 32));
+    const resample_pos end = (resample_pos{ loop_length } << 32) - 1;
+    EXPECT_EQ(at(end), at(0));
+}
+
+TEST(PolyphaseResampler, EmptyLoopPlaysSilence)
+{
+    std::vector<int16_t> out(8, 1234);
+    resample_pos pos = resampler_t::process(
+      nullptr, 0, 0, resample_one, out.data(), out.size());
+    EXPECT_EQ(pos, 0u);
+    EXPECT_EQ(out, std::vector<int16_t>(8, 0));
+}
+
+TEST(TrackBankTempo, LoopsKeepTheirLengthInBeats)
+{
+    track_bank<int16_t, 2, loop_length> bank(48000);
+    bank.set_samples_per_beat(1200);
+    auto loop = tone_loop();
+    std::vector<int16_t> out(loop_length);
+    bank.arm(0, loop_command::record, quantize::immediate);
+    bank.process(loop.data(), out.data(), loop_length);
+    bank.arm(0, loop_command::play, quantize::immediate);
+    bank.process(loop.data(), out.data(), loop_length / 4);
+    ASSERT_EQ(bank.duration(0), loop_length);
+    ASSERT_EQ(bank.position(0), loop_length / 4);
+
+    // Faster tempo: the loop still spans four beats and keeps its phase
+    bank.set_samples_per_beat(1000);
+    EXPECT_EQ(bank.length(0), loop_length);
+    EXPECT_EQ(bank.duration(0), 4000u);
+    EXPECT_EQ(bank.position(0), 1000u);
+    EXPECT_EQ(bank.base_length(), 4000u);
+
+    // Overdubbing needs the loop at its recorded tempo
+    bank.arm(0, loop_command::overdub, quantize::immediate);
+    bank.process(loop.data(), out.data(), 0);
+    EXPECT_EQ(bank.state(0), loop_state::playing);
+
+    // Back at the recorded tempo the loop plays from the buffer again
+    bank.set_samples_per_beat(1200);
+    EXPECT_EQ(bank.duration(0), loop_length);
+    bank.arm(0, loop_command::overdub, quantize::immediate);
+    bank.process(loop.data(), out.data(), 0);
+    EXPECT_EQ(bank.state(0), loop_state::overdubbing);
+}
+
+TEST(TrackBankTempo, RetimedLoopPlaysAtNewPitch)
+{
+    track_bank<int16_t, 1, loop_length> bank(48000);
+    bank.set_samples_per_beat(1200);
+    auto loop = tone_loop();
+    std::vector<int16_t> out(loop_length);
+    bank.arm(0, loop_command::record, quantize::immediate);
+    bank.process(loop.data(), out.data(), loop_length);
+    bank.arm(0, loop_command::play, quantize::immediate);
+    bank.set_samples_per_beat(960);
+
+    // 4800 samples in 3840: 100 cycles per pass is now 1250 Hz
+    std::vector<int16_t> played(3840);
+    bank.process(loop.data(), played.data(), played.size());
+    EXPECT_LT(error_rms(played, 1.25), 16);
+}
@@ -0,0 +1,288 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include <cmsis_os2.h>
+#include <cmsis_os2_host.h>
+#include <quantized_looper/Software/rtos2_tasks.hpp>
+
+namespace {
+
+// The host kernel ticks at 1 kHz off a general purpose OS, so the timing
+// checks leave room for a busy build machine
+class Rtos2 : public ::testing::Test
+{
+protected:
+    void SetUp() override { ASSERT_EQ(osKernelInitialize(), osOK); }
+
+    void TearDown() override { osHostShutdown(); }
+
+    static void sleep_ms(int ms)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+
+    // Until the thread is in a wait, so a flag set next is seen by it
+    static void wait_blocked(osThreadId_t thread)
+    {
+        for (int i = 0; i < 1000; ++i) {
+            if (osThreadGetState(thread) == osThreadBlocked) {
+                return;
+            }
+            sleep_ms(1);
+        }
+    }
+};
+
+} // namespace
+
+TEST_F(Rtos2, KernelStates)
+{
+    EXPECT_EQ(osKernelGetState(), osKernelReady);
+    EXPECT_EQ(osKernelInitialize(), osError);
+    EXPECT_EQ(osKernelStart(), osOK);
+    EXPECT_EQ(osKernelGetState(), osKernelRunning);
+    EXPECT_EQ(osKernelGetTickFreq(), 1000u);
+
+    const uint32_t before = osKernelGetTickCount();
+    sleep_ms(20);
+    EXPECT_GE(osKernelGetTickCount() - before, 20u);
+
+    osHostShutdown();
+    EXPECT_EQ(osKernelGetState(), osKernelInactive);
+    EXPECT_EQ(osKernelInitialize(), osOK);
+}
+
+namespace {
+
+struct flag_results
+{
+    uint32_t any = 0;
+    uint32_t all = 0;
+    uint32_t timeout = 0;
+    uint32_t kept = 0;
+    uint32_t left = 0;
+    std::atomic<bool> done{ false };
+};
+
+void wait_flags(void* argument)
+{
+    auto& r = *static_cast<flag_results*>(argument);
+    r.any = osThreadFlagsWait(0x3, osFlagsWaitAny, osWaitForever);
+    r.all = osThreadFlagsWait(0xC, osFlagsWaitAll, osWaitForever);
+    r.timeout = osThreadFlagsWait(0x10, osFlagsWaitAny, 5);
+    r.kept = osThreadFlagsWait(0x20, osFlagsNoClear, osWaitForever);
+    r.left = osThreadFlagsGet();
+    r.done = true;
+}
+
+} // namespace
+
+TEST_F(Rtos2, ThreadFlags)
+{
+    flag_results r;
+    osThreadAttr_t attr{};
+    attr.name = "flags";
+    osThreadId_t t = osThreadNew(wait_flags, &r, &attr);
+    ASSERT_NE(t, nullptr);
+    EXPECT_STREQ(osThreadGetName(t), "flags");
+    EXPECT_EQ(osThreadGetPriority(t), osPriorityNormal);
+    ASSERT_EQ(osKernelStart(), osOK);
+
+    wait_blocked(t);
+    osThreadFlagsSet(t, 0x2);
+    wait_blocked(t);
+    // Half of an all-wait does not release it
+    osThreadFlagsSet(t, 0x4);
+    sleep_ms(5);
+    EXPECT_FALSE(r.done);
+    osThreadFlagsSet(t, 0x8);
+    sleep_ms(20);
+    wait_blocked(t);
+    osThreadFlagsSet(t, 0x20);
+    for (int i = 0; i < 100 && !r.done; ++i) {
+        sleep_ms(1);
+    }
+
+    ASSERT_TRUE(r.done);
+    EXPECT_EQ(r.any, 0x2u);
+    EXPECT_EQ(r.all, 0xCu);
+    EXPECT_EQ(r.timeout, osFlagsErrorTimeout);
+    EXPECT_EQ(r.kept, 0x20u);
+    EXPECT_EQ(r.left, 0x20u);
+}
+
+namespace {
+
+std::atomic<int> fired;
+
+void count_fire(void*)
+{
+    ++fired;
+}
+
+} // namespace
+
+TEST_F(Rtos2, Timers)
+{
+    fired = 0;
+    ASSERT_EQ(osKernelStart(), osOK);
+    osTimerId_t once = osTimerNew(count_fire, osTimerOnce, nullptr, nullptr);
+    ASSERT_NE(once, nullptr);
+    EXPECT_EQ(osTimerStart(once, 5), osOK);
+    EXPECT_EQ(osTimerIsRunning(once), 1u);
+    sleep_ms(30);
+    EXPECT_EQ(fired, 1);
+    EXPECT_EQ(osTimerIsRunning(once), 0u);
+    EXPECT_EQ(osTimerStop(once), osErrorResource);
+
+    fired = 0;
+    osTimerId_t periodic =
+      osTimerNew(count_fire, osTimerPeriodic, nullptr, nullptr);
+    EXPECT_EQ(osTimerStart(periodic, 10), osOK);
+    sleep_ms(105);
+    EXPECT_EQ(osTimerStop(periodic), osOK);
+    // Due at 10, 20, .., 100 ms: periodic timers do not drift
+    EXPECT_GE(fired, 8);
+    EXPECT_LE(fired, 10);
+    EXPECT_EQ(osTimerDelete(periodic), osOK);
+    EXPECT_EQ(osTimerIsRunning(periodic), 0u);
+}
+
+namespace {
+
+std::atomic<uint32_t> woke_at;
+
+void delay_until(void*)
+{
+    osDelayUntil(osKernelGetTickCount() + 20);
+    woke_at = osKernelGetTickCount();
+}
+
+} // namespace
+
+TEST_F(Rtos2, DelayUntil)
+{
+    woke_at = 0;
+    ASSERT_NE(osThreadNew(delay_until, nullptr, nullptr), nullptr);
+    const uint32_t start = osKernelGetTickCount();
+    ASSERT_EQ(osKernelStart(), osOK);
+    sleep_ms(50);
+    EXPECT_GE(woke_at - start, 20u);
+    EXPECT_LT(woke_at - start, 40u);
+    EXPECT_EQ(osDelayUntil(osKernelGetTickCount() - 1), osErrorParameter);
+}
+
+namespace {
+
+std::atomic<int> fast_runs;
+std::atomic<int> slow_runs;
+std::atomic<int> once_runs;
+std::atomic<uint32_t> first_slow;
+
+void fast()
+{
+    ++fast_runs;
+}
+
+// Far longer than the fast task's period, as a blocking flash write would be
+void slow()
+{
+    if (slow_runs++ == 0) {
+        first_slow = osKernelGetTickCount();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+}
+
+void once()
+{
+    ++once_runs;
+}
+
+uint64_t never()
+{
+    return 0;
+}
+
+// Table clock in microseconds, like the looper's
+using task_t = wheel_task<uint64_t>;
+using tasks_t = rtos2_tasks<uint64_t, 3>;
+
+} // namespace
+
+TEST_F(Rtos2, TasksRunAtTheirPeriods)
+{
+    fast_runs = 0;
+    slow_runs = 0;
+    once_runs = 0;
+    first_slow = 0;
+
+    std::array<task_t, 3> table = { task_t(fast, never, 5000, 0),
+                                    task_t(slow, never, 50000, 20000),
+                                    task_t(once, never, 0, 10000) };
+    tasks_t::config_type config{};
+    config[0].priority = osPriorityHigh;
+    tasks_t tasks(table, config, 1000);
+    const std::array<const char*, 3> names = { "fast", "slow", "once" };
+    ASSERT_TRUE(tasks.start(&names));
+    EXPECT_STREQ(osThreadGetName(tasks.thread(1)), "slow");
+
+    const uint32_t start = osKernelGetTickCount();
+    ASSERT_EQ(osKernelStart(), osOK);
+    sleep_ms(200);
+    // Done with its one run, the thread has exited
+    EXPECT_EQ(osThreadGetState(tasks.thread(2)), osThreadTerminated);
+    osHostShutdown();
+
+    // The fast task keeps its rate while the slow one is in its 30 ms run;
+    // run in turn with it, it would manage about 20
+    EXPECT_GE(fast_runs, 25);
+    EXPECT_LE(fast_runs, 42);
+    EXPECT_EQ(tasks.overruns(0), 0u);
+    EXPECT_GE(slow_runs, 3);
+    EXPECT_LE(slow_runs, 5);
+    EXPECT_GE(first_slow - start, 20u);
+    EXPECT_EQ(once_runs, 1);
+    EXPECT_EQ(tasks.runs(2), 1u);
+}
+
+TEST_F(Rtos2, OverrunsAreCounted)
+{
+    slow_runs = 0;
+    // Released every 10 ms, running for 30
+    std::array<task_t, 1> table = { task_t(slow, never, 10000, 0) };
+    rtos2_tasks<uint64_t, 1> tasks(table, {}, 1000);
+    ASSERT_TRUE(tasks.start());
+    ASSERT_EQ(osKernelStart(), osOK);
+    sleep_ms(100);
+    osHostShutdown();
+
+    EXPECT_GE(tasks.overruns(0), 3u);
+    EXPECT_LE(tasks.runs(0), 5u);
+}
+
+TEST_F(Rtos2, PeriodsMustBeWholeKernelTicks)
+{
+    std::array<task_t, 1> table = { task_t(fast, never, 2500, 0) };
+    rtos2_tasks<uint64_t, 1> tasks(table, {}, 1000);
+    EXPECT_FALSE(tasks.start());
+}
+
+TEST_F(Rtos2, NoTaskRunsWhenStartFails)
+{
+    once_runs = 0;
+    // The first thread exists by the time the second task is refused
+    std::array<task_t, 2> table = { task_t(once, never, 0, 0),
+                                    task_t(fast, never, 2500, 0) };
+    rtos2_tasks<uint64_t, 2> tasks(table, {}, 1000);
+    EXPECT_FALSE(tasks.start());
+    ASSERT_EQ(osKernelStart(), osOK);
+    sleep_ms(20);
+    osHostShutdown();
+
+    EXPECT_EQ(once_runs, 0);
+}
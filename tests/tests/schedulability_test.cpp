@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+
+#include <quantized_looper/Software/schedulability.hpp>
+
+namespace {
+
+// Rate-monotonic textbook set: periods 7, 12, 20 and run times 3, 3, 5
+constexpr std::array<task_budget, 3> textbook = {
+    task_budget{ 7, 3 }, task_budget{ 12, 3 }, task_budget{ 20, 5 }
+};
+
+constexpr std::array<task_budget, 0> none{};
+
+} // namespace
+
+TEST(Schedulability, ForegroundResponseTimes)
+{
+    static_assert(foreground_response(textbook, 0) == 3);
+    static_assert(foreground_response(textbook, 1) == 6);
+    static_assert(foreground_response(textbook, 2) == 20);
+    static_assert(schedulable(none, textbook));
+
+    // A little more and the lowest priority misses
+    constexpr std::array<task_budget, 3> over = {
+        task_budget{ 7, 3 }, task_budget{ 12, 3 }, task_budget{ 20, 6 }
+    };
+    static_assert(foreground_response(over, 2) == no_response);
+    static_assert(!schedulable(none, over));
+    SUCCEED();
+}
+
+TEST(Schedulability, BackgroundWaitsForOneRunOfEachOther)
+{
+    // A 1 ms task due every 5 ms and a 3 ms one: either may have to wait
+    // for one run of the other, however often the other is released
+    constexpr std::array<task_budget, 2> loop = { task_budget{ 5, 1 },
+                                                  task_budget{ 100, 3 } };
+    static_assert(background_response(loop, none, 0) == 4);
+    static_assert(background_response(loop, none, 1) == 4);
+
+    // A 5 ms one leaves no time in 5 ms
+    constexpr std::array<task_budget, 2> blocking = { task_budget{ 5, 1 },
+                                                      task_budget{ 100, 5 } };
+    static_assert(background_response(blocking, none, 0) == no_response);
+    SUCCEED();
+}
+
+TEST(Schedulability, ForegroundStretchesTheBackground)
+{
+    constexpr std::array<task_budget, 2> loop = { task_budget{ 20, 2 },
+                                                  task_budget{ 100, 4 } };
+    constexpr std::array<task_budget, 1> audio = { task_budget{ 2, 1 } };
+    // A granule late, then 2 + 4 of background work at half speed
+    static_assert(background_response(loop, audio, 0, 1) == 14);
+    static_assert(schedulable(loop, audio, 1));
+
+    constexpr std::array<task_budget, 1> heavy = { task_budget{ 2, 2 } };
+    static_assert(!schedulable(loop, heavy));
+    SUCCEED();
+}
+
+TEST(Schedulability, DeadlinesAndMissingBudgets)
+{
+    // Unbudgeted tasks cost nothing; a deadline can be shorter than the
+    // period
+    constexpr std::array<task_budget, 2> loop = { task_budget{ 10, 3 },
+                                                  task_budget{ 10 } };
+    static_assert(background_response(loop, none, 0) == 3);
+    constexpr std::array<task_budget, 2> tight = { task_budget{ 10, 3, 2 },
+                                                   task_budget{ 10 } };
+    static_assert(!schedulable(tight, none));
+    SUCCEED();
+}
+
+TEST(Schedulability, MeasuredCyclesToBudget)
+{
+    EXPECT_EQ(cycles_to_us(96, 96000000), 1u);
+    EXPECT_EQ(cycles_to_us(97, 96000000), 2u);
+    EXPECT_EQ(cycles_to_us(0, 96000000), 0u);
+    EXPECT_EQ(cycles_to_us(96000000, 96000000), 1000000u);
+}
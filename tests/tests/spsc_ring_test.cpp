@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <quantized_looper/Software/spsc_ring.hpp>
+
+namespace {
+
+constexpr std::size_t frames_per_block = 32;
+constexpr std::size_t sample_rate = 48000;
+
+struct audio_block
+{
+    uint32_t sequence;
+    std::array<int16_t, frames_per_block * 2> samples;
+};
+
+audio_block make_block(uint32_t sequence)
+{
+    audio_block block{};
+    block.sequence = sequence;
+    for (std::size_t i = 0; i < block.samples.size(); ++i) {
+        block.samples[i] = static_cast<int16_t>(sequence + i);
+    }
+    return block;
+}
+
+bool block_is_intact(const audio_block& block)
+{
+    for (std::size_t i = 0; i < block.samples.size(); ++i) {
+        if (block.samples[i] != static_cast<int16_t>(block.sequence + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(SpscRing, StartsEmpty)
+{
+    spsc_ring<int, 4> ring;
+    int value = 0;
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.size(), 0u);
+    EXPECT_FALSE(ring.try_pop(value));
+    EXPECT_EQ(ring.read_slot(), nullptr);
+}
+
+TEST(SpscRing, RejectsPushWhenFull)
+{
+    spsc_ring<int, 4> ring;
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.try_push(i));
+    }
+    EXPECT_TRUE(ring.full());
+    EXPECT_FALSE(ring.try_push(4));
+    EXPECT_EQ(ring.write_slot(), nullptr);
+
+    int value = -1;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.try_pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SpscRing, InPlaceSlotsAreOnlyVisibleAfterCommit)
+{
+    spsc_ring<audio_block, 2> ring;
+
+    audio_block* slot = ring.write_slot();
+    ASSERT_NE(slot, nullptr);
+    *slot = make_block(7);
+    EXPECT_EQ(ring.read_slot(), nullptr);
+
+    ring.commit_write();
+    const audio_block* front = ring.read_slot();
+    ASSERT_NE(front, nullptr);
+    EXPECT_EQ(front->sequence, 7u);
+    EXPECT_TRUE(block_is_intact(*front));
+
+    ring.commit_read();
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SpscRing, IndicesSurviveManyWraps)
+{
+    spsc_ring<uint32_t, 8> ring;
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < 100000; ++i) {
+        ASSERT_TRUE(ring.try_push(i));
+        ASSERT_TRUE(ring.try_pop(value));
+        ASSERT_EQ(value, i);
+    }
+}
+
+// Hammer the ring from two threads with no pacing; every block has to come out
+// once, in order and untorn.
+TEST(SpscRing, TwoThreadStressKeepsOrder)
+{
+    constexpr uint32_t n_blocks = 200000;
+    static spsc_ring<audio_block, 8> ring;
+
+    std::thread producer([] {
+        for (uint32_t i = 0; i < n_blocks;) {
+            audio_block* slot = ring.write_slot();
+            if (slot == nullptr) {
+                std::this_thread::yield();
+                continue;
+            }
+            *slot = make_block(i);
+            ring.commit_write();
+            ++i;
+        }
+    });
+
+    uint32_t expected = 0;
+    uint32_t torn = 0;
+    while (expected < n_blocks) {
+        const audio_block* block = ring.read_slot();
+        if (block == nullptr) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(block->sequence, expected);
+        torn += block_is_intact(*block) ? 0 : 1;
+        ring.commit_read();
+        ++expected;
+    }
+    producer.join();
+
+    EXPECT_EQ(torn, 0u);
+    EXPECT_TRUE(ring.empty());
+}
+
+namespace {
+
+// Model the DMA interrupt on a simulated timeline: each block period the
+// producer hands the captured block to the engine and collects the
+// processed ones. It never waits, so a full ring would mean a dropped block.
+// The engine task only gets to run every few periods, as when it waits
+// behind other tasks; the ring has to cover the longest gap.
+struct realtime_result
+{
+    uint32_t dropped = 0;
+    uint32_t processed = 0;
+    uint32_t returned = 0;
+    std::vector<uint32_t> sequence; //!< Of the blocks the engine processed
+};
+
+template<std::size_t Capacity, std::size_t Gaps>
+realtime_result run_realtime(const std::array<uint32_t, Gaps>& gaps,
+                             uint32_t n_blocks)
+{
+    spsc_ring<audio_block, Capacity> to_engine;
+    spsc_ring<audio_block, Capacity> from_engine;
+    realtime_result r;
+    audio_block block{};
+    std::size_t gap = 0;
+    uint32_t next_service = gaps[0];
+
+    // One pass more than the blocks, to return the last of them
+    for (uint32_t period = 0; period <= n_blocks; ++period) {
+        if (period < n_blocks && !to_engine.try_push(make_block(period))) {
+            ++r.dropped;
+        }
+        while (from_engine.try_pop(block)) {
+            r.returned += block_is_intact(block) ? 1 : 0;
+        }
+        if (period + 1 == next_service || period == n_blocks) {
+            while (to_engine.try_pop(block)) {
+                r.sequence.push_back(block.sequence);
+                if (from_engine.try_push(block)) {
+                    ++r.processed;
+                }
+            }
+            gap = (gap + 1) % Gaps;
+            next_service += gaps[gap];
+        }
+    }
+    while (from_engine.try_pop(block)) {
+        r.returned += block_is_intact(block) ? 1 : 0;
+    }
+    return r;
+}
+
+} // namespace
+
+TEST(SpscRing, RealTimeProducerDropsNothingAt48kHz)
+{
+    // Half a second of 32-frame blocks; gaps of up to four block periods,
+    // 2.7 ms at 48 kHz, fit the four slots
+    constexpr uint32_t n_blocks = sample_rate / frames_per_block / 2;
+    constexpr std::array<uint32_t, 7> gaps = { 1, 1, 4, 2, 3, 1, 4 };
+    realtime_result r = run_realtime<4>(gaps, n_blocks);
+
+    EXPECT_EQ(r.dropped, 0u);
+    EXPECT_EQ(r.processed, n_blocks);
+    EXPECT_EQ(r.returned, n_blocks);
+    ASSERT_EQ(r.sequence.size(), n_blocks);
+    for (uint32_t i = 0; i < n_blocks; ++i) {
+        EXPECT_EQ(r.sequence[i], i);
+    }
+}
+
+TEST(SpscRing, RealTimeProducerDropsWhenTheEngineFallsBehind)
+{
+    // A gap of five periods loses one block each time, and keeps order
+    constexpr std::array<uint32_t, 2> gaps = { 1, 5 };
+    realtime_result r = run_realtime<4>(gaps, 60);
+
+    EXPECT_EQ(r.dropped, 10u);
+    EXPECT_EQ(r.processed, 50u);
+    EXPECT_EQ(r.returned, 50u);
+    for (std::size_t i = 1; i < r.sequence.size(); ++i) {
+        EXPECT_LT(r.sequence[i - 1], r.sequence[i]);
+    }
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <quantized_looper/Software/static_scheduler.hpp>
+
+namespace {
+
+// Simulated clock, and every run as (task, clock time)
+struct sim_clock
+{
+    using tick_type = uint64_t;
+
+    static tick_type now() { return value; }
+
+    static inline tick_type value = 0;
+};
+
+std::vector<std::pair<int, uint64_t>> runs;
+
+template<int I>
+void record()
+{
+    runs.emplace_back(I, sim_clock::value);
+}
+
+std::vector<uint64_t> times_of(int task)
+{
+    std::vector<uint64_t> t;
+    for (auto [i, at] : runs) {
+        if (i == task) {
+            t.push_back(at);
+        }
+    }
+    return t;
+}
+
+template<typename Scheduler>
+void run_until(Scheduler& s, uint64_t end, uint64_t step)
+{
+    while (sim_clock::value < end) {
+        sim_clock::value += step;
+        s.poll(sim_clock::value);
+    }
+}
+
+void reset()
+{
+    sim_clock::value = 0;
+    runs.clear();
+}
+
+// A task with its own state
+struct counter
+{
+    static constexpr uint64_t period = 50;
+    static constexpr uint64_t offset = 0;
+
+    void operator()() { ++count; }
+
+    int count = 0;
+};
+
+} // namespace
+
+TEST(StaticScheduler, RunsEachTaskAtItsPeriodAndOffset)
+{
+    reset();
+    static_scheduler<sim_clock,
+                     std::tuple<static_task<record<0>, 100>,
+                                static_task<record<1>, 30, 10>>>
+      s;
+    static_assert(decltype(s)::size() == 2);
+    s.start(sim_clock::now());
+    run_until(s, 300, 1);
+
+    EXPECT_EQ(times_of(0), std::vector<uint64_t>({ 1, 100, 200, 300 }));
+    EXPECT_EQ(times_of(1),
+              std::vector<uint64_t>(
+                { 10, 40, 70, 100, 130, 160, 190, 220, 250, 280 }));
+}
+
+TEST(StaticScheduler, DueTogetherRunInTableOrder)
+{
+    reset();
+    static_scheduler<sim_clock,
+                     std::tuple<static_task<record<2>, 10>,
+                                static_task<record<1>, 10>,
+                                static_task<record<0>, 10>>>
+      s;
+    s.start(sim_clock::now());
+    EXPECT_EQ(s.poll(0), 3u);
+    ASSERT_EQ(runs.size(), 3u);
+    EXPECT_EQ(runs[0].first, 2);
+    EXPECT_EQ(runs[1].first, 1);
+    EXPECT_EQ(runs[2].first, 0);
+    EXPECT_EQ(s.poll(9), 0u);
+    EXPECT_EQ(s.next_release(), 10u);
+}
+
+TEST(StaticScheduler, MissedReleasesAreSkippedKeepingPhase)
+{
+    reset();
+    static_scheduler<sim_clock, std::tuple<static_task<record<0>, 10, 5>>>
+      s;
+    s.start(sim_clock::now());
+    sim_clock::value = 47;
+    EXPECT_EQ(s.poll(sim_clock::value), 1u);
+    EXPECT_EQ(s.next_release(), 55u);
+    run_until(s, 75, 1);
+    EXPECT_EQ(times_of(0), std::vector<uint64_t>({ 47, 55, 65, 75 }));
+}
+
+TEST(StaticScheduler, TasksKeepTheirOwnState)
+{
+    reset();
+    static_scheduler<sim_clock, std::tuple<counter, counter>> s(
+      { counter{}, counter{ 100 } });
+    s.start(sim_clock::now());
+    run_until(s, 1000, 5);
+    EXPECT_EQ(s.task<0>().count, 21);
+    EXPECT_EQ(s.task<1>().count, 121);
+}
@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <quantized_looper/Software/tap_tempo.hpp>
+
+namespace {
+
+using tempo_t = tap_tempo<8>;
+
+constexpr uint32_t min_period = 60000;
+constexpr uint32_t max_period = 3000000;
+
+tempo_t make_tempo()
+{
+    return tempo_t(min_period, max_period, 1000000);
+}
+
+// Tap times for a steady beat, each tap off by up to +/- jitter us
+std::vector<uint32_t> taps(uint32_t start,
+                           uint32_t period,
+                           uint32_t jitter,
+                           std::size_t n,
+                           unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int32_t> off(-static_cast<int32_t>(jitter),
+                                               static_cast<int32_t>(jitter));
+    std::vector<uint32_t> t(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        t[i] = start + static_cast<uint32_t>(i) * period +
+               static_cast<uint32_t>(off(rng));
+    }
+    return t;
+}
+
+// Mean absolute period error after each tap, over many jittered streams
+std::vector<double> convergence(uint32_t period,
+                                uint32_t jitter,
+                                std::size_t n,
+                                bool last_interval_only)
+{
+    constexpr int runs = 200;
+    std::vector<double> error(n, 0.0);
+    for (int r = 0; r < runs; ++r) {
+        auto tempo = make_tempo();
+        auto t = taps(1000, period, jitter, n, r);
+        for (std::size_t i = 0; i < n; ++i) {
+            tempo.tap(t[i]);
+            double estimate = last_interval_only && i > 0
+                                ? static_cast<double>(t[i] - t[i - 1])
+                                : tempo.period_q8() / 256.0;
+            error[i] += std::abs(estimate - period) / runs;
+        }
+    }
+    return error;
+}
+
+} // namespace
+
+TEST(TapTempo, ExactTapsGiveExactPeriod)
+{
+    auto tempo = make_tempo();
+    for (uint32_t i = 0; i < 5; ++i) {
+        tempo.tap(1000 + i * 468750);
+    }
+    EXPECT_EQ(tempo.period_q8(), 468750u << 8);
+    EXPECT_EQ(tempo.period_us(), 468750u);
+    EXPECT_EQ(tempo.taps(), 5u);
+}
+
+TEST(TapTempo, SecondTapSetsPeriod)
+{
+    auto tempo = make_tempo();
+    EXPECT_FALSE(tempo.tap(5000));
+    EXPECT_EQ(tempo.period_us(), 1000000u);
+    EXPECT_TRUE(tempo.tap(505000));
+    EXPECT_EQ(tempo.period_us(), 500000u);
+}
+
+TEST(TapTempo, ConvergesUnderJitter)
+{
+    // +/-15 ms of jitter, about what a careful player manages
+    constexpr uint32_t period = 500000;
+    auto fitted = convergence(period, 15000, 12, false);
+    auto naive = convergence(period, 15000, 12, true);
+
+    for (std::size_t i = 0; i < fitted.size(); ++i) {
+        RecordProperty("mean_error_us_after_tap_" + std::to_string(i + 1),
+                       static_cast<int>(fitted[i]));
+    }
+
+    // Within 0.5% by the eighth tap, and several times better than timing
+    // the last interval alone
+    EXPECT_LT(fitted[7], period * 0.005);
+    EXPECT_LT(fitted[11], fitted[2] / 3);
+    EXPECT_LT(fitted[11] * 4, naive[11]);
+}
+
+TEST(TapTempo, SloppyTapBarelyMovesIt)
+{
+    auto tempo = make_tempo();
+    for (uint32_t i = 0; i < 6; ++i) {
+        tempo.tap(i * 500000);
+    }
+    // One tap 90 ms late: the last-interval estimate would jump 18%
+    tempo.tap(6 * 500000 + 90000);
+    EXPECT_EQ(tempo.period_us(), 500000u);
+    tempo.tap(7 * 500000);
+    EXPECT_EQ(tempo.period_us(), 500000u);
+}
+
+TEST(TapTempo, MissedTapCountsAsTwoBeats)
+{
+    auto tempo = make_tempo();
+    for (uint32_t beat : { 0u, 1u, 2u, 4u, 5u, 6u }) {
+        tempo.tap(beat * 400000);
+    }
+    EXPECT_EQ(tempo.period_us(), 400000u);
+}
+
+TEST(TapTempo, BouncesAreIgnored)
+{
+    auto tempo = make_tempo();
+    tempo.tap(0);
+    EXPECT_FALSE(tempo.tap(20000));
+    tempo.tap(500000);
+    EXPECT_EQ(tempo.period_us(), 500000u);
+    EXPECT_EQ(tempo.taps(), 2u);
+}
+
+TEST(TapTempo, SimultaneousTapsAreBouncesWithNoMinimum)
+{
+    // With no minimum, a second tap at the same time would make the median
+    // interval zero and the fit divide by it
+    tap_tempo<8> tempo(0, 3000000, 1000000);
+    tempo.tap(1000);
+    EXPECT_FALSE(tempo.tap(1000));
+    EXPECT_TRUE(tempo.tap(501000));
+    EXPECT_EQ(tempo.period_us(), 500000u);
+}
+
+TEST(TapTempo, LongPauseStartsOver)
+{
+    auto tempo = make_tempo();
+    for (uint32_t i = 0; i < 4; ++i) {
+        tempo.tap(i * 500000);
+    }
+    // Four seconds later, a new tempo from just two taps
+    uint32_t start = 3 * 500000 + 4000000;
+    tempo.tap(start);
+    EXPECT_EQ(tempo.taps(), 1u);
+    tempo.tap(start + 750000);
+    EXPECT_EQ(tempo.period_us(), 750000u);
+}
+
+TEST(TapTempo, FollowsTempoChangeWithoutPause)
+{
+    auto tempo = make_tempo();
+    uint32_t t = 0;
+    for (int i = 0; i < 8; ++i, t += 500000) {
+        tempo.tap(t);
+    }
+
+    // Speed up by 20%; old taps fall out of the window within eight taps
+    int taps_to_settle = 0;
+    for (int i = 0; i < 8; ++i, t += 400000) {
+        tempo.tap(t);
+        if (tempo.period_us() != 400000u) {
+            taps_to_settle = i + 1;
+        }
+    }
+    EXPECT_EQ(tempo.period_us(), 400000u);
+    EXPECT_LE(taps_to_settle, 6);
+    RecordProperty("taps_to_settle", taps_to_settle);
+}
+
+TEST(TapTempo, CounterWrapIsSeamless)
+{
+    auto tempo = make_tempo();
+    uint32_t start = 0xFFFFFFFFu - 1200000u;
+    for (uint32_t i = 0; i < 6; ++i) {
+        tempo.tap(start + i * 600000u);
+    }
+    EXPECT_EQ(tempo.period_us(), 600000u);
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <quantized_looper/Software/task_stats.hpp>
+#include <quantized_looper/Software/timer_wheel.hpp>
+
+namespace {
+
+// Cycle counter the test moves by hand
+struct fake_cycles
+{
+    static uint32_t now() { return value; }
+
+    static inline uint32_t value = 0;
+};
+
+// Scheduler clock, and what each task costs when it runs
+uint64_t sim_now = 0;
+std::array<uint32_t, 2> cost = { 0, 0 };
+
+uint64_t sim_clock()
+{
+    return sim_now;
+}
+
+template<int I>
+void work()
+{
+    fake_cycles::value += cost[I];
+}
+
+using stats_t = task_stats<2, fake_cycles, 8>;
+
+// A run costing `cycles` that started `late` ticks after its release
+void run(stats_t& stats, std::size_t task, uint32_t cycles, uint64_t late)
+{
+    uint32_t started = stats.start();
+    fake_cycles::value += cycles;
+    stats.finish(task, started, late);
+}
+
+} // namespace
+
+TEST(TaskStats, MinMeanMax)
+{
+    stats_t stats;
+    run(stats, 0, 100, 0);
+    run(stats, 0, 300, 0);
+    run(stats, 0, 200, 0);
+    run(stats, 1, 50, 0);
+
+    EXPECT_EQ(stats[0].runs, 3u);
+    EXPECT_EQ(stats[0].min_cycles, 100u);
+    EXPECT_EQ(stats[0].mean_cycles(), 200u);
+    EXPECT_EQ(stats[0].max_cycles, 300u);
+    EXPECT_EQ(stats[1].runs, 1u);
+    EXPECT_EQ(stats[1].mean_cycles(), 50u);
+
+    stats.reset();
+    EXPECT_EQ(stats[0].runs, 0u);
+    EXPECT_EQ(stats[0].mean_cycles(), 0u);
+}
+
+TEST(TaskStats, CountsAcrossACounterWrap)
+{
+    stats_t stats;
+    fake_cycles::value = 0xFFFFFF00;
+    run(stats, 0, 0x200, 0);
+    EXPECT_EQ(stats[0].max_cycles, 0x200u);
+}
+
+TEST(TaskStats, LatenessBuckets)
+{
+    EXPECT_EQ(stats_t::bucket(0), 0u);
+    EXPECT_EQ(stats_t::bucket(1), 1u);
+    EXPECT_EQ(stats_t::bucket(2), 2u);
+    EXPECT_EQ(stats_t::bucket(3), 2u);
+    EXPECT_EQ(stats_t::bucket(4), 3u);
+    EXPECT_EQ(stats_t::bucket(127), 7u);
+    // The last bucket takes everything later
+    EXPECT_EQ(stats_t::bucket(128), 7u);
+    EXPECT_EQ(stats_t::bucket(0xFFFFFFFF), 7u);
+
+    stats_t stats;
+    const std::array<uint64_t, 6> lateness = { 0, 0, 5, 6, 1000, 1ull << 40 };
+    for (uint64_t late : lateness) {
+        run(stats, 1, 1, late);
+    }
+    std::array<uint32_t, 8> expected = { 2, 0, 0, 2, 0, 0, 0, 2 };
+    EXPECT_EQ(stats[1].late, expected);
+}
+
+TEST(TaskStats, Jitter)
+{
+    stats_t stats;
+    EXPECT_EQ(stats[0].jitter(), 0u);
+    run(stats, 0, 1, 12);
+    EXPECT_EQ(stats[0].jitter(), 0u);
+    run(stats, 0, 1, 3);
+    run(stats, 0, 1, 40);
+    EXPECT_EQ(stats[0].min_late, 3u);
+    EXPECT_EQ(stats[0].max_late, 40u);
+    EXPECT_EQ(stats[0].jitter(), 37u);
+}
+
+TEST(TaskStats, WheelTimesEveryRun)
+{
+    using task_t = wheel_task<uint64_t>;
+    sim_now = 0;
+    cost = { 1000, 40 };
+
+    // 16 ticks per granule, polled every 10
+    std::array<task_t, 2> tasks = { task_t(work<0>, sim_clock, 160, 0),
+                                    task_t(work<1>, sim_clock, 100, 5) };
+    timer_wheel<uint64_t, 2, stats_t> wheel(tasks, 4);
+    wheel.start(sim_now);
+    // Releases at 0, 160 .. 1600 and 5, 105 .. 1505
+    while (sim_now < 1600) {
+        sim_now += 10;
+        wheel.poll(sim_now);
+    }
+
+    const auto& slow = wheel.statistics()[0];
+    const auto& fast = wheel.statistics()[1];
+    EXPECT_EQ(slow.runs, 11u);
+    EXPECT_EQ(slow.min_cycles, 1000u);
+    EXPECT_EQ(slow.max_cycles, 1000u);
+    EXPECT_EQ(fast.runs, 16u);
+    EXPECT_EQ(fast.mean_cycles(), 40u);
+
+    // Never later than a granule and a polling interval
+    for (const auto* r : { &slow, &fast }) {
+        EXPECT_LT(r->max_late, 16u + 10u);
+        uint32_t total = 0;
+        for (uint32_t n : r->late) {
+            total += n;
+        }
+        EXPECT_EQ(total, r->runs);
+    }
+}
+
+TEST(TaskStats, Dump)
+{
+    stats_t stats;
+    run(stats, 1, 100, 0);
+    run(stats, 1, 300, 6);
+    run(stats, 1, 200, 1000);
+
+    std::vector<std::string> lines;
+    stats.dump({ "idle", "audio" },
+               [&](const char* line) { lines.emplace_back(line); });
+
+    // A task that never ran is left out
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[0],
+              "audio: 3 runs, 100/200/300 cycles min/mean/max, "
+              "late 0..1000 ticks, jitter 1000");
+    EXPECT_EQ(lines[1], "audio late <1:1 <8:1 more:1");
+}
+
+TEST(TaskStats, DisabledLeavesNothingBehind)
+{
+    static_assert(!no_task_stats::enabled);
+    static_assert(std::is_empty_v<no_task_stats>);
+    static_assert(sizeof(timer_wheel<uint64_t, 4, no_task_stats>) ==
+                  sizeof(timer_wheel<uint64_t, 4>));
+    static_assert(sizeof(timer_wheel<uint64_t, 4, task_stats<4, fake_cycles>>) >
+                  sizeof(timer_wheel<uint64_t, 4>));
+    SUCCEED();
+}
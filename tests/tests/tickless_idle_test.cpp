@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <Software/mock_alarm.hpp>
+#include <Software/mock_counter.hpp>
+#include <quantized_looper/Software/monotonic_clock.hpp>
+#include <quantized_looper/Software/tickless_idle.hpp>
+#include <quantized_looper/Software/timer_wheel.hpp>
+
+namespace {
+
+// A 1 MHz timer, so ticks read as microseconds
+constexpr uint32_t timer_hz = 1000000;
+
+template<typename Tag>
+struct sim
+{
+    using counter = mock_counter<timer_hz, Tag>;
+    using clock = monotonic_clock<counter>;
+    using alarm = mock_alarm<counter, clock>;
+    using idle = tickless_idle<clock, alarm>;
+};
+
+// 20 us shortest sleep, 100 ms longest, 3 us to wake
+template<typename Idle>
+Idle make_idle()
+{
+    return Idle(20, 100000, 3);
+}
+
+} // namespace
+
+TEST(TicklessIdle, WakesAheadOfTheNextRelease)
+{
+    struct tag;
+    auto idle = make_idle<sim<tag>::idle>();
+    auto p = idle.deadline(1000, true, 5000);
+    EXPECT_TRUE(p.sleep);
+    EXPECT_EQ(p.wake, 4997u);
+}
+
+TEST(TicklessIdle, SpinsThroughShortGaps)
+{
+    struct tag;
+    auto idle = make_idle<sim<tag>::idle>();
+    EXPECT_FALSE(idle.deadline(1000, true, 1010).sleep);
+    EXPECT_FALSE(idle.deadline(1000, true, 1022).sleep);
+    EXPECT_TRUE(idle.deadline(1000, true, 1023).sleep);
+    // Already due, or overdue
+    EXPECT_FALSE(idle.deadline(1000, true, 1000).sleep);
+    EXPECT_FALSE(idle.deadline(1000, true, 2).sleep);
+}
+
+TEST(TicklessIdle, SleepIsCapped)
+{
+    struct tag;
+    auto idle = make_idle<sim<tag>::idle>();
+    auto p = idle.deadline(1000, false, 0);
+    EXPECT_TRUE(p.sleep);
+    EXPECT_EQ(p.wake, 101000u);
+    EXPECT_EQ(idle.deadline(1000, true, 10000000).wake, 101000u);
+}
+
+TEST(TicklessIdle, SleepsUntilTheAlarm)
+{
+    struct tag;
+    using s = sim<tag>;
+    s::alarm::reset();
+    auto idle = make_idle<s::idle>();
+    s::counter::advance(500);
+
+    idle(true, 2500);
+    EXPECT_EQ(s::clock::now(), 2497u);
+    EXPECT_FALSE(s::alarm::armed);
+    EXPECT_EQ(idle.sleep_count(), 1u);
+    EXPECT_EQ(idle.slept_ticks(), 1997u);
+}
+
+TEST(TicklessIdle, InterruptWakesEarly)
+{
+    struct tag;
+    using s = sim<tag>;
+    s::alarm::reset();
+    auto idle = make_idle<s::idle>();
+
+    s::alarm::interrupt = 700;
+    idle(true, 5000);
+    EXPECT_EQ(s::clock::now(), 700u);
+    EXPECT_FALSE(s::alarm::armed);
+
+    // The next idle goes back to sleep for the rest
+    idle(true, 5000);
+    EXPECT_EQ(s::clock::now(), 4997u);
+}
+
+namespace {
+
+struct run_tag;
+using run_sim = sim<run_tag>;
+std::vector<std::pair<int, uint64_t>> runs;
+
+template<int I>
+void record()
+{
+    runs.emplace_back(I, run_sim::clock::now());
+}
+
+} // namespace
+
+TEST(TicklessIdle, SchedulerSleepsBetweenTasks)
+{
+    using s = run_sim;
+    using task_t = wheel_task<uint64_t>;
+    s::alarm::reset();
+    runs.clear();
+
+    // The looper's table, in microseconds, on 16 us granules
+    std::array<task_t, 4> tasks = {
+        task_t(record<0>, s::clock::now, 20000, 0),
+        task_t(record<1>, s::clock::now, 800000, 0),
+        task_t(record<2>, s::clock::now, 333, 0),
+        task_t(record<3>, s::clock::now, 100000, 0)
+    };
+    timer_wheel<uint64_t, 4> wheel(tasks, 4);
+    auto idle = make_idle<s::idle>();
+    wheel.start(s::clock::now());
+
+    // Ten seconds of the main loop, each pass costing a microsecond, with
+    // an interrupt every 667 us like the audio DMA
+    constexpr uint64_t end = 10000000;
+    int passes = 0;
+    uint64_t next_interrupt = 667;
+    while (s::clock::now() < end) {
+        wheel.poll(s::clock::now());
+        uint64_t at = 0;
+        bool pending = wheel.next_release(at);
+        if (!s::alarm::interrupt) {
+            s::alarm::interrupt = next_interrupt;
+            next_interrupt += 667;
+        }
+        idle(pending, at);
+        s::counter::advance(1);
+        ++passes;
+    }
+
+    // Every release ran, none early and none later than a granule and the
+    // cost of a pass
+    std::array<uint64_t, 4> releases{};
+    for (auto [task, at] : runs) {
+        EXPECT_GE(at, releases[task]) << task;
+        EXPECT_LE(at, releases[task] + 16 + 1) << task;
+        releases[task] += tasks[task].period;
+    }
+    for (int task = 0; task < 4; ++task) {
+        EXPECT_GT(releases[task], end - 16 - 1) << task;
+    }
+
+    // Asleep for most of it, and a few passes per wake-up rather than ten
+    // million spins
+    EXPECT_GT(idle.slept_ticks(), 9000000u);
+    EXPECT_LT(passes, 4 * idle.sleep_count());
+}
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <quantized_looper/Audio/real_fft.hpp>
+#include <quantized_looper/Audio/time_stretch.hpp>
+#include <quantized_looper/Audio/track_bank.hpp>
+
+namespace {
+
+using stretch_t = time_stretch<int16_t>;
+
+constexpr double sample_rate = 48000;
+
+// 440 Hz at half scale; 48000 samples hold exactly 440 cycles, so the loop
+// wraps without a seam
+constexpr std::size_t loop_length = 48000;
+constexpr double tone_hz = 440;
+constexpr double amplitude = 16384;
+
+std::vector<int16_t> tone_loop()
+{
+    std::vector<int16_t> x(loop_length);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        x[i] = static_cast<int16_t>(std::lround(
+          amplitude * std::sin(2 * M_PI * tone_hz * i / sample_rate)));
+    }
+    return x;
+}
+
+std::vector<int16_t> stretch(stretch_t& s,
+                             const std::vector<int16_t>& loop,
+                             double ratio,
+                             std::size_t n)
+{
+    const auto step = static_cast<resample_pos>(ratio * resample_one);
+    std::vector<int16_t> out(n);
+    resample_pos pos = 0;
+    for (std::size_t i = 0; i < n; i += 32) {
+        pos = s.process(loop.data(), loop.size(), pos, step, &out[i], 32);
+    }
+    return out;
+}
+
+// Rising zero crossings per second
+double frequency(const std::vector<int16_t>& x)
+{
+    std::size_t crossings = 0;
+    for (std::size_t i = 1; i < x.size(); ++i) {
+        crossings += x[i - 1] < 0 && x[i] >= 0;
+    }
+    return crossings * sample_rate / x.size();
+}
+
+double rms(const std::vector<int16_t>& x)
+{
+    double sum = 0;
+    for (int16_t v : x) {
+        sum += static_cast<double>(v) * v;
+    }
+    return std::sqrt(sum / x.size());
+}
+
+} // namespace
+
+TEST(RealFft, MatchesDirectDft)
+{
+    constexpr std::size_t n = 64;
+    real_fft<n> fft;
+    std::array<float, n> x;
+    for (std::size_t i = 0; i < n; ++i) {
+        x[i] = static_cast<float>(std::sin(0.3 * i) + 0.01 * i);
+    }
+    std::array<float, n> time = x;
+    std::array<float, n> spectrum;
+    fft.forward(time.data(), spectrum.data());
+
+    for (std::size_t k = 0; k <= n / 2; ++k) {
+        double re = 0;
+        double im = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            re += x[i] * std::cos(2 * M_PI * k * i / n);
+            im -= x[i] * std::sin(2 * M_PI * k * i / n);
+        }
+        if (k == 0) {
+            EXPECT_NEAR(spectrum[0], re, 1e-4);
+        } else if (k == n / 2) {
+            EXPECT_NEAR(spectrum[1], re, 1e-4);
+        } else {
+            EXPECT_NEAR(spectrum[2 * k], re, 1e-4) << k;
+            EXPECT_NEAR(spectrum[2 * k + 1], im, 1e-4) << k;
+        }
+    }
+}
+
+TEST(RealFft, InverseUndoesForward)
+{
+    constexpr std::size_t n = 512;
+    real_fft<n> fft;
+    std::array<float, n> x;
+    for (std::size_t i = 0; i < n; ++i) {
+        x[i] = static_cast<float>(i * 37 % 101) - 50.0f;
+    }
+    std::array<float, n> time = x;
+    std::array<float, n> spectrum;
+    fft.forward(time.data(), spectrum.data());
+    fft.inverse(spectrum.data(), time.data());
+    for (std::size_t i = 0; i < n; ++i) {
+        ASSERT_NEAR(time[i], x[i], 1e-3) << i;
+    }
+}
+
+TEST(TimeStretch, UnityStepReproducesTheLoop)
+{
+    auto loop = tone_loop();
+    auto s = std::make_unique<stretch_t>();
+    auto out = stretch(*s, loop, 1.0, 9600);
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        ASSERT_NEAR(out[i], loop[i], 2) << i;
+    }
+}
+
+TEST(TimeStretch, KeepsPitchAndLevel)
+{
+    auto loop = tone_loop();
+    auto s = std::make_unique<stretch_t>();
+    for (double ratio : { 0.8, 0.95, 1.05, 1.25 }) {
+        auto out = stretch(*s, loop, ratio, 24000);
+        EXPECT_NEAR(frequency(out), tone_hz, 4) << ratio;
+        EXPECT_NEAR(rms(out), amplitude / std::sqrt(2.0), amplitude * 0.02)
+          << ratio;
+    }
+}
+
+TEST(TimeStretch, ReadPositionAdvancesByStep)
+{
+    auto loop = tone_loop();
+    auto s = std::make_unique<stretch_t>();
+    const resample_pos step = resample_one * 5 / 4;
+    std::vector<int16_t> out(100);
+    resample_pos pos = s->process(
+      loop.data(), loop.size(), resample_one * 10, step, out.data(), 100);
+    EXPECT_EQ(pos, resample_one * 10 + step * 100);
+
+    // Wraps into the loop
+    pos = s->process(loop.data(), loop.size(), pos, step, out.data(), 100);
+    pos = s->process(
+      loop.data(), 160, resample_one * 150, step, out.data(), 10);
+    EXPECT_EQ(pos, resample_one * 150 + step * 10 - resample_one * 160);
+}
+
+TEST(TimeStretch, JumpRestartsCleanly)
+{
+    auto loop = tone_loop();
+    auto s = std::make_unique<stretch_t>();
+    const resample_pos step = resample_one * 9 / 10;
+    std::vector<int16_t> out(4800);
+    s->process(loop.data(), loop.size(), 0, step, out.data(), 4800);
+
+    // A jump to an arbitrary position is as clean as a fresh start
+    auto fresh = std::make_unique<stretch_t>();
+    std::vector<int16_t> expected(480);
+    std::vector<int16_t> jumped(480);
+    fresh->process(loop.data(),
+                   loop.size(),
+                   resample_one * 20000,
+                   step,
+                   expected.data(),
+                   480);
+    s->process(
+      loop.data(), loop.size(), resample_one * 20000, step, jumped.data(), 480);
+    EXPECT_EQ(jumped, expected);
+}
+
+TEST(TimeStretch, EmptyLoopPlaysSilence)
+{
+    auto s = std::make_unique<stretch_t>();
+    std::vector<int16_t> out(64, 1234);
+    resample_pos pos =
+      s->process(nullptr, 0, 0, resample_one, out.data(), out.size());
+    EXPECT_EQ(pos, 0u);
+    EXPECT_EQ(out, std::vector<int16_t>(64, 0));
+
+    // A loop recorded after that starts cleanly
+    auto loop = tone_loop();
+    auto played = stretch(*s, loop, 1.0, 4800);
+    for (std::size_t i = 0; i < played.size(); ++i) {
+        ASSERT_NEAR(played[i], loop[i], 2) << i;
+    }
+}
+
+TEST(TimeStretch, TrackBankKeepsPitchAcrossTempoChange)
+{
+    using bank_t =
+      track_bank<int16_t, 1, loop_length, 0, time_stretch<int16_t>>;
+    auto bank = std::make_unique<bank_t>(48000);
+    bank->set_samples_per_beat(12000);
+
+    auto loop = tone_loop();
+    std::vector<int16_t> out(loop_length);
+    bank->arm(0, loop_command::record, quantize::immediate);
+    bank->process(loop.data(), out.data(), loop.size());
+    bank->arm(0, loop_command::play, quantize::immediate);
+
+    // A tenth faster: the loop is shorter but the tone stays at 440 Hz
+    bank->set_samples_per_beat(10800);
+    std::vector<int16_t> silence(24000);
+    out.resize(silence.size());
+    bank->process(silence.data(), out.data(), silence.size());
+    EXPECT_EQ(bank->duration(0), 43200u);
+    EXPECT_NEAR(frequency(out), tone_hz, 4);
+}
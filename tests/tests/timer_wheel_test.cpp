@@ -0,0 +1,293 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <quantized_looper/Software/timer_wheel.hpp>
+
+namespace {
+
+// Simulated clock, and every run as (task, clock time)
+uint64_t sim_now = 0;
+std::vector<std::pair<int, uint64_t>> runs;
+
+uint64_t sim_clock()
+{
+    return sim_now;
+}
+
+template<int I>
+void record()
+{
+    runs.emplace_back(I, sim_now);
+}
+
+using task_t = wheel_task<uint64_t>;
+
+// 16 ticks per granule
+constexpr unsigned shift = 4;
+
+void reset()
+{
+    sim_now = 0;
+    runs.clear();
+}
+
+// Poll every `step` ticks until `end`
+template<typename Wheel>
+void run_until(Wheel& wheel, uint64_t end, uint64_t step)
+{
+    while (sim_now < end) {
+        sim_now += step;
+        wheel.poll(sim_now);
+    }
+}
+
+std::vector<uint64_t> times_of(int task)
+{
+    std::vector<uint64_t> t;
+    for (auto [i, at] : runs) {
+        if (i == task) {
+            t.push_back(at);
+        }
+    }
+    return t;
+}
+
+} // namespace
+
+TEST(TimerWheel, PeriodicTasksRunOnTime)
+{
+    reset();
+    std::array<task_t, 3> tasks = { task_t(record<0>, sim_clock, 100, 0),
+                                    task_t(record<1>, sim_clock, 333, 50),
+                                    task_t(record<2>, sim_clock, 7000, 10) };
+    timer_wheel<uint64_t, 3> wheel(tasks, shift);
+    wheel.start(sim_now);
+    run_until(wheel, 100000, 1);
+
+    // Polled every tick, each run lands within a granule of its release
+    for (int task = 0; task < 3; ++task) {
+        auto t = times_of(task);
+        uint64_t period = tasks[task].period;
+        uint64_t release = task == 0 ? 0 : task == 1 ? 50 : 10;
+        ASSERT_EQ(t.size(), (100000 - release) / period + 1) << task;
+        for (uint64_t at : t) {
+            EXPECT_GE(at, release);
+            EXPECT_LT(at, release + 16);
+            release += period;
+        }
+    }
+}
+
+TEST(TimerWheel, LongPeriodsCascadeThroughEveryLevel)
+{
+    reset();
+    // 2^22 granules reaches the top level of four 64-slot wheels
+    const uint64_t period = (uint64_t{ 1 } << 22) * 16 + 5;
+    std::array<task_t, 2> tasks = { task_t(record<0>, sim_clock, period, 0),
+                                    task_t(record<1>, sim_clock, 1000, 0) };
+    timer_wheel<uint64_t, 2> wheel(tasks, shift);
+    wheel.start(sim_now);
+    run_until(wheel, 3 * period + 1, 7);
+
+    auto t = times_of(0);
+    ASSERT_EQ(t.size(), 4u);
+    for (std::size_t k = 0; k < t.size(); ++k) {
+        EXPECT_GE(t[k], k * period);
+        EXPECT_LT(t[k], k * period + 16 + 7);
+    }
+    EXPECT_EQ(times_of(1).size(), 3 * period / 1000 + 1);
+}
+
+TEST(TimerWheel, BeyondTheHorizonStillRunsOnTime)
+{
+    reset();
+    // 64^4 granules is the horizon; this is three times that
+    const uint64_t far = 3 * (uint64_t{ 1 } << 24) * 16 + 123;
+    std::array<task_t, 1> tasks = { task_t(record<0>, sim_clock, 0, far) };
+    timer_wheel<uint64_t, 1> wheel(tasks, shift);
+    wheel.start(sim_now);
+    run_until(wheel, far - 1000, 997);
+    EXPECT_TRUE(runs.empty());
+    run_until(wheel, far + 100, 1);
+    ASSERT_EQ(runs.size(), 1u);
+    EXPECT_GE(runs[0].second, far);
+    EXPECT_LT(runs[0].second, far + 16);
+    EXPECT_FALSE(wheel.scheduled(0));
+}
+
+TEST(TimerWheel, StallSkipsMissedReleasesAndKeepsPhase)
+{
+    reset();
+    std::array<task_t, 1> tasks = { task_t(record<0>, sim_clock, 160, 0) };
+    timer_wheel<uint64_t, 1> wheel(tasks, shift);
+    wheel.start(sim_now);
+    wheel.poll(sim_now);
+
+    // Ten periods without a poll: one catch-up run, then back on the grid
+    sim_now = 1600 + 40;
+    wheel.poll(sim_now);
+    run_until(wheel, 2000, 1);
+    EXPECT_EQ(times_of(0), (std::vector<uint64_t>{ 0, 1640, 1760, 1920 }));
+}
+
+TEST(TimerWheel, MatchesLinearScan)
+{
+    reset();
+    // A reference scheduler that checks every task on every pass
+    struct linear
+    {
+        uint64_t period;
+        uint64_t release;
+    };
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<uint64_t> periods(20, 50000);
+    std::array<task_t, 8> tasks = {
+        task_t(record<0>, sim_clock, 0, 0), task_t(record<1>, sim_clock, 0, 0),
+        task_t(record<2>, sim_clock, 0, 0), task_t(record<3>, sim_clock, 0, 0),
+        task_t(record<4>, sim_clock, 0, 0), task_t(record<5>, sim_clock, 0, 0),
+        task_t(record<6>, sim_clock, 0, 0), task_t(record<7>, sim_clock, 0, 0)
+    };
+    std::array<linear, 8> reference{};
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        // Periods and offsets on whole granules, so both agree exactly
+        tasks[i].period = periods(rng) * 16;
+        tasks[i].release = periods(rng) * 16;
+        reference[i] = { tasks[i].period, tasks[i].release };
+    }
+    timer_wheel<uint64_t, 8> wheel(tasks, shift);
+    wheel.start(sim_now);
+
+    std::vector<std::pair<int, uint64_t>> expected;
+    while (sim_now < 2000000) {
+        sim_now += 16;
+        wheel.poll(sim_now);
+        for (std::size_t i = 0; i < reference.size(); ++i) {
+            if (sim_now >= reference[i].release) {
+                expected.emplace_back(static_cast<int>(i), sim_now);
+                reference[i].release += reference[i].period;
+            }
+        }
+    }
+    std::sort(runs.begin(), runs.end(), [](auto a, auto b) {
+        return a.second != b.second ? a.second < b.second : a.first < b.first;
+    });
+    EXPECT_EQ(runs, expected);
+}
+
+namespace {
+
+timer_wheel<uint64_t, 2>* self_wheel = nullptr;
+
+// Reschedules itself a fixed time out, and cancels the other task
+void one_shot_chain()
+{
+    runs.emplace_back(0, sim_now);
+    if (runs.size() < 4) {
+        self_wheel->schedule(0, sim_now + 512);
+    }
+    self_wheel->cancel(1);
+}
+
+} // namespace
+
+TEST(TimerWheel, TasksMayScheduleAndCancel)
+{
+    reset();
+    std::array<task_t, 2> tasks = { task_t(one_shot_chain, sim_clock, 0, 96),
+                                    task_t(record<1>, sim_clock, 50, 1000) };
+    timer_wheel<uint64_t, 2> wheel(tasks, shift);
+    self_wheel = &wheel;
+    wheel.start(sim_now);
+    run_until(wheel, 10000, 1);
+
+    // The other is cancelled before it starts
+    EXPECT_EQ(times_of(0), (std::vector<uint64_t>{ 96, 608, 1120, 1632 }));
+    EXPECT_TRUE(times_of(1).empty());
+    EXPECT_FALSE(wheel.scheduled(0));
+
+    // A time already past runs in the next granule
+    wheel.schedule(1, 0);
+    sim_now += 16;
+    wheel.poll(sim_now);
+    EXPECT_EQ(times_of(1), (std::vector<uint64_t>{ sim_now }));
+    self_wheel = nullptr;
+}
+
+namespace {
+
+timer_wheel<uint64_t, 1>* past_wheel = nullptr;
+
+// Always asks to run again at time zero; gives up after a while so a
+// failure does not hang the test
+void reschedules_in_the_past()
+{
+    runs.emplace_back(0, sim_now);
+    if (runs.size() < 1000) {
+        past_wheel->schedule(0, 0);
+    }
+}
+
+} // namespace
+
+TEST(TimerWheel, TaskSchedulingItselfInThePastRunsOncePerGranule)
+{
+    reset();
+    std::array<task_t, 1> tasks = { task_t(
+      reschedules_in_the_past, sim_clock, 0, 0) };
+    timer_wheel<uint64_t, 1> wheel(tasks, shift);
+    past_wheel = &wheel;
+    wheel.start(sim_now);
+    EXPECT_EQ(wheel.poll(sim_now), 1u);
+    EXPECT_EQ(wheel.poll(sim_now), 0u);
+
+    // Ten granules behind: one run for each, not one per reschedule
+    sim_now = 10 * 16;
+    EXPECT_EQ(wheel.poll(sim_now), 10u);
+    EXPECT_EQ(runs.size(), 11u);
+    EXPECT_TRUE(wheel.scheduled(0));
+    past_wheel = nullptr;
+}
+
+TEST(TimerWheel, NextReleaseIsNeverLate)
+{
+    reset();
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<uint64_t> periods(1, 200000);
+    std::array<task_t, 4> tasks = { task_t(record<0>, sim_clock, 0, 0),
+                                    task_t(record<1>, sim_clock, 0, 0),
+                                    task_t(record<2>, sim_clock, 0, 0),
+                                    task_t(record<3>, sim_clock, 0, 0) };
+    std::array<uint64_t, 4> releases{};
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        tasks[i].period = periods(rng);
+        tasks[i].release = periods(rng);
+        releases[i] = tasks[i].release;
+    }
+    timer_wheel<uint64_t, 4> wheel(tasks, shift);
+    wheel.start(sim_now);
+
+    // Jump from one next_release() to the next, as a sleeping scheduler
+    // would: nothing is due before it, and nothing is missed
+    while (sim_now < 20000000) {
+        uint64_t at = 0;
+        ASSERT_TRUE(wheel.next_release(at));
+        ASSERT_GT(at, sim_now);
+        EXPECT_EQ(wheel.poll(at - 1), 0u);
+        sim_now = at;
+        wheel.poll(sim_now);
+    }
+    for (auto [task, at] : runs) {
+        EXPECT_GE(at, releases[task]) << task;
+        EXPECT_LT(at, releases[task] + 16) << task;
+        releases[task] += tasks[task].period;
+    }
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        EXPECT_GT(releases[i], sim_now - 16) << i;
+    }
+}
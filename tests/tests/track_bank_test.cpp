@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include <quantized_looper/Audio/track_bank.hpp>
+
+namespace {
+
+constexpr uint32_t sample_rate = 48000;
+constexpr uint32_t beat = 8;
+
+using bank_t = track_bank<int16_t, 4, 256>;
+
+// Process n samples of a constant input, returning the output
+std::vector<int16_t> run(bank_t& bank, int16_t level, std::size_t n)
+{
+    std::vector<int16_t> in(n, level);
+    std::vector<int16_t> out(n);
+    bank.process(in.data(), out.data(), n);
+    return out;
+}
+
+// Record `level` on a track for exactly n samples starting now
+void record(bank_t& bank, std::size_t track, int16_t level, std::size_t n)
+{
+    bank.arm(track, loop_command::record, quantize::immediate);
+    run(bank, level, n);
+    bank.arm(track, loop_command::play, quantize::immediate);
+    run(bank, 0, 0);
+}
+
+} // namespace
+
+TEST(TrackBank, FirstRecordingSetsBaseLength)
+{
+    bank_t bank(sample_rate);
+    bank.set_samples_per_beat(beat);
+    EXPECT_EQ(bank.base_length(), 0u);
+
+    record(bank, 0, 1000, 2 * beat);
+    EXPECT_EQ(bank.base_length(), 2 * beat);
+    EXPECT_EQ(bank.state(0), loop_state::playing);
+    EXPECT_EQ(bank.length(0), 2 * beat);
+}
+
+TEST(TrackBank, MultiplierClosesRecordingOnItsOwn)
+{
+    bank_t bank(sample_rate);
+    bank.set_samples_per_beat(beat);
+    record(bank, 0, 1000, beat);
+
+    bank.set_length_multiplier(1, 3);
+    bank.arm(1, loop_command::record, quantize::beat);
+    run(bank, 2000, 5 * beat);
+    EXPECT_EQ(bank.state(1), loop_state::playing);
+    EXPECT_EQ(bank.length(1), 3 * beat);
+    // Recorded on the base loop's downbeat, so both tracks wrap together
+    EXPECT_EQ(bank.position(0), 0u);
+    EXPECT_EQ(bank.position(1), 2 * beat);
+}
+
+TEST(TrackBank, OutputIsGainWeightedSum)
+{
+    bank_t bank(sample_rate);
+    bank.set_samples_per_beat(beat);
+    record(bank, 0, 1000, beat);
+    record(bank, 1, 2000, beat);
+    run(bank, 0, 1);
+
+    bank.set_gain(1, 0.5f);
+    auto out = run(bank, 0, beat);
+    for (int16_t x : out) {
+        ASSERT_EQ(x, 1000 + 1000);
+    }
+}
+
+TEST(TrackBank, SumSaturates)
+{
+    bank_t bank(sample_rate);
+    bank.set_samples_per_beat(beat);
+    for (std::size_t t = 0; t < bank.tracks(); ++t) {
+        record(bank, t, 30000, beat);
+    }
+    auto out = run(bank, 0, beat);
+    for (int16_t x : out) {
+        ASSERT_EQ(x, INT16_MAX);
+    }
+}
+
+TEST(TrackBank, MuteSilencesButKeepsPosition)
+{
+    bank_t bank(sample_rate);
+    bank.set_samples_per_beat(beat);
+    record(bank, 0, 1000, 2 * beat);
+
+    bank.set_mute(0, true);
+    auto muted = run(bank, 0, beat);
+    EXPECT_EQ(muted, std::vector<int16_t>(beat, 0));
+    EXPECT_EQ(bank.position(0), beat);
+
+    bank.set_mute(0, false);
+    auto out = run(bank, 0, beat);
+    EXPECT_EQ(out, std::vector<int16_t>(beat, 1000));
+}
+
+TEST(TrackBank, FeedbackIsPerTrack)
+{
+    bank_t bank(sample_rate);
+    bank.set_samples_per_beat(beat);
+    record(bank, 0, 1000, beat);
+    record(bank, 1, 1000, beat);
+
+    bank.set_feedback(0, 0.5f);
+    bank.arm(0, loop_command::overdub, quantize::immediate);
+    bank.arm(1, loop_command::overdub, quantize::immediate);
+    run(bank, 0, beat);
+    bank.arm(0, loop_command::play, quantize::immediate);
+    bank.arm(1, loop_command::play, quantize::immediate);
+    run(bank, 0, 0);
+
+    EXPECT_EQ(bank.data(0)[0], 500);
+    EXPECT_EQ(bank.data(1)[0], 1000);
+}
+
+TEST(TrackBank, RerecordingOnlyTrackResetsBase)
+{
+    bank_t bank(sample_rate);
+    bank.set_samples_per_beat(beat);
+    record(bank, 0, 1000, beat);
+    record(bank, 0, 1000, 3 * beat);
+    EXPECT_EQ(bank.base_length(), 3 * beat);
+    EXPECT_EQ(bank.length(0), 3 * beat);
+}
+
+TEST(TrackBank, ClearingLastLoopResetsBase)
+{
+    bank_t bank(sample_rate);
+    bank.set_samples_per_beat(beat);
+    record(bank, 0, 1000, beat);
+    record(bank, 1, 1000, beat);
+
+    bank.clear(0);
+    EXPECT_EQ(bank.base_length(), beat);
+    bank.clear(1);
+    EXPECT_EQ(bank.base_length(), 0u);
+    EXPECT_EQ(run(bank, 0, beat), std::vector<int16_t>(beat, 0));
+}
+
+TEST(TrackBank, AdoptedTempoKeepsLoopsAsRecorded)
+{
+    bank_t bank(sample_rate);
+    bank.set_samples_per_beat(beat);
+    record(bank, 0, 1000, 4 * beat);
+
+    // The loop turns out to be two beats long, not four
+    bank.adopt_tempo(2 * beat);
+    EXPECT_EQ(bank.samples_per_beat(), 2 * beat);
+    EXPECT_EQ(bank.base_length(), 4 * beat);
+    EXPECT_EQ(bank.duration(0), 4 * beat);
+    EXPECT_EQ(run(bank, 0, 4 * beat), std::vector<int16_t>(4 * beat, 1000));
+
+    // Multipliers and retiming go from the adopted beat
+    bank.set_samples_per_beat(beat);
+    EXPECT_EQ(bank.base_length(), 2 * beat);
+    EXPECT_EQ(bank.duration(0), 2 * beat);
+}
+
+TEST(TrackBank, RetimedFullTrackPlaysPastItsBuffer)
+{
+    bank_t bank(sample_rate);
+    bank.set_samples_per_beat(beat);
+    record(bank, 0, 1000, 256);
+    ASSERT_EQ(bank.length(0), 256u);
+
+    // At half the tempo the loop lasts twice the buffer
+    bank.set_samples_per_beat(2 * beat);
+    EXPECT_EQ(bank.duration(0), 512u);
+    for (int16_t x : run(bank, 0, 512)) {
+        EXPECT_NEAR(x, 1000, 8);
+    }
+    EXPECT_EQ(bank.position(0), 0u);
+}
@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include <quantized_looper/Audio/track_bank.hpp>
+#include <quantized_looper/Audio/transport.hpp>
+
+namespace {
+
+using transport_t = transport<int, 4>;
+
+constexpr uint32_t sample_rate = 48000;
+
+// Advance in blocks, firing due actions at their exact sample the way the
+// audio engine does, and record (action, sample) pairs
+struct fired
+{
+    int action;
+    uint64_t sample;
+};
+
+std::vector<fired> run(transport_t& t, std::size_t n, std::size_t block = 32)
+{
+    std::vector<fired> log;
+    auto fire = [&](int a) { log.push_back({ a, t.sample_clock() }); };
+    while (n > 0) {
+        std::size_t piece = std::min(block, n);
+        t.fire_due(fire);
+        piece = std::min(piece, t.samples_to_next_action());
+        if (piece == 0) {
+            continue;
+        }
+        t.advance(piece);
+        n -= piece;
+    }
+    t.fire_due(fire);
+    return log;
+}
+
+} // namespace
+
+TEST(Transport, PositionFromSampleCount)
+{
+    transport_t t(sample_rate, 3);
+    t.set_samples_per_beat(960);
+    t.advance(960 * 4 + 30);
+    auto p = t.now();
+    EXPECT_EQ(p.beats, 4u);
+    EXPECT_EQ(p.bar, 1u);
+    EXPECT_EQ(p.beat, 1u);
+    EXPECT_EQ(p.sample, 30u);
+    EXPECT_EQ(p.tick, 3u);
+}
+
+TEST(Transport, TickStartsMatchPosition)
+{
+    transport_t t(sample_rate);
+    t.set_samples_per_beat(1001);
+    for (uint32_t tick = 0; tick < transport_t::ppqn; ++tick) {
+        uint64_t s = t.sample_of_tick(2, tick);
+        ASSERT_EQ(t.at(s).tick, tick);
+        ASSERT_EQ(t.at(s).beats, 2u);
+        if (s > 0) {
+            ASSERT_NE(t.at(s - 1).tick, tick);
+        }
+    }
+}
+
+TEST(Transport, TempoChangeKeepsBeatAndPhase)
+{
+    transport_t t(sample_rate);
+    t.set_samples_per_beat(1000);
+    t.advance(5250);
+    t.set_samples_per_beat(2000);
+    auto p = t.now();
+    EXPECT_EQ(p.beats, 5u);
+    EXPECT_EQ(p.sample, 500u);
+
+    // The rest of the beat runs at the new length
+    t.advance(1500);
+    EXPECT_EQ(t.now().beats, 6u);
+    EXPECT_EQ(t.now().sample, 0u);
+}
+
+TEST(Transport, ActionsFireOnExactBoundaries)
+{
+    transport_t t(sample_rate, 4);
+    t.set_samples_per_beat(1000);
+    t.advance(10);
+    EXPECT_TRUE(t.schedule(1, quantize::beat));
+    EXPECT_TRUE(t.schedule(2, quantize::bar));
+    EXPECT_TRUE(t.schedule(3, quantize::immediate));
+
+    auto log = run(t, 5000);
+    ASSERT_EQ(log.size(), 3u);
+    EXPECT_EQ(log[0].action, 3);
+    EXPECT_EQ(log[0].sample, 10u);
+    EXPECT_EQ(log[1].action, 1);
+    EXPECT_EQ(log[1].sample, 1000u);
+    EXPECT_EQ(log[2].action, 2);
+    EXPECT_EQ(log[2].sample, 4000u);
+}
+
+TEST(Transport, OnTheBoundaryIsNow)
+{
+    transport_t t(sample_rate);
+    t.set_samples_per_beat(1000);
+    t.advance(2000);
+    EXPECT_EQ(t.next_boundary(quantize::beat), 2000u);
+    EXPECT_EQ(t.next_boundary(quantize::bar), 4000u);
+}
+
+TEST(Transport, QueuedBeatFollowsTempoChange)
+{
+    transport_t t(sample_rate);
+    t.set_samples_per_beat(1000);
+    t.advance(100);
+    t.schedule(1, quantize::bar);
+    t.schedule_at(2, 3000);
+
+    // Halve the tempo 1.5 beats in: the bar now starts 2.5 slow beats later
+    run(t, 1400);
+    t.set_samples_per_beat(2000);
+    auto log = run(t, 10000);
+    ASSERT_EQ(log.size(), 2u);
+    EXPECT_EQ(log[0].action, 2);
+    EXPECT_EQ(log[0].sample, 3000u);
+    EXPECT_EQ(log[1].action, 1);
+    EXPECT_EQ(log[1].sample, 1500u + 500u * 2 + 2u * 2000u);
+    EXPECT_EQ(t.at(log[1].sample).beats, 4u);
+    EXPECT_EQ(t.at(log[1].sample).sample, 0u);
+}
+
+TEST(Transport, LocateMovesGridAndSnapsQueue)
+{
+    transport_t t(sample_rate, 4);
+    t.set_samples_per_beat(1000);
+    t.advance(200);
+    t.schedule(1, quantize::bar);
+    t.schedule(2, quantize::beat);
+    t.schedule_at(3, 5000);
+
+    // Jump to 250 samples into beat 10; the bar is now beat 12
+    t.locate(10, 250);
+    auto p = t.now();
+    EXPECT_EQ(p.beats, 10u);
+    EXPECT_EQ(p.bar, 2u);
+    EXPECT_EQ(p.sample, 250u);
+
+    auto log = run(t, 5000);
+    ASSERT_EQ(log.size(), 3u);
+    EXPECT_EQ(log[0].action, 2);
+    EXPECT_EQ(log[0].sample, 200u + 750u);
+    EXPECT_EQ(log[1].action, 1);
+    EXPECT_EQ(log[1].sample, 200u + 750u + 1000u);
+    EXPECT_EQ(log[2].action, 3);
+    EXPECT_EQ(log[2].sample, 5000u);
+}
+
+TEST(Transport, CancelAndFind)
+{
+    transport_t t(sample_rate);
+    t.schedule(1, quantize::beat);
+    t.schedule(2, quantize::beat);
+    t.schedule(3, quantize::beat);
+    t.cancel_if([](int a) { return a == 2; });
+    EXPECT_EQ(t.pending(), 2u);
+    EXPECT_EQ(t.find_if([](int a) { return a == 2; }), nullptr);
+    ASSERT_NE(t.find_if([](int a) { return a == 3; }), nullptr);
+    EXPECT_EQ(*t.find_if([](int a) { return a == 3; }), 3);
+}
+
+TEST(Transport, SameSampleKeepsOrderAndCapacityIsBounded)
+{
+    transport_t t(sample_rate);
+    t.set_samples_per_beat(100);
+    t.advance(1);
+    for (int a = 0; a < 4; ++a) {
+        EXPECT_TRUE(t.schedule(a, quantize::beat));
+    }
+    EXPECT_FALSE(t.schedule(4, quantize::beat));
+    EXPECT_EQ(t.samples_to_next_action(), 99u);
+
+    auto log = run(t, 100);
+    ASSERT_EQ(log.size(), 4u);
+    for (int a = 0; a < 4; ++a) {
+        EXPECT_EQ(log[a].action, a);
+        EXPECT_EQ(log[a].sample, 100u);
+    }
+}
+
+TEST(Transport, TrackBankDrivesTheTransport)
+{
+    track_bank<int16_t, 2, 4800> bank(sample_rate);
+    bank.set_samples_per_beat(600);
+    std::vector<int16_t> in(1000, 100);
+    std::vector<int16_t> out(1000);
+    bank.process(in.data(), out.data(), 700);
+    EXPECT_EQ(bank.transport().sample_clock(), 700u);
+    EXPECT_EQ(bank.transport().now().beats, 1u);
+
+    // Armed commands are the transport's queued actions
+    bank.arm(1, loop_command::play, quantize::beat);
+    bank.arm(1, loop_command::record, quantize::beat);
+    EXPECT_EQ(bank.transport().pending(), 1u);
+    EXPECT_EQ(bank.armed(1), loop_command::record);
+    EXPECT_EQ(bank.armed(0), loop_command::none);
+    bank.process(in.data(), out.data(), 600);
+    EXPECT_EQ(bank.transport().pending(), 0u);
+    EXPECT_EQ(bank.state(1), loop_state::recording);
+}